@@ -22,6 +22,7 @@
 
 #include "gui/EventRecorder.h"
 
+#include "common/config-manager.h"
 #include "common/util.h"
 #include "common/textconsole.h"
 
@@ -43,24 +44,44 @@ namespace Audio {
  */
 class Channel {
 public:
-	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent);
+	Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream, DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, ResamplerType resampler);
 	~Channel();
 
 	/**
 	 * Mixes the channel's samples into the given buffer.
 	 *
-	 * @param data buffer where to mix the data
-	 * @param len  number of sample *pairs*. So a value of
-	 *             10 means that the buffer contains twice 10 sample, each
-	 *             16 bits, for a total of 40 bytes.
+	 * @param data          32-bit buffer where to accumulate the data
+	 * @param convertBuffer scratch buffer of the same number of samples
+	 * @param len           number of sample *pairs*. So a value of
+	 *                      10 means that the buffers contain twice 10 samples.
+	 * @param accumulate    kernel used to add the scaled samples onto data
 	 * @return number of sample pairs processed (which can still be silence!)
 	 */
-	int mix(int16 *data, uint len);
+	int mix(int32 *data, int16 *convertBuffer, uint len, MixAccumulateProc accumulate);
 
 	/**
-	 * Queries whether the channel is still playing or not.
+	 * Queries whether the channel is still playing or not. Only to be
+	 * called from the mixer callback, which owns the stream.
 	 */
-	bool isFinished() const { return _stream->endOfStream(); }
+	bool isFinished() const { return _stream->endOfStream() && !_converter->hasPendingOutput(); }
+
+	/**
+	 * Frees the stream and the rate converter of a finished channel, so
+	 * that its memory and files are released right away. Only to be called
+	 * from the mixer callback, which owns the stream.
+	 */
+	void releaseStream();
+
+	/**
+	 * Flags the channel as finished. This is the last access of the mixer
+	 * callback to the channel.
+	 */
+	void setFinished() { _finished.store(true); }
+
+	/**
+	 * Queries whether the mixer callback is done with the channel.
+	 */
+	bool hasFinished() const { return _finished.load(); }
 
 	/**
 	 * Queries whether the channel is a permanent channel.
@@ -87,6 +108,11 @@ public:
 	 */
 	bool isPaused() const { return (_pauseLevel != 0); }
 
+	/**
+	 * Queries whether the mixer callback should skip the channel.
+	 */
+	bool isMixingPaused() const { return _paused.load(); }
+
 	/**
 	 * Sets the channel's own volume.
 	 *
@@ -154,15 +180,35 @@ private:
 	int8 _balance;
 
 	void updateChannelVolumes();
-	st_volume_t _volL, _volR;
+
+	/** Effective left volume in the low, right volume in the high 16 bits. */
+	Common::Atomic<uint32> _volumes;
+
+	/**
+	 * The rate converter reverses stereo output, so the left volume
+	 * applies to the second sample of each pair.
+	 */
+	bool _swapVolumes;
 
 	Mixer *_mixer;
 
-	uint32 _samplesConsumed;
+	Common::Atomic<bool> _paused;
+	Common::Atomic<bool> _finished;
+
+	/**
+	 * Playback position, published by mix() for getElapsedTime(). The
+	 * sequence is odd while mix() updates the other values.
+	 */
+	Common::Atomic<uint32> _timeSequence;
+	Common::Atomic<uint32> _samplesConsumed;
+	Common::Atomic<uint32> _mixerTimeStamp;
+	Common::Atomic<uint32> _mixCount;
+
 	uint32 _samplesDecoded;
-	uint32 _mixerTimeStamp;
 	uint32 _pauseStartTime;
 	uint32 _pauseTime;
+	/** Value of _mixCount when the channel was last unpaused. */
+	uint32 _pauseMixCount;
 
 	RateConverter *_converter;
 	Common::DisposablePtr<AudioStream> _stream;
@@ -172,24 +218,53 @@ private:
 #pragma mark --- Mixer ---
 #pragma mark -
 
+#ifndef NO_CXX11_ATOMIC
+// Set while the current thread runs a mixer callback
+static thread_local bool inMixCallback = false;
+#endif
+
 MixerImpl::MixerImpl(uint sampleRate)
-	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings() {
+	: _mutex(), _sampleRate(sampleRate), _mixerReady(false), _handleSeed(0), _soundTypeSettings(), _callbackEpoch(0), _retiredEpoch(0),
+	  _mixAccumulate(mixAccumulateGeneric), _mixClamp(mixClampGeneric), _resampler(kResamplerLinear) {
 
 	assert(sampleRate > 0);
 
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		_channels[i] = 0;
+
+	if (ConfMan.get("resampler") == "sinc")
+		_resampler = kResamplerSinc;
+
+	// Pick the fastest mixing kernels the CPU supports
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		_mixAccumulate = mixAccumulateNEON;
+		_mixClamp = mixClampNEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		_mixAccumulate = mixAccumulateSSE2;
+		_mixClamp = mixClampSSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		_mixAccumulate = mixAccumulateAVX2;
+		_mixClamp = mixClampAVX2;
+	}
+#endif
 }
 
 MixerImpl::~MixerImpl() {
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		delete _channels[i];
+	for (uint i = 0; i < _retiredChannels.size(); i++)
+		delete _retiredChannels[i];
 }
 
 void MixerImpl::setReady(bool ready) {
-	Common::StackLock lock(_mutex);
-
-	_mixerReady = ready;
+	_mixerReady.store(ready);
 }
 
 uint MixerImpl::getOutputRate() const {
@@ -219,6 +294,67 @@ void MixerImpl::insertChannel(SoundHandle *handle, Channel *chan) {
 	_handleSeed++;
 	if (handle)
 		*handle = chanHandle;
+
+	// Hand the fully set up channel to the mixer callback
+	_mixChannels[index].store(chan);
+}
+
+void MixerImpl::reapFinishedChannels() {
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		if (_channels[i] && _channels[i]->hasFinished()) {
+			delete _channels[i];
+			_channels[i] = 0;
+		}
+	}
+
+	// The callback which might still have used the retired channels has
+	// returned once the epoch moved on
+	if (!_retiredChannels.empty() && _callbackEpoch.load() != _retiredEpoch) {
+		for (uint i = 0; i < _retiredChannels.size(); i++)
+			delete _retiredChannels[i];
+		_retiredChannels.clear();
+	}
+}
+
+Channel *MixerImpl::removeChannel(int index) {
+	Channel *chan = _channels[index];
+	_channels[index] = 0;
+	_mixChannels[index].store(nullptr);
+	return chan;
+}
+
+void MixerImpl::deleteChannels(Channel *const *channels, int count) {
+	if (!count)
+		return;
+
+#ifndef NO_CXX11_ATOMIC
+	// A callback which started before the channels were removed may still
+	// be mixing them. No need to wait when a stream being mixed stops
+	// channels, as the callback does not run concurrently then. Without
+	// atomics, the callback holds _mutex, so it is never running here.
+	if (!inMixCallback) {
+		const uint32 epoch = _callbackEpoch.load();
+		if (epoch & 1) {
+			const uint32 start = g_system->getMillis(true);
+			while (_callbackEpoch.load() == epoch) {
+				if (g_system->getMillis(true) - start >= kCallbackTimeout) {
+					// The callback is stuck, e.g. on a lock held by the
+					// caller. Delete the channels once it has returned.
+					warning("MixerImpl::deleteChannels: Timed out waiting for the mixer callback");
+					Common::StackLock lock(_mutex);
+					for (int i = 0; i < count; i++)
+						_retiredChannels.push_back(channels[i]);
+					_retiredEpoch = epoch;
+					return;
+				}
+				g_system->delayMillis(1);
+			}
+		}
+	}
+#endif
+
+	for (int i = 0; i < count; i++)
+		delete channels[i];
 }
 
 void MixerImpl::playStream(
@@ -237,7 +373,10 @@ void MixerImpl::playStream(
 	}
 
 
-	assert(_mixerReady);
+
+	assert(_mixerReady.load());
+
+	reapFinishedChannels();
 
 	// Prevent duplicate sounds
 	if (id != -1) {
@@ -260,7 +399,7 @@ void MixerImpl::playStream(
 #endif
 
 	// Create the channel
-	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent);
+	Channel *chan = new Channel(this, type, stream, autofreeStream, reverseStereo, id, permanent, _resampler);
 	chan->setVolume(volume);
 	chan->setBalance(balance);
 	insertChannel(handle, chan);
@@ -269,7 +408,14 @@ void MixerImpl::playStream(
 int MixerImpl::mixCallback(byte *samples, uint len) {
 	assert(samples);
 
+#ifndef NO_CXX11_ATOMIC
+	// This runs on the audio thread and must never block. The channels are
+	// only read from _mixChannels, see deleteChannels().
+	inMixCallback = true;
+#else
 	Common::StackLock lock(_mutex);
+#endif
+	_callbackEpoch.fetchAdd(1);
 
 	int16 *buf = (int16 *)samples;
 	// we store stereo, 16-bit samples
@@ -277,63 +423,112 @@ int MixerImpl::mixCallback(byte *samples, uint len) {
 	len >>= 2;
 
 	// Since the mixer callback has been called, the mixer must be ready...
-	_mixerReady = true;
+	_mixerReady.store(true);
+
+	// Grow the intermediate buffers, if necessary
+	if (_mixBuffer.size() < 2 * len) {
+		_mixBuffer.resize(2 * len);
+		_convertBuffer.resize(2 * len);
+	}
 
-	//  zero the buf
-	memset(buf, 0, 2 * len * sizeof(int16));
+	//  zero the accumulation buffer
+	int32 *mixBuf = _mixBuffer.begin();
+	memset(mixBuf, 0, 2 * len * sizeof(int32));
 
 	// mix all channels
 	int res = 0, tmp;
-	for (int i = 0; i != NUM_CHANNELS; i++)
-		if (_channels[i]) {
-			if (_channels[i]->isFinished()) {
-				delete _channels[i];
-				_channels[i] = 0;
-			} else if (!_channels[i]->isPaused()) {
-				tmp = _channels[i]->mix(buf, len);
-
-				if (tmp > res)
-					res = tmp;
+	for (int i = 0; i != NUM_CHANNELS; i++) {
+		Channel *chan = _mixChannels[i].load();
+		if (!chan)
+			continue;
+
+		if (chan->isFinished()) {
+			// Free the stream now and leave the rest of the channel to
+			// reapFinishedChannels(), unless it is being removed already
+			if (_mixChannels[i].compareExchange(chan, nullptr)) {
+				chan->releaseStream();
+				chan->setFinished();
 			}
+		} else if (!chan->isMixingPaused()) {
+			tmp = chan->mix(mixBuf, _convertBuffer.begin(), len, _mixAccumulate);
+
+			if (tmp > res)
+				res = tmp;
 		}
+	}
+
+	// Clip the sum of all channels only once
+	_mixClamp(buf, mixBuf, 2 * len);
+
+#ifdef OUTPUT_UNSIGNED_AUDIO
+	for (uint i = 0; i < 2 * len; i++)
+		buf[i] ^= 0x8000;
+#endif
+
+	_callbackEpoch.fetchAdd(1);
+#ifndef NO_CXX11_ATOMIC
+	inMixCallback = false;
+#endif
 
 	return res;
 }
 
 void MixerImpl::stopAll() {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && !_channels[i]->isPermanent()) {
-			delete _channels[i];
-			_channels[i] = 0;
+	Channel *removed[NUM_CHANNELS];
+	int numRemoved = 0;
+
+	{
+		Common::StackLock lock(_mutex);
+		reapFinishedChannels();
+
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != 0 && !_channels[i]->isPermanent())
+				removed[numRemoved++] = removeChannel(i);
 		}
 	}
+
+	deleteChannels(removed, numRemoved);
 }
 
 void MixerImpl::stopID(int id) {
-	Common::StackLock lock(_mutex);
-	for (int i = 0; i != NUM_CHANNELS; i++) {
-		if (_channels[i] != 0 && _channels[i]->getId() == id) {
-			delete _channels[i];
-			_channels[i] = 0;
+	Channel *removed[NUM_CHANNELS];
+	int numRemoved = 0;
+
+	{
+		Common::StackLock lock(_mutex);
+		reapFinishedChannels();
+
+		for (int i = 0; i != NUM_CHANNELS; i++) {
+			if (_channels[i] != 0 && _channels[i]->getId() == id)
+				removed[numRemoved++] = removeChannel(i);
 		}
 	}
+
+	deleteChannels(removed, numRemoved);
 }
 
 void MixerImpl::stopHandle(SoundHandle handle) {
-	Common::StackLock lock(_mutex);
+	Channel *removed;
 
-	// Simply ignore stop requests for handles of sounds that already terminated
-	const int index = handle._val % NUM_CHANNELS;
-	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
-		return;
+	{
+		Common::StackLock lock(_mutex);
+		reapFinishedChannels();
 
-	delete _channels[index];
-	_channels[index] = 0;
+		// Simply ignore stop requests for handles of sounds that already terminated
+		const int index = handle._val % NUM_CHANNELS;
+		if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
+			return;
+
+		removed = removeChannel(index);
+	}
+
+	deleteChannels(&removed, 1);
 }
 
 void MixerImpl::muteSoundType(SoundType type, bool mute) {
 	assert(0 <= (int)type && (int)type < ARRAYSIZE(_soundTypeSettings));
+
+	Common::StackLock lock(_mutex);
 	_soundTypeSettings[type].mute = mute;
 
 	for (int i = 0; i != NUM_CHANNELS; ++i) {
@@ -349,6 +544,7 @@ bool MixerImpl::isSoundTypeMuted(SoundType type) const {
 
 void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 	Common::StackLock lock(_mutex);
+	reapFinishedChannels();
 
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
@@ -358,6 +554,9 @@ void MixerImpl::setChannelVolume(SoundHandle handle, byte volume) {
 }
 
 byte MixerImpl::getChannelVolume(SoundHandle handle) {
+	Common::StackLock lock(_mutex);
+	reapFinishedChannels();
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -367,6 +566,7 @@ byte MixerImpl::getChannelVolume(SoundHandle handle) {
 
 void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 	Common::StackLock lock(_mutex);
+	reapFinishedChannels();
 
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
@@ -376,6 +576,9 @@ void MixerImpl::setChannelBalance(SoundHandle handle, int8 balance) {
 }
 
 int8 MixerImpl::getChannelBalance(SoundHandle handle) {
+	Common::StackLock lock(_mutex);
+	reapFinishedChannels();
+
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
 		return 0;
@@ -389,6 +592,7 @@ uint32 MixerImpl::getSoundElapsedTime(SoundHandle handle) {
 
 Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	reapFinishedChannels();
 
 	const int index = handle._val % NUM_CHANNELS;
 	if (!_channels[index] || _channels[index]->getHandle()._val != handle._val)
@@ -399,6 +603,7 @@ Timestamp MixerImpl::getElapsedTime(SoundHandle handle) {
 
 void MixerImpl::pauseAll(bool paused) {
 	Common::StackLock lock(_mutex);
+	reapFinishedChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0) {
 			_channels[i]->pause(paused);
@@ -408,6 +613,7 @@ void MixerImpl::pauseAll(bool paused) {
 
 void MixerImpl::pauseID(int id, bool paused) {
 	Common::StackLock lock(_mutex);
+	reapFinishedChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++) {
 		if (_channels[i] != 0 && _channels[i]->getId() == id) {
 			_channels[i]->pause(paused);
@@ -418,6 +624,7 @@ void MixerImpl::pauseID(int id, bool paused) {
 
 void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 	Common::StackLock lock(_mutex);
+	reapFinishedChannels();
 
 	// Simply ignore (un)pause requests for sounds that already terminated
 	const int index = handle._val % NUM_CHANNELS;
@@ -429,6 +636,7 @@ void MixerImpl::pauseHandle(SoundHandle handle, bool paused) {
 
 bool MixerImpl::isSoundIDActive(int id) {
 	Common::StackLock lock(_mutex);
+	reapFinishedChannels();
 
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
@@ -442,6 +650,7 @@ bool MixerImpl::isSoundIDActive(int id) {
 
 int MixerImpl::getSoundID(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	reapFinishedChannels();
 	const int index = handle._val % NUM_CHANNELS;
 	if (_channels[index] && _channels[index]->getHandle()._val == handle._val)
 		return _channels[index]->getId();
@@ -450,6 +659,7 @@ int MixerImpl::getSoundID(SoundHandle handle) {
 
 bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 	Common::StackLock lock(_mutex);
+	reapFinishedChannels();
 
 #ifdef ENABLE_EVENTRECORDER
 	g_eventRec.updateSubsystems();
@@ -461,6 +671,7 @@ bool MixerImpl::isSoundHandleActive(SoundHandle handle) {
 
 bool MixerImpl::hasActiveChannelOfType(SoundType type) {
 	Common::StackLock lock(_mutex);
+	reapFinishedChannels();
 	for (int i = 0; i != NUM_CHANNELS; i++)
 		if (_channels[i] && _channels[i]->getType() == type)
 			return true;
@@ -497,22 +708,31 @@ int MixerImpl::getVolumeForSoundType(SoundType type) const {
 #pragma mark -
 
 Channel::Channel(Mixer *mixer, Mixer::SoundType type, AudioStream *stream,
-                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent)
+                 DisposeAfterUse::Flag autofreeStream, bool reverseStereo, int id, bool permanent, ResamplerType resampler)
     : _type(type), _mixer(mixer), _id(id), _permanent(permanent), _volume(Mixer::kMaxChannelVolume),
-      _balance(0), _pauseLevel(0), _samplesConsumed(0), _samplesDecoded(0), _mixerTimeStamp(0),
-      _pauseStartTime(0), _pauseTime(0), _converter(0), _volL(0), _volR(0),
-      _stream(stream, autofreeStream) {
+      _balance(0), _pauseLevel(0), _volumes(0), _swapVolumes(false), _paused(false), _finished(false),
+      _timeSequence(0), _samplesConsumed(0), _mixerTimeStamp(0), _mixCount(0), _samplesDecoded(0),
+      _pauseStartTime(0), _pauseTime(0), _pauseMixCount(0), _converter(0), _stream(stream, autofreeStream) {
 	assert(mixer);
 	assert(stream);
 
+	// Mono streams are never reversed by the rate converter
+	_swapVolumes = reverseStereo && _stream->isStereo();
+
 	// Get a rate converter instance
-	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo);
+	_converter = makeRateConverter(_stream->getRate(), mixer->getOutputRate(), _stream->isStereo(), reverseStereo, resampler);
 }
 
 Channel::~Channel() {
 	delete _converter;
 }
 
+void Channel::releaseStream() {
+	delete _converter;
+	_converter = 0;
+	_stream.reset();
+}
+
 void Channel::setVolume(const byte volume) {
 	_volume = volume;
 	updateChannelVolumes();
@@ -540,22 +760,27 @@ void Channel::updateChannelVolumes() {
 	// volume is in the range 0 - kMaxMixerVolume.
 	// Hence, the vol_l/vol_r values will be in that range, too
 
+	st_volume_t volL, volR;
+
 	if (!_mixer->isSoundTypeMuted(_type)) {
 		int vol = _mixer->getVolumeForSoundType(_type) * _volume;
 
 		if (_balance == 0) {
-			_volL = vol / Mixer::kMaxChannelVolume;
-			_volR = vol / Mixer::kMaxChannelVolume;
+			volL = vol / Mixer::kMaxChannelVolume;
+			volR = vol / Mixer::kMaxChannelVolume;
 		} else if (_balance < 0) {
-			_volL = vol / Mixer::kMaxChannelVolume;
-			_volR = ((127 + _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
+			volL = vol / Mixer::kMaxChannelVolume;
+			volR = ((127 + _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
 		} else {
-			_volL = ((127 - _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
-			_volR = vol / Mixer::kMaxChannelVolume;
+			volL = ((127 - _balance) * vol) / (Mixer::kMaxChannelVolume * 127);
+			volR = vol / Mixer::kMaxChannelVolume;
 		}
 	} else {
-		_volL = _volR = 0;
+		volL = volR = 0;
 	}
+
+	// Both volumes are picked up by the mixer callback at once
+	_volumes.store(volL | (volR << 16));
 }
 
 void Channel::pause(bool paused) {
@@ -572,8 +797,11 @@ void Channel::pause(bool paused) {
 		if (!_pauseLevel) {
 			_pauseTime = (g_system->getMillis(true) - _pauseStartTime);
 			_pauseStartTime = 0;
+			_pauseMixCount = _mixCount.load();
 		}
 	}
+
+	_paused.store(_pauseLevel != 0);
 }
 
 Timestamp Channel::getElapsedTime() {
@@ -582,17 +810,29 @@ Timestamp Channel::getElapsedTime() {
 
 	Audio::Timestamp ts(0, rate);
 
-	if (_mixerTimeStamp == 0)
+	// Read a consistent snapshot of the values published by mix()
+	uint32 sequence, samplesConsumed, mixerTimeStamp, mixCount;
+	do {
+		sequence = _timeSequence.load();
+		samplesConsumed = _samplesConsumed.load();
+		mixerTimeStamp = _mixerTimeStamp.load();
+		mixCount = _mixCount.load();
+	} while ((sequence & 1) || sequence != _timeSequence.load());
+
+	if (mixerTimeStamp == 0)
 		return ts;
 
+	// The pause time only counts until the channel is mixed again
+	const uint32 pauseTime = (mixCount == _pauseMixCount) ? _pauseTime : 0;
+
 	if (isPaused())
-		delta = _pauseStartTime - _mixerTimeStamp;
+		delta = _pauseStartTime - mixerTimeStamp;
 	else
-		delta = g_system->getMillis(true) - _mixerTimeStamp - _pauseTime;
+		delta = g_system->getMillis(true) - mixerTimeStamp - pauseTime;
 
 	// Convert the number of samples into a time duration.
 
-	ts = ts.addFrames(_samplesConsumed);
+	ts = ts.addFrames(samplesConsumed);
 	ts = ts.addMsecs(delta);
 
 	// In theory it would seem like a good idea to limit the approximation
@@ -604,19 +844,34 @@ Timestamp Channel::getElapsedTime() {
 	return ts;
 }
 
-int Channel::mix(int16 *data, uint len) {
+int Channel::mix(int32 *data, int16 *convertBuffer, uint len, MixAccumulateProc accumulate) {
 	assert(_stream);
 
 	int res = 0;
-	if (_stream->endOfData()) {
+	// The converter may still hold the filter tail once the stream ended
+	if (_stream->endOfData() && !(_stream->endOfStream() && _converter->hasPendingOutput())) {
 		// TODO: call drain method
 	} else {
 		assert(_converter);
-		_samplesConsumed = _samplesDecoded;
-		_mixerTimeStamp = g_system->getMillis(true);
-		_pauseTime = 0;
-		res = _converter->flow(*_stream, data, len, _volL, _volR);
+		_timeSequence.fetchAdd(1);
+		_samplesConsumed.store(_samplesDecoded);
+		_mixerTimeStamp.store(g_system->getMillis(true));
+		_mixCount.store(_mixCount.load() + 1);
+		_timeSequence.fetchAdd(1);
+
+		res = _converter->convert(*_stream, convertBuffer, len);
 		_samplesDecoded += res;
+
+		const uint32 volumes = _volumes.load();
+		const st_volume_t volL = volumes & 0xFFFF;
+		const st_volume_t volR = volumes >> 16;
+
+		if (res > 0 && (volL || volR)) {
+			if (_swapVolumes)
+				accumulate(data, convertBuffer, res, volR, volL);
+			else
+				accumulate(data, convertBuffer, res, volL, volR);
+		}
 	}
 
 	return res;
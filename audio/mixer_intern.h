@@ -24,8 +24,12 @@
 #define AUDIO_MIXER_INTERN_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
+#include "common/atomic.h"
 #include "common/mutex.h"
 #include "audio/mixer.h"
+#include "audio/mixer_kernels.h"
+#include "audio/rate.h"
 
 namespace Audio {
 
@@ -59,13 +63,20 @@ namespace Audio {
 class MixerImpl : public Mixer {
 private:
 	enum {
-		NUM_CHANNELS = 32
+		NUM_CHANNELS = 32,
+		/** Longest wait for a mixer callback to return, in milliseconds. */
+		kCallbackTimeout = 500
 	};
 
+	/**
+	 * Serializes the control functions called by the engine. The mixer
+	 * callback never takes it, see _mixChannels, unless the compiler has
+	 * no atomics (NO_CXX11_ATOMIC).
+	 */
 	Common::Mutex _mutex;
 
 	const uint _sampleRate;
-	bool _mixerReady;
+	Common::Atomic<bool> _mixerReady;
 	uint32 _handleSeed;
 
 	struct SoundTypeSettings {
@@ -76,15 +87,47 @@ private:
 	};
 
 	SoundTypeSettings _soundTypeSettings[4];
+	/** Channels as seen by the control functions. */
 	Channel *_channels[NUM_CHANNELS];
 
+	/**
+	 * Channels as seen by the mixer callback.
+	 *
+	 * The control functions publish new channels here. To remove a channel,
+	 * they clear its slot and wait for a running callback to return before
+	 * deleting it. The callback clears the slots of finished channels
+	 * itself, frees their streams and flags them, so that they can be
+	 * deleted right away.
+	 */
+	Common::Atomic<Channel *> _mixChannels[NUM_CHANNELS];
+
+	/** Incremented when the mixer callback starts, and when it returns. */
+	Common::Atomic<uint32> _callbackEpoch;
+
+	/**
+	 * Removed channels which a stuck mixer callback may still be using.
+	 * They are deleted once _callbackEpoch differs from _retiredEpoch.
+	 */
+	Common::Array<Channel *> _retiredChannels;
+	uint32 _retiredEpoch;
+
+	/** 32-bit sum of all channels, clamped to 16 bits once per callback. */
+	Common::Array<int32> _mixBuffer;
+	/** Unscaled output of the channel currently being mixed. */
+	Common::Array<int16> _convertBuffer;
+
+	MixAccumulateProc _mixAccumulate;
+	MixClampProc _mixClamp;
+
+	/** Resampler used for channels created from now on. */
+	ResamplerType _resampler;
 
 public:
 
 	MixerImpl(uint sampleRate);
 	~MixerImpl();
 
-	virtual bool isReady() const { Common::StackLock lock(_mutex); return _mixerReady; }
+	virtual bool isReady() const { return _mixerReady.load(); }
 
 	virtual void playStream(
 		SoundType type,
@@ -129,6 +172,25 @@ public:
 protected:
 	void insertChannel(SoundHandle *handle, Channel *chan);
 
+	/**
+	 * Delete the channels which the mixer callback flagged as finished.
+	 * Must be called with _mutex held.
+	 */
+	void reapFinishedChannels();
+
+	/**
+	 * Remove a channel from both channel tables. Must be called with _mutex
+	 * held. The returned channel has to be passed on to deleteChannels().
+	 */
+	Channel *removeChannel(int index);
+
+	/**
+	 * Delete channels returned by removeChannel(), once the mixer callback
+	 * can no longer access them. Must be called without _mutex held, as
+	 * the streams being mixed may call back into the mixer.
+	 */
+	void deleteChannels(Channel *const *channels, int count);
+
 public:
 	/**
 	 * The mixer callback function, to be called at regular intervals by
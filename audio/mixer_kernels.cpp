@@ -0,0 +1,68 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/mixer_kernels.h"
+#include "audio/mixer.h"
+#include "audio/rate.h"
+#include "common/system.h"
+#include "common/util.h"
+
+namespace Audio {
+
+void mixAccumulateGeneric(int32 *acc, const int16 *src, uint frames, uint16 vol0, uint16 vol1) {
+	for (uint i = 0; i < frames; ++i) {
+		acc[0] += (src[0] * (int)vol0) / Mixer::kMaxMixerVolume;
+		acc[1] += (src[1] * (int)vol1) / Mixer::kMaxMixerVolume;
+		acc += 2;
+		src += 2;
+	}
+}
+
+void mixClampGeneric(int16 *dst, const int32 *acc, uint samples) {
+	for (uint i = 0; i < samples; ++i)
+		dst[i] = CLIP<int32>(acc[i], ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+}
+
+int32 dotProductGeneric(const int16 *a, const int16 *b, uint count) {
+	int32 sum = 0;
+	for (uint i = 0; i < count; ++i)
+		sum += a[i] * b[i];
+	return sum;
+}
+
+DotProductProc getDotProductProc() {
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		return dotProductAVX2;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		return dotProductSSE2;
+#endif
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		return dotProductNEON;
+#endif
+	return dotProductGeneric;
+}
+
+} // End of namespace Audio
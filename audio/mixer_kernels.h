@@ -0,0 +1,108 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AUDIO_MIXER_KERNELS_H
+#define AUDIO_MIXER_KERNELS_H
+
+#include "common/scummsys.h"
+
+namespace Audio {
+
+/**
+ * @defgroup audio_mixer_kernels Mixer kernels
+ * @ingroup audio
+ *
+ * @brief Block mixing primitives used by the default mixer implementation.
+ *
+ * MixerImpl accumulates all of its channels into a 32-bit buffer and only
+ * clamps the sum to 16 bits once per callback. Both steps are provided in a
+ * generic version, plus SIMD versions for the instruction set extensions
+ * the build has been configured for. The SIMD versions produce exactly the
+ * same output as the generic ones.
+ * @{
+ */
+
+/**
+ * Scale interleaved stereo samples by a volume per output side and add
+ * them onto a 32-bit accumulation buffer.
+ *
+ * The volumes are in the range 0 - Mixer::kMaxMixerVolume. Scaled samples
+ * are rounded towards zero, like RateConverter::flow() does.
+ *
+ * @param acc    Accumulation buffer of 2 * frames samples.
+ * @param src    Interleaved stereo source samples.
+ * @param frames Number of sample pairs to process.
+ * @param vol0   Volume applied to the even (first) sample of each pair.
+ * @param vol1   Volume applied to the odd (second) sample of each pair.
+ */
+typedef void (*MixAccumulateProc)(int32 *acc, const int16 *src, uint frames, uint16 vol0, uint16 vol1);
+
+/**
+ * Saturate accumulated 32-bit samples into the signed 16-bit range.
+ *
+ * @param dst     Output buffer.
+ * @param acc     Accumulation buffer.
+ * @param samples Number of samples (not pairs) to process.
+ */
+typedef void (*MixClampProc)(int16 *dst, const int32 *acc, uint samples);
+
+/**
+ * Compute the inner product of two 16-bit vectors, as used by the
+ * filter of the polyphase rate converter.
+ *
+ * @param a     First vector.
+ * @param b     Second vector.
+ * @param count Number of elements, must be a multiple of 16.
+ */
+typedef int32 (*DotProductProc)(const int16 *a, const int16 *b, uint count);
+
+void mixAccumulateGeneric(int32 *acc, const int16 *src, uint frames, uint16 vol0, uint16 vol1);
+void mixClampGeneric(int16 *dst, const int32 *acc, uint samples);
+int32 dotProductGeneric(const int16 *a, const int16 *b, uint count);
+
+#ifdef SCUMMVM_SSE2
+void mixAccumulateSSE2(int32 *acc, const int16 *src, uint frames, uint16 vol0, uint16 vol1);
+void mixClampSSE2(int16 *dst, const int32 *acc, uint samples);
+int32 dotProductSSE2(const int16 *a, const int16 *b, uint count);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void mixAccumulateAVX2(int32 *acc, const int16 *src, uint frames, uint16 vol0, uint16 vol1);
+void mixClampAVX2(int16 *dst, const int32 *acc, uint samples);
+int32 dotProductAVX2(const int16 *a, const int16 *b, uint count);
+#endif
+
+#ifdef SCUMMVM_NEON
+void mixAccumulateNEON(int32 *acc, const int16 *src, uint frames, uint16 vol0, uint16 vol1);
+void mixClampNEON(int16 *dst, const int32 *acc, uint samples);
+int32 dotProductNEON(const int16 *a, const int16 *b, uint count);
+#endif
+
+/**
+ * Return the fastest inner product kernel the CPU supports.
+ */
+DotProductProc getDotProductProc();
+
+/** @} */
+} // End of namespace Audio
+
+#endif
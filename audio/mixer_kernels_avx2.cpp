@@ -0,0 +1,87 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/mixer_kernels.h"
+
+#include <immintrin.h>
+
+namespace Audio {
+
+/**
+ * Multiply eight samples by their volumes and divide the products by
+ * Mixer::kMaxMixerVolume, rounding towards zero.
+ */
+static inline __m256i scaleAVX2(__m128i samples, __m256i vol) {
+	__m256i p = _mm256_mullo_epi32(_mm256_cvtepi16_epi32(samples), vol);
+
+	// Bias negative products by 255 so the shift truncates like a division
+	p = _mm256_add_epi32(p, _mm256_srli_epi32(_mm256_srai_epi32(p, 31), 24));
+	return _mm256_srai_epi32(p, 8);
+}
+
+void mixAccumulateAVX2(int32 *acc, const int16 *src, uint frames, uint16 vol0, uint16 vol1) {
+	const __m256i vol = _mm256_set_epi32(vol1, vol0, vol1, vol0, vol1, vol0, vol1, vol0);
+
+	uint i = 0;
+	for (; i + 8 <= frames; i += 8) {
+		const __m256i s0 = scaleAVX2(_mm_loadu_si128((const __m128i *)src), vol);
+		const __m256i s1 = scaleAVX2(_mm_loadu_si128((const __m128i *)(src + 8)), vol);
+
+		_mm256_storeu_si256((__m256i *)acc, _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)acc), s0));
+		_mm256_storeu_si256((__m256i *)(acc + 8), _mm256_add_epi32(_mm256_loadu_si256((const __m256i *)(acc + 8)), s1));
+
+		acc += 16;
+		src += 16;
+	}
+
+	mixAccumulateGeneric(acc, src, frames - i, vol0, vol1);
+}
+
+void mixClampAVX2(int16 *dst, const int32 *acc, uint samples) {
+	uint i = 0;
+	for (; i + 16 <= samples; i += 16) {
+		const __m256i a0 = _mm256_loadu_si256((const __m256i *)(acc + i));
+		const __m256i a1 = _mm256_loadu_si256((const __m256i *)(acc + i + 8));
+
+		// packs works within 128-bit lanes, so restore the sample order afterwards
+		const __m256i packed = _mm256_packs_epi32(a0, a1);
+		_mm256_storeu_si256((__m256i *)(dst + i), _mm256_permute4x64_epi64(packed, 0xD8));
+	}
+
+	mixClampGeneric(dst + i, acc + i, samples - i);
+}
+
+int32 dotProductAVX2(const int16 *a, const int16 *b, uint count) {
+	__m256i sum = _mm256_setzero_si256();
+	for (uint i = 0; i < count; i += 16) {
+		const __m256i va = _mm256_loadu_si256((const __m256i *)(a + i));
+		const __m256i vb = _mm256_loadu_si256((const __m256i *)(b + i));
+		sum = _mm256_add_epi32(sum, _mm256_madd_epi16(va, vb));
+	}
+
+	__m128i half = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+	half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(1, 0, 3, 2)));
+	half = _mm_add_epi32(half, _mm_shuffle_epi32(half, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(half);
+}
+
+} // End of namespace Audio
@@ -0,0 +1,83 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/mixer_kernels.h"
+
+#include <arm_neon.h>
+
+namespace Audio {
+
+/**
+ * Multiply four samples by their volumes and divide the products by
+ * Mixer::kMaxMixerVolume, rounding towards zero.
+ */
+static inline int32x4_t scaleNEON(int16x4_t samples, int16x4_t vol) {
+	const int32x4_t p = vmull_s16(samples, vol);
+
+	// Bias negative products by 255 so the shift truncates like a division
+	const uint32x4_t bias = vshrq_n_u32(vreinterpretq_u32_s32(vshrq_n_s32(p, 31)), 24);
+	return vshrq_n_s32(vaddq_s32(p, vreinterpretq_s32_u32(bias)), 8);
+}
+
+void mixAccumulateNEON(int32 *acc, const int16 *src, uint frames, uint16 vol0, uint16 vol1) {
+	const int16 volumes[4] = { (int16)vol0, (int16)vol1, (int16)vol0, (int16)vol1 };
+	const int16x4_t vol = vld1_s16(volumes);
+
+	uint i = 0;
+	for (; i + 4 <= frames; i += 4) {
+		const int16x8_t s = vld1q_s16(src);
+
+		vst1q_s32(acc, vaddq_s32(vld1q_s32(acc), scaleNEON(vget_low_s16(s), vol)));
+		vst1q_s32(acc + 4, vaddq_s32(vld1q_s32(acc + 4), scaleNEON(vget_high_s16(s), vol)));
+
+		acc += 8;
+		src += 8;
+	}
+
+	mixAccumulateGeneric(acc, src, frames - i, vol0, vol1);
+}
+
+void mixClampNEON(int16 *dst, const int32 *acc, uint samples) {
+	uint i = 0;
+	for (; i + 8 <= samples; i += 8) {
+		const int16x4_t lo = vqmovn_s32(vld1q_s32(acc + i));
+		const int16x4_t hi = vqmovn_s32(vld1q_s32(acc + i + 4));
+		vst1q_s16(dst + i, vcombine_s16(lo, hi));
+	}
+
+	mixClampGeneric(dst + i, acc + i, samples - i);
+}
+
+int32 dotProductNEON(const int16 *a, const int16 *b, uint count) {
+	int32x4_t sum = vdupq_n_s32(0);
+	for (uint i = 0; i < count; i += 8) {
+		const int16x8_t va = vld1q_s16(a + i);
+		const int16x8_t vb = vld1q_s16(b + i);
+		sum = vmlal_s16(sum, vget_low_s16(va), vget_low_s16(vb));
+		sum = vmlal_s16(sum, vget_high_s16(va), vget_high_s16(vb));
+	}
+
+	const int32x2_t half = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+	return vget_lane_s32(vpadd_s32(half, half), 0);
+}
+
+} // End of namespace Audio
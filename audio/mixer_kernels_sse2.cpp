@@ -0,0 +1,86 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "audio/mixer_kernels.h"
+
+#include <emmintrin.h>
+
+namespace Audio {
+
+/**
+ * Multiply eight samples by their volumes and divide the products by
+ * Mixer::kMaxMixerVolume, rounding towards zero.
+ */
+static inline void scaleSSE2(__m128i samples, __m128i vol, __m128i &out0, __m128i &out1) {
+	const __m128i lo = _mm_mullo_epi16(samples, vol);
+	const __m128i hi = _mm_mulhi_epi16(samples, vol);
+	out0 = _mm_unpacklo_epi16(lo, hi);
+	out1 = _mm_unpackhi_epi16(lo, hi);
+
+	// Bias negative products by 255 so the shift truncates like a division
+	out0 = _mm_srai_epi32(_mm_add_epi32(out0, _mm_srli_epi32(_mm_srai_epi32(out0, 31), 24)), 8);
+	out1 = _mm_srai_epi32(_mm_add_epi32(out1, _mm_srli_epi32(_mm_srai_epi32(out1, 31), 24)), 8);
+}
+
+void mixAccumulateSSE2(int32 *acc, const int16 *src, uint frames, uint16 vol0, uint16 vol1) {
+	const __m128i vol = _mm_set_epi16(vol1, vol0, vol1, vol0, vol1, vol0, vol1, vol0);
+
+	uint i = 0;
+	for (; i + 4 <= frames; i += 4) {
+		__m128i s0, s1;
+		scaleSSE2(_mm_loadu_si128((const __m128i *)src), vol, s0, s1);
+
+		_mm_storeu_si128((__m128i *)acc, _mm_add_epi32(_mm_loadu_si128((const __m128i *)acc), s0));
+		_mm_storeu_si128((__m128i *)(acc + 4), _mm_add_epi32(_mm_loadu_si128((const __m128i *)(acc + 4)), s1));
+
+		acc += 8;
+		src += 8;
+	}
+
+	mixAccumulateGeneric(acc, src, frames - i, vol0, vol1);
+}
+
+void mixClampSSE2(int16 *dst, const int32 *acc, uint samples) {
+	uint i = 0;
+	for (; i + 8 <= samples; i += 8) {
+		const __m128i a0 = _mm_loadu_si128((const __m128i *)(acc + i));
+		const __m128i a1 = _mm_loadu_si128((const __m128i *)(acc + i + 4));
+		_mm_storeu_si128((__m128i *)(dst + i), _mm_packs_epi32(a0, a1));
+	}
+
+	mixClampGeneric(dst + i, acc + i, samples - i);
+}
+
+int32 dotProductSSE2(const int16 *a, const int16 *b, uint count) {
+	__m128i sum = _mm_setzero_si128();
+	for (uint i = 0; i < count; i += 8) {
+		const __m128i va = _mm_loadu_si128((const __m128i *)(a + i));
+		const __m128i vb = _mm_loadu_si128((const __m128i *)(b + i));
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(va, vb));
+	}
+
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return _mm_cvtsi128_si32(sum);
+}
+
+} // End of namespace Audio
@@ -13,10 +13,12 @@ MODULE_OBJS := \
 	miles_adlib.o \
 	miles_midi.o \
 	mixer.o \
+	mixer_kernels.o \
 	mpu401.o \
 	mt32gm.o \
 	musicplugin.o \
 	null.o \
+	samplecache.o \
 	timestamp.o \
 	decoders/3do.o \
 	decoders/aac.o \
@@ -96,6 +98,25 @@ MODULE_OBJS += \
 	opl2lpt.o
 endif
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	mixer_kernels_sse2.o
+
+$(MODULE)/mixer_kernels_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	mixer_kernels_avx2.o
+
+$(MODULE)/mixer_kernels_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	mixer_kernels_neon.o
+endif
+
 ifndef USE_ARM_SOUND_ASM
 MODULE_OBJS += \
 	rate.o
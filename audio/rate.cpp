@@ -31,7 +31,10 @@
 #include "audio/audiostream.h"
 #include "audio/rate.h"
 #include "audio/mixer.h"
+#include "audio/mixer_kernels.h"
+#include "common/array.h"
 #include "common/frac.h"
+#include "common/math.h"
 #include "common/textconsole.h"
 #include "common/util.h"
 
@@ -57,6 +60,25 @@ enum {
 	FRAC_HALF_LOW = (1L << (FRAC_BITS_LOW-1))
 };
 
+/**
+ * Store one output sample pair. When mixing, the samples are scaled by the
+ * channel volumes and added onto the buffer contents; otherwise they are
+ * written unscaled (see RateConverter::convert()).
+ */
+template<bool mix, bool reverseStereo>
+static inline void outputSamples(st_sample_t *obuf, st_sample_t out0, st_sample_t out1, st_volume_t vol_l, st_volume_t vol_r) {
+	if (mix) {
+		// output left channel
+		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
+
+		// output right channel
+		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
+	} else {
+		obuf[reverseStereo    ] = out0;
+		obuf[reverseStereo ^ 1] = out1;
+	}
+}
+
 /**
  * Audio rate converter based on simple resampling. Used when no
  * interpolation is required.
@@ -77,9 +99,17 @@ protected:
 	/** fractional position increment in the output stream */
 	long opos_inc;
 
+	template<bool mix>
+	int process(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+
 public:
 	SimpleRateConverter(st_rate_t inrate, st_rate_t outrate);
-	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return process<true>(input, obuf, osamp, vol_l, vol_r);
+	}
+	int convert(AudioStream &input, st_sample_t *obuf, st_size_t osamp) {
+		return process<false>(input, obuf, osamp, 0, 0);
+	}
 	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
 		return ST_SUCCESS;
 	}
@@ -112,7 +142,8 @@ SimpleRateConverter<stereo, reverseStereo>::SimpleRateConverter(st_rate_t inrate
  * Return number of sample pairs processed.
  */
 template<bool stereo, bool reverseStereo>
-int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+template<bool mix>
+int SimpleRateConverter<stereo, reverseStereo>::process(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 	st_sample_t *ostart, *oend;
 
 	ostart = obuf;
@@ -143,12 +174,7 @@ int SimpleRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 		// Increment output position
 		opos += opos_inc;
 
-		// output left channel
-		clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-		// output right channel
-		clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
+		outputSamples<mix, reverseStereo>(obuf, out0, out1, vol_l, vol_r);
 		obuf += 2;
 	}
 	return (obuf - ostart) / 2;
@@ -183,9 +209,17 @@ protected:
 	/** current sample(s) in the input stream (left/right channel) */
 	st_sample_t icur0, icur1;
 
+	template<bool mix>
+	int process(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+
 public:
 	LinearRateConverter(st_rate_t inrate, st_rate_t outrate);
-	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return process<true>(input, obuf, osamp, vol_l, vol_r);
+	}
+	int convert(AudioStream &input, st_sample_t *obuf, st_size_t osamp) {
+		return process<false>(input, obuf, osamp, 0, 0);
+	}
 	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
 		return ST_SUCCESS;
 	}
@@ -221,7 +255,8 @@ LinearRateConverter<stereo, reverseStereo>::LinearRateConverter(st_rate_t inrate
  * Return number of sample pairs processed.
  */
 template<bool stereo, bool reverseStereo>
-int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+template<bool mix>
+int LinearRateConverter<stereo, reverseStereo>::process(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 	st_sample_t *ostart, *oend;
 
 	ostart = obuf;
@@ -258,12 +293,7 @@ int LinearRateConverter<stereo, reverseStereo>::flow(AudioStream &input, st_samp
 						  (st_sample_t)(ilast1 + (((icur1 - ilast1) * opos + FRAC_HALF_LOW) >> FRAC_BITS_LOW)) :
 						  out0);
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
+			outputSamples<mix, reverseStereo>(obuf, out0, out1, vol_l, vol_r);
 			obuf += 2;
 
 			// Increment output position
@@ -284,13 +314,9 @@ template<bool stereo, bool reverseStereo>
 class CopyRateConverter : public RateConverter {
 	st_sample_t *_buffer;
 	st_size_t _bufferSize;
-public:
-	CopyRateConverter() : _buffer(0), _bufferSize(0) {}
-	~CopyRateConverter() {
-		free(_buffer);
-	}
 
-	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	template<bool mix>
+	int process(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
 		assert(input.isStereo() == stereo);
 
 		st_sample_t *ptr;
@@ -321,29 +347,330 @@ public:
 			out0 = *ptr++;
 			out1 = (stereo ? *ptr++ : out0);
 
-			// output left channel
-			clampedAdd(obuf[reverseStereo    ], (out0 * (int)vol_l) / Audio::Mixer::kMaxMixerVolume);
-
-			// output right channel
-			clampedAdd(obuf[reverseStereo ^ 1], (out1 * (int)vol_r) / Audio::Mixer::kMaxMixerVolume);
-
+			outputSamples<mix, reverseStereo>(obuf, out0, out1, vol_l, vol_r);
 			obuf += 2;
 		}
 		return (obuf - ostart) / 2;
 	}
 
+public:
+	CopyRateConverter() : _buffer(0), _bufferSize(0) {}
+	~CopyRateConverter() {
+		free(_buffer);
+	}
+
+	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return process<true>(input, obuf, osamp, vol_l, vol_r);
+	}
+
+	virtual int convert(AudioStream &input, st_sample_t *obuf, st_size_t osamp) {
+		// Stereo input in its original order can be read straight into place
+		if (stereo && !reverseStereo) {
+			assert(input.isStereo());
+			const int len = input.readBuffer(obuf, osamp * 2);
+			return (len > 0) ? len / 2 : 0;
+		}
+
+		return process<false>(input, obuf, osamp, 0, 0);
+	}
+
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
 		return ST_SUCCESS;
 	}
 };
 
 
+#pragma mark -
+
+
+/**
+ * Audio rate converter based on a polyphase windowed-sinc FIR filter.
+ *
+ * The conversion ratio is reduced to L/M, with L being the number of
+ * filter phases. Every output sample is the inner product of the most
+ * recent input samples with the coefficients of one phase, after which the
+ * phase advances by M. The coefficients of all phases are computed once
+ * when the converter is created, and the inner products use the fastest
+ * SIMD kernel the CPU supports.
+ *
+ * This is considerably slower than linear interpolation when done per
+ * sample in plain C, but avoids its aliasing and high frequency damping.
+ */
+template<bool stereo, bool reverseStereo>
+class PolyphaseRateConverter : public RateConverter {
+public:
+	enum {
+		/** Filter taps per phase when upsampling. */
+		kBaseTaps = 16,
+		/** Upper bound for the taps per phase when downsampling. */
+		kMaxTaps = 64,
+		/** Upper bound for the number of phases (i.e. L). */
+		kMaxPhases = 1024,
+		/** Fixed point precision of the coefficients. */
+		kCoefBits = 14
+	};
+
+	/**
+	 * Whether a converter for these rates can be built with a reasonably
+	 * sized coefficient table.
+	 */
+	static bool isSupported(st_rate_t inrate, st_rate_t outrate) {
+		return (outrate / Common::gcd(inrate, outrate)) <= kMaxPhases;
+	}
+
+protected:
+	st_sample_t inBuf[INTERMEDIATE_BUFFER_SIZE];
+
+	/** number of filter phases (L) */
+	uint _phases;
+	/** phase increment per output sample (M) */
+	uint _step;
+	/** filter taps per phase, a multiple of 16 */
+	uint _taps;
+	/** current filter phase */
+	uint _phase;
+
+	/** _phases * _taps coefficients, each phase in reverse order */
+	Common::Array<int16> _coefs;
+
+	/** input history per channel, oldest sample first */
+	Common::Array<int16> _history[2];
+	/** number of valid samples in the history */
+	uint _historyLen;
+	/** history index of the oldest sample of the filter window */
+	uint _pos;
+	/** samples of silence still to append after the end of the stream */
+	uint _tailLen;
+
+	DotProductProc _dotProduct;
+
+	void computeCoefficients();
+	bool refill(AudioStream &input);
+
+	template<bool mix>
+	int process(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r);
+
+public:
+	PolyphaseRateConverter(st_rate_t inrate, st_rate_t outrate);
+	int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+		return process<true>(input, obuf, osamp, vol_l, vol_r);
+	}
+	int convert(AudioStream &input, st_sample_t *obuf, st_size_t osamp) {
+		return process<false>(input, obuf, osamp, 0, 0);
+	}
+	int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) {
+		return ST_SUCCESS;
+	}
+	bool hasPendingOutput() const {
+		return _tailLen > 0 || _pos + _taps <= _historyLen;
+	}
+};
+
+/**
+ * Zeroth order modified Bessel function of the first kind, used for the
+ * Kaiser window.
+ */
+static double besselI0(double x) {
+	double sum = 1.0, term = 1.0;
+	for (int k = 1; k < 32; ++k) {
+		term *= (x / (2 * k)) * (x / (2 * k));
+		sum += term;
+		if (term < sum * 1e-12)
+			break;
+	}
+	return sum;
+}
+
+/*
+ * Prepare processing.
+ */
+template<bool stereo, bool reverseStereo>
+PolyphaseRateConverter<stereo, reverseStereo>::PolyphaseRateConverter(st_rate_t inrate, st_rate_t outrate) {
+	const st_rate_t divisor = Common::gcd(inrate, outrate);
+	_phases = outrate / divisor;
+	_step = inrate / divisor;
+	assert(_phases <= kMaxPhases);
+
+	// When downsampling, the cutoff frequency drops below the input
+	// Nyquist frequency, so more taps are needed for the same transition
+	// band width.
+	_taps = kBaseTaps;
+	if (_step > _phases)
+		_taps = MIN<uint>((kBaseTaps * _step + _phases - 1) / _phases, kMaxTaps);
+	_taps = (_taps + 15) & ~15;
+
+	computeCoefficients();
+
+	// Pre-fill half a window of silence, which centers the filter on the
+	// first input sample.
+	_pos = 0;
+	_phase = 0;
+	_historyLen = _taps / 2;
+	_tailLen = _taps / 2;
+	for (int i = 0; i < (stereo ? 2 : 1); ++i) {
+		_history[i].resize(_taps + INTERMEDIATE_BUFFER_SIZE);
+		memset(_history[i].begin(), 0, _historyLen * sizeof(int16));
+	}
+
+	_dotProduct = getDotProductProc();
+}
+
+template<bool stereo, bool reverseStereo>
+void PolyphaseRateConverter<stereo, reverseStereo>::computeCoefficients() {
+	// Cutoff relative to the input Nyquist frequency, slightly below the
+	// lower of both Nyquist frequencies to leave room for the transition band.
+	const double cutoff = 0.92 * MIN<double>(1.0, (double)_phases / _step);
+	const double beta = 8.0;
+	const double length = _phases * _taps;
+	const double center = (length - 1) / 2.0;
+
+	_coefs.resize(_phases * _taps);
+
+	Common::Array<double> phase;
+	phase.resize(_taps);
+
+	for (uint p = 0; p < _phases; ++p) {
+		double sum = 0.0;
+		for (uint m = 0; m < _taps; ++m) {
+			// Tap m of phase p is sample p + m * L of the prototype filter,
+			// which runs at L times the input rate.
+			const double t = (p + m * _phases - center) / _phases;
+			const double x = M_PI * cutoff * t;
+			const double sinc = (fabs(x) < 1e-9) ? 1.0 : sin(x) / x;
+			const double w = (p + m * _phases - center) / (center + 1);
+			const double window = besselI0(beta * sqrt(MAX(0.0, 1.0 - w * w))) / besselI0(beta);
+
+			phase[m] = sinc * window;
+			sum += phase[m];
+		}
+
+		// Normalize every phase to unity gain, and make sure the rounded
+		// coefficients still add up exactly to 1.0 by correcting the
+		// largest one.
+		int16 *coefs = &_coefs[p * _taps];
+		int total = 0;
+		uint largest = 0;
+		for (uint m = 0; m < _taps; ++m) {
+			// Store the phase reversed, so it lines up with the history
+			const uint i = _taps - 1 - m;
+			coefs[i] = (int16)floor(phase[m] / sum * (1 << kCoefBits) + 0.5);
+			total += coefs[i];
+			if (ABS(coefs[i]) > ABS(coefs[largest]))
+				largest = i;
+		}
+		coefs[largest] += (1 << kCoefBits) - total;
+	}
+}
+
+/*
+ * Discard the history which is no longer needed and append new input, or
+ * the silence which flushes the filter at the end of the stream.
+ * Returns false when the input stream has no more data.
+ */
+template<bool stereo, bool reverseStereo>
+bool PolyphaseRateConverter<stereo, reverseStereo>::refill(AudioStream &input) {
+	if (_pos < _historyLen) {
+		const uint keep = _historyLen - _pos;
+		for (int i = 0; i < (stereo ? 2 : 1); ++i)
+			memmove(_history[i].begin(), _history[i].begin() + _pos, keep * sizeof(int16));
+		_historyLen = keep;
+		_pos = 0;
+	} else {
+		// When downsampling by a large factor, the filter window can
+		// advance past the end of the history. Skip those samples of the
+		// next input.
+		_pos -= _historyLen;
+		_historyLen = 0;
+	}
+
+	int numSamples = MIN<uint>(_history[0].size() - _historyLen, ARRAYSIZE(inBuf) / 2);
+	if (stereo)
+		numSamples *= 2;
+
+	const int inLen = input.readBuffer(inBuf, numSamples);
+	if (inLen <= 0) {
+		if (_tailLen == 0 || !input.endOfStream())
+			return false;
+
+		// Append half a window of silence, which centers the filter on
+		// the last input samples
+		const uint len = MIN<uint>(_tailLen, _history[0].size() - _historyLen);
+		for (int i = 0; i < (stereo ? 2 : 1); ++i)
+			memset(_history[i].begin() + _historyLen, 0, len * sizeof(int16));
+		_historyLen += len;
+		_tailLen -= len;
+		return true;
+	}
+
+	if (stereo) {
+		int16 *left = _history[0].begin() + _historyLen;
+		int16 *right = _history[1].begin() + _historyLen;
+		for (int i = 0; i < inLen; i += 2) {
+			*left++ = inBuf[i];
+			*right++ = inBuf[i + 1];
+		}
+		_historyLen += inLen / 2;
+	} else {
+		memcpy(_history[0].begin() + _historyLen, inBuf, inLen * sizeof(int16));
+		_historyLen += inLen;
+	}
+
+	return true;
+}
+
+/*
+ * Processed signed long samples from ibuf to obuf.
+ * Return number of sample pairs processed.
+ */
+template<bool stereo, bool reverseStereo>
+template<bool mix>
+int PolyphaseRateConverter<stereo, reverseStereo>::process(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) {
+	st_sample_t *ostart, *oend;
+
+	ostart = obuf;
+	oend = obuf + osamp * 2;
+
+	while (obuf < oend) {
+		// read enough input samples to fill the filter window
+		while (_pos + _taps > _historyLen) {
+			if (!refill(input))
+				return (obuf - ostart) / 2;
+		}
+
+		const int16 *coefs = &_coefs[_phase * _taps];
+
+		st_sample_t out0, out1;
+		int32 acc = _dotProduct(_history[0].begin() + _pos, coefs, _taps);
+		out0 = (st_sample_t)CLIP<int32>((acc + (1 << (kCoefBits - 1))) >> kCoefBits, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+		if (stereo) {
+			acc = _dotProduct(_history[1].begin() + _pos, coefs, _taps);
+			out1 = (st_sample_t)CLIP<int32>((acc + (1 << (kCoefBits - 1))) >> kCoefBits, ST_SAMPLE_MIN, ST_SAMPLE_MAX);
+		} else {
+			out1 = out0;
+		}
+
+		outputSamples<mix, reverseStereo>(obuf, out0, out1, vol_l, vol_r);
+		obuf += 2;
+
+		// Increment output position
+		_phase += _step;
+		while (_phase >= _phases) {
+			_phase -= _phases;
+			_pos++;
+		}
+	}
+	return (obuf - ostart) / 2;
+}
+
+
 #pragma mark -
 
 template<bool stereo, bool reverseStereo>
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, ResamplerType type) {
 	if (inrate != outrate) {
-		if ((inrate % outrate) == 0 && (inrate < 65536)) {
+		if (type == kResamplerSinc && PolyphaseRateConverter<stereo, reverseStereo>::isSupported(inrate, outrate)) {
+			return new PolyphaseRateConverter<stereo, reverseStereo>(inrate, outrate);
+		} else if ((inrate % outrate) == 0 && (inrate < 65536)) {
 			return new SimpleRateConverter<stereo, reverseStereo>(inrate, outrate);
 		} else {
 			return new LinearRateConverter<stereo, reverseStereo>(inrate, outrate);
@@ -355,15 +682,18 @@ RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate) {
 
 /**
  * Create and return a RateConverter object for the specified input and output rates.
+ *
+ * The sinc resampler falls back to linear interpolation for rates whose
+ * ratio would need an excessively large coefficient table.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, ResamplerType type) {
 	if (stereo) {
 		if (reverseStereo)
-			return makeRateConverter<true, true>(inrate, outrate);
+			return makeRateConverter<true, true>(inrate, outrate, type);
 		else
-			return makeRateConverter<true, false>(inrate, outrate);
+			return makeRateConverter<true, false>(inrate, outrate, type);
 	} else
-		return makeRateConverter<false, false>(inrate, outrate);
+		return makeRateConverter<false, false>(inrate, outrate, type);
 }
 
 } // End of namespace Audio
@@ -24,6 +24,7 @@
 #define AUDIO_RATE_H
 
 #include "common/scummsys.h"
+#include "audio/mixer.h"
 
 namespace Audio {
 /**
@@ -82,10 +83,57 @@ public:
 	 */
 	virtual int flow(AudioStream &input, st_sample_t *obuf, st_size_t osamp, st_volume_t vol_l, st_volume_t vol_r) = 0;
 
+	/**
+	 * Resample the input into the buffer without applying any volume.
+	 *
+	 * Unlike flow(), this overwrites the buffer contents instead of mixing
+	 * into them, which leaves scaling and accumulation to the caller. The
+	 * sample pairs are stored in the same (possibly reversed) order flow()
+	 * would mix them in.
+	 *
+	 * @return Number of sample pairs written into the buffer.
+	 */
+	virtual int convert(AudioStream &input, st_sample_t *obuf, st_size_t osamp) {
+		// A full volume sample added onto silence can never clip. flow()
+		// mixes into samples stored the same way as the output, so silence
+		// is not zero with unsigned output.
+#ifdef OUTPUT_UNSIGNED_AUDIO
+		for (st_size_t i = 0; i < osamp * 2; i++)
+			obuf[i] = (st_sample_t)0x8000;
+#else
+		memset(obuf, 0, osamp * 2 * sizeof(st_sample_t));
+#endif
+
+		int written = flow(input, obuf, osamp, Mixer::kMaxMixerVolume, Mixer::kMaxMixerVolume);
+
+#ifdef OUTPUT_UNSIGNED_AUDIO
+		// The samples written by convert() are always signed
+		for (int i = 0; i < written * 2; i++)
+			obuf[i] ^= 0x8000;
+#endif
+		return written;
+	}
+
 	virtual int drain(st_sample_t *obuf, st_size_t osamp, st_volume_t vol) = 0;
+
+	/**
+	 * Whether the converter still holds output for input it has already
+	 * read, which convert() and flow() return after the end of the stream.
+	 */
+	virtual bool hasPendingOutput() const { return false; }
+};
+
+/**
+ * The interpolation used when the input and output rates differ.
+ */
+enum ResamplerType {
+	/** Drop samples or interpolate linearly. Fast, but prone to aliasing. */
+	kResamplerLinear,
+	/** Polyphase windowed-sinc filter, for high quality output. */
+	kResamplerSinc
 };
 
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false);
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo = false, ResamplerType type = kResamplerLinear);
 /** @} */
 } // End of namespace Audio
 
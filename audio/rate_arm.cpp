@@ -446,8 +446,11 @@ public:
 
 /**
  * Create and return a RateConverter object for the specified input and output rates.
+ *
+ * The ARM assembly converters only implement linear interpolation, so the
+ * resampler type is ignored.
  */
-RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo) {
+RateConverter *makeRateConverter(st_rate_t inrate, st_rate_t outrate, bool stereo, bool reverseStereo, ResamplerType type) {
 	if (inrate != outrate) {
 		if ((inrate % outrate) == 0 && (inrate < 65536)) {
 			if (stereo) {
@@ -0,0 +1,320 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+#include "audio/samplecache.h"
+#include "audio/audiostream.h"
+#include "audio/timestamp.h"
+
+#include "common/array.h"
+#include "common/atomic.h"
+#include "common/hash-str.h"
+#include "common/system.h"
+#include "common/timer.h"
+
+namespace Audio {
+
+enum {
+	/** Number of samples decoded at once. */
+	kDecodeChunkSamples = 2048,
+	/** Number of samples decoded per timer callback. */
+	kSliceSamples = 8192,
+	/** Interval of the background decoding timer, in microseconds. */
+	kTimerInterval = 10000
+};
+
+/**
+ * Decoded samples of a sound, shared between the cache and the streams
+ * replaying it. The reference count is atomic, as the streams are deleted
+ * on whatever thread stops them.
+ */
+struct CachedSound {
+	CachedSound(int rate_, bool stereo_) : rate(rate_), stereo(stereo_), refCount(1) {}
+
+	void incRef() { refCount.fetchAdd(1); }
+	void decRef() {
+		if (refCount.fetchSub(1) == 1)
+			delete this;
+	}
+
+	uint32 getSize() const { return samples.size() * sizeof(int16); }
+
+	Common::Array<int16> samples;
+	const int rate;
+	const bool stereo;
+	Common::Atomic<int> refCount;
+};
+
+/**
+ * Stream replaying the samples of a cached sound.
+ */
+class CachedSoundStream : public SeekableAudioStream {
+public:
+	CachedSoundStream(CachedSound *sound) : _sound(sound), _pos(0) {
+		_sound->incRef();
+	}
+
+	~CachedSoundStream() {
+		_sound->decRef();
+	}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		// Rate converters keep reading once the stream has ended
+		if (_pos >= _sound->samples.size())
+			return 0;
+
+		const int samples = MIN<int>(numSamples, _sound->samples.size() - _pos);
+		memcpy(buffer, &_sound->samples[_pos], samples * sizeof(int16));
+		_pos += samples;
+		return samples;
+	}
+
+	bool isStereo() const { return _sound->stereo; }
+	int getRate() const { return _sound->rate; }
+	bool endOfData() const { return _pos >= _sound->samples.size(); }
+
+	bool seek(const Timestamp &where) {
+		const uint32 frame = where.convertToFramerate(_sound->rate).totalNumberOfFrames();
+		_pos = frame * (_sound->stereo ? 2 : 1);
+		if (_pos > _sound->samples.size()) {
+			_pos = _sound->samples.size();
+			return false;
+		}
+		return true;
+	}
+
+	Timestamp getLength() const {
+		return Timestamp(0, _sound->samples.size() / (_sound->stereo ? 2 : 1), _sound->rate);
+	}
+
+private:
+	CachedSound *_sound;
+	uint _pos;
+};
+
+uint SampleCache::KeyHash::operator()(const Key &key) const {
+	return Common::hashit(key.member.c_str()) * 31 + key.offset;
+}
+
+SampleCache::SampleCache(uint32 budget) : _budget(budget), _size(0), _timerInstalled(false) {
+}
+
+SampleCache::~SampleCache() {
+	// This also removes the timer. Once removed, the timer callback is
+	// guaranteed to not run anymore.
+	clear();
+}
+
+bool SampleCache::decode(AudioStream &decoder, CachedSound &sound, uint maxSamples) {
+	int16 buffer[kDecodeChunkSamples];
+
+	for (uint decoded = 0; decoded < maxSamples; decoded += kDecodeChunkSamples) {
+		if (decoder.endOfData())
+			return true;
+
+		const int samples = decoder.readBuffer(buffer, kDecodeChunkSamples);
+		if (samples <= 0)
+			return true;
+
+		const uint size = sound.samples.size();
+		sound.samples.resize(size + samples);
+		memcpy(&sound.samples[size], buffer, samples * sizeof(int16));
+	}
+
+	return decoder.endOfData();
+}
+
+SeekableAudioStream *SampleCache::getStream(const Key &key) {
+	SeekableAudioStream *stream = nullptr;
+
+	{
+		Common::StackLock lock(_mutex);
+
+		// Do not wait for the timer to get to queued sounds
+		JobList::iterator job = findJob(key);
+		if (job != _jobs.end()) {
+			while (!decode(*job->decoder, *job->sound, kSliceSamples))
+				;
+			finishJob(job);
+		}
+
+		SoundMap::iterator i = _sounds.find(key);
+		if (i != _sounds.end()) {
+			// Move the sound to the front of the LRU list
+			const Entry entry = *i->_value;
+			_lru.erase(i->_value);
+			_lru.push_front(entry);
+			i->_value = _lru.begin();
+
+			stream = new CachedSoundStream(entry.sound);
+		}
+	}
+
+	stopIdleTimer();
+	return stream;
+}
+
+SeekableAudioStream *SampleCache::addStream(const Key &key, AudioStream *decoder) {
+	assert(decoder);
+
+	CachedSound *sound = new CachedSound(decoder->getRate(), decoder->isStereo());
+	while (!decode(*decoder, *sound, kSliceSamples))
+		;
+	delete decoder;
+
+	if (sound->samples.empty()) {
+		sound->decRef();
+		return nullptr;
+	}
+
+	SeekableAudioStream *stream = new CachedSoundStream(sound);
+
+	Common::StackLock lock(_mutex);
+	insert(key, sound);
+	return stream;
+}
+
+void SampleCache::prefetch(const Key &key, AudioStream *decoder) {
+	assert(decoder);
+
+	Common::StackLock lock(_mutex);
+
+	if (_sounds.contains(key) || findJob(key) != _jobs.end()) {
+		delete decoder;
+		return;
+	}
+
+	_jobs.push_back(Job(key, decoder, new CachedSound(decoder->getRate(), decoder->isStereo())));
+
+	// Without a timer, queued sounds are only decoded when requested
+	if (!_timerInstalled && g_system->getTimerManager())
+		_timerInstalled = g_system->getTimerManager()->installTimerProc(&timerProc, kTimerInterval, this, "SampleCache");
+}
+
+bool SampleCache::isCached(const Key &key) {
+	Common::StackLock lock(_mutex);
+	return _sounds.contains(key);
+}
+
+void SampleCache::setBudget(uint32 budget) {
+	Common::StackLock lock(_mutex);
+	_budget = budget;
+	evict();
+}
+
+void SampleCache::clear() {
+	{
+		Common::StackLock lock(_mutex);
+
+		for (JobList::iterator i = _jobs.begin(); i != _jobs.end(); ++i) {
+			delete i->decoder;
+			i->sound->decRef();
+		}
+		_jobs.clear();
+
+		for (LRUList::iterator i = _lru.begin(); i != _lru.end(); ++i)
+			i->sound->decRef();
+		_lru.clear();
+		_sounds.clear();
+		_size = 0;
+	}
+
+	stopIdleTimer();
+}
+
+void SampleCache::insert(const Key &key, CachedSound *sound) {
+	// Sounds which do not fit are handed out uncached
+	if (sound->getSize() > _budget) {
+		sound->decRef();
+		return;
+	}
+
+	// Another thread may have decoded the same sound meanwhile
+	SoundMap::iterator i = _sounds.find(key);
+	if (i != _sounds.end()) {
+		_size -= i->_value->sound->getSize();
+		i->_value->sound->decRef();
+		_lru.erase(i->_value);
+	}
+
+	_lru.push_front(Entry(key, sound));
+	_sounds[key] = _lru.begin();
+	_size += sound->getSize();
+
+	evict();
+}
+
+void SampleCache::evict() {
+	while (_size > _budget && !_lru.empty()) {
+		const Entry &entry = _lru.back();
+		_sounds.erase(entry.key);
+		_size -= entry.sound->getSize();
+		entry.sound->decRef();
+		_lru.pop_back();
+	}
+}
+
+SampleCache::JobList::iterator SampleCache::findJob(const Key &key) {
+	JobList::iterator i;
+	for (i = _jobs.begin(); i != _jobs.end(); ++i) {
+		if (i->key == key)
+			break;
+	}
+	return i;
+}
+
+void SampleCache::finishJob(JobList::iterator job) {
+	delete job->decoder;
+	if (job->sound->samples.empty())
+		job->sound->decRef();
+	else
+		insert(job->key, job->sound);
+	_jobs.erase(job);
+}
+
+void SampleCache::stopIdleTimer() {
+	{
+		Common::StackLock lock(_mutex);
+		if (!_timerInstalled || !_jobs.empty())
+			return;
+		_timerInstalled = false;
+	}
+
+	// Not under the lock: the timer manager holds its own lock while the
+	// callback waits for ours
+	g_system->getTimerManager()->removeTimerProc(&timerProc);
+}
+
+void SampleCache::timerProc(void *refCon) {
+	((SampleCache *)refCon)->decodeSlice();
+}
+
+void SampleCache::decodeSlice() {
+	Common::StackLock lock(_mutex);
+
+	if (_jobs.empty())
+		return;
+
+	JobList::iterator job = _jobs.begin();
+	if (decode(*job->decoder, *job->sound, kSliceSamples))
+		finishJob(job);
+}
+
+} // End of namespace Audio
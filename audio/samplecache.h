@@ -0,0 +1,194 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+#ifndef AUDIO_SAMPLECACHE_H
+#define AUDIO_SAMPLECACHE_H
+
+#include "common/scummsys.h"
+#include "common/hashmap.h"
+#include "common/list.h"
+#include "common/mutex.h"
+#include "common/str.h"
+
+namespace Audio {
+
+/**
+ * @defgroup audio_samplecache Sample cache
+ * @ingroup audio
+ *
+ * @brief Cache for decoded compressed sounds.
+ * @{
+ */
+
+class AudioStream;
+class SeekableAudioStream;
+struct CachedSound;
+
+/**
+ * Cache of completely decoded sounds.
+ *
+ * Compressed sounds which are played over and over again, like short sound
+ * effects, only need to be decoded once. The cache keeps their samples
+ * until its byte budget is exceeded, and then evicts the least recently
+ * used sounds first. Streams returned by the cache replay the decoded
+ * samples and keep them alive on their own, so evicting a sound which is
+ * still playing is safe.
+ *
+ * Sounds can also be queued for decoding ahead of time. They are decoded
+ * in small slices from a timer callback, i.e. in the background on
+ * backends with a timer thread. The timer is removed again when the cache
+ * is used or cleared while no sound is queued.
+ */
+class SampleCache {
+public:
+	/**
+	 * Identifies a sound by the archive member it is stored in and its
+	 * offset in that member.
+	 */
+	struct Key {
+		Key(const Common::String &member_, uint32 offset_) : member(member_), offset(offset_) {}
+
+		bool operator==(const Key &other) const {
+			return offset == other.offset && member == other.member;
+		}
+
+		Common::String member;
+		uint32 offset;
+	};
+
+	enum {
+		kDefaultBudget = 16 * 1024 * 1024
+	};
+
+	/**
+	 * @param budget Maximum number of bytes of decoded samples to keep.
+	 */
+	explicit SampleCache(uint32 budget = kDefaultBudget);
+	~SampleCache();
+
+	/**
+	 * Return a stream replaying a cached sound. A sound which is still
+	 * queued for background decoding is decoded completely first.
+	 *
+	 * @return The stream, or nullptr if the sound is not in the cache.
+	 */
+	SeekableAudioStream *getStream(const Key &key);
+
+	/**
+	 * Decode a sound completely and add it to the cache.
+	 *
+	 * Sounds larger than the budget are not cached, but a stream for them
+	 * is still returned.
+	 *
+	 * @param key     Key of the sound.
+	 * @param decoder Stream decoding the sound. Must end at some point, and
+	 *                is deleted by the cache.
+	 * @return A stream replaying the decoded sound, or nullptr if the
+	 *         decoder did not produce any samples.
+	 */
+	SeekableAudioStream *addStream(const Key &key, AudioStream *decoder);
+
+	/**
+	 * Queue a sound for decoding in the background. Nothing happens if the
+	 * sound is cached or queued already.
+	 *
+	 * @param key     Key of the sound.
+	 * @param decoder Stream decoding the sound. Must end at some point, and
+	 *                is deleted by the cache.
+	 */
+	void prefetch(const Key &key, AudioStream *decoder);
+
+	/**
+	 * Check whether a sound is cached. Queued sounds do not count.
+	 */
+	bool isCached(const Key &key);
+
+	/**
+	 * Change the budget, evicting sounds if necessary.
+	 */
+	void setBudget(uint32 budget);
+
+	/**
+	 * Return the number of bytes used by the cached sounds.
+	 */
+	uint32 getSize() const { return _size; }
+
+	/**
+	 * Remove all sounds from the cache, and drop all queued sounds.
+	 */
+	void clear();
+
+private:
+	struct KeyHash {
+		uint operator()(const Key &key) const;
+	};
+
+	struct Job {
+		Job(const Key &key_, AudioStream *decoder_, CachedSound *sound_) : key(key_), decoder(decoder_), sound(sound_) {}
+
+		Key key;
+		AudioStream *decoder;
+		CachedSound *sound;
+	};
+
+	struct Entry {
+		Entry(const Key &key_, CachedSound *sound_) : key(key_), sound(sound_) {}
+
+		Key key;
+		CachedSound *sound;
+	};
+
+	typedef Common::List<Entry> LRUList;
+	typedef Common::HashMap<Key, LRUList::iterator, KeyHash> SoundMap;
+	typedef Common::List<Job> JobList;
+
+	/** Decode up to the given number of samples. Returns true once the decoder ended. */
+	static bool decode(AudioStream &decoder, CachedSound &sound, uint maxSamples);
+
+	void insert(const Key &key, CachedSound *sound);
+	void evict();
+	JobList::iterator findJob(const Key &key);
+	/** Cache the sound of a decoded job, and remove the job. */
+	void finishJob(JobList::iterator job);
+
+	/** Remove the timer once no sound is queued anymore. */
+	void stopIdleTimer();
+	static void timerProc(void *refCon);
+	void decodeSlice();
+
+	Common::Mutex _mutex;
+
+	uint32 _budget;
+	uint32 _size;
+
+	/** Cached sounds, most recently used first. */
+	LRUList _lru;
+	SoundMap _sounds;
+
+	/** Sounds queued for background decoding. */
+	JobList _jobs;
+	bool _timerInstalled;
+};
+
+/** @} */
+} // End of namespace Audio
+
+#endif
@@ -198,6 +198,17 @@ public:
 	* @return true if the directory is created successfully
 	*/
 	virtual bool createDirectory() = 0;
+
+	/**
+	 * Retrieves the size of the file referred by this node and the time of
+	 * its last modification, in seconds since the Unix epoch.
+	 *
+	 * The default implementation is for filesystems which cannot provide
+	 * this information.
+	 *
+	 * @return true if the attributes were retrieved, false otherwise.
+	 */
+	virtual bool getFileAttributes(int64 &size, uint32 &modificationTime) const { return false; }
 };
 
 
@@ -104,6 +104,10 @@ bool ChRootFilesystemNode::createDirectory() {
 	return _realNode->createDirectory();
 }
 
+bool ChRootFilesystemNode::getFileAttributes(int64 &size, uint32 &modificationTime) const {
+	return _realNode->getFileAttributes(size, modificationTime);
+}
+
 Common::String ChRootFilesystemNode::addPathComponent(const Common::String &path, const Common::String &component) {
 	const char sep = '/';
 	if (path.lastChar() == sep && component.firstChar() == sep) {
@@ -50,6 +50,7 @@ public:
 	virtual Common::SeekableReadStream *createReadStream();
 	virtual Common::WriteStream *createWriteStream();
 	virtual bool createDirectory();
+	virtual bool getFileAttributes(int64 &size, uint32 &modificationTime) const;
 
 private:
 	static Common::String addPathComponent(const Common::String &path, const Common::String &component);
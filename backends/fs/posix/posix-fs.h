@@ -69,6 +69,7 @@ public:
 	virtual Common::SeekableReadStream *createReadStream();
 	virtual Common::WriteStream *createWriteStream();
 	virtual bool createDirectory();
+	virtual bool getFileAttributes(int64 &size, uint32 &modificationTime) const;
 
 protected:
 	/**
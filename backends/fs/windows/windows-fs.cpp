@@ -245,4 +245,19 @@ bool WindowsFilesystemNode::createDirectory() {
 	return _isValid && _isDirectory;
 }
 
+bool WindowsFilesystemNode::getFileAttributes(int64 &size, uint32 &modificationTime) const {
+	WIN32_FILE_ATTRIBUTE_DATA data;
+
+	if (!GetFileAttributesEx(toUnicode(_path.c_str()), GetFileExInfoStandard, &data) ||
+	    (data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) != 0)
+		return false;
+
+	size = ((int64)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+
+	// FILETIME counts 100 nanosecond intervals since January 1, 1601
+	const uint64 fileTime = ((uint64)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+	modificationTime = (uint32)((fileTime - 116444736000000000ULL) / 10000000);
+	return true;
+}
+
 #endif //#ifdef WIN32
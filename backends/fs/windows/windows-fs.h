@@ -81,6 +81,7 @@ public:
 	virtual Common::SeekableReadStream *createReadStream() override;
 	virtual Common::WriteStream *createWriteStream() override;
 	virtual bool createDirectory() override;
+	virtual bool getFileAttributes(int64 &size, uint32 &modificationTime) const override;
 
 private:
 	/**
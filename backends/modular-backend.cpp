@@ -45,6 +45,9 @@ ModularGraphicsBackend::~ModularGraphicsBackend() {
 }
 
 bool ModularGraphicsBackend::hasFeature(Feature f) {
+	// The CPU features are detected independently of the graphics manager
+	if (BaseBackend::hasFeature(f))
+		return true;
 	return _graphicsManager->hasFeature(f);
 }
 
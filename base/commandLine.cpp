@@ -27,6 +27,7 @@
 
 #include <limits.h>
 
+#include "engines/detectioncache.h"
 #include "engines/metaengine.h"
 #include "base/commandLine.h"
 #include "base/plugins.h"
@@ -84,6 +85,9 @@ static const char HELP_STRING[] =
 	"  --auto-detect            Display a list of games from current or specified directory\n"
 	"                           and start the first one. Use --path=PATH to specify a directory.\n"
 	"  --recursive              In combination with --add or --detect recurse down all subdirectories\n"
+	"  --rebuild-detection-cache\n"
+	"                           Compute again the checksums of the game files\n"
+	"                           remembered by previous detections\n"
 #if defined(WIN32) && !defined(__SYMBIAN32__)
 	"  --console                Enable the console window (default:enabled)\n"
 #endif
@@ -251,6 +255,7 @@ void registerDefaults() {
 	ConfMan.registerDefault("sfx_mute", false);
 	ConfMan.registerDefault("speech_mute", false);
 	ConfMan.registerDefault("mute", false);
+	ConfMan.registerDefault("resampler", "linear");
 
 	ConfMan.registerDefault("multi_midi", false);
 	ConfMan.registerDefault("native_mt32", false);
@@ -752,6 +757,9 @@ Common::String parseCommandLine(Common::StringMap &settings, int argc, const cha
 			DO_LONG_OPTION_BOOL("recursive")
 			END_OPTION
 
+			DO_LONG_OPTION_BOOL("rebuild-detection-cache")
+			END_OPTION
+
 			DO_LONG_OPTION("themepath")
 				Common::FSNode path(option);
 				if (!path.exists()) {
@@ -1057,12 +1065,23 @@ static DetectedGames recListGames(const Common::FSNode &dir, const Common::Strin
 	return list;
 }
 
+/** Save the detection cache and display how much it was used */
+static void flushDetectionCache() {
+	DetectionCacheMan.flush();
+	printf("Detection cache: %u hits, %u misses\n", DetectionCacheMan.getHits(), DetectionCacheMan.getMisses());
+}
+
 /** Display all games in the given directory, return ID of first detected game */
 static Common::String detectGames(const Common::String &path, const Common::String &engineId, const Common::String &gameId, bool recursive) {
 	bool noPath = path.empty();
 	//Current directory
 	Common::FSNode dir(path);
+	// A recursive scan uses the cache entries of all the files still present
+	if (recursive)
+		DetectionCacheMan.startScan();
 	DetectedGames candidates = recListGames(dir, engineId, gameId, recursive);
+	if (recursive)
+		DetectionCacheMan.finishScan(dir.getPath());
 
 	if (candidates.empty()) {
 		printf("WARNING: ScummVM could not find any game in %s\n", dir.getPath().c_str());
@@ -1130,7 +1149,11 @@ static int recAddGames(const Common::FSNode &dir, const Common::String &engineId
 static bool addGames(const Common::String &path, const Common::String &engineId, const Common::String &gameId, bool recursive) {
 	//Current directory
 	Common::FSNode dir(path);
+	if (recursive)
+		DetectionCacheMan.startScan();
 	int added = recAddGames(dir, engineId, gameId, recursive);
+	if (recursive)
+		DetectionCacheMan.finishScan(dir.getPath());
 	printf("Added %d games\n", added);
 	if (added == 0 && !recursive) {
 		printf("Consider using --recursive to search inside subdirectories\n");
@@ -1353,6 +1376,11 @@ bool processSettings(Common::String &command, Common::StringMap &settings, Commo
 		}
 	}
 
+	// Start from an empty detection cache, so that all the checksums are
+	// computed again
+	if (settings["rebuild-detection-cache"] == "true")
+		DetectionCacheMan.clear();
+
 	// Handle commands passed via the command line (like --list-targets and
 	// --list-games). This must be done after the config file and the plugins
 	// have been loaded.
@@ -1402,9 +1430,11 @@ bool processSettings(Common::String &command, Common::StringMap &settings, Commo
 		}
 	} else if (command == "detect") {
 		detectGames(settings["path"], gameOption.engineId, gameOption.gameId, settings["recursive"] == "true");
+		flushDetectionCache();
 		return true;
 	} else if (command == "add") {
 		addGames(settings["path"], gameOption.engineId, gameOption.gameId, settings["recursive"] == "true");
+		flushDetectionCache();
 		return true;
 	}
 #ifdef DETECTOR_TESTING_HACK
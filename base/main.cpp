@@ -31,6 +31,7 @@
 // FIXME: Avoid using printf
 #define FORBIDDEN_SYMBOL_EXCEPTION_printf
 
+#include "engines/detectioncache.h"
 #include "engines/engine.h"
 #include "engines/metaengine.h"
 #include "base/commandLine.h"
@@ -590,6 +591,9 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 				ttsMan->pushState();
 			}
 #endif
+			// Keep what the detection learnt, in case the game does not return
+			DetectionCacheMan.flush();
+
 			// Try to run the game
 			Common::Error result = runGame(plugin, system, specialDebug);
 
@@ -687,6 +691,8 @@ extern "C" int scummvm_main(int argc, const char * const argv[]) {
 	Cloud::CloudManager::destroy();
 #endif
 #endif
+	DetectionCacheMan.flush();
+	DetectionCache::destroy();
 	PluginManager::instance().unloadDetectionPlugin();
 	PluginManager::instance().unloadAllPlugins();
 	PluginManager::destroy();
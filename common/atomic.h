@@ -0,0 +1,206 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+#ifndef COMMON_ATOMIC_H
+#define COMMON_ATOMIC_H
+
+#include "common/scummsys.h"
+
+#ifndef NO_CXX11_ATOMIC
+#include <atomic>
+#else
+#include "common/mutex.h"
+#endif
+
+namespace Common {
+
+/**
+ * @defgroup common_atomic Atomic
+ * @ingroup common
+ *
+ * @brief Lock-free variables shared between threads.
+ *
+ * When the compiler does not provide std::atomic, the variables are
+ * protected by a mutex instead, so they are not lock-free anymore.
+ * @{
+ */
+
+#ifndef NO_CXX11_ATOMIC
+
+/**
+ * Wrapper around std::atomic for integral and pointer types.
+ *
+ * All operations are sequentially consistent, which is what lock-free code
+ * outside of the hottest loops should use. Use the relaxed variants only
+ * for values which carry no other data with them, like statistics counters.
+ */
+template<class T>
+class Atomic {
+public:
+	Atomic() : _value(T()) {}
+	explicit Atomic(T value) : _value(value) {}
+
+	T load() const { return _value.load(); }
+	void store(T value) { _value.store(value); }
+
+	T loadRelaxed() const { return _value.load(std::memory_order_relaxed); }
+	void storeRelaxed(T value) { _value.store(value, std::memory_order_relaxed); }
+
+	/** Set a new value and return the previous one. */
+	T exchange(T value) { return _value.exchange(value); }
+
+	/**
+	 * Set the value to @p desired if it equals @p expected. Otherwise,
+	 * @p expected is updated to the current value.
+	 *
+	 * @return Whether the value was changed.
+	 */
+	bool compareExchange(T &expected, T desired) { return _value.compare_exchange_strong(expected, desired); }
+
+	/** Add @p value and return the previous value. */
+	T fetchAdd(T value) { return _value.fetch_add(value); }
+	/** Subtract @p value and return the previous value. */
+	T fetchSub(T value) { return _value.fetch_sub(value); }
+
+private:
+	// Copying an atomic is not atomic
+	Atomic(const Atomic &);
+	Atomic &operator=(const Atomic &);
+
+	std::atomic<T> _value;
+};
+
+/**
+ * Specialization for pointers, which have no arithmetic operations here.
+ */
+template<class T>
+class Atomic<T *> {
+public:
+	Atomic() : _value(nullptr) {}
+	explicit Atomic(T *value) : _value(value) {}
+
+	T *load() const { return _value.load(); }
+	void store(T *value) { _value.store(value); }
+
+	T *exchange(T *value) { return _value.exchange(value); }
+	bool compareExchange(T *&expected, T *desired) { return _value.compare_exchange_strong(expected, desired); }
+
+private:
+	Atomic(const Atomic &);
+	Atomic &operator=(const Atomic &);
+
+	std::atomic<T *> _value;
+};
+
+#else
+
+template<class T>
+class Atomic {
+public:
+	Atomic() : _value(T()) {}
+	explicit Atomic(T value) : _value(value) {}
+
+	T load() const { StackLock lock(_mutex); return _value; }
+	void store(T value) { StackLock lock(_mutex); _value = value; }
+
+	T loadRelaxed() const { return load(); }
+	void storeRelaxed(T value) { store(value); }
+
+	T exchange(T value) {
+		StackLock lock(_mutex);
+		const T old = _value;
+		_value = value;
+		return old;
+	}
+
+	bool compareExchange(T &expected, T desired) {
+		StackLock lock(_mutex);
+		if (_value != expected) {
+			expected = _value;
+			return false;
+		}
+		_value = desired;
+		return true;
+	}
+
+	T fetchAdd(T value) {
+		StackLock lock(_mutex);
+		const T old = _value;
+		_value += value;
+		return old;
+	}
+
+	T fetchSub(T value) {
+		StackLock lock(_mutex);
+		const T old = _value;
+		_value -= value;
+		return old;
+	}
+
+private:
+	Atomic(const Atomic &);
+	Atomic &operator=(const Atomic &);
+
+	T _value;
+	Mutex _mutex;
+};
+
+template<class T>
+class Atomic<T *> {
+public:
+	Atomic() : _value(nullptr) {}
+	explicit Atomic(T *value) : _value(value) {}
+
+	T *load() const { StackLock lock(_mutex); return _value; }
+	void store(T *value) { StackLock lock(_mutex); _value = value; }
+
+	T *exchange(T *value) {
+		StackLock lock(_mutex);
+		T *old = _value;
+		_value = value;
+		return old;
+	}
+
+	bool compareExchange(T *&expected, T *desired) {
+		StackLock lock(_mutex);
+		if (_value != expected) {
+			expected = _value;
+			return false;
+		}
+		_value = desired;
+		return true;
+	}
+
+private:
+	Atomic(const Atomic &);
+	Atomic &operator=(const Atomic &);
+
+	T *_value;
+	Mutex _mutex;
+};
+
+#endif
+
+/** @} */
+
+} // End of namespace Common
+
+#endif
@@ -168,6 +168,10 @@ bool FSNode::createDirectory() const {
 	return _realNode->createDirectory();
 }
 
+bool FSNode::getFileAttributes(int64 &size, uint32 &modificationTime) const {
+	return _realNode && _realNode->getFileAttributes(size, modificationTime);
+}
+
 FSDirectory::FSDirectory(const FSNode &node, int depth, bool flat, bool ignoreClashes, bool includeDirectories)
   : _node(node), _cached(false), _depth(depth), _flat(flat), _ignoreClashes(ignoreClashes),
 	_includeDirectories(includeDirectories) {
@@ -248,6 +248,15 @@ public:
 	 * @return True if the directory was created, false otherwise.
 	 */
 	bool createDirectory() const;
+
+	/**
+	 * Retrieve the size of the file referred by this node and the time of
+	 * its last modification, in seconds since the Unix epoch. Not all
+	 * filesystems provide this information.
+	 *
+	 * @return True if the attributes were retrieved, false otherwise.
+	 */
+	bool getFileAttributes(int64 &size, uint32 &modificationTime) const;
 };
 
 /**
@@ -220,6 +220,13 @@ public:
 	};
 	static MacVers *parseVers(SeekableReadStream *vvers);
 
+	/**
+	 * Construct the name of the AppleDouble file holding the resource fork
+	 * of the given file, i.e. the name with "._" inserted before its last
+	 * path component.
+	 */
+	static String constructAppleDoubleName(String name);
+
 private:
 	SeekableReadStream *_stream;
 	String _baseFileName;
@@ -229,7 +236,6 @@ private:
 	bool loadFromRawFork(SeekableReadStream &stream);
 	bool loadFromAppleDouble(SeekableReadStream &stream);
 
-	static String constructAppleDoubleName(String name);
 	static String disassembleAppleDoubleName(String name, bool *isAppleDouble);
 
 	/**
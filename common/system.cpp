@@ -123,6 +123,40 @@ void OSystem::destroy() {
 	delete this;
 }
 
+bool OSystem::hasFeature(Feature f) {
+	switch (f) {
+#ifdef SCUMMVM_SSE2
+	case kFeatureCpuSSE2:
+#if defined(__x86_64__) || defined(_M_X64)
+		// SSE2 is part of the x86-64 baseline
+		return true;
+#elif defined(__GNUC__) && (defined(__i386__) || defined(_M_IX86))
+		return __builtin_cpu_supports("sse2");
+#else
+		return false;
+#endif
+#endif
+
+#ifdef SCUMMVM_AVX2
+	case kFeatureCpuAVX2:
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+		return __builtin_cpu_supports("avx2");
+#else
+		return false;
+#endif
+#endif
+
+#ifdef SCUMMVM_NEON
+	case kFeatureCpuNEON:
+		// configure only enables NEON when the compiler targets it by default
+		return true;
+#endif
+
+	default:
+		return false;
+	}
+}
+
 bool OSystem::setGraphicsMode(const char *name) {
 	if (!name)
 		return false;
@@ -499,13 +499,35 @@ public:
 		/**
 		* For platforms that should not have a Quit button.
 		*/
-		kFeatureNoQuit
+		kFeatureNoQuit,
+
+		/**
+		* The host CPU supports the x86 SSE2 instruction set extension.
+		*
+		* The CPU features are detected at runtime and only reported
+		* when the matching code paths were compiled in (see the
+		* SCUMMVM_SSE2, SCUMMVM_AVX2 and SCUMMVM_NEON defines).
+		* They have no associated state.
+		*/
+		kFeatureCpuSSE2,
+
+		/**
+		* The host CPU supports the x86 AVX2 instruction set extension.
+		*/
+		kFeatureCpuAVX2,
+
+		/**
+		* The host CPU supports the ARM NEON instruction set extension.
+		*/
+		kFeatureCpuNEON
 	};
 
 	/**
 	 * Determine whether the backend supports the specified feature.
+	 *
+	 * The default implementation only reports the CPU features.
 	 */
-	virtual bool hasFeature(Feature f) { return false; }
+	virtual bool hasFeature(Feature f);
 
 	/**
 	 * Enable or disable the specified feature.
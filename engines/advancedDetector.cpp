@@ -33,6 +33,7 @@
 #include "gui/gui-manager.h"
 #include "gui/message.h"
 #include "engines/advancedDetector.h"
+#include "engines/detectioncache.h"
 #include "engines/obsolete.h"
 
 /**
@@ -445,7 +446,7 @@ void AdvancedMetaEngineDetection::composeFileHashMap(FileMap &allFiles, const Co
 	}
 }
 
-bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, const ADGameDescription &game, const Common::String fname, FileProperties &fileProps) const {
+static bool computeFileProperties(uint md5Bytes, const AdvancedMetaEngine::FileMap &allFiles, const ADGameDescription &game, const Common::String &fname, FileProperties &fileProps) {
 	// FIXME/TODO: We don't handle the case that a file is listed as a regular
 	// file and as one with resource fork.
 
@@ -457,7 +458,7 @@ bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, con
 		if (!macResMan.open(fname, fileMapArchive))
 			return false;
 
-		fileProps.md5 = macResMan.computeResForkMD5AsString(_md5Bytes);
+		fileProps.md5 = macResMan.computeResForkMD5AsString(md5Bytes);
 		fileProps.size = macResMan.getResForkDataSize();
 
 		if (fileProps.size != 0)
@@ -473,42 +474,75 @@ bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, con
 		return false;
 
 	fileProps.size = (int32)testFile.size();
-	fileProps.md5 = Common::computeStreamMD5AsString(testFile, _md5Bytes);
+	fileProps.md5 = Common::computeStreamMD5AsString(testFile, md5Bytes);
 	return true;
 }
 
-bool AdvancedMetaEngine::getFilePropertiesExtern(uint md5Bytes, const FileMap &allFiles, const ADGameDescription &game, const Common::String fname, FileProperties &fileProps) const {
-	// FIXME/TODO: We don't handle the case that a file is listed as a regular
-	// file and as one with resource fork.
+/**
+ * Get the properties of a file from the detection cache, or compute them and
+ * store them in the cache. The cached properties are used as long as the
+ * files they were computed from keep the same size and modification time.
+ */
+static bool getFilePropertiesCached(uint md5Bytes, const AdvancedMetaEngine::FileMap &allFiles, const ADGameDescription &game, const Common::String &fname, FileProperties &fileProps) {
+	Common::String key;
+	Common::String path;
+	Common::String signature;
 
 	if (game.flags & ADGF_MACRESFORK) {
-		FileMapArchive fileMapArchive(allFiles);
-
-		Common::MacResManager macResMan;
+		// All the files MacResManager may read the resource fork from
+		const Common::String candidates[] = {
+			fname + ".rsrc",
+			Common::MacResManager::constructAppleDoubleName(fname),
+			fname + ".bin",
+			fname
+		};
+
+		for (int i = 0; i < ARRAYSIZE(candidates); i++) {
+			if (!allFiles.contains(candidates[i]))
+				continue;
 
-		if (!macResMan.open(fname, fileMapArchive))
-			return false;
+			const Common::FSNode &node = allFiles[candidates[i]];
+			Common::String fileSignature;
+			if (!DetectionCache::getFileSignature(node, fileSignature))
+				return computeFileProperties(md5Bytes, allFiles, game, fname, fileProps);
 
-		fileProps.md5 = macResMan.computeResForkMD5AsString(md5Bytes);
-		fileProps.size = macResMan.getResForkDataSize();
+			if (key.empty()) {
+				path = node.getPath();
+				key = Common::String::format("rsrc:%u:", md5Bytes) + path;
+			}
+			signature += candidates[i] + "=" + fileSignature + ";";
+		}
+	} else if (allFiles.contains(fname)) {
+		const Common::FSNode &node = allFiles[fname];
+		if (!DetectionCache::getFileSignature(node, signature))
+			return computeFileProperties(md5Bytes, allFiles, game, fname, fileProps);
 
-		if (fileProps.size != 0)
-			return true;
+		path = node.getPath();
+		key = Common::String::format("%u:", md5Bytes) + path;
 	}
 
-	if (!allFiles.contains(fname))
-		return false;
+	// None of the files exist, so there is nothing worth caching
+	if (key.empty())
+		return computeFileProperties(md5Bytes, allFiles, game, fname, fileProps);
 
-	Common::File testFile;
+	if (DetectionCacheMan.lookup(key, signature, fileProps))
+		return true;
 
-	if (!testFile.open(allFiles[fname]))
+	if (!computeFileProperties(md5Bytes, allFiles, game, fname, fileProps))
 		return false;
 
-	fileProps.size = (int32)testFile.size();
-	fileProps.md5 = Common::computeStreamMD5AsString(testFile, md5Bytes);
+	DetectionCacheMan.store(key, path, signature, fileProps);
 	return true;
 }
 
+bool AdvancedMetaEngineDetection::getFileProperties(const FileMap &allFiles, const ADGameDescription &game, const Common::String fname, FileProperties &fileProps) const {
+	return getFilePropertiesCached(_md5Bytes, allFiles, game, fname, fileProps);
+}
+
+bool AdvancedMetaEngine::getFilePropertiesExtern(uint md5Bytes, const FileMap &allFiles, const ADGameDescription &game, const Common::String fname, FileProperties &fileProps) const {
+	return getFilePropertiesCached(md5Bytes, allFiles, game, fname, fileProps);
+}
+
 ADDetectedGames AdvancedMetaEngineDetection::detectGame(const Common::FSNode &parent, const FileMap &allFiles, Common::Language language, Common::Platform platform, const Common::String &extra) const {
 	FilePropertiesMap filesProps;
 	ADDetectedGames matched;
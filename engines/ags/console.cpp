@@ -25,6 +25,8 @@
 #include "ags/globals.h"
 #include "ags/shared/ac/spritecache.h"
 #include "ags/shared/gfx/allegrobitmap.h"
+#include "ags/engine/script/cc_instance.h"
+#include "ags/engine/script/script_benchmark.h"
 #include "image/png.h"
 
 namespace AGS {
@@ -34,6 +36,7 @@ AGSConsole::AGSConsole(AGSEngine *vm) : GUI::Debugger(), _vm(vm), _logOutputTarg
 	registerCmd("ags_debug_groups_set",  WRAP_METHOD(AGSConsole, Cmd_setDebugGroupLevel));
 	registerCmd("ags_sprite_info",   WRAP_METHOD(AGSConsole, Cmd_getSpriteInfo));
 	registerCmd("ags_sprite_dump",  WRAP_METHOD(AGSConsole, Cmd_dumpSprite));
+	registerCmd("ags_script_bench",  WRAP_METHOD(AGSConsole, Cmd_scriptBenchmark));
 
 	_logOutputTarget = new LogOutputTarget();
 	_agsDebuggerOutput = _GP(DbgMgr).RegisterOutput("ScummVMLog", _logOutputTarget, AGS3::AGS::Shared::kDbgMsg_None);
@@ -230,6 +233,36 @@ bool AGSConsole::Cmd_dumpSprite(int argc, const char **argv) {
 	return true;
 }
 
+bool AGSConsole::Cmd_scriptBenchmark(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Usage: %s [iterations]\n", argv[0]);
+		return true;
+	}
+
+	if (AGS3::ccInstance::GetCurrentInstance()) {
+		debugPrintf("Cannot run the benchmark while a script is running\n");
+		return true;
+	}
+
+	int iterations = (argc == 2) ? atoi(argv[1]) : 1000;
+	if (iterations <= 0) {
+		debugPrintf("Invalid number of iterations '%s'\n", argv[1]);
+		return true;
+	}
+
+	AGS3::std::vector<AGS3::ScriptBenchmarkResult> results;
+	AGS3::String error;
+	if (!AGS3::RunScriptBenchmark(iterations, results, error)) {
+		debugPrintf("Script benchmark failed: %s\n", error.GetCStr());
+		return true;
+	}
+
+	debugPrintf("%-20s %12s %12s\n", "Function", "Predecoded", "Raw");
+	for (uint i = 0; i < results.size(); ++i)
+		debugPrintf("%-20s %10u ms %10u ms\n", results[i].Name.GetCStr(), results[i].PredecodedMs, results[i].RawMs);
+	return true;
+}
+
 LogOutputTarget::LogOutputTarget() {
 }
 
@@ -50,6 +50,8 @@ private:
 	bool Cmd_getSpriteInfo(int argc, const char **argv);
 	bool Cmd_dumpSprite(int argc, const char **argv);
 
+	bool Cmd_scriptBenchmark(int argc, const char **argv);
+
 	const char *getVerbosityLevel(AGS3::uint32_t groupID) const;
 	AGS3::uint32_t parseGroup(const char *, bool &) const;
 	AGS3::AGS::Shared::MessageType parseLevel(const char *, bool &) const;
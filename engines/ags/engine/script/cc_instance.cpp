@@ -222,6 +222,8 @@ ccInstance::ccInstance() {
 	numimports = 0;
 	resolved_imports = nullptr;
 	code_fixups         = nullptr;
+	code_ops            = nullptr;
+	code_args           = nullptr;
 
 	memset(callStackLineNumber, 0, sizeof(callStackLineNumber));
 	memset(callStackAddr, 0, sizeof(callStackAddr));
@@ -412,6 +414,8 @@ int ccInstance::Run(int32_t curpc) {
 	ccInstance *codeInst = runningInst;
 	int write_debug_dump = ccGetOption(SCOPT_DEBUGRUN);
 	ScriptOperation codeOp;
+	const ScriptPredecodedOp *codeOps = ccGetOption(SCOPT_NOPREDECODE) ? nullptr : codeInst->code_ops;
+	const RuntimeScriptValue *codeArgs = codeInst->code_args;
 
 	FunctionCallStack func_callstack;
 
@@ -419,97 +423,138 @@ int ccInstance::Run(int32_t curpc) {
 		if (_G(abort_engine))
 			return -1;
 
-		/*
-		if (!codeInst->ReadOperation(codeOp, pc))
-		{
-		    return -1;
-		}
-		*/
-		/* ReadOperation */
-		//=====================================================================
-		codeOp.Instruction.Code         = codeInst->code[pc];
-		codeOp.Instruction.InstanceId   = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
-		codeOp.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
-
-		if (codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS) {
-			cc_error("invalid instruction %d found in code stream", codeOp.Instruction.Code);
-			return -1;
-		}
+		const RuntimeScriptValue *args = codeOp.Args;
+		int reg1_index, reg2_index;
+		const ScriptPredecodedOp *predecoded = (codeOps && pc < codeInst->codesize && codeOps[pc].Code >= 0) ?
+			&codeOps[pc] : nullptr;
+		if (predecoded) {
+			codeOp.Instruction.Code = predecoded->Code;
+			codeOp.Instruction.InstanceId = predecoded->InstanceId;
+			codeOp.ArgCount = predecoded->ArgCount;
+			if (predecoded->RuntimeFixups == 0) {
+				// Everything is known in advance, use the decoded arguments in place
+				args = &codeArgs[predecoded->FirstArg];
+				reg1_index = predecoded->Reg1;
+				reg2_index = predecoded->Reg2;
+			} else {
+				for (int i = 0; i < codeOp.ArgCount; ++i) {
+					const int32_t arg_at = pc + 1 + i;
+					if ((predecoded->RuntimeFixups & (1 << i)) == 0) {
+						codeOp.Args[i] = codeArgs[predecoded->FirstArg + i];
+					} else if (codeInst->code_fixups[arg_at] == FIXUP_IMPORT) {
+						const ScriptImport *import = _GP(simp).getByIndex((int32_t)codeInst->code[arg_at]);
+						if (import) {
+							codeOp.Args[i] = import->Value;
+						} else {
+							cc_error("cannot resolve import, key = %ld", codeInst->code[arg_at]);
+							return -1;
+						}
+					} else {
+						codeOp.Args[i] = GetStackPtrOffsetFw((int32_t)codeInst->code[arg_at]);
+					}
+				}
+				reg1_index = codeOp.Args[0].IValue;
+				reg2_index = codeOp.Args[1].IValue;
+			}
+		} else {
+			/*
+			if (!codeInst->ReadOperation(codeOp, pc))
+			{
+			    return -1;
+			}
+			*/
+			/* ReadOperation */
+			//=====================================================================
+			codeOp.Instruction.Code         = codeInst->code[pc];
+			codeOp.Instruction.InstanceId   = (codeOp.Instruction.Code >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK;
+			codeOp.Instruction.Code        &= INSTANCE_ID_REMOVEMASK; // now this is pure instruction code
+
+			if (codeOp.Instruction.Code < 0 || codeOp.Instruction.Code >= CC_NUM_SCCMDS) {
+				cc_error("invalid instruction %d found in code stream", codeOp.Instruction.Code);
+				return -1;
+			}
 
-		codeOp.ArgCount = sccmd_info[codeOp.Instruction.Code].ArgCount;
-		if (pc + codeOp.ArgCount >= codeInst->codesize) {
-			cc_error("unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
-			return -1;
-		}
+			codeOp.ArgCount = sccmd_info[codeOp.Instruction.Code].ArgCount;
+			if (pc + codeOp.ArgCount >= codeInst->codesize) {
+				cc_error("unexpected end of code data (%d; %d)", pc + codeOp.ArgCount, codeInst->codesize);
+				return -1;
+			}
 
-		int pc_at = pc + 1;
-		for (int i = 0; i < codeOp.ArgCount; ++i, ++pc_at) {
-			char fixup = codeInst->code_fixups[pc_at];
-			if (fixup > 0) {
-				// could be relative pointer or import address
-				/*
-				if (!FixupArgument(code[pc], fixup, codeOp.Args[i]))
-				{
-				    return -1;
-				}
-				*/
-				/* FixupArgument */
-				//=====================================================================
-				switch (fixup) {
-				case FIXUP_GLOBALDATA: {
-					ScriptVariable *gl_var = (ScriptVariable *)codeInst->code[pc_at];
-					codeOp.Args[i].SetGlobalVar(&gl_var->RValue);
-				}
-				break;
-				case FIXUP_FUNCTION:
-					// originally commented -- CHECKME: could this be used in very old versions of AGS?
-					//      code[fixup] += (long)&code[0];
-					// This is a program counter value, presumably will be used as SCMD_CALL argument
-					codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
+			int pc_at = pc + 1;
+			for (int i = 0; i < codeOp.ArgCount; ++i, ++pc_at) {
+				char fixup = codeInst->code_fixups[pc_at];
+				if (fixup > 0) {
+					// could be relative pointer or import address
+					/*
+					if (!FixupArgument(code[pc], fixup, codeOp.Args[i]))
+					{
+					    return -1;
+					}
+					*/
+					/* FixupArgument */
+					//=====================================================================
+					switch (fixup) {
+					case FIXUP_GLOBALDATA: {
+						ScriptVariable *gl_var = (ScriptVariable *)codeInst->code[pc_at];
+						codeOp.Args[i].SetGlobalVar(&gl_var->RValue);
+					}
 					break;
-				case FIXUP_STRING:
-					codeOp.Args[i].SetStringLiteral(&codeInst->strings[0] + codeInst->code[pc_at]);
+					case FIXUP_FUNCTION:
+						// originally commented -- CHECKME: could this be used in very old versions of AGS?
+						//      code[fixup] += (long)&code[0];
+						// This is a program counter value, presumably will be used as SCMD_CALL argument
+						codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
+						break;
+					case FIXUP_STRING:
+						codeOp.Args[i].SetStringLiteral(&codeInst->strings[0] + codeInst->code[pc_at]);
+						break;
+					case FIXUP_IMPORT: {
+						const ScriptImport *import = _GP(simp).getByIndex((int32_t)codeInst->code[pc_at]);
+						if (import) {
+							codeOp.Args[i] = import->Value;
+						} else {
+							cc_error("cannot resolve import, key = %ld", codeInst->code[pc_at]);
+							return -1;
+						}
+					}
 					break;
-				case FIXUP_IMPORT: {
-					const ScriptImport *import = _GP(simp).getByIndex((int32_t)codeInst->code[pc_at]);
-					if (import) {
-						codeOp.Args[i] = import->Value;
-					} else {
-						cc_error("cannot resolve import, key = %ld", codeInst->code[pc_at]);
+					case FIXUP_STACK:
+						codeOp.Args[i] = GetStackPtrOffsetFw((int32_t)codeInst->code[pc_at]);
+						break;
+					default:
+						cc_error("internal fixup type error: %d", fixup);
 						return -1;
 					}
+					/* End FixupArgument */
+					//=====================================================================
+				} else {
+					// should be a numeric literal (int32 or float)
+					codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
 				}
-				break;
-				case FIXUP_STACK:
-					codeOp.Args[i] = GetStackPtrOffsetFw((int32_t)codeInst->code[pc_at]);
-					break;
-				default:
-					cc_error("internal fixup type error: %d", fixup);
-					return -1;
-				}
-				/* End FixupArgument */
-				//=====================================================================
-			} else {
-				// should be a numeric literal (int32 or float)
-				codeOp.Args[i].SetInt32((int32_t)codeInst->code[pc_at]);
 			}
+			/* End ReadOperation */
+			//=====================================================================
+			reg1_index = codeOp.Args[0].IValue;
+			reg2_index = codeOp.Args[1].IValue;
 		}
-		/* End ReadOperation */
-		//=====================================================================
 
 		// save the arguments for quick access
-		RuntimeScriptValue &arg1 = codeOp.Args[0];
-		RuntimeScriptValue &arg2 = codeOp.Args[1];
-		RuntimeScriptValue &arg3 = codeOp.Args[2];
+		const RuntimeScriptValue &arg1 = args[0];
+		const RuntimeScriptValue &arg2 = args[1];
+		const RuntimeScriptValue &arg3 = args[2];
 		RuntimeScriptValue &reg1 =
-		    registers[arg1.IValue >= 0 && arg1.IValue < CC_NUM_REGISTERS ? arg1.IValue : 0];
+		    registers[reg1_index >= 0 && reg1_index < CC_NUM_REGISTERS ? reg1_index : 0];
 		RuntimeScriptValue &reg2 =
-		    registers[arg2.IValue >= 0 && arg2.IValue < CC_NUM_REGISTERS ? arg2.IValue : 0];
+		    registers[reg2_index >= 0 && reg2_index < CC_NUM_REGISTERS ? reg2_index : 0];
 
 		const char *direct_ptr1;
 		const char *direct_ptr2;
 
 		if (write_debug_dump) {
+			if (args != codeOp.Args) {
+				for (int i = 0; i < codeOp.ArgCount; ++i)
+					codeOp.Args[i] = args[i];
+			}
 			DumpInstruction(codeOp);
 		}
 
@@ -1342,6 +1387,8 @@ bool ccInstance::_Create(PScript scri, ccInstance *joined) {
 	if (joined) {
 		resolved_imports = joined->resolved_imports;
 		code_fixups = joined->code_fixups;
+		code_ops = joined->code_ops;
+		code_args = joined->code_args;
 	} else {
 		if (!ResolveScriptImports(scri)) {
 			return false;
@@ -1352,6 +1399,7 @@ bool ccInstance::_Create(PScript scri, ccInstance *joined) {
 		if (!CreateRuntimeCodeFixups(scri)) {
 			return false;
 		}
+		PredecodeCode();
 	}
 
 	exports = new RuntimeScriptValue[scri->numexports];
@@ -1427,9 +1475,13 @@ void ccInstance::Free() {
 	if ((flags & INSTF_SHAREDATA) == 0) {
 		delete [] resolved_imports;
 		delete [] code_fixups;
+		delete [] code_ops;
+		delete [] code_args;
 	}
 	resolved_imports = nullptr;
 	code_fixups = nullptr;
+	code_ops = nullptr;
+	code_args = nullptr;
 }
 
 bool ccInstance::ResolveScriptImports(PScript scri) {
@@ -1600,6 +1652,70 @@ bool ccInstance::CreateRuntimeCodeFixups(PScript scri) {
 	return true;
 }
 
+void ccInstance::PredecodeCode() {
+	code_ops = new ScriptPredecodedOp[codesize];
+	std::vector<RuntimeScriptValue> args;
+
+	// Instructions follow each other, each one followed by its arguments.
+	// Decoding stops at the first invalid instruction; Run decodes whatever
+	// was not decoded here by itself, and reports the error when it gets there.
+	int32_t at = 0;
+	while (at < codesize) {
+		int32_t instr = (int32_t)(code[at] & INSTANCE_ID_REMOVEMASK);
+		if (instr < 0 || instr >= CC_NUM_SCCMDS)
+			break;
+		int arg_count = sccmd_info[instr].ArgCount;
+		if (at + arg_count >= codesize)
+			break;
+
+		ScriptPredecodedOp op;
+		op.FirstArg = (int32_t)args.size();
+		bool valid = true;
+		for (int i = 0; i < arg_count; ++i) {
+			const int32_t arg_at = at + 1 + i;
+			RuntimeScriptValue arg;
+			switch (code_fixups[arg_at]) {
+			case FIXUP_GLOBALDATA:
+				arg.SetGlobalVar(&((ScriptVariable *)code[arg_at])->RValue);
+				break;
+			case FIXUP_STRING:
+				arg.SetStringLiteral(&strings[0] + code[arg_at]);
+				break;
+			case FIXUP_IMPORT:
+			case FIXUP_STACK:
+				// Imports may be replaced, and stack addresses depend on the stack
+				op.RuntimeFixups |= 1 << i;
+				arg.SetInt32((int32_t)code[arg_at]);
+				break;
+			default:
+				if (code_fixups[arg_at] > 0 && code_fixups[arg_at] != FIXUP_FUNCTION)
+					valid = false;
+				// Numeric literal or a program counter value
+				arg.SetInt32((int32_t)code[arg_at]);
+				break;
+			}
+			args.push_back(arg);
+		}
+		if (!valid)
+			break;
+
+		op.Code = instr;
+		op.InstanceId = (int32_t)((code[at] >> INSTANCE_ID_SHIFT) & INSTANCE_ID_MASK);
+		op.ArgCount = arg_count;
+		const int32_t reg1 = (arg_count >= 1) ? args[op.FirstArg].IValue : 0;
+		const int32_t reg2 = (arg_count >= 2) ? args[op.FirstArg + 1].IValue : 0;
+		op.Reg1 = (reg1 >= 0 && reg1 < CC_NUM_REGISTERS) ? reg1 : 0;
+		op.Reg2 = (reg2 >= 0 && reg2 < CC_NUM_REGISTERS) ? reg2 : 0;
+		code_ops[at] = op;
+		at += arg_count + 1;
+	}
+
+	// Leave room for reading the unused arguments of the last instruction
+	code_args = new RuntimeScriptValue[args.size() + MAX_SCMD_ARGS];
+	for (size_t i = 0; i < args.size(); ++i)
+		code_args[i] = args[i];
+}
+
 /*
 bool ccInstance::ReadOperation(ScriptOperation &op, int32_t at_pc)
 {
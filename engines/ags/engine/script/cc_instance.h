@@ -78,6 +78,27 @@ struct ScriptOperation {
 	int                 ArgCount;
 };
 
+// Instruction decoded ahead of execution, when the script instance is created
+struct ScriptPredecodedOp {
+	ScriptPredecodedOp() {
+		Code = -1;
+		InstanceId = 0;
+		FirstArg = 0;
+		ArgCount = 0;
+		RuntimeFixups = 0;
+		Reg1 = 0;
+		Reg2 = 0;
+	}
+
+	int32_t Code;           // pure instruction code, -1 if there is no decoded instruction here
+	int32_t InstanceId;
+	int32_t FirstArg;       // index of the first argument in code_args
+	uint8_t ArgCount;
+	uint8_t RuntimeFixups;  // bit N is set if argument N can only be resolved when run
+	uint8_t Reg1;           // registers addressed by the first two arguments
+	uint8_t Reg2;
+};
+
 struct ScriptVariable {
 	ScriptVariable() {
 		ScAddress = -1; // address = 0 is valid one, -1 means undefined
@@ -150,6 +171,11 @@ public:
 
 	char *code_fixups;
 
+	// Byte-code decoded when the instance is created, indexed by pc; the
+	// decoded arguments of all the instructions follow each other in code_args
+	ScriptPredecodedOp *code_ops;
+	RuntimeScriptValue *code_args;
+
 	// returns the currently executing instance, or NULL if none
 	static ccInstance *GetCurrentInstance(void);
 	// create a runnable instance of the supplied script
@@ -191,6 +217,9 @@ protected:
 	bool    AddGlobalVar(const ScriptVariable &glvar);
 	ScriptVariable *FindGlobalVar(int32_t var_addr);
 	bool    CreateRuntimeCodeFixups(PScript scri);
+	// Decode the instructions and all the arguments that do not depend on
+	// the state of execution, so that Run does not need to do it every time
+	void    PredecodeCode();
 	//bool    ReadOperation(ScriptOperation &op, int32_t at_pc);
 
 	// Runtime fixups
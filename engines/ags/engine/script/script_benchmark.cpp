@@ -0,0 +1,193 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "ags/engine/script/script_benchmark.h"
+#include "ags/engine/script/cc_instance.h"
+#include "ags/shared/script/cc_options.h"
+#include "ags/shared/script/cc_script.h"
+#include "ags/shared/script/script_common.h"
+#include "ags/shared/util/string_compat.h"
+#include "ags/globals.h"
+#include "common/system.h"
+
+namespace AGS3 {
+
+// Number of loop iterations done by each benchmark function per call
+#define BENCH_LOOP_COUNT 1000
+
+ccScript *ScriptAssembler::CreateScript(int32_t globaldatasize) const {
+	ccScript *scri = new ccScript();
+	scri->globaldatasize = globaldatasize;
+	scri->globaldata = (char *)calloc(globaldatasize, 1);
+	scri->codesize = (int32_t)_code.size();
+	scri->code = (int32_t *)malloc(_code.size() * sizeof(int32_t));
+	memcpy(scri->code, &_code[0], _code.size() * sizeof(int32_t));
+	scri->stringssize = (int32_t)_strings.size();
+	scri->strings = (char *)malloc(_strings.size());
+	memcpy(scri->strings, &_strings[0], _strings.size());
+	scri->numfixups = (int)_fixups.size();
+	scri->fixups = (int32_t *)malloc(_fixups.size() * sizeof(int32_t));
+	memcpy(scri->fixups, &_fixups[0], _fixups.size() * sizeof(int32_t));
+	scri->fixuptypes = (char *)malloc(_fixupTypes.size());
+	memcpy(scri->fixuptypes, &_fixupTypes[0], _fixupTypes.size());
+	scri->numimports = scri->importsCapacity = (int)_imports.size();
+	scri->imports = (char **)malloc(_imports.size() * sizeof(char *));
+	for (size_t i = 0; i < _imports.size(); ++i)
+		scri->imports[i] = ags_strdup(_imports[i].GetCStr());
+	scri->numexports = scri->exportsCapacity = (int)_exports.size();
+	scri->exports = (char **)malloc(_exports.size() * sizeof(char *));
+	scri->export_addr = (int32_t *)malloc(_exports.size() * sizeof(int32_t));
+	for (size_t i = 0; i < _exports.size(); ++i) {
+		scri->exports[i] = ags_strdup(_exports[i].GetCStr());
+		scri->export_addr[i] = _exportAddrs[i];
+	}
+	return scri;
+}
+
+static const char *const BenchFunctions[] = { "bench_loop", "bench_strings", "bench_properties" };
+
+static ccScript *CreateBenchmarkScript() {
+	ScriptAssembler as;
+	int32_t top, exit_jump;
+
+	// int bench_loop() { int sum = 0; for (...) sum += i; return sum; }
+	as.Export(BenchFunctions[0]);
+	as.Op(SCMD_THISBASE, as.Pos());
+	as.Op(SCMD_LINENUM, 1);
+	as.Op(SCMD_LITTOREG, SREG_AX, 0);
+	as.Op(SCMD_PUSHREG, SREG_AX);
+	top = as.BeginLoop(BENCH_LOOP_COUNT, exit_jump);
+	as.Op(SCMD_LINENUM, 2);
+	as.Op(SCMD_LOADSPOFFS, 4);
+	as.Op(SCMD_MEMREAD, SREG_AX);
+	as.Op(SCMD_LOADSPOFFS, 8);
+	as.Op(SCMD_MEMREAD, SREG_BX);
+	as.Op(SCMD_ADDREG, SREG_BX, SREG_AX);
+	as.Op(SCMD_MEMWRITE, SREG_BX);
+	as.EndLoop(top, exit_jump);
+	as.Op(SCMD_LOADSPOFFS, 4);
+	as.Op(SCMD_MEMREAD, SREG_AX);
+	as.Op(SCMD_SUB, SREG_SP, 4);
+	as.Op(SCMD_RET);
+
+	// int bench_strings() { for (...) { StrComp(a, b); StrLen(a); a == c; } }
+	as.Export(BenchFunctions[1]);
+	as.Op(SCMD_THISBASE, as.Pos());
+	as.Op(SCMD_LINENUM, 10);
+	top = as.BeginLoop(BENCH_LOOP_COUNT, exit_jump);
+	as.Op(SCMD_LINENUM, 11);
+	as.OpString(SCMD_LITTOREG, SREG_AX, "Hello there");
+	as.Op(SCMD_PUSHREAL, SREG_AX);
+	as.OpString(SCMD_LITTOREG, SREG_AX, "Hello world");
+	as.Op(SCMD_PUSHREAL, SREG_AX);
+	as.Op(SCMD_NUMFUNCARGS, 2);
+	as.OpImport(SCMD_LITTOREG, SREG_AX, "StrComp");
+	as.Op(SCMD_CALLEXT, SREG_AX);
+	as.Op(SCMD_SUBREALSTACK, 2);
+	as.Op(SCMD_LINENUM, 12);
+	as.OpString(SCMD_LITTOREG, SREG_AX, "Hello world");
+	as.Op(SCMD_PUSHREAL, SREG_AX);
+	as.Op(SCMD_NUMFUNCARGS, 1);
+	as.OpImport(SCMD_LITTOREG, SREG_AX, "StrLen");
+	as.Op(SCMD_CALLEXT, SREG_AX);
+	as.Op(SCMD_SUBREALSTACK, 1);
+	as.Op(SCMD_LINENUM, 13);
+	as.OpString(SCMD_LITTOREG, SREG_AX, "Hello world");
+	as.OpString(SCMD_LITTOREG, SREG_BX, "Hello there");
+	as.Op(SCMD_STRINGSEQUAL, SREG_AX, SREG_BX);
+	as.EndLoop(top, exit_jump);
+	as.Op(SCMD_LITTOREG, SREG_AX, 0);
+	as.Op(SCMD_RET);
+
+	// int bench_properties() { total = 0; for (...) total += character[0].x; return total; }
+	as.Export(BenchFunctions[2]);
+	as.Op(SCMD_THISBASE, as.Pos());
+	as.Op(SCMD_LINENUM, 20);
+	as.OpGlobal(SCMD_LITTOREG, SREG_MAR, 0);
+	as.Op(SCMD_LITTOREG, SREG_AX, 0);
+	as.Op(SCMD_MEMWRITE, SREG_AX);
+	top = as.BeginLoop(BENCH_LOOP_COUNT, exit_jump);
+	as.Op(SCMD_LINENUM, 21);
+	as.OpImport(SCMD_LITTOREG, SREG_MAR, "character");
+	as.Op(SCMD_CALLOBJ, SREG_MAR);
+	as.Op(SCMD_NUMFUNCARGS, 0);
+	as.OpImport(SCMD_LITTOREG, SREG_AX, "Character::get_X");
+	as.Op(SCMD_CALLEXT, SREG_AX);
+	as.OpGlobal(SCMD_LITTOREG, SREG_MAR, 0);
+	as.Op(SCMD_MEMREAD, SREG_BX);
+	as.Op(SCMD_ADDREG, SREG_BX, SREG_AX);
+	as.Op(SCMD_MEMWRITE, SREG_BX);
+	as.EndLoop(top, exit_jump);
+	as.OpGlobal(SCMD_LITTOREG, SREG_MAR, 0);
+	as.Op(SCMD_MEMREAD, SREG_AX);
+	as.Op(SCMD_RET);
+
+	return as.CreateScript(sizeof(int32_t));
+}
+
+bool RunScriptBenchmark(int iterations, std::vector<ScriptBenchmarkResult> &results, String &error) {
+	PScript script(CreateBenchmarkScript());
+
+	// Keep the benchmark functions out of the game's symbols
+	const int autoImport = ccGetOption(SCOPT_AUTOIMPORT);
+	ccSetOption(SCOPT_AUTOIMPORT, 0);
+	ccInstance *inst = ccInstance::CreateFromScript(script);
+	ccSetOption(SCOPT_AUTOIMPORT, autoImport);
+	if (!inst) {
+		error = _G(ccErrorString);
+		return false;
+	}
+
+	const int noPredecode = ccGetOption(SCOPT_NOPREDECODE);
+	bool success = true;
+	for (size_t f = 0; f < ARRAYSIZE(BenchFunctions) && success; ++f) {
+		ScriptBenchmarkResult result;
+		result.Name = BenchFunctions[f];
+		int returnValues[2];
+		for (int raw = 0; raw < 2 && success; ++raw) {
+			ccSetOption(SCOPT_NOPREDECODE, raw);
+			const uint32_t start = g_system->getMillis();
+			for (int i = 0; i < iterations; ++i) {
+				if (inst->CallScriptFunction(BenchFunctions[f], 0, nullptr) != 0) {
+					error = String::FromFormat("%s: %s", BenchFunctions[f], _G(ccErrorString).GetCStr());
+					success = false;
+					break;
+				}
+			}
+			(raw ? result.RawMs : result.PredecodedMs) = g_system->getMillis() - start;
+			returnValues[raw] = inst->returnValue;
+		}
+		if (success && returnValues[0] != returnValues[1]) {
+			error = String::FromFormat("%s: predecoded code returned %d instead of %d",
+				BenchFunctions[f], returnValues[0], returnValues[1]);
+			success = false;
+		}
+		if (success)
+			results.push_back(result);
+	}
+	ccSetOption(SCOPT_NOPREDECODE, noPredecode);
+
+	delete inst;
+	return success;
+}
+
+} // namespace AGS3
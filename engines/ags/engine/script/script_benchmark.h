@@ -0,0 +1,157 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+//=============================================================================
+//
+// Script interpreter benchmark: runs a built-in script, shaped like the code
+// of compiled game scripts, with and without the predecoded byte-code.
+// The assembler used to build it is shared with the interpreter tests.
+//
+//=============================================================================
+
+#ifndef AGS_ENGINE_SCRIPT_SCRIPT_BENCHMARK_H
+#define AGS_ENGINE_SCRIPT_SCRIPT_BENCHMARK_H
+
+#include "ags/lib/std/vector.h"
+#include "ags/shared/script/script_common.h"
+#include "ags/shared/util/string.h"
+
+namespace AGS3 {
+
+using AGS::Shared::String;
+
+struct ccScript;
+
+// Assembles byte-code the way the script compiler lays it out, for the
+// benchmark and the interpreter tests
+class ScriptAssembler {
+public:
+	int32_t Pos() const {
+		return (int32_t)_code.size();
+	}
+
+	void Op(int32_t cmd) {
+		_code.push_back(cmd);
+	}
+	void Op(int32_t cmd, int32_t arg1) {
+		_code.push_back(cmd);
+		_code.push_back(arg1);
+	}
+	void Op(int32_t cmd, int32_t arg1, int32_t arg2) {
+		_code.push_back(cmd);
+		_code.push_back(arg1);
+		_code.push_back(arg2);
+	}
+
+	// Instruction with a register and a fixed up value, as the compiler
+	// writes for string literals, global variables and imports
+	void OpString(int32_t cmd, int32_t reg, const char *str) {
+		AddFixup(cmd, reg, (int32_t)_strings.size(), FIXUP_STRING);
+		_strings.insert(_strings.end(), str, str + strlen(str) + 1);
+	}
+	void OpGlobal(int32_t cmd, int32_t reg, int32_t address) {
+		AddFixup(cmd, reg, address, FIXUP_GLOBALDATA);
+	}
+	void OpImport(int32_t cmd, int32_t reg, const char *name) {
+		AddFixup(cmd, reg, (int32_t)_imports.size(), FIXUP_IMPORT);
+		_imports.push_back(name);
+	}
+	void OpFunction(int32_t cmd, int32_t reg, int32_t address) {
+		AddFixup(cmd, reg, address, FIXUP_FUNCTION);
+	}
+	// Address of the stack data at the given offset from the bottom of the stack
+	void OpStack(int32_t cmd, int32_t reg, int32_t offset) {
+		AddFixup(cmd, reg, offset, FIXUP_STACK);
+	}
+
+	// Jumps are relative to the instruction that follows them
+	int32_t JumpForward(int32_t cmd) {
+		Op(cmd, 0);
+		return Pos() - 1;
+	}
+	void JumpBack(int32_t cmd, int32_t target) {
+		Op(cmd, target - (Pos() + 2));
+	}
+	void SetJumpTarget(int32_t at, int32_t target) {
+		_code[at] = target - (at + 1);
+	}
+
+	// for (int i = 0; i < count; i++), with i as a local variable
+	int32_t BeginLoop(int32_t count, int32_t &exit_jump) {
+		Op(SCMD_LITTOREG, SREG_AX, 0);
+		Op(SCMD_PUSHREG, SREG_AX);
+		int32_t top = Pos();
+		Op(SCMD_LOADSPOFFS, 4);
+		Op(SCMD_MEMREAD, SREG_AX);
+		Op(SCMD_LITTOREG, SREG_BX, count);
+		Op(SCMD_LESSTHAN, SREG_AX, SREG_BX);
+		exit_jump = JumpForward(SCMD_JZ);
+		return top;
+	}
+	void EndLoop(int32_t top, int32_t exit_jump) {
+		Op(SCMD_LOADSPOFFS, 4);
+		Op(SCMD_MEMREAD, SREG_AX);
+		Op(SCMD_ADD, SREG_AX, 1);
+		Op(SCMD_MEMWRITE, SREG_AX);
+		JumpBack(SCMD_JMP, top);
+		SetJumpTarget(exit_jump, Pos());
+		Op(SCMD_SUB, SREG_SP, 4);
+	}
+
+	void Export(const char *name) {
+		_exports.push_back(String::FromFormat("%s$0", name));
+		_exportAddrs.push_back((EXPORT_FUNCTION << 24) | Pos());
+	}
+
+	ccScript *CreateScript(int32_t globaldatasize) const;
+
+private:
+	void AddFixup(int32_t cmd, int32_t reg, int32_t value, char type) {
+		Op(cmd, reg, value);
+		_fixups.push_back(Pos() - 1);
+		_fixupTypes.push_back(type);
+	}
+
+	std::vector<int32_t> _code;
+	std::vector<char>    _strings;
+	std::vector<int32_t> _fixups;
+	std::vector<char>    _fixupTypes;
+	std::vector<String>  _imports;
+	std::vector<String>  _exports;
+	std::vector<int32_t> _exportAddrs;
+};
+
+
+struct ScriptBenchmarkResult {
+	String   Name;
+	uint32_t PredecodedMs;  // run time using the instructions decoded at load
+	uint32_t RawMs;         // run time decoding each instruction when it is run
+};
+
+// Runs every benchmark function the given number of times. The script
+// imports the game's API, so this can only be done once a game is loaded.
+// Returns false and sets the error text if the benchmark could not be run.
+extern bool RunScriptBenchmark(int iterations, std::vector<ScriptBenchmarkResult> &results, String &error);
+
+} // namespace AGS3
+
+#endif
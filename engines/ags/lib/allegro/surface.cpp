@@ -23,8 +23,10 @@
 #include "ags/lib/allegro/gfx.h"
 #include "ags/lib/allegro/color.h"
 #include "ags/lib/allegro/flood.h"
+#include "ags/lib/allegro/surface_kernels.h"
 #include "ags/ags.h"
 #include "ags/globals.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "graphics/screen.h"
 
@@ -108,42 +110,41 @@ void BITMAP::floodfill(int x, int y, int color) {
 const int SCALE_THRESHOLD = 0x100;
 #define VGA_COLOR_TRANS(x) ((x) * 255 / 63)
 
-void BITMAP::draw(const BITMAP *srcBitmap, const Common::Rect &srcRect,
-		int dstX, int dstY, bool horizFlip, bool vertFlip,
-		bool skipTrans, int srcAlpha, int tintRed, int tintGreen,
-		int tintBlue) {
-	assert(format.bytesPerPixel == 2 || format.bytesPerPixel == 4 ||
-		(format.bytesPerPixel == 1 && srcBitmap->format.bytesPerPixel == 1));
-
-	// Allegro disables draw when the clipping rect has negative width/height.
-	// Common::Rect instead asserts, which we don't want.
-	if (cr <= cl || cb <= ct)
-		return;
-
-	// Figure out the dest area that will be updated
-	Common::Rect dstRect(dstX, dstY, dstX + srcRect.width(), dstY + srcRect.height());
-	Common::Rect destRect = dstRect.findIntersectingRect(
-		Common::Rect(cl, ct, cr, cb));
-	if (destRect.isEmpty())
-		// Area is entirely outside the clipping area, so nothing to draw
-		return;
+/**
+ * Everything the drawing loops need, worked out once per draw call
+ */
+struct BITMAP::DrawInnerArgs {
+	const Graphics::ManagedSurface &src;
+	Graphics::Surface destArea;
+	Common::Rect srcRect, dstRect;
+	int xStart, yStart;
+	bool horizFlip, vertFlip, skipTrans, sameFormat;
+	int srcAlpha;
+	bool useTint;
+	int tintRed, tintGreen, tintBlue;
+	bool scale;
+	int scaleX, scaleY;
+	uint32 transColor, alphaMask;
+	PALETTE palette;
 
-	// Get source and dest surface. Note that for the destination we create
-	// a temporary sub-surface based on the allowed clipping area
-	const Graphics::ManagedSurface &src = **srcBitmap;
-	Graphics::ManagedSurface &dest = *_owner;
-	Graphics::Surface destArea = dest.getSubArea(destRect);
+	// Row kernel for the 32-bit alpha blenders, or nullptr to blend per pixel
+	RgbBlendRowProc rgbBlendRowProc;
+	RgbBlendRowArgs rgbBlendRowArgs;
 
-	// Define scaling and other stuff used by the drawing loops
-	const int xDir = horizFlip ? -1 : 1;
-	bool useTint = (tintRed >= 0 && tintGreen >= 0 && tintBlue >= 0);
-	bool sameFormat = (src.format == format);
+	DrawInnerArgs(BITMAP *dstBitmap, const BITMAP *srcBitmap, const Common::Rect &srcRect_,
+			const Common::Rect &dstRect_, const Common::Rect &destRect, bool skipTrans_, int srcAlpha_);
+};
 
-	byte rSrc, gSrc, bSrc, aSrc;
-	byte rDest = 0, gDest = 0, bDest = 0, aDest = 0;
+BITMAP::DrawInnerArgs::DrawInnerArgs(BITMAP *dstBitmap, const BITMAP *srcBitmap, const Common::Rect &srcRect_,
+		const Common::Rect &dstRect_, const Common::Rect &destRect, bool skipTrans_, int srcAlpha_) :
+		src(**srcBitmap), destArea((**dstBitmap).getSubArea(destRect)), srcRect(srcRect_), dstRect(dstRect_),
+		horizFlip(false), vertFlip(false), skipTrans(skipTrans_), srcAlpha(srcAlpha_),
+		useTint(false), tintRed(-1), tintGreen(-1), tintBlue(-1),
+		scale(false), scaleX(SCALE_THRESHOLD), scaleY(SCALE_THRESHOLD),
+		rgbBlendRowProc(nullptr) {
+	sameFormat = (src.format == dstBitmap->format);
 
-	PALETTE palette;
-	if (src.format.bytesPerPixel == 1 && format.bytesPerPixel != 1) {
+	if (src.format.bytesPerPixel == 1 && dstBitmap->format.bytesPerPixel != 1) {
 		for (int i = 0; i < PAL_SIZE; ++i) {
 			palette[i].r = VGA_COLOR_TRANS(_G(current_palette)[i].r);
 			palette[i].g = VGA_COLOR_TRANS(_G(current_palette)[i].g);
@@ -151,91 +152,46 @@ void BITMAP::draw(const BITMAP *srcBitmap, const Common::Rect &srcRect,
 		}
 	}
 
-	uint32 transColor = 0, alphaMask = 0xff;
+	transColor = 0;
+	alphaMask = 0xff;
 	if (skipTrans && src.format.bytesPerPixel != 1) {
 		transColor = src.format.ARGBToColor(0, 255, 0, 255);
 		alphaMask = src.format.ARGBToColor(255, 0, 0, 0);
 		alphaMask = ~alphaMask;
 	}
 
-	int xStart = (dstRect.left < destRect.left) ? dstRect.left - destRect.left : 0;
-	int yStart = (dstRect.top < destRect.top) ? dstRect.top - destRect.top : 0;
-
-	for (int destY = yStart, yCtr = 0; yCtr < dstRect.height(); ++destY, ++yCtr) {
-		if (destY < 0 || destY >= destArea.h)
-			continue;
-		byte *destP = (byte *)destArea.getBasePtr(0, destY);
-		const byte *srcP = (const byte *)src.getBasePtr(
-			horizFlip ? srcRect.right - 1 : srcRect.left,
-			vertFlip ? srcRect.bottom - 1 - yCtr :
-			srcRect.top + yCtr);
-
-		// Loop through the pixels of the row
-		for (int destX = xStart, xCtr = 0, xCtrBpp = 0; xCtr < dstRect.width(); ++destX, ++xCtr, xCtrBpp += src.format.bytesPerPixel) {
-			if (destX < 0 || destX >= destArea.w)
-				continue;
-
-			const byte *srcVal = srcP + xDir * xCtrBpp;
-			uint32 srcCol = getColor(srcVal, src.format.bytesPerPixel);
-
-			// Check if this is a transparent color we should skip
-			if (skipTrans && ((srcCol & alphaMask) == transColor))
-				continue;
-
-			byte *destVal = (byte *)&destP[destX * format.bytesPerPixel];
+	xStart = (dstRect.left < destRect.left) ? dstRect.left - destRect.left : 0;
+	yStart = (dstRect.top < destRect.top) ? dstRect.top - destRect.top : 0;
+}
 
-			// When blitting to the same format we can just copy the color
-			if (format.bytesPerPixel == 1) {
-				*destVal = srcCol;
-				continue;
-			} else if (sameFormat && srcAlpha == -1) {
-				if (format.bytesPerPixel == 4)
-					*(uint32 *)destVal = srcCol;
-				else
-					*(uint16 *)destVal = srcCol;
-				continue;
-			}
+void BITMAP::draw(const BITMAP *srcBitmap, const Common::Rect &srcRect,
+		int dstX, int dstY, bool horizFlip, bool vertFlip,
+		bool skipTrans, int srcAlpha, int tintRed, int tintGreen,
+		int tintBlue) {
+	assert(format.bytesPerPixel == 2 || format.bytesPerPixel == 4 ||
+		(format.bytesPerPixel == 1 && srcBitmap->format.bytesPerPixel == 1));
 
-			// We need the rgb values to do blending and/or convert between formats
-			if (src.format.bytesPerPixel == 1) {
-				const RGB& rgb = palette[srcCol];
-				aSrc = 0xff;
-				rSrc = rgb.r;
-				gSrc = rgb.g;
-				bSrc = rgb.b;
-			} else
-				src.format.colorToARGB(srcCol, aSrc, rSrc, gSrc, bSrc);
+	// Allegro disables draw when the clipping rect has negative width/height.
+	// Common::Rect instead asserts, which we don't want.
+	if (cr <= cl || cb <= ct)
+		return;
 
-			if (srcAlpha == -1) {
-				// This means we don't use blending.
-				aDest = aSrc;
-				rDest = rSrc;
-				gDest = gSrc;
-				bDest = bSrc;
-			} else {
-				if (useTint) {
-					rDest = rSrc;
-					gDest = gSrc;
-					bDest = bSrc;
-					aDest = aSrc;
-					rSrc = tintRed;
-					gSrc = tintGreen;
-					bSrc = tintBlue;
-					aSrc = srcAlpha;
-				} else {
-					// TODO: move this to blendPixel to only do it when needed?
-					format.colorToARGB(getColor(destVal, format.bytesPerPixel), aDest, rDest, gDest, bDest);
-				}
-				blendPixel(aSrc, rSrc, gSrc, bSrc, aDest, rDest, gDest, bDest, srcAlpha);
-			}
+	// Figure out the dest area that will be updated
+	Common::Rect dstRect(dstX, dstY, dstX + srcRect.width(), dstY + srcRect.height());
+	Common::Rect destRect = dstRect.findIntersectingRect(
+		Common::Rect(cl, ct, cr, cb));
+	if (destRect.isEmpty())
+		// Area is entirely outside the clipping area, so nothing to draw
+		return;
 
-			uint32 pixel = format.ARGBToColor(aDest, rDest, gDest, bDest);
-			if (format.bytesPerPixel == 4)
-				*(uint32 *)destVal = pixel;
-			else
-				*(uint16 *)destVal = pixel;
-		}
-	}
+	DrawInnerArgs args(this, srcBitmap, srcRect, dstRect, destRect, skipTrans, srcAlpha);
+	args.horizFlip = horizFlip;
+	args.vertFlip = vertFlip;
+	args.useTint = (tintRed >= 0 && tintGreen >= 0 && tintBlue >= 0);
+	args.tintRed = tintRed;
+	args.tintGreen = tintGreen;
+	args.tintBlue = tintBlue;
+	drawInner(args);
 }
 
 void BITMAP::stretchDraw(const BITMAP *srcBitmap, const Common::Rect &srcRect,
@@ -255,68 +211,177 @@ void BITMAP::stretchDraw(const BITMAP *srcBitmap, const Common::Rect &srcRect,
 		// Area is entirely outside the clipping area, so nothing to draw
 		return;
 
-	// Get source and dest surface. Note that for the destination we create
-	// a temporary sub-surface based on the allowed clipping area
-	const Graphics::ManagedSurface &src = **srcBitmap;
-	Graphics::ManagedSurface &dest = *_owner;
-	Graphics::Surface destArea = dest.getSubArea(destRect);
+	DrawInnerArgs args(this, srcBitmap, srcRect, dstRect, destRect, skipTrans, srcAlpha);
+	args.scaleX = SCALE_THRESHOLD * srcRect.width() / dstRect.width();
+	args.scaleY = SCALE_THRESHOLD * srcRect.height() / dstRect.height();
+	// Stepping through the source at the threshold is the same as not scaling
+	args.scale = (args.scaleX != SCALE_THRESHOLD || args.scaleY != SCALE_THRESHOLD);
+	drawInner(args);
+}
 
-	// Define scaling and other stuff used by the drawing loops
-	const int scaleX = SCALE_THRESHOLD * srcRect.width() / dstRect.width();
-	const int scaleY = SCALE_THRESHOLD * srcRect.height() / dstRect.height();
-	bool sameFormat = (src.format == format);
+static RgbBlendRowProc s_rgbBlendRowProc = nullptr;
+static bool s_rgbBlendRowProcInitialized = false;
 
-	byte rSrc, gSrc, bSrc, aSrc;
-	byte rDest = 0, gDest = 0, bDest = 0, aDest = 0;
+void BITMAP::setSIMDEnabled(bool enabled) {
+	s_rgbBlendRowProc = nullptr;
+	s_rgbBlendRowProcInitialized = true;
 
-	PALETTE palette;
-	if (src.format.bytesPerPixel == 1 && format.bytesPerPixel != 1) {
-		for (int i = 0; i < PAL_SIZE; ++i) {
-			palette[i].r = VGA_COLOR_TRANS(_G(current_palette)[i].r);
-			palette[i].g = VGA_COLOR_TRANS(_G(current_palette)[i].g);
-			palette[i].b = VGA_COLOR_TRANS(_G(current_palette)[i].b);
+	if (!enabled)
+		return;
+
+	// Pick the fastest row kernel the CPU supports
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		s_rgbBlendRowProc = rgbBlendRowSSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		s_rgbBlendRowProc = rgbBlendRowAVX2;
+#endif
+}
+
+void BITMAP::drawInner(DrawInnerArgs &args) {
+	if (!s_rgbBlendRowProcInitialized)
+		setSIMDEnabled(true);
+
+	// The blenders built on rgbBlend have row kernels for unscaled drawing
+	// between 32-bit surfaces of the same format
+	const BlenderMode blenderMode = _G(_blender_mode);
+	if (s_rgbBlendRowProc && args.sameFormat && format.bytesPerPixel == 4 &&
+			args.srcAlpha != -1 && !args.useTint && !args.scale &&
+			format.rBits() == 8 && format.gBits() == 8 && format.bBits() == 8 &&
+			(format.aBits() == 0 || format.aBits() == 8) &&
+			(blenderMode == kSourceAlphaBlender || blenderMode == kArgbToRgbBlender ||
+			 blenderMode == kRgbToRgbBlender || blenderMode == kAlphaPreservedBlenderMode)) {
+		RgbBlendRowArgs &rowArgs = args.rgbBlendRowArgs;
+		rowArgs.rShift = format.rShift;
+		rowArgs.gShift = format.gShift;
+		rowArgs.bShift = format.bShift;
+		rowArgs.aShift = format.aShift;
+		// Formats without alpha bits have an opaque source alpha
+		rowArgs.alphaOr = (format.aBits() == 0) ? 0xff : 0;
+		if (blenderMode == kSourceAlphaBlender) {
+			rowArgs.alphaMul = 256;
+		} else if (blenderMode == kArgbToRgbBlender) {
+			rowArgs.alphaMul = (args.srcAlpha == 0) ? 256 : (args.srcAlpha & 0xff) + 1;
+		} else {
+			// (0xff * (alpha + 1)) >> 8 is alpha for the whole 0-255 range
+			rowArgs.alphaOr = 0xff;
+			rowArgs.alphaMul = (args.srcAlpha & 0xff) + 1;
 		}
+		rowArgs.destKeepMask = (blenderMode == kAlphaPreservedBlenderMode) ?
+			format.ARGBToColor(0xff, 0, 0, 0) : 0;
+		rowArgs.skipTrans = args.skipTrans;
+		rowArgs.transMask = args.alphaMask;
+		rowArgs.transColor = args.transColor;
+		args.rgbBlendRowProc = s_rgbBlendRowProc;
 	}
 
-	uint32 transColor = 0, alphaMask = 0xff;
-	if (skipTrans && src.format.bytesPerPixel != 1) {
-		transColor = src.format.ARGBToColor(0, 255, 0, 255);
-		alphaMask = src.format.ARGBToColor(255, 0, 0, 0);
-		alphaMask = ~alphaMask;
+	switch (format.bytesPerPixel) {
+	case 1:
+		if (args.scale)
+			drawInnerForSrc<1, true>(args);
+		else
+			drawInnerForSrc<1, false>(args);
+		break;
+	case 2:
+		if (args.scale)
+			drawInnerForSrc<2, true>(args);
+		else
+			drawInnerForSrc<2, false>(args);
+		break;
+	case 4:
+		if (args.scale)
+			drawInnerForSrc<4, true>(args);
+		else
+			drawInnerForSrc<4, false>(args);
+		break;
+	default:
+		error("Unsupported format in BITMAP::drawInner");
 	}
+}
+
+template<int DestBytesPerPixel, bool Scale>
+void BITMAP::drawInnerForSrc(const DrawInnerArgs &args) {
+	switch (args.src.format.bytesPerPixel) {
+	case 1:
+		drawInnerGeneric<DestBytesPerPixel, 1, Scale>(args);
+		break;
+	case 2:
+		drawInnerGeneric<DestBytesPerPixel, 2, Scale>(args);
+		break;
+	case 4:
+		drawInnerGeneric<DestBytesPerPixel, 4, Scale>(args);
+		break;
+	default:
+		error("Unsupported format in BITMAP::drawInnerForSrc");
+	}
+}
+
+template<int DestBytesPerPixel, int SrcBytesPerPixel, bool Scale>
+void BITMAP::drawInnerGeneric(const DrawInnerArgs &args) {
+	const Graphics::PixelFormat &srcFormat = args.src.format;
+	Graphics::Surface destArea = args.destArea;
+	const int xDir = args.horizFlip ? -1 : 1;
+
+	// Only the rows and columns inside the clipping area are visited
+	const int xCtrStart = MAX(0, -args.xStart);
+	const int xCtrEnd = MIN<int>(args.dstRect.width(), destArea.w - args.xStart);
+	const int yCtrStart = MAX(0, -args.yStart);
+	const int yCtrEnd = MIN<int>(args.dstRect.height(), destArea.h - args.yStart);
+	if (xCtrStart >= xCtrEnd)
+		return;
 
-	int xStart = (dstRect.left < destRect.left) ? dstRect.left - destRect.left : 0;
-	int yStart = (dstRect.top < destRect.top) ? dstRect.top - destRect.top : 0;
+	// When blitting to the same format we can just copy the color
+	const bool copyOnly = (DestBytesPerPixel == 1) || (args.sameFormat && args.srcAlpha == -1);
+	const bool copyRows = copyOnly && !Scale && !args.skipTrans && !args.horizFlip;
 
-	for (int destY = yStart, yCtr = 0, scaleYCtr = 0; yCtr < dstRect.height();
-			++destY, ++yCtr, scaleYCtr += scaleY) {
-		if (destY < 0 || destY >= destArea.h)
+	byte rSrc, gSrc, bSrc, aSrc;
+	byte rDest = 0, gDest = 0, bDest = 0, aDest = 0;
+
+	for (int yCtr = yCtrStart; yCtr < yCtrEnd; ++yCtr) {
+		byte *destP = (byte *)destArea.getBasePtr(0, args.yStart + yCtr);
+		const byte *srcP;
+		if (Scale)
+			srcP = (const byte *)args.src.getBasePtr(
+				args.srcRect.left, args.srcRect.top + yCtr * args.scaleY / SCALE_THRESHOLD);
+		else
+			srcP = (const byte *)args.src.getBasePtr(
+				args.horizFlip ? args.srcRect.right - 1 : args.srcRect.left,
+				args.vertFlip ? args.srcRect.bottom - 1 - yCtr :
+				args.srcRect.top + yCtr);
+
+		if (copyRows) {
+			memmove(destP + (args.xStart + xCtrStart) * DestBytesPerPixel,
+				srcP + xCtrStart * SrcBytesPerPixel,
+				(xCtrEnd - xCtrStart) * DestBytesPerPixel);
 			continue;
-		byte *destP = (byte *)destArea.getBasePtr(0, destY);
-		const byte *srcP = (const byte *)src.getBasePtr(
-			srcRect.left, srcRect.top + scaleYCtr / SCALE_THRESHOLD);
+		}
 
-		// Loop through the pixels of the row
-		for (int destX = xStart, xCtr = 0, scaleXCtr = 0; xCtr < dstRect.width();
-				++destX, ++xCtr, scaleXCtr += scaleX) {
-			if (destX < 0 || destX >= destArea.w)
-				continue;
+		if (DestBytesPerPixel == 4 && SrcBytesPerPixel == 4 && !Scale && args.rgbBlendRowProc) {
+			args.rgbBlendRowProc((uint32 *)destP + args.xStart + xCtrStart,
+				(const uint32 *)srcP + xDir * xCtrStart, xCtrEnd - xCtrStart,
+				xDir, args.rgbBlendRowArgs);
+			continue;
+		}
 
-			const byte *srcVal = srcP + scaleXCtr / SCALE_THRESHOLD * src.format.bytesPerPixel;
-			uint32 srcCol = getColor(srcVal, src.format.bytesPerPixel);
+		// Loop through the pixels of the row
+		for (int xCtr = xCtrStart, destX = args.xStart + xCtrStart; xCtr < xCtrEnd; ++xCtr, ++destX) {
+			const byte *srcVal = Scale ?
+				srcP + xCtr * args.scaleX / SCALE_THRESHOLD * SrcBytesPerPixel :
+				srcP + xDir * xCtr * SrcBytesPerPixel;
+			uint32 srcCol = getColor(srcVal, SrcBytesPerPixel);
 
 			// Check if this is a transparent color we should skip
-			if (skipTrans && ((srcCol & alphaMask) == transColor))
+			if (args.skipTrans && ((srcCol & args.alphaMask) == args.transColor))
 				continue;
 
-			byte *destVal = (byte *)&destP[destX * format.bytesPerPixel];
+			byte *destVal = &destP[destX * DestBytesPerPixel];
 
-			// When blitting to the same format we can just copy the color
-			if (format.bytesPerPixel == 1) {
-				*destVal = srcCol;
-				continue;
-			} else if (sameFormat && srcAlpha == -1) {
-				if (format.bytesPerPixel == 4)
+			if (copyOnly) {
+				if (DestBytesPerPixel == 1)
+					*destVal = srcCol;
+				else if (DestBytesPerPixel == 4)
 					*(uint32 *)destVal = srcCol;
 				else
 					*(uint16 *)destVal = srcCol;
@@ -324,29 +389,39 @@ void BITMAP::stretchDraw(const BITMAP *srcBitmap, const Common::Rect &srcRect,
 			}
 
 			// We need the rgb values to do blending and/or convert between formats
-			if (src.format.bytesPerPixel == 1) {
-				const RGB& rgb = palette[srcCol];
+			if (SrcBytesPerPixel == 1) {
+				const RGB &rgb = args.palette[srcCol];
 				aSrc = 0xff;
 				rSrc = rgb.r;
 				gSrc = rgb.g;
 				bSrc = rgb.b;
 			} else
-				src.format.colorToARGB(srcCol, aSrc, rSrc, gSrc, bSrc);
+				srcFormat.colorToARGB(srcCol, aSrc, rSrc, gSrc, bSrc);
 
-			if (srcAlpha == -1) {
+			if (args.srcAlpha == -1) {
 				// This means we don't use blending.
 				aDest = aSrc;
 				rDest = rSrc;
 				gDest = gSrc;
 				bDest = bSrc;
 			} else {
-				// TODO: move this to blendPixel to only do it when needed?
-				format.colorToARGB(getColor(destVal, format.bytesPerPixel), aDest, rDest, gDest, bDest);
-				blendPixel(aSrc, rSrc, gSrc, bSrc, aDest, rDest, gDest, bDest, srcAlpha);
+				if (args.useTint) {
+					rDest = rSrc;
+					gDest = gSrc;
+					bDest = bSrc;
+					aDest = aSrc;
+					rSrc = args.tintRed;
+					gSrc = args.tintGreen;
+					bSrc = args.tintBlue;
+					aSrc = args.srcAlpha;
+				} else {
+					format.colorToARGB(getColor(destVal, DestBytesPerPixel), aDest, rDest, gDest, bDest);
+				}
+				blendPixel(aSrc, rSrc, gSrc, bSrc, aDest, rDest, gDest, bDest, args.srcAlpha);
 			}
 
 			uint32 pixel = format.ARGBToColor(aDest, rDest, gDest, bDest);
-			if (format.bytesPerPixel == 4)
+			if (DestBytesPerPixel == 4)
 				*(uint32 *)destVal = pixel;
 			else
 				*(uint16 *)destVal = pixel;
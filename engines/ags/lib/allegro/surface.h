@@ -116,7 +116,27 @@ public:
 	void stretchDraw(const BITMAP *srcBitmap, const Common::Rect &srcRect,
 		const Common::Rect &destRect, bool skipTrans, int srcAlpha);
 
+	/**
+	 * Enables or disables the use of SIMD row kernels by draw and
+	 * stretchDraw, when supported by the CPU. They are enabled by default.
+	 */
+	static void setSIMDEnabled(bool enabled);
+
 private:
+	struct DrawInnerArgs;
+
+	/**
+	 * Runs the drawing loops specialized for the formats of the source
+	 * and destination and for the drawing mode
+	 */
+	void drawInner(DrawInnerArgs &args);
+
+	template<int DestBytesPerPixel, bool Scale>
+	void drawInnerForSrc(const DrawInnerArgs &args);
+
+	template<int DestBytesPerPixel, int SrcBytesPerPixel, bool Scale>
+	void drawInnerGeneric(const DrawInnerArgs &args);
+
 	// True color blender functions
 	// In Allegro all the blender functions are of the form
 	// unsigned int blender_func(unsigned long x, unsigned long y, unsigned long n)
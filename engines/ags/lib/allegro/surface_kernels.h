@@ -0,0 +1,90 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef AGS_LIB_ALLEGRO_SURFACE_KERNELS_H
+#define AGS_LIB_ALLEGRO_SURFACE_KERNELS_H
+
+#include "common/scummsys.h"
+
+namespace AGS3 {
+
+/**
+ * Parameters for blending a row of 32-bit pixels with one of the blenders
+ * built on BITMAP::rgbBlend: kSourceAlphaBlender, kArgbToRgbBlender,
+ * kRgbToRgbBlender and kAlphaPreservedBlenderMode. Source and destination
+ * share a pixel format with 8-bit color channels.
+ */
+struct RgbBlendRowArgs {
+	uint32 rShift, gShift, bShift, aShift;
+
+	/**
+	 * The alpha used for a source pixel is ((aSrc | alphaOr) * alphaMul) >> 8.
+	 * alphaOr is 0xff when the source alpha is not used, and alphaMul is
+	 * 256 when the blender alpha is not used, which covers all the blenders.
+	 */
+	uint32 alphaOr, alphaMul;
+
+	/** Destination bits that are kept, i.e. the alpha bits for kAlphaPreservedBlenderMode */
+	uint32 destKeepMask;
+
+	/** When set, source pixels with (color & transMask) == transColor are skipped */
+	bool skipTrans;
+	uint32 transMask, transColor;
+};
+
+/**
+ * Blend one source pixel onto one destination pixel, with the same double
+ * precision arithmetic as BITMAP::rgbBlend. The SIMD kernels use this for
+ * the pixels left over at the end of a row.
+ */
+inline uint32 rgbBlendPixel(uint32 srcCol, uint32 destCol, const RgbBlendRowArgs &args) {
+	const uint32 alpha = ((((srcCol >> args.aShift) & 0xff) | args.alphaOr) * args.alphaMul) >> 8;
+	const double sAlpha = (double)alpha / 255.0;
+	const uint32 r = (uint32)(((srcCol >> args.rShift) & 0xff) * sAlpha + ((destCol >> args.rShift) & 0xff) * (1. - sAlpha));
+	const uint32 g = (uint32)(((srcCol >> args.gShift) & 0xff) * sAlpha + ((destCol >> args.gShift) & 0xff) * (1. - sAlpha));
+	const uint32 b = (uint32)(((srcCol >> args.bShift) & 0xff) * sAlpha + ((destCol >> args.bShift) & 0xff) * (1. - sAlpha));
+	return (r << args.rShift) | (g << args.gShift) | (b << args.bShift) | (destCol & args.destKeepMask);
+}
+
+/**
+ * Blend a row of source pixels onto the destination pixels.
+ *
+ * @param dest    Destination pixels.
+ * @param src     First source pixel.
+ * @param width   Number of pixels.
+ * @param srcStep Distance in pixels between source pixels, -1 when the
+ *                source is flipped horizontally.
+ * @param args    Blending parameters.
+ */
+typedef void (*RgbBlendRowProc)(uint32 *dest, const uint32 *src, int width, int srcStep, const RgbBlendRowArgs &args);
+
+#ifdef SCUMMVM_SSE2
+void rgbBlendRowSSE2(uint32 *dest, const uint32 *src, int width, int srcStep, const RgbBlendRowArgs &args);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void rgbBlendRowAVX2(uint32 *dest, const uint32 *src, int width, int srcStep, const RgbBlendRowArgs &args);
+#endif
+
+} // namespace AGS3
+
+#endif
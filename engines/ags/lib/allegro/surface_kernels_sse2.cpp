@@ -0,0 +1,90 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "ags/lib/allegro/surface_kernels.h"
+
+#include <emmintrin.h>
+
+namespace AGS3 {
+
+// Two pixels are blended per iteration, with each color channel converted
+// to a pair of doubles. The operations are the same as in rgbBlendPixel,
+// so the results are bit-exact with the scalar blenders.
+
+static inline __m128i loadPixelsSSE2(const uint32 *src, int srcStep) {
+	return _mm_set_epi32(0, 0, (int)src[srcStep], (int)src[0]);
+}
+
+static inline __m128i blendChannelSSE2(__m128i src, __m128i dest, __m128i shift, __m128d sAlpha, __m128d dAlpha) {
+	const __m128i channelMask = _mm_set1_epi32(0xff);
+	const __m128d s = _mm_cvtepi32_pd(_mm_and_si128(_mm_srl_epi32(src, shift), channelMask));
+	const __m128d d = _mm_cvtepi32_pd(_mm_and_si128(_mm_srl_epi32(dest, shift), channelMask));
+	const __m128i c = _mm_cvttpd_epi32(_mm_add_pd(_mm_mul_pd(s, sAlpha), _mm_mul_pd(d, dAlpha)));
+	return _mm_sll_epi32(c, shift);
+}
+
+void rgbBlendRowSSE2(uint32 *dest, const uint32 *src, int width, int srcStep, const RgbBlendRowArgs &args) {
+	const __m128i rShift = _mm_cvtsi32_si128(args.rShift);
+	const __m128i gShift = _mm_cvtsi32_si128(args.gShift);
+	const __m128i bShift = _mm_cvtsi32_si128(args.bShift);
+	const __m128i aShift = _mm_cvtsi32_si128(args.aShift);
+	const __m128i channelMask = _mm_set1_epi32(0xff);
+	const __m128i alphaOr = _mm_set1_epi32(args.alphaOr);
+	const __m128i alphaMul = _mm_set1_epi32(args.alphaMul);
+	const __m128i destKeepMask = _mm_set1_epi32(args.destKeepMask);
+	// Without a transparent color, compare against a value the masked
+	// source can never have
+	const __m128i transMask = _mm_set1_epi32(args.skipTrans ? args.transMask : 0);
+	const __m128i transColor = _mm_set1_epi32(args.skipTrans ? args.transColor : 0xffffffff);
+	const __m128d maxAlpha = _mm_set1_pd(255.0);
+	const __m128d one = _mm_set1_pd(1.0);
+
+	int x = 0;
+	for (; x + 2 <= width; x += 2, dest += 2, src += 2 * srcStep) {
+		const __m128i s = loadPixelsSSE2(src, srcStep);
+		const __m128i d = _mm_loadl_epi64((const __m128i *)dest);
+
+		// Both factors fit in 16 bits, and so does their product
+		__m128i alpha = _mm_or_si128(_mm_and_si128(_mm_srl_epi32(s, aShift), channelMask), alphaOr);
+		alpha = _mm_srli_epi32(_mm_mullo_epi16(alpha, alphaMul), 8);
+		const __m128d sAlpha = _mm_div_pd(_mm_cvtepi32_pd(alpha), maxAlpha);
+		const __m128d dAlpha = _mm_sub_pd(one, sAlpha);
+
+		__m128i result = _mm_and_si128(d, destKeepMask);
+		result = _mm_or_si128(result, blendChannelSSE2(s, d, rShift, sAlpha, dAlpha));
+		result = _mm_or_si128(result, blendChannelSSE2(s, d, gShift, sAlpha, dAlpha));
+		result = _mm_or_si128(result, blendChannelSSE2(s, d, bShift, sAlpha, dAlpha));
+
+		// Leave the destination alone where the source is transparent
+		const __m128i skip = _mm_cmpeq_epi32(_mm_and_si128(s, transMask), transColor);
+		result = _mm_or_si128(_mm_and_si128(skip, d), _mm_andnot_si128(skip, result));
+		_mm_storel_epi64((__m128i *)dest, result);
+	}
+
+	for (; x < width; ++x, ++dest, src += srcStep) {
+		if (args.skipTrans && (*src & args.transMask) == args.transColor)
+			continue;
+		*dest = rgbBlendPixel(*src, *dest, args);
+	}
+}
+
+} // namespace AGS3
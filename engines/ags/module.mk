@@ -281,6 +281,7 @@ MODULE_OBJS = \
 	engine/script/runtimescriptvalue.o \
 	engine/script/script.o \
 	engine/script/script_api.o \
+	engine/script/script_benchmark.o \
 	engine/script/script_engine.o \
 	engine/script/script_runtime.o \
 	engine/script/systemimports.o \
@@ -314,6 +315,20 @@ MODULE_OBJS = \
 	plugins/ags_tcp_ip/ags_tcp_ip.o \
 	plugins/ags_wadjet_util/ags_wadjet_util.o
 
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	lib/allegro/surface_kernels_sse2.o
+
+$(MODULE)/lib/allegro/surface_kernels_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	lib/allegro/surface_kernels_avx2.o
+
+$(MODULE)/lib/allegro/surface_kernels_avx2.o: CXXFLAGS += -mavx2
+endif
+
 ifdef ENABLE_AGS_TESTS
 MODULE_OBJS += \
 	tests/test_all.o \
@@ -322,6 +337,7 @@ MODULE_OBJS += \
 	tests/test_inifile.o \
 	tests/test_math.o \
 	tests/test_memory.o \
+	tests/test_script.o \
 	tests/test_sprintf.o \
 	tests/test_string.o \
 	tests/test_version.o
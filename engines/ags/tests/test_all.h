@@ -39,6 +39,9 @@ extern void Test_Gfx();
 // Memory / bit-byte operations
 extern void Test_Memory();
 
+// Script interpreter tests
+extern void Test_Script();
+
 // String tests
 extern void Test_ScriptSprintf();
 extern void Test_String();
@@ -0,0 +1,305 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "ags/shared/core/platform.h"
+#include "ags/shared/script/cc_options.h"
+#include "ags/shared/script/cc_script.h"
+#include "ags/engine/script/cc_instance.h"
+#include "ags/engine/script/script_benchmark.h"
+#include "ags/engine/script/script_runtime.h"
+
+namespace AGS3 {
+
+// Size of the global data of the test script: an int at 0, and an int at 4
+// also written to byte by byte
+#define TEST_GLOBAL_DATA_SIZE 8
+
+static int32_t FloatBits(float f) {
+	int32_t bits;
+	memcpy(&bits, &f, sizeof(bits));
+	return bits;
+}
+
+// Native function imported by the test script
+static RuntimeScriptValue Test_ScriptMulAdd(const RuntimeScriptValue *params, int32_t param_count) {
+	assert(param_count == 2);
+	return RuntimeScriptValue().SetInt32(params[0].IValue * params[1].IValue + 1);
+}
+
+static ccScript *CreateTestScript() {
+	ScriptAssembler as;
+	int32_t top, exit_jump, jump;
+
+	// int fact(int n), called with SCMD_CALL
+	const int32_t fact = as.Pos();
+	as.Op(SCMD_THISBASE, fact);
+	as.Op(SCMD_LOADSPOFFS, 8);
+	as.Op(SCMD_MEMREAD, SREG_AX);
+	as.Op(SCMD_LITTOREG, SREG_BX, 1);
+	as.Op(SCMD_GREATER, SREG_AX, SREG_BX);
+	jump = as.JumpForward(SCMD_JNZ);
+	as.Op(SCMD_LITTOREG, SREG_AX, 1);
+	as.Op(SCMD_RET);
+	as.SetJumpTarget(jump, as.Pos());
+	as.Op(SCMD_LOADSPOFFS, 8);
+	as.Op(SCMD_MEMREAD, SREG_AX);
+	as.Op(SCMD_SUB, SREG_AX, 1);
+	as.Op(SCMD_PUSHREG, SREG_AX);
+	as.OpFunction(SCMD_LITTOREG, SREG_AX, fact);
+	as.Op(SCMD_CALL, SREG_AX);
+	as.Op(SCMD_SUB, SREG_SP, 4);
+	as.Op(SCMD_LOADSPOFFS, 8);
+	as.Op(SCMD_MEMREAD, SREG_BX);
+	as.Op(SCMD_MULREG, SREG_AX, SREG_BX);
+	as.Op(SCMD_RET);
+
+	// Integer arithmetics, comparisons and branches mixed into a global
+	as.Export("test_arith");
+	as.Op(SCMD_THISBASE, as.Pos());
+	as.OpGlobal(SCMD_LITTOREG, SREG_MAR, 0);
+	as.Op(SCMD_LITTOREG, SREG_AX, 1);
+	as.Op(SCMD_MEMWRITE, SREG_AX);
+	top = as.BeginLoop(100, exit_jump);
+	as.Op(SCMD_LOADSPOFFS, 4);
+	as.Op(SCMD_MEMREAD, SREG_CX);
+	as.OpGlobal(SCMD_LITTOREG, SREG_MAR, 0);
+	as.Op(SCMD_MEMREAD, SREG_BX);
+	as.Op(SCMD_MUL, SREG_BX, 3);
+	as.Op(SCMD_XORREG, SREG_BX, SREG_CX);
+	as.Op(SCMD_REGTOREG, SREG_CX, SREG_DX);
+	as.Op(SCMD_LITTOREG, SREG_AX, 2);
+	as.Op(SCMD_SHIFTLEFT, SREG_DX, SREG_AX);
+	as.Op(SCMD_ADDREG, SREG_BX, SREG_DX);
+	as.Op(SCMD_LITTOREG, SREG_AX, 0xfffff);
+	as.Op(SCMD_BITAND, SREG_BX, SREG_AX);
+	as.Op(SCMD_REGTOREG, SREG_BX, SREG_DX);
+	as.Op(SCMD_LITTOREG, SREG_AX, 97);
+	as.Op(SCMD_MODREG, SREG_DX, SREG_AX);
+	as.Op(SCMD_SUBREG, SREG_BX, SREG_DX);
+	as.Op(SCMD_REGTOREG, SREG_CX, SREG_DX);
+	as.Op(SCMD_ADD, SREG_DX, 1);
+	as.Op(SCMD_REGTOREG, SREG_BX, SREG_AX);
+	as.Op(SCMD_DIVREG, SREG_AX, SREG_DX);
+	as.Op(SCMD_ADDREG, SREG_BX, SREG_AX);
+	as.Op(SCMD_REGTOREG, SREG_BX, SREG_DX);
+	as.Op(SCMD_LITTOREG, SREG_AX, 3);
+	as.Op(SCMD_SHIFTRIGHT, SREG_DX, SREG_AX);
+	as.Op(SCMD_BITOR, SREG_BX, SREG_DX);
+	static const int32_t compares[] = { SCMD_ISEQUAL, SCMD_NOTEQUAL, SCMD_GREATER, SCMD_LESSTHAN, SCMD_GTE, SCMD_LTE };
+	for (int i = 0; i < ARRAYSIZE(compares); ++i) {
+		as.Op(SCMD_REGTOREG, SREG_CX, SREG_DX);
+		as.Op(SCMD_LITTOREG, SREG_AX, 17 * i);
+		as.Op(compares[i], SREG_DX, SREG_AX);
+		as.Op(SCMD_MUL, SREG_DX, 1 << i);
+		as.Op(SCMD_ADDREG, SREG_BX, SREG_DX);
+	}
+	as.Op(SCMD_REGTOREG, SREG_CX, SREG_DX);
+	as.Op(SCMD_LITTOREG, SREG_AX, 3);
+	as.Op(SCMD_MODREG, SREG_DX, SREG_AX);
+	as.Op(SCMD_NOTREG, SREG_DX);
+	as.Op(SCMD_REGTOREG, SREG_CX, SREG_AX);
+	as.Op(SCMD_AND, SREG_DX, SREG_AX);
+	as.Op(SCMD_ADDREG, SREG_BX, SREG_DX);
+	as.Op(SCMD_LITTOREG, SREG_DX, 0);
+	as.Op(SCMD_OR, SREG_DX, SREG_CX);
+	as.Op(SCMD_ADDREG, SREG_BX, SREG_DX);
+	as.Op(SCMD_REGTOREG, SREG_CX, SREG_AX);
+	as.Op(SCMD_LITTOREG, SREG_DX, 4);
+	as.Op(SCMD_BITAND, SREG_AX, SREG_DX);
+	jump = as.JumpForward(SCMD_JNZ);
+	as.Op(SCMD_ADD, SREG_BX, 1000);
+	as.SetJumpTarget(jump, as.Pos());
+	as.OpGlobal(SCMD_LITTOREG, SREG_MAR, 0);
+	as.Op(SCMD_MEMWRITE, SREG_BX);
+	as.EndLoop(top, exit_jump);
+	as.OpGlobal(SCMD_LITTOREG, SREG_MAR, 0);
+	as.Op(SCMD_MEMREAD, SREG_AX);
+	as.Op(SCMD_RET);
+
+	// Float arithmetics and comparisons
+	as.Export("test_float");
+	as.Op(SCMD_THISBASE, as.Pos());
+	as.Op(SCMD_LITTOREG, SREG_AX, FloatBits(1.5f));
+	as.Op(SCMD_LITTOREG, SREG_BX, FloatBits(0.25f));
+	as.Op(SCMD_FMULREG, SREG_AX, SREG_BX);
+	as.Op(SCMD_FADD, SREG_AX, 2);
+	as.Op(SCMD_FADDREG, SREG_AX, SREG_BX);
+	as.Op(SCMD_FDIVREG, SREG_AX, SREG_BX);
+	as.Op(SCMD_FSUB, SREG_AX, 1);
+	as.Op(SCMD_FSUBREG, SREG_AX, SREG_BX);
+	as.Op(SCMD_REGTOREG, SREG_AX, SREG_CX);
+	as.Op(SCMD_FGREATER, SREG_CX, SREG_BX);
+	as.Op(SCMD_REGTOREG, SREG_AX, SREG_DX);
+	as.Op(SCMD_FLTE, SREG_DX, SREG_BX);
+	as.Op(SCMD_ADDREG, SREG_CX, SREG_DX);
+	as.OpGlobal(SCMD_LITTOREG, SREG_MAR, 0);
+	as.Op(SCMD_MEMWRITE, SREG_CX);
+	as.Op(SCMD_RET);
+
+	// Byte and word access to global data, and access to local data through
+	// a stack address
+	as.Export("test_memory");
+	as.Op(SCMD_THISBASE, as.Pos());
+	as.OpGlobal(SCMD_LITTOREG, SREG_MAR, 4);
+	as.Op(SCMD_LITTOREG, SREG_AX, 0x11223344);
+	as.Op(SCMD_MEMWRITE, SREG_AX);
+	as.OpGlobal(SCMD_LITTOREG, SREG_MAR, 4);
+	as.Op(SCMD_ADD, SREG_MAR, 1);
+	as.Op(SCMD_LITTOREG, SREG_AX, 0x1ff);
+	as.Op(SCMD_MEMWRITEB, SREG_AX);
+	as.OpGlobal(SCMD_LITTOREG, SREG_MAR, 4);
+	as.Op(SCMD_ADD, SREG_MAR, 2);
+	as.Op(SCMD_LITTOREG, SREG_AX, 0x2bcd);
+	as.Op(SCMD_MEMWRITEW, SREG_AX);
+	as.OpGlobal(SCMD_LITTOREG, SREG_MAR, 4);
+	as.Op(SCMD_ADD, SREG_MAR, 1);
+	as.Op(SCMD_MEMREADB, SREG_BX);
+	as.OpGlobal(SCMD_LITTOREG, SREG_MAR, 4);
+	as.Op(SCMD_ADD, SREG_MAR, 2);
+	as.Op(SCMD_MEMREADW, SREG_CX);
+	as.Op(SCMD_ADDREG, SREG_BX, SREG_CX);
+	as.Op(SCMD_LITTOREG, SREG_AX, 1234);
+	as.Op(SCMD_PUSHREG, SREG_AX);
+	as.OpStack(SCMD_LITTOREG, SREG_MAR, 4);
+	as.Op(SCMD_MEMREAD, SREG_CX);
+	as.Op(SCMD_ADDREG, SREG_BX, SREG_CX);
+	as.OpStack(SCMD_LITTOREG, SREG_MAR, 4);
+	as.Op(SCMD_LITTOREG, SREG_AX, 99);
+	as.Op(SCMD_MEMWRITE, SREG_AX);
+	as.Op(SCMD_LOADSPOFFS, 4);
+	as.Op(SCMD_MEMREAD, SREG_CX);
+	as.Op(SCMD_ADDREG, SREG_BX, SREG_CX);
+	as.Op(SCMD_POPREG, SREG_CX);
+	as.Op(SCMD_REGTOREG, SREG_BX, SREG_AX);
+	as.Op(SCMD_RET);
+
+	// String literals
+	as.Export("test_strings");
+	as.Op(SCMD_THISBASE, as.Pos());
+	as.Op(SCMD_LITTOREG, SREG_BX, 0);
+	as.OpString(SCMD_LITTOREG, SREG_AX, "abc");
+	as.OpString(SCMD_LITTOREG, SREG_CX, "abc");
+	as.Op(SCMD_STRINGSEQUAL, SREG_AX, SREG_CX);
+	as.Op(SCMD_ADDREG, SREG_BX, SREG_AX);
+	as.OpString(SCMD_LITTOREG, SREG_AX, "abc");
+	as.OpString(SCMD_LITTOREG, SREG_CX, "abd");
+	as.Op(SCMD_STRINGSNOTEQ, SREG_AX, SREG_CX);
+	as.Op(SCMD_MUL, SREG_AX, 2);
+	as.Op(SCMD_ADDREG, SREG_BX, SREG_AX);
+	as.OpString(SCMD_LITTOREG, SREG_AX, "abc");
+	as.OpString(SCMD_LITTOREG, SREG_CX, "abd");
+	as.Op(SCMD_STRINGSEQUAL, SREG_AX, SREG_CX);
+	as.Op(SCMD_MUL, SREG_AX, 4);
+	as.Op(SCMD_ADDREG, SREG_BX, SREG_AX);
+	as.Op(SCMD_REGTOREG, SREG_BX, SREG_AX);
+	as.Op(SCMD_RET);
+
+	// Recursive calls within the script
+	as.Export("test_calls");
+	as.Op(SCMD_THISBASE, as.Pos());
+	as.Op(SCMD_LITTOREG, SREG_AX, 10);
+	as.Op(SCMD_PUSHREG, SREG_AX);
+	as.OpFunction(SCMD_LITTOREG, SREG_AX, fact);
+	as.Op(SCMD_CALL, SREG_AX);
+	as.Op(SCMD_SUB, SREG_SP, 4);
+	as.Op(SCMD_RET);
+
+	// Calls to an imported function
+	as.Export("test_import");
+	as.Op(SCMD_THISBASE, as.Pos());
+	as.Op(SCMD_LITTOREG, SREG_AX, 0);
+	as.Op(SCMD_PUSHREG, SREG_AX);
+	top = as.BeginLoop(10, exit_jump);
+	as.Op(SCMD_LOADSPOFFS, 8);
+	as.Op(SCMD_MEMREAD, SREG_AX);
+	as.Op(SCMD_PUSHREAL, SREG_AX);
+	as.Op(SCMD_LITTOREG, SREG_AX, 3);
+	as.Op(SCMD_PUSHREAL, SREG_AX);
+	as.Op(SCMD_NUMFUNCARGS, 2);
+	as.OpImport(SCMD_LITTOREG, SREG_AX, "Test_ScriptMulAdd");
+	as.Op(SCMD_CALLEXT, SREG_AX);
+	as.Op(SCMD_SUBREALSTACK, 2);
+	as.Op(SCMD_LOADSPOFFS, 8);
+	as.Op(SCMD_MEMWRITE, SREG_AX);
+	as.EndLoop(top, exit_jump);
+	as.Op(SCMD_LOADSPOFFS, 4);
+	as.Op(SCMD_MEMREAD, SREG_AX);
+	as.Op(SCMD_SUB, SREG_SP, 4);
+	as.Op(SCMD_RET);
+
+	return as.CreateScript(TEST_GLOBAL_DATA_SIZE);
+}
+
+// Runs a function of the test script with and without the predecoded
+// byte-code, which must give the same results
+static int Test_RunScriptFunction(ccInstance *inst, const char *name) {
+	int returnValues[2];
+	char globalData[2][TEST_GLOBAL_DATA_SIZE];
+	for (int raw = 0; raw < 2; ++raw) {
+		ccSetOption(SCOPT_NOPREDECODE, raw);
+		memset(inst->globaldata, 0, TEST_GLOBAL_DATA_SIZE);
+		int result = inst->CallScriptFunction(name, 0, nullptr);
+		assert(result == 0);
+		returnValues[raw] = inst->returnValue;
+		memcpy(globalData[raw], inst->globaldata, TEST_GLOBAL_DATA_SIZE);
+	}
+	assert(returnValues[0] == returnValues[1]);
+	assert(memcmp(globalData[0], globalData[1], TEST_GLOBAL_DATA_SIZE) == 0);
+	return returnValues[0];
+}
+
+void Test_Script() {
+	PScript script(CreateTestScript());
+
+	const int autoImport = ccGetOption(SCOPT_AUTOIMPORT);
+	const int noPredecode = ccGetOption(SCOPT_NOPREDECODE);
+	ccSetOption(SCOPT_AUTOIMPORT, 0);
+	ccAddExternalStaticFunction("Test_ScriptMulAdd", Test_ScriptMulAdd);
+	ccInstance *inst = ccInstance::CreateFromScript(script);
+	ccSetOption(SCOPT_AUTOIMPORT, autoImport);
+	assert(inst);
+
+	// The whole script is decoded ahead, and the arguments are stored only
+	// for the instructions which have some
+	int32_t argCount = 0;
+	for (int32_t at = 0; at < inst->codesize; at += inst->code_ops[at].ArgCount + 1) {
+		assert(inst->code_ops[at].Code >= 0);
+		assert(inst->code_ops[at].FirstArg == argCount);
+		argCount += inst->code_ops[at].ArgCount;
+	}
+
+	Test_RunScriptFunction(inst, "test_arith");
+	Test_RunScriptFunction(inst, "test_float");
+	Test_RunScriptFunction(inst, "test_memory");
+	int strings = Test_RunScriptFunction(inst, "test_strings");
+	assert(strings == 3);
+	int fact = Test_RunScriptFunction(inst, "test_calls");
+	assert(fact == 3628800);
+	int mulAdd = Test_RunScriptFunction(inst, "test_import");
+	assert(mulAdd == 29524);
+
+	ccSetOption(SCOPT_NOPREDECODE, noPredecode);
+	delete inst;
+	ccRemoveExternalSymbol("Test_ScriptMulAdd");
+}
+
+} // namespace AGS3
@@ -0,0 +1,232 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/debug.h"
+#include "common/fs.h"
+#include "common/stream.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+#include "engines/detectioncache.h"
+
+namespace Common {
+DECLARE_SINGLETON(DetectionCache);
+}
+
+static const uint32 kCacheFileTag = MKTAG('S', 'V', 'D', 'C');
+static const uint32 kCacheFileVersion = 2;
+static const char *const kCacheFileName = "scummvm-detection.cache";
+
+// The cache is stored in the same directory as the default config file
+static Common::FSNode getCacheFile() {
+	Common::FSNode configFile(g_system->getDefaultConfigFileName());
+	Common::FSNode dir = configFile.getParent();
+	if (dir.isDirectory())
+		return dir.getChild(kCacheFileName);
+
+	// The config file name is relative to the current directory
+	return Common::FSNode(kCacheFileName);
+}
+
+static void writeCacheString(Common::WriteStream &stream, const Common::String &str) {
+	stream.writeUint16BE(str.size());
+	stream.write(str.c_str(), str.size());
+}
+
+static bool readCacheString(Common::SeekableReadStream &stream, Common::String &str) {
+	uint16 size = stream.readUint16BE();
+	if (stream.eos() || stream.err())
+		return false;
+
+	char *buf = new char[size];
+	bool success = (stream.read(buf, size) == size);
+	if (success)
+		str = Common::String(buf, size);
+	delete[] buf;
+	return success;
+}
+
+// Whether the path is the one of a file in the directory, or in one of its subdirectories
+static bool isPathBelow(const Common::String &path, const Common::String &dir) {
+	uint dirSize = dir.size();
+	while (dirSize > 0 && (dir[dirSize - 1] == '/' || dir[dirSize - 1] == '\\'))
+		dirSize--;
+
+	return path.size() > dirSize + 1 && !strncmp(path.c_str(), dir.c_str(), dirSize) &&
+	       (path[dirSize] == '/' || path[dirSize] == '\\');
+}
+
+DetectionCache::DetectionCache() : _loaded(false), _dirty(false), _scanning(false), _hits(0), _misses(0) {
+}
+
+bool DetectionCache::getFileSignature(const Common::FSNode &node, Common::String &signature) {
+	int64 size;
+	uint32 modificationTime;
+	if (!node.getFileAttributes(size, modificationTime))
+		return false;
+
+	signature = Common::String::format("%lld:%u", (long long)size, modificationTime);
+	return true;
+}
+
+bool DetectionCache::lookup(const Common::String &key, const Common::String &signature, FileProperties &fileProps) {
+	load();
+
+	if (_scanning)
+		_scanned[key] = true;
+
+	EntryMap::const_iterator it = _entries.find(key);
+	if (it == _entries.end() || it->_value.signature != signature) {
+		_misses++;
+		return false;
+	}
+
+	fileProps = it->_value.fileProps;
+	_hits++;
+	return true;
+}
+
+void DetectionCache::store(const Common::String &key, const Common::String &path, const Common::String &signature, const FileProperties &fileProps) {
+	load();
+
+	if (_scanning)
+		_scanned[key] = true;
+
+	Entry &entry = _entries[key];
+	entry.path = path;
+	entry.signature = signature;
+	entry.fileProps = fileProps;
+	_dirty = true;
+}
+
+void DetectionCache::clear() {
+	// There is no need to read the stored entries anymore
+	_loaded = true;
+	_entries.clear();
+	_dirty = true;
+}
+
+void DetectionCache::startScan() {
+	_scanning = true;
+	_scanned.clear();
+}
+
+void DetectionCache::finishScan(const Common::String &rootPath) {
+	if (!_scanning)
+		return;
+	_scanning = false;
+
+	uint pruned = 0;
+	for (EntryMap::iterator it = _entries.begin(); it != _entries.end(); ++it) {
+		if (!_scanned.contains(it->_key) && isPathBelow(it->_value.path, rootPath)) {
+			_entries.erase(it);
+			pruned++;
+		}
+	}
+	_scanned.clear();
+
+	if (pruned) {
+		debug(1, "DetectionCache: Dropped %u entries below '%s'", pruned, rootPath.c_str());
+		_dirty = true;
+	}
+}
+
+void DetectionCache::load() {
+	if (_loaded)
+		return;
+	_loaded = true;
+
+	Common::FSNode file = getCacheFile();
+	if (!file.exists())
+		return;
+
+	Common::SeekableReadStream *stream = file.createReadStream();
+	if (!stream)
+		return;
+
+	if (loadFromStream(*stream))
+		debug(1, "DetectionCache: Loaded %u entries from '%s'", _entries.size(), file.getPath().c_str());
+	else
+		debug(1, "DetectionCache: Ignoring '%s', which is truncated or has an unknown format", file.getPath().c_str());
+	delete stream;
+}
+
+bool DetectionCache::loadFromStream(Common::SeekableReadStream &stream) {
+	_entries.clear();
+
+	if (stream.readUint32BE() != kCacheFileTag || stream.readUint32BE() != kCacheFileVersion)
+		return false;
+
+	uint32 count = stream.readUint32BE();
+	for (uint32 i = 0; i < count; i++) {
+		Common::String key;
+		Entry entry;
+		if (!readCacheString(stream, key) || !readCacheString(stream, entry.path) ||
+		    !readCacheString(stream, entry.signature) || !readCacheString(stream, entry.fileProps.md5)) {
+			_entries.clear();
+			return false;
+		}
+		entry.fileProps.size = stream.readSint32BE();
+		_entries[key] = entry;
+	}
+
+	if (stream.eos() || stream.err()) {
+		_entries.clear();
+		return false;
+	}
+	return true;
+}
+
+void DetectionCache::saveToStream(Common::WriteStream &stream) const {
+	stream.writeUint32BE(kCacheFileTag);
+	stream.writeUint32BE(kCacheFileVersion);
+	stream.writeUint32BE(_entries.size());
+	for (EntryMap::const_iterator it = _entries.begin(); it != _entries.end(); ++it) {
+		writeCacheString(stream, it->_key);
+		writeCacheString(stream, it->_value.path);
+		writeCacheString(stream, it->_value.signature);
+		writeCacheString(stream, it->_value.fileProps.md5);
+		stream.writeSint32BE(it->_value.fileProps.size);
+	}
+}
+
+void DetectionCache::flush() {
+	if (!_dirty)
+		return;
+
+	Common::FSNode file = getCacheFile();
+	Common::WriteStream *stream = file.createWriteStream();
+	if (!stream) {
+		debug(1, "DetectionCache: Could not create the cache file");
+		return;
+	}
+
+	saveToStream(*stream);
+	stream->finalize();
+
+	if (stream->err())
+		warning("DetectionCache: Failed to write '%s'", file.getPath().c_str());
+	else
+		_dirty = false;
+
+	delete stream;
+}
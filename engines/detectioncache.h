@@ -0,0 +1,149 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef ENGINES_DETECTIONCACHE_H
+#define ENGINES_DETECTIONCACHE_H
+
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/singleton.h"
+#include "common/str.h"
+
+#include "engines/game.h"
+
+namespace Common {
+class FSNode;
+class SeekableReadStream;
+class WriteStream;
+}
+
+/**
+ * @defgroup engines_detectioncache Detection cache
+ * @ingroup engines
+ *
+ * @brief Persistent cache of the file properties computed by the detection.
+ * @{
+ */
+
+/**
+ * Remembers the MD5 and size computed for the files checked during game
+ * detection, so that scanning the same files again does not need to read
+ * them. The cache is shared by all the detection plugins and is stored next
+ * to the configuration file.
+ *
+ * Each entry is identified by a key, which tells the file and the way its
+ * properties were computed, and holds a signature built from the size and
+ * the modification time of the files involved. An entry is only used while
+ * its signature matches the current one.
+ *
+ * Entries for files which have been removed, or which the detection does
+ * not check anymore, are dropped when a whole directory tree is scanned
+ * again without using them.
+ */
+class DetectionCache : public Common::Singleton<DetectionCache> {
+public:
+	/**
+	 * Build the signature of a file, from its size and modification time.
+	 *
+	 * @return False if the filesystem cannot provide these attributes, in
+	 *         which case the file properties should not be cached.
+	 */
+	static bool getFileSignature(const Common::FSNode &node, Common::String &signature);
+
+	/**
+	 * Look up the properties stored for the given key.
+	 *
+	 * @return True if an entry with the same signature was found.
+	 */
+	bool lookup(const Common::String &key, const Common::String &signature, FileProperties &fileProps);
+
+	/**
+	 * Store the properties computed for the given key.
+	 *
+	 * @param path  Path of the file the properties belong to.
+	 */
+	void store(const Common::String &key, const Common::String &path, const Common::String &signature, const FileProperties &fileProps);
+
+	/** Forget all the stored properties, for the cache to be rebuilt. */
+	void clear();
+
+	/**
+	 * Start tracking the entries used by a scan, for finishScan() to drop
+	 * the ones which were not.
+	 */
+	void startScan();
+
+	/**
+	 * Drop the entries for the files below the given directory which were
+	 * neither looked up nor stored since startScan(). This must only be
+	 * called once the whole directory tree was scanned.
+	 */
+	void finishScan(const Common::String &rootPath);
+
+	/** Write the cache to disk, if it was modified. */
+	void flush();
+
+	/** Replace the entries with the ones read from a stream written by saveToStream(). */
+	bool loadFromStream(Common::SeekableReadStream &stream);
+
+	/** Write all the entries to a stream. */
+	void saveToStream(Common::WriteStream &stream) const;
+
+	/** Number of entries in the cache. */
+	uint size() const { return _entries.size(); }
+
+	/** Number of lookups which found valid properties since the start. */
+	uint getHits() const { return _hits; }
+
+	/** Number of lookups which did not find valid properties since the start. */
+	uint getMisses() const { return _misses; }
+
+private:
+	friend class Common::Singleton<SingletonBaseType>;
+	DetectionCache();
+
+	struct Entry {
+		Common::String path;
+		Common::String signature;
+		FileProperties fileProps;
+	};
+
+	typedef Common::HashMap<Common::String, Entry> EntryMap;
+	typedef Common::HashMap<Common::String, bool> KeySet;
+
+	void load();
+
+	EntryMap _entries;
+	bool _loaded;
+	bool _dirty;
+	bool _scanning;
+	KeySet _scanned;
+	uint _hits;
+	uint _misses;
+};
+
+/** Shortcut for accessing the detection cache. */
+#define DetectionCacheMan DetectionCache::instance()
+
+/** @} */
+
+#endif
@@ -33,7 +33,8 @@
 
 namespace Director {
 
-Channel::Channel(Sprite *sp, int priority) {
+Channel::Channel(Score *sc, Sprite *sp, int priority) {
+	_score = sc;
 	_sprite = sp;
 	_widget = nullptr;
 	_currentPoint = sp->_startPoint;
@@ -271,6 +272,7 @@ void Channel::setCast(uint16 castId) {
 	_width = _sprite->_width;
 	_height = _sprite->_height;
 	replaceWidget();
+	_score->invalidateSpriteIndex();
 }
 
 void Channel::setClean(Sprite *nextSprite, int spriteId, bool partial) {
@@ -310,6 +312,7 @@ void Channel::setClean(Sprite *nextSprite, int spriteId, bool partial) {
 	setEditable(_sprite->_editable);
 
 	_dirty = false;
+	_score->invalidateSpriteIndex();
 }
 
 void Channel::setEditable(bool editable) {
@@ -339,17 +342,21 @@ void Channel::replaceSprite(Sprite *nextSprite) {
 		_width = _sprite->_width;
 		_height = _sprite->_height;
 	}
+
+	_score->invalidateSpriteIndex();
 }
 
 void Channel::setWidth(int w) {
 	if (_sprite->_puppet && _sprite->_stretch) {
 		_width = w;
+		_score->invalidateSpriteIndex();
 	}
 }
 
 void Channel::setHeight(int h) {
 	if (_sprite->_puppet && _sprite->_stretch) {
 		_height = h;
+		_score->invalidateSpriteIndex();
 	}
 }
 
@@ -362,6 +369,23 @@ void Channel::setBbox(int l, int t, int r, int b) {
 		_currentPoint.y = t;
 
 		addRegistrationOffset(_currentPoint, true);
+		_score->invalidateSpriteIndex();
+	}
+}
+
+void Channel::setPosition(int x, int y) {
+	_currentPoint.x = x;
+	_currentPoint.y = y;
+	_score->invalidateSpriteIndex();
+}
+
+void Channel::setStretch(bool stretch) {
+	_sprite->_stretch = stretch;
+
+	if (stretch) {
+		_width = _sprite->_width;
+		_height = _sprite->_height;
+		_score->invalidateSpriteIndex();
 	}
 }
 
@@ -390,6 +414,8 @@ void Channel::replaceWidget() {
 			}
 		}
 	}
+
+	_score->invalidateSpriteIndex();
 }
 
 bool Channel::updateWidget() {
@@ -430,11 +456,10 @@ void Channel::addRegistrationOffset(Common::Point &pos, bool subtract) {
 }
 
 void Channel::addDelta(Common::Point pos) {
-	// TODO: Channel should have a pointer to its score
 	if (_sprite->_moveable &&
 			_constraint > 0 &&
-			_constraint < g_director->getCurrentMovie()->getScore()->_channels.size()) {
-		Common::Rect constraintBbox = g_director->getCurrentMovie()->getScore()->_channels[_constraint]->getBbox();
+			_constraint < _score->_channels.size()) {
+		Common::Rect constraintBbox = _score->_channels[_constraint]->getBbox();
 
 		Common::Rect currentBbox = getBbox();
 		currentBbox.translate(_delta.x + pos.x, _delta.y + pos.y);
@@ -464,6 +489,7 @@ void Channel::addDelta(Common::Point pos) {
 	}
 
 	_delta += pos;
+	_score->invalidateSpriteIndex();
 }
 
 Common::Point Channel::getPosition() {
@@ -33,12 +33,13 @@ namespace Graphics {
 
 namespace Director {
 
+class Score;
 class Sprite;
 class Cursor;
 
 class Channel {
 public:
-	Channel(Sprite *sp, int priority = 0);
+	Channel(Score *sc, Sprite *sp, int priority = 0);
 	~Channel();
 
 	DirectorPlotData getPlotData();
@@ -58,6 +59,8 @@ public:
 	void setWidth(int w);
 	void setHeight(int h);
 	void setBbox(int l, int t, int r, int b);
+	void setPosition(int x, int y);
+	void setStretch(bool stretch);
 	void setCast(uint16 castId);
 	void setClean(Sprite *nextSprite, int spriteId, bool partial = false);
 	void setEditable(bool editable);
@@ -68,6 +71,7 @@ public:
 	void addDelta(Common::Point pos);
 
 public:
+	Score *_score;
 	Sprite *_sprite;
 	Cursor _cursor;
 	Graphics::MacWidget *_widget;
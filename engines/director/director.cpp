@@ -55,6 +55,7 @@ DirectorEngine::DirectorEngine(OSystem *syst, const DirectorGameDescription *gam
 	DebugMan.addDebugChannel(kDebugFewFramesOnly, "fewframesonly", "Only run the first 10 frames");
 	DebugMan.addDebugChannel(kDebugImages, "images", "Image drawing");
 	DebugMan.addDebugChannel(kDebugLingoExec, "lingoexec", "Lingo Execution");
+	DebugMan.addDebugChannel(kDebugLingoProfile, "lingoprofile", "Lingo handler profiling");
 	DebugMan.addDebugChannel(kDebugLoading, "loading", "Loading");
 	DebugMan.addDebugChannel(kDebugNoBytecode, "nobytecode", "Do not execute Lscr bytecode");
 	DebugMan.addDebugChannel(kDebugNoLoop, "noloop", "Do not loop the playback");
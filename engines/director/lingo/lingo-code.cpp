@@ -222,6 +222,13 @@ void LC::c_xpop() {
 
 void Lingo::pushContext(const Symbol funcSym, bool allowRetVal, Datum defaultRetVal) {
 	debugC(5, kDebugLingoExec, "Pushing frame %d", g_lingo->_callstack.size() + 1);
+
+	bool profiling = debugChannelSet(-1, kDebugLingoProfile);
+	if (profiling)
+		updateProfile();
+	else
+		_profileStarted = false;
+
 	CFrame *fp = new CFrame;
 
 	fp->retpc = g_lingo->_pc;
@@ -292,6 +299,9 @@ void Lingo::pushContext(const Symbol funcSym, bool allowRetVal, Datum defaultRet
 
 	g_lingo->_callstack.push_back(fp);
 
+	if (profiling)
+		_handlerProfiles[getProfileName()].calls++;
+
 	if (debugChannelSet(5, kDebugLingoExec)) {
 		g_lingo->printCallStack(0);
 	}
@@ -299,6 +309,12 @@ void Lingo::pushContext(const Symbol funcSym, bool allowRetVal, Datum defaultRet
 
 void Lingo::popContext() {
 	debugC(5, kDebugLingoExec, "Popping frame %d", g_lingo->_callstack.size());
+
+	if (debugChannelSet(-1, kDebugLingoProfile))
+		updateProfile();
+	else
+		_profileStarted = false;
+
 	CFrame *fp = g_lingo->_callstack.back();
 	g_lingo->_callstack.pop_back();
 
@@ -1449,20 +1465,20 @@ void LC::call(const Common::String &name, int nargs, bool allowRetVal) {
 		}
 	}
 
+	// Builtins take precedence over handlers, so look them up first and
+	// skip the handler lookups when one is found. They are not bound when
+	// the script is compiled: with arguments, the same call may turn into
+	// a method call above, depending on the value of the first argument.
+	const SymbolHash &builtins = allowRetVal ? g_lingo->_builtinFuncs : g_lingo->_builtinCmds;
+	SymbolHash::const_iterator it = builtins.find(name);
+	if (it != builtins.end()) {
+		call(it->_value, nargs, allowRetVal);
+		return;
+	}
+
 	// Handler
 	funcSym = g_lingo->getHandler(name);
 
-	// Builtin
-	if (allowRetVal) {
-		if (g_lingo->_builtinFuncs.contains(name)) {
-			funcSym = g_lingo->_builtinFuncs[name];
-		}
-	} else {
-		if (g_lingo->_builtinCmds.contains(name)) {
-			funcSym = g_lingo->_builtinCmds[name];
-		}
-	}
-
 	call(funcSym, nargs, allowRetVal);
 }
 
@@ -1367,14 +1367,14 @@ void Lingo::setTheSprite(Datum &id1, int field, Datum &d) {
 	case kTheLocH:
 		if (d.asInt() != channel->_currentPoint.x) {
 			g_director->getCurrentMovie()->getWindow()->addDirtyRect(channel->getBbox());
-			channel->_currentPoint.x = d.asInt();
+			channel->setPosition(d.asInt(), channel->_currentPoint.y);
 			channel->_dirty = true;
 		}
 		break;
 	case kTheLocV:
 		if (d.asInt() != channel->_currentPoint.y) {
 			g_director->getCurrentMovie()->getWindow()->addDirtyRect(channel->getBbox());
-			channel->_currentPoint.y = d.asInt();
+			channel->setPosition(channel->_currentPoint.x, d.asInt());
 			channel->_dirty = true;
 		}
 		break;
@@ -1424,15 +1424,11 @@ void Lingo::setTheSprite(Datum &id1, int field, Datum &d) {
 		break;
 	case kTheStretch:
 		if (d.asInt() != sprite->_stretch) {
-			sprite->_stretch = d.asInt();
-			channel->_dirty = true;
-
-			if (sprite->_stretch) {
+			if (d.asInt())
 				g_director->getCurrentWindow()->addDirtyRect(channel->getBbox());
 
-				channel->_width = sprite->_width;
-				channel->_height = sprite->_height;
-			}
+			channel->setStretch(d.asInt());
+			channel->_dirty = true;
 		}
 		break;
 	case kTheTrails:
@@ -1522,6 +1518,10 @@ void Lingo::setTheCast(Datum &id1, int field, Datum &d) {
 	}
 
 	member->setField(field, d);
+
+	// The cast member dimensions determine the bounding box of its sprites
+	if (movie->getScore())
+		movie->getScore()->invalidateSpriteIndex();
 }
 
 Datum Lingo::getTheField(Datum &id1, int field) {
@@ -20,7 +20,9 @@
  *
  */
 
+#include "common/algorithm.h"
 #include "common/file.h"
+#include "common/system.h"
 #include "common/config-manager.h"
 
 #include "graphics/macgui/macwindowmanager.h"
@@ -151,6 +153,9 @@ Lingo::Lingo(DirectorEngine *vm) : _vm(vm) {
 
 	_currentChannelId = -1;
 	_globalCounter = 0;
+	_profileTime = 0;
+	_profileCounter = 0;
+	_profileStarted = false;
 	_pc = 0;
 	_abort = false;
 	_indef = kStateNone;
@@ -195,6 +200,7 @@ Lingo::Lingo(DirectorEngine *vm) : _vm(vm) {
 }
 
 Lingo::~Lingo() {
+	printHandlerProfiles();
 	resetLingo();
 	cleanupFuncs();
 	cleanupMethods();
@@ -240,8 +246,11 @@ Common::String LingoArchive::getName(uint16 id) {
 Symbol Lingo::getHandler(const Common::String &name) {
 	if (!_eventHandlerTypeIds.contains(name)) {
 		// local functions
-		if (_currentScriptContext && _currentScriptContext->_functionHandlers.contains(name))
-			return _currentScriptContext->_functionHandlers[name];
+		if (_currentScriptContext) {
+			SymbolHash::const_iterator it = _currentScriptContext->_functionHandlers.find(name);
+			if (it != _currentScriptContext->_functionHandlers.end())
+				return it->_value;
+		}
 
 		Symbol sym = g_director->getCurrentMovie()->getHandler(name);
 		if (sym.type != VOIDSYM)
@@ -575,40 +584,66 @@ Common::String Lingo::decodeInstruction(LingoArchive *archive, ScriptData *sd, u
 	return res;
 }
 
+Common::String Lingo::getProfileName() {
+	const Symbol &sp = _callstack.back()->sp;
+	Common::String name = sp.name ? *sp.name : "<anonymous>";
+	if (sp.ctx)
+		return sp.ctx->getName() + ": " + name;
+	return name;
+}
+
 void Lingo::execute(uint pc) {
 	uint localCounter = 0;
 
+	// The debug settings are only checked again when another script is
+	// entered, so that the common case does not pay for them on every
+	// instruction.
+	ScriptData *script = nullptr;
+	bool fewFramesOnly = false;
+	bool traceExec = false;
+
 	for (_pc = pc; !_abort && (*_currentScript)[_pc] != STOP;) {
-		if (_globalCounter > 1000 && debugChannelSet(-1, kDebugFewFramesOnly)) {
+		if (script != _currentScript) {
+			script = _currentScript;
+			fewFramesOnly = debugChannelSet(-1, kDebugFewFramesOnly);
+			traceExec = debugChannelSet(1, kDebugLingoExec);
+		}
+
+		if (fewFramesOnly && _globalCounter > 1000) {
 			warning("Lingo::execute(): Stopping due to debug few frames only");
 			_vm->getCurrentMovie()->getScore()->_playState = kPlayStopped;
 			break;
 		}
-	
-		Common::String instr = decodeInstruction(_currentArchive, _currentScript, _pc);
-		uint current = _pc;
-
-		if (debugChannelSet(5, kDebugLingoExec))
-			printStack("Stack before: ", current);
-
-		if (debugChannelSet(9, kDebugLingoExec)) {
-			debug("Vars before");
-			printAllVars();
-			if (_currentMe.type == OBJECT)
-				debug("me: %s", _currentMe.asString(true).c_str());
-		}
 
-		debugC(1, kDebugLingoExec, "[%3d]: %s", current, instr.c_str());
+		if (traceExec) {
+			Common::String instr = decodeInstruction(_currentArchive, _currentScript, _pc);
+			uint current = _pc;
+
+			if (debugChannelSet(5, kDebugLingoExec))
+				printStack("Stack before: ", current);
+
+			if (debugChannelSet(9, kDebugLingoExec)) {
+				debug("Vars before");
+				printAllVars();
+				if (_currentMe.type == OBJECT)
+					debug("me: %s", _currentMe.asString(true).c_str());
+			}
+
+			debugC(1, kDebugLingoExec, "[%3d]: %s", current, instr.c_str());
 
-		_pc++;
-		(*((*_currentScript)[_pc - 1]))();
+			_pc++;
+			(*((*_currentScript)[_pc - 1]))();
 
-		if (debugChannelSet(5, kDebugLingoExec))
-			printStack("Stack after: ", current);
+			if (debugChannelSet(5, kDebugLingoExec))
+				printStack("Stack after: ", current);
 
-		if (debugChannelSet(9, kDebugLingoExec)) {
-			debug("Vars after");
-			printAllVars();
+			if (debugChannelSet(9, kDebugLingoExec)) {
+				debug("Vars after");
+				printAllVars();
+			}
+		} else {
+			_pc++;
+			(*((*_currentScript)[_pc - 1]))();
 		}
 
 		if (!_abort && _pc >= (*_currentScript).size()) {
@@ -630,6 +665,45 @@ void Lingo::execute(uint pc) {
 	_abort = false;
 }
 
+void Lingo::updateProfile() {
+	// Charge the handler on top of the call stack with what was executed
+	// since it was last resumed. Handlers it calls are charged separately,
+	// so that nested and recursive calls are not counted twice.
+	// When profiling was switched on while a handler was running, nothing
+	// is known about that handler until the next call or return.
+	uint32 now = g_system->getMillis();
+	if (_profileStarted && !_callstack.empty()) {
+		HandlerProfile &profile = _handlerProfiles[getProfileName()];
+		profile.instructions += _globalCounter - _profileCounter;
+		profile.millis += now - _profileTime;
+	}
+	_profileTime = now;
+	_profileCounter = _globalCounter;
+	_profileStarted = true;
+}
+
+static bool compareHandlerProfiles(const Common::HashMap<Common::String, HandlerProfile>::const_iterator &a,
+		const Common::HashMap<Common::String, HandlerProfile>::const_iterator &b) {
+	return a->_value.millis > b->_value.millis;
+}
+
+void Lingo::printHandlerProfiles() {
+	if (_handlerProfiles.empty())
+		return;
+
+	Common::Array<Common::HashMap<Common::String, HandlerProfile>::const_iterator> profiles;
+	for (Common::HashMap<Common::String, HandlerProfile>::const_iterator it = _handlerProfiles.begin(); it != _handlerProfiles.end(); ++it)
+		profiles.push_back(it);
+	Common::sort(profiles.begin(), profiles.end(), compareHandlerProfiles);
+
+	debug("Lingo handler profile:");
+	debug("%8s %12s %8s  %s", "calls", "instructions", "ms", "handler");
+	for (uint i = 0; i < profiles.size(); i++) {
+		const HandlerProfile &profile = profiles[i]->_value;
+		debug("%8u %12llu %8u  %s", profile.calls, (unsigned long long)profile.instructions, profile.millis, profiles[i]->_key.c_str());
+	}
+}
+
 void Lingo::executeScript(ScriptType type, uint16 id) {
 	Movie *movie = _vm->getCurrentMovie();
 	if (!movie) {
@@ -194,6 +194,14 @@ struct CFrame {	/* proc/func call stack frame */
 	Datum defaultRetVal;		/* default return value */
 };
 
+struct HandlerProfile {	/* per-handler execution statistics */
+	uint calls;				/* number of times the handler was called */
+	uint64 instructions;	/* number of instructions executed in the handler */
+	uint32 millis;			/* milliseconds spent in the handler itself, builtins included */
+
+	HandlerProfile() : calls(0), instructions(0), millis(0) {}
+};
+
 struct LingoEvent {
 	LEvent event;
 	int eventId;
@@ -252,6 +260,7 @@ public:
 	void executeScript(ScriptType type, uint16 id);
 	void printStack(const char *s, uint pc);
 	void printCallStack(uint pc);
+	void printHandlerProfiles();
 	Common::String decodeInstruction(LingoArchive *archive, ScriptData *sd, uint pc, uint *newPC = NULL);
 
 	void reloadBuiltIns();
@@ -292,6 +301,8 @@ public:
 
 public:
 	void execute(uint pc);
+	void updateProfile();
+	Common::String getProfileName();
 	void pushContext(const Symbol funcSym, bool allowRetVal, Datum defaultRetVal);
 	void popContext();
 	void cleanLocalVars();
@@ -468,6 +479,12 @@ public:
 	uint _globalCounter;
 	uint _pc;
 
+	// Filled when the lingoprofile debug channel is enabled
+	Common::HashMap<Common::String, HandlerProfile> _handlerProfiles;
+	uint32 _profileTime;	// when the handler on top of the call stack was last resumed
+	uint _profileCounter;	// value of _globalCounter at that time
+	bool _profileStarted;	// whether both were recorded since profiling was last switched on
+
 	StackData _stack;
 
 	DirectorEngine *_vm;
@@ -17,6 +17,7 @@ MODULE_OBJS = \
 	score.o \
 	sound.o \
 	sprite.o \
+	spriteindex.o \
 	stxt.o \
 	tests.o \
 	transitions.o \
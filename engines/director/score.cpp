@@ -75,6 +75,7 @@ Score::Score(Movie *movie) {
 	_playState = kPlayNotStarted;
 
 	_numChannelsDisplayed = 0;
+	_spriteIndexDirty = true;
 
 	_framesRan = 0; // used by kDebugFewFramesOnly and kDebugScreenshot
 }
@@ -263,7 +264,9 @@ void Score::startPlay() {
 	// All frames in the same movie have the same number of channels
 	if (_playState != kPlayStopped)
 		for (uint i = 0; i < _frames[1]->_sprites.size(); i++)
-			_channels.push_back(new Channel(_frames[1]->_sprites[i], i));
+			_channels.push_back(new Channel(this, _frames[1]->_sprites[i], i));
+
+	invalidateSpriteIndex();
 
 	if (_vm->getVersion() >= 300)
 		_movie->processEvent(kEventStartMovie);
@@ -522,9 +525,10 @@ void Score::renderCursor(Common::Point pos) {
 	if (_channels.empty())
 		return;
 
-	for (int i = _channels.size() - 1; i >=0; i--)
-		if (_channels[i]->isMouseIn(pos) && !_channels[i]->_cursor.isEmpty())
-			spriteId = i;
+	const Common::Array<uint16> &ids = getSpritesAtPos(pos);
+	for (int i = ids.size() - 1; i >= 0; i--)
+		if (_channels[ids[i]]->isMouseIn(pos) && !_channels[ids[i]]->_cursor.isEmpty())
+			spriteId = ids[i];
 
 	if (_channels[spriteId]->_cursor.isEmpty()) {
 		if (_currentCursor) {
@@ -565,26 +569,42 @@ void Score::screenShot() {
 	newSurface->free();
 }
 
+void Score::updateSpriteIndex() {
+	if (_spriteIndexDirty) {
+		_spriteIndex.update(_channels, Common::Rect(_window->getSurface()->w, _window->getSurface()->h));
+		_spriteIndexDirty = false;
+	}
+}
+
+const Common::Array<uint16> &Score::getSpritesAtPos(const Common::Point &pos) {
+	updateSpriteIndex();
+
+	return _spriteIndex.findChannels(pos);
+}
+
 uint16 Score::getSpriteIDFromPos(Common::Point pos) {
-	for (int i = _channels.size() - 1; i >= 0; i--)
-		if (_channels[i]->isMouseIn(pos))
-			return i;
+	const Common::Array<uint16> &ids = getSpritesAtPos(pos);
+	for (int i = ids.size() - 1; i >= 0; i--)
+		if (_channels[ids[i]]->isMouseIn(pos))
+			return ids[i];
 
 	return 0;
 }
 
 uint16 Score::getMouseSpriteIDFromPos(Common::Point pos) {
-	for (int i = _channels.size() - 1; i >= 0; i--)
-		if (_channels[i]->isMouseIn(pos) && _channels[i]->_sprite->respondsToMouse())
-			return i;
+	const Common::Array<uint16> &ids = getSpritesAtPos(pos);
+	for (int i = ids.size() - 1; i >= 0; i--)
+		if (_channels[ids[i]]->isMouseIn(pos) && _channels[ids[i]]->_sprite->respondsToMouse())
+			return ids[i];
 
 	return 0;
 }
 
 uint16 Score::getActiveSpriteIDFromPos(Common::Point pos) {
-	for (int i = _channels.size() - 1; i >= 0; i--)
-		if (_channels[i]->isMouseIn(pos) && _channels[i]->_sprite->isActive())
-			return i;
+	const Common::Array<uint16> &ids = getSpritesAtPos(pos);
+	for (int i = ids.size() - 1; i >= 0; i--)
+		if (_channels[ids[i]]->isMouseIn(pos) && _channels[ids[i]]->_sprite->isActive())
+			return ids[i];
 
 	return 0;
 }
@@ -596,15 +616,17 @@ bool Score::checkSpriteIntersection(uint16 spriteId, Common::Point pos) {
 	return false;
 }
 
-Common::List<Channel *> Score::getSpriteIntersections(const Common::Rect &r) {
-	Common::List<Channel *>intersections;
+void Score::getSpriteIntersections(const Common::Rect &r, Common::Array<Channel *> &intersections) {
+	updateSpriteIndex();
 
-	for (uint i = 0; i < _channels.size(); i++) {
-		if (!_channels[i]->isEmpty() && !r.findIntersectingRect(_channels[i]->getBbox()).isEmpty())
-			intersections.push_back(_channels[i]);
-	}
+	intersections.resize(0);
+	_spriteIndex.findChannels(r, _spriteIndexIds);
 
-	return intersections;
+	for (uint i = 0; i < _spriteIndexIds.size(); i++) {
+		Channel *channel = _channels[_spriteIndexIds[i]];
+		if (!channel->isEmpty() && !r.findIntersectingRect(channel->getBbox()).isEmpty())
+			intersections.push_back(channel);
+	}
 }
 
 Sprite *Score::getSpriteById(uint16 id) {
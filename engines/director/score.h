@@ -25,6 +25,8 @@
 
 //#include "graphics/macgui/macwindowmanager.h"
 
+#include "director/spriteindex.h"
+
 namespace Graphics {
 	struct Surface;
 	class ManagedSurface;
@@ -104,7 +106,11 @@ public:
 	uint16 getMouseSpriteIDFromPos(Common::Point pos);
 	uint16 getActiveSpriteIDFromPos(Common::Point pos);
 	bool checkSpriteIntersection(uint16 spriteId, Common::Point pos);
-	Common::List<Channel *> getSpriteIntersections(const Common::Rect &r);
+	void getSpriteIntersections(const Common::Rect &r, Common::Array<Channel *> &intersections);
+
+	// Must be called when the bounding box of a channel may have changed
+	// outside of renderSprites()
+	void invalidateSpriteIndex() { _spriteIndexDirty = true; }
 
 	bool renderTransition(uint16 frameId);
 	void renderFrame(uint16 frameId, RenderMode mode = kRenderModeNormal);
@@ -116,6 +122,9 @@ private:
 
 	void playSoundChannel(uint16 frameId);
 
+	void updateSpriteIndex();
+	const Common::Array<uint16> &getSpritesAtPos(const Common::Point &pos);
+
 	void screenShot();
 
 	bool processImmediateFrameScript(Common::String s, int id);
@@ -156,6 +165,10 @@ private:
 	uint16 _nextFrame;
 	int _currentLabel;
 	DirectorSound *_soundManager;
+
+	SpriteIndex _spriteIndex;
+	bool _spriteIndexDirty;
+	Common::Array<uint16> _spriteIndexIds;
 };
 
 } // End of namespace Director
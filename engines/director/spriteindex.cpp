@@ -0,0 +1,181 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/algorithm.h"
+
+#include "director/director.h"
+#include "director/channel.h"
+#include "director/spriteindex.h"
+
+namespace Director {
+
+// Size in pixels of the grid cells
+#define SPRITE_INDEX_CELL_SIZE 64
+
+static bool isIndexed(const Common::Rect &bbox) {
+	return bbox.isValidRect() && !bbox.isEmpty();
+}
+
+static void insertSorted(Common::Array<uint16> &ids, uint16 id) {
+	uint i = ids.size();
+	while (i > 0 && ids[i - 1] > id)
+		i--;
+	ids.insert_at(i, id);
+}
+
+static void removeSorted(Common::Array<uint16> &ids, uint16 id) {
+	for (uint i = 0; i < ids.size(); i++) {
+		if (ids[i] == id) {
+			ids.remove_at(i);
+			return;
+		}
+	}
+}
+
+SpriteIndex::SpriteIndex() {
+	_cols = _rows = 0;
+	_mark = 0;
+}
+
+void SpriteIndex::clear() {
+	_cells.clear();
+	_outside.clear();
+	_bboxes.clear();
+	_marks.clear();
+	_bounds = Common::Rect();
+	_cols = _rows = 0;
+}
+
+void SpriteIndex::update(const Common::Array<Channel *> &channels, const Common::Rect &bounds) {
+	if (bounds != _bounds || channels.size() != _bboxes.size()) {
+		clear();
+
+		_bounds = bounds;
+		_cols = (bounds.width() + SPRITE_INDEX_CELL_SIZE - 1) / SPRITE_INDEX_CELL_SIZE;
+		_rows = (bounds.height() + SPRITE_INDEX_CELL_SIZE - 1) / SPRITE_INDEX_CELL_SIZE;
+		_cells.resize(_cols * _rows);
+
+		_bboxes.resize(channels.size());
+		_marks.resize(channels.size());
+	}
+
+	for (uint i = 0; i < channels.size(); i++) {
+		Common::Rect bbox = channels[i]->getBbox();
+		if (bbox == _bboxes[i])
+			continue;
+
+		remove(i, _bboxes[i]);
+		insert(i, bbox);
+		_bboxes[i] = bbox;
+	}
+}
+
+bool SpriteIndex::getCellRange(const Common::Rect &r, Common::Rect &cells) const {
+	Common::Rect clipped(r);
+	clipped.clip(_bounds);
+	if (clipped.isEmpty())
+		return false;
+
+	cells.left = (clipped.left - _bounds.left) / SPRITE_INDEX_CELL_SIZE;
+	cells.top = (clipped.top - _bounds.top) / SPRITE_INDEX_CELL_SIZE;
+	cells.right = (clipped.right - 1 - _bounds.left) / SPRITE_INDEX_CELL_SIZE + 1;
+	cells.bottom = (clipped.bottom - 1 - _bounds.top) / SPRITE_INDEX_CELL_SIZE + 1;
+	return true;
+}
+
+void SpriteIndex::insert(uint16 id, const Common::Rect &bbox) {
+	if (!isIndexed(bbox))
+		return;
+
+	Common::Rect cells;
+	if (getCellRange(bbox, cells)) {
+		for (int y = cells.top; y < cells.bottom; y++)
+			for (int x = cells.left; x < cells.right; x++)
+				insertSorted(_cells[y * _cols + x], id);
+	}
+
+	if (!_bounds.contains(bbox))
+		insertSorted(_outside, id);
+}
+
+void SpriteIndex::remove(uint16 id, const Common::Rect &bbox) {
+	if (!isIndexed(bbox))
+		return;
+
+	Common::Rect cells;
+	if (getCellRange(bbox, cells)) {
+		for (int y = cells.top; y < cells.bottom; y++)
+			for (int x = cells.left; x < cells.right; x++)
+				removeSorted(_cells[y * _cols + x], id);
+	}
+
+	if (!_bounds.contains(bbox))
+		removeSorted(_outside, id);
+}
+
+const Common::Array<uint16> &SpriteIndex::findChannels(const Common::Point &pos) const {
+	if (!_bounds.contains(pos))
+		return _outside;
+
+	int x = (pos.x - _bounds.left) / SPRITE_INDEX_CELL_SIZE;
+	int y = (pos.y - _bounds.top) / SPRITE_INDEX_CELL_SIZE;
+	return _cells[y * _cols + x];
+}
+
+void SpriteIndex::findChannels(const Common::Rect &r, Common::Array<uint16> &ids) {
+	ids.resize(0);
+
+	if (++_mark == 0) {
+		// The marks wrapped around, so the old ones could match again
+		for (uint i = 0; i < _marks.size(); i++)
+			_marks[i] = 0;
+		_mark = 1;
+	}
+
+	Common::Rect cells;
+	if (getCellRange(r, cells)) {
+		for (int y = cells.top; y < cells.bottom; y++) {
+			for (int x = cells.left; x < cells.right; x++) {
+				const Common::Array<uint16> &cell = _cells[y * _cols + x];
+				for (uint i = 0; i < cell.size(); i++) {
+					if (_marks[cell[i]] != _mark) {
+						_marks[cell[i]] = _mark;
+						ids.push_back(cell[i]);
+					}
+				}
+			}
+		}
+	}
+
+	if (!_bounds.contains(r)) {
+		for (uint i = 0; i < _outside.size(); i++) {
+			if (_marks[_outside[i]] != _mark) {
+				_marks[_outside[i]] = _mark;
+				ids.push_back(_outside[i]);
+			}
+		}
+	}
+
+	Common::sort(ids.begin(), ids.end());
+}
+
+} // End of namespace Director
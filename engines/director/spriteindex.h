@@ -0,0 +1,86 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef DIRECTOR_SPRITEINDEX_H
+#define DIRECTOR_SPRITEINDEX_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Director {
+
+class Channel;
+
+/**
+ * Uniform grid over the stage, which tells the channels whose bounding box
+ * may intersect a given point or rectangle, without going through all the
+ * channels of the score.
+ *
+ * Every cell lists the channels overlapping it, by increasing channel number,
+ * so that the candidates keep the drawing order. Channels extending beyond
+ * the stage are also listed separately, for the queries outside of it.
+ *
+ * The bounding boxes are only read in update(), which moves the channels
+ * whose box has changed since the previous call.
+ */
+class SpriteIndex {
+public:
+	SpriteIndex();
+
+	/**
+	 * Bring the index up to date with the current bounding boxes.
+	 * @param channels the channels of the score
+	 * @param bounds the area covered by the grid, usually the stage
+	 */
+	void update(const Common::Array<Channel *> &channels, const Common::Rect &bounds);
+
+	/** Forget all the channels, for them to be indexed again by the next update. */
+	void clear();
+
+	/** The channels which may contain the given point, by increasing channel number. */
+	const Common::Array<uint16> &findChannels(const Common::Point &pos) const;
+
+	/** The channels which may intersect the given rectangle, by increasing channel number. */
+	void findChannels(const Common::Rect &r, Common::Array<uint16> &ids);
+
+private:
+	void insert(uint16 id, const Common::Rect &bbox);
+	void remove(uint16 id, const Common::Rect &bbox);
+	bool getCellRange(const Common::Rect &r, Common::Rect &cells) const;
+
+	Common::Rect _bounds;
+	int _cols;
+	int _rows;
+
+	Common::Array<Common::Array<uint16> > _cells;
+	Common::Array<uint16> _outside;	// channels extending beyond _bounds
+
+	Common::Array<Common::Rect> _bboxes;	// the box each channel is indexed with
+
+	// Used to report each channel once in rectangle queries
+	Common::Array<uint32> _marks;
+	uint32 _mark;
+};
+
+} // End of namespace Director
+
+#endif
@@ -118,9 +118,9 @@ bool Window::render(bool forceRedraw, Graphics::ManagedSurface *blitTo) {
 		const Common::Rect &r = *i;
 		blitTo->fillRect(r, _stageColor);
 
-		_dirtyChannels = _currentMovie->getScore()->getSpriteIntersections(r);
+		_currentMovie->getScore()->getSpriteIntersections(r, _dirtyChannels);
 		for (int pass = 0; pass < 2; pass++) {
-			for (Common::List<Channel *>::iterator j = _dirtyChannels.begin(); j != _dirtyChannels.end(); j++) {
+			for (Common::Array<Channel *>::iterator j = _dirtyChannels.begin(); j != _dirtyChannels.end(); j++) {
 				if ((*j)->isActiveVideo() && (*j)->isVideoDirectToStage()) {
 					if (pass == 0)
 						continue;
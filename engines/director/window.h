@@ -162,7 +162,7 @@ class Window : public Graphics::MacWindow, public Object<Window> {
 	bool setField(int field, const Datum &value) override;
 
 public:
-	Common::List<Channel *> _dirtyChannels;
+	Common::Array<Channel *> _dirtyChannels;
 	TransParams *_puppetTransition;
 
 	MovieReference _nextMovie;
@@ -22,6 +22,7 @@
 
 #include "common/config-manager.h"
 #include "graphics/renderer.h"
+#include "graphics/tinygl/gl.h"
 
 #include "engines/grim/debugger.h"
 #include "engines/grim/md5check.h"
@@ -38,6 +39,7 @@ Debugger::Debugger() :
 	registerCmd("set_renderer", WRAP_METHOD(Debugger, cmd_set_renderer));
 	registerCmd("save", WRAP_METHOD(Debugger, cmd_save));
 	registerCmd("load", WRAP_METHOD(Debugger, cmd_load));
+	registerCmd("tinygl_vertex_bench", WRAP_METHOD(Debugger, cmd_tinygl_vertex_bench));
 }
 
 Debugger::~Debugger() {
@@ -127,4 +129,32 @@ bool Debugger::cmd_load(int argc, const char **argv) {
 	return true;
 }
 
+bool Debugger::cmd_tinygl_vertex_bench(int argc, const char **argv) {
+	// Typical sizes of a Grim Fandango actor, of an Escape from Monkey Island
+	// actor and of a whole set of meshes
+	int sizes[] = { 500, 2000, 8000 };
+	int sizeCount = ARRAYSIZE(sizes);
+
+	if (argc > 1) {
+		sizes[0] = atoi(argv[1]);
+		sizeCount = 1;
+		if (sizes[0] <= 0) {
+			debugPrintf("Usage: tinygl_vertex_bench [vertices]\n");
+			debugPrintf("Transforms and lights a mesh with the generic and the SIMD vertex kernels\n");
+			return true;
+		}
+	}
+
+	for (int i = 0; i < sizeCount; i++) {
+		// About two million vertices for each size
+		int iterations = MAX(1, 2000000 / sizes[i]);
+		TinyGL::VertexBenchmark result;
+		TinyGL::tglBenchmarkVertexKernels(sizes[i], iterations, result);
+		debugPrintf("%d vertices, %d iterations: %d ms generic, %d ms SIMD, output %s\n",
+			result.vertices, result.iterations, result.genericTime, result.simdTime,
+			result.identical ? "identical" : "DIFFERS");
+	}
+	return true;
+}
+
 }
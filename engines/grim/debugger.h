@@ -40,6 +40,7 @@ public:
 	bool cmd_set_renderer(int argc, const char **argv);
 	bool cmd_save(int argc, const char **argv);
 	bool cmd_load(int argc, const char **argv);
+	bool cmd_tinygl_vertex_bench(int argc, const char **argv);
 };
 
 }
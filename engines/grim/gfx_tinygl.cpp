@@ -22,6 +22,7 @@
 
 #include "common/config-manager.h"
 #include "common/endian.h"
+#include "common/hashmap.h"
 #include "common/system.h"
 
 #include "graphics/surface.h"
@@ -48,6 +49,21 @@ GfxBase *CreateGfxTinyGL() {
 	return new GfxTinyGL();
 }
 
+// Vertex arrays of a Grim mesh. Each pair of vertex and texture vertex used
+// by the faces becomes one array element, so that the runs of faces sharing
+// a material can be drawn with a single tglDrawElements call, which
+// transforms and lights each element only once.
+struct TinyGLMeshData {
+	Common::Array<float> _vertices;
+	Common::Array<float> _normals;
+	Common::Array<float> _texCoords;
+
+	// The triangles of face i are _indices[_faceStart[i]] to
+	// _indices[_faceStart[i + 1]]
+	Common::Array<uint32> _indices;
+	Common::Array<uint32> _faceStart;
+};
+
 GfxTinyGL::GfxTinyGL() :
 		_zb(nullptr), _alpha(1.f),
 		_currentActor(nullptr), _smushImage(nullptr) {
@@ -613,8 +629,25 @@ void GfxTinyGL::getShadowColor(byte *r, byte *g, byte *b) {
 	*b = _shadowColorB;
 }
 
+void GfxTinyGL::createEMIModel(EMIModel *model) {
+	// Colors of the vertices, computed for each face as the lighting
+	// depends on its flags
+	model->_userData = new float[4 * model->_numVertices];
+}
+
+void GfxTinyGL::destroyEMIModel(EMIModel *model) {
+	delete[] (float *)model->_userData;
+	model->_userData = nullptr;
+}
+
+// Unlike drawMesh(), this does not batch faces: an EMI face already holds all
+// the triangles of one material group, and draws them with a single
+// tglDrawElements call. Merging the groups which share a texture would need
+// EMIModel::draw() to hand the whole model to the driver, instead of
+// selecting the material of each face itself.
 void GfxTinyGL::drawEMIModelFace(const EMIModel *model, const EMIMeshFace *face) {
 	uint16 *indices = (uint16 *)face->_indexes;
+	float *colors = (float *)model->_userData;
 
 	tglEnable(TGL_DEPTH_TEST);
 	tglDisable(TGL_ALPHA_TEST);
@@ -626,34 +659,47 @@ void GfxTinyGL::drawEMIModelFace(const EMIModel *model, const EMIMeshFace *face)
 	if (face->_flags & EMIMeshFace::kAlphaBlend || face->_flags & EMIMeshFace::kUnknownBlend || _currentActor->hasLocalAlpha() || _alpha < 1.0f)
 		tglEnable(TGL_BLEND);
 
-	tglBegin(TGL_TRIANGLES);
 	float alpha = _alpha;
 	if (model->_meshAlphaMode == Actor::AlphaReplace) {
 		alpha *= model->_meshAlpha;
 	}
 	Math::Vector3d noLighting(1.f, 1.f, 1.f);
-	for (uint j = 0; j < face->_faceLength * 3; j++) {
-		uint16 index = indices[j];
 
-		if (!_currentShadowArray) {
-			if (face->_hasTexture) {
-				tglTexCoord2f(model->_texVerts[index].getX(), model->_texVerts[index].getY());
-			}
+	tglEnableClientState(TGL_VERTEX_ARRAY);
+	tglVertexPointer(3, TGL_FLOAT, 0, model->_drawVertices[0].getData());
+	tglEnableClientState(TGL_NORMAL_ARRAY);
+	tglNormalPointer(TGL_FLOAT, 0, model->_normals[0].getData());
+
+	if (!_currentShadowArray) {
+		for (uint j = 0; j < face->_faceLength * 3; j++) {
+			uint16 index = indices[j];
+
 			Math::Vector3d lighting = (face->_flags & EMIMeshFace::kNoLighting) ? noLighting : model->_lighting[index];
 			byte r = (byte)(model->_colorMap[index].r * lighting.x());
 			byte g = (byte)(model->_colorMap[index].g * lighting.y());
 			byte b = (byte)(model->_colorMap[index].b * lighting.z());
 			byte a = (int)(model->_colorMap[index].a * alpha * _currentActor->getLocalAlpha(index));
-			tglColor4ub(r, g, b, a);
+			colors[4 * index] = r / 255.0f;
+			colors[4 * index + 1] = g / 255.0f;
+			colors[4 * index + 2] = b / 255.0f;
+			colors[4 * index + 3] = a / 255.0f;
 		}
 
-		Math::Vector3d normal = model->_normals[index];
-		Math::Vector3d vertex = model->_drawVertices[index];
+		tglEnableClientState(TGL_COLOR_ARRAY);
+		tglColorPointer(4, TGL_FLOAT, 0, colors);
 
-		tglNormal3fv(normal.getData());
-		tglVertex3fv(vertex.getData());
+		if (face->_hasTexture) {
+			tglEnableClientState(TGL_TEXTURE_COORD_ARRAY);
+			tglTexCoordPointer(2, TGL_FLOAT, 0, model->_texVerts[0].getData());
+		}
 	}
-	tglEnd();
+
+	tglDrawElements(TGL_TRIANGLES, face->_faceLength * 3, TGL_UNSIGNED_SHORT, indices);
+
+	tglDisableClientState(TGL_VERTEX_ARRAY);
+	tglDisableClientState(TGL_NORMAL_ARRAY);
+	tglDisableClientState(TGL_COLOR_ARRAY);
+	tglDisableClientState(TGL_TEXTURE_COORD_ARRAY);
 
 	if (!_currentShadowArray) {
 		tglColor3f(1.0f, 1.0f, 1.0f);
@@ -692,6 +738,121 @@ void GfxTinyGL::drawModelFace(const Mesh *mesh, const MeshFace *face) {
 	tglDisable(TGL_ALPHA_TEST);
 }
 
+void GfxTinyGL::createMesh(Mesh *mesh) {
+	// The elements are identified by 16-bit vertex and texture vertex numbers
+	if (mesh->_numVertices > 0xffff || mesh->_numTextureVerts > 0xffff) {
+		mesh->_userData = nullptr;
+		return;
+	}
+
+	TinyGLMeshData *data = new TinyGLMeshData();
+	Common::HashMap<uint32, uint32> elements;
+
+	data->_faceStart.reserve(mesh->_numFaces + 1);
+	for (int i = 0; i < mesh->_numFaces; i++) {
+		const MeshFace *face = &mesh->_faces[i];
+		data->_faceStart.push_back(data->_indices.size());
+
+		// Faces without texture keep being drawn one at a time
+		if (!face->hasTexture())
+			continue;
+
+		Common::Array<uint32> faceElements;
+		for (int j = 0; j < face->getNumVertices(); j++) {
+			int vertex = face->getVertex(j);
+			int texVertex = face->getTextureVertex(j);
+			uint32 key = ((uint32)vertex << 16) | texVertex;
+
+			Common::HashMap<uint32, uint32>::const_iterator it = elements.find(key);
+			if (it != elements.end()) {
+				faceElements.push_back(it->_value);
+				continue;
+			}
+
+			uint32 element = data->_vertices.size() / 3;
+			elements[key] = element;
+			faceElements.push_back(element);
+			for (int k = 0; k < 3; k++) {
+				data->_vertices.push_back(mesh->_vertices[3 * vertex + k]);
+				data->_normals.push_back(mesh->_vertNormals[3 * vertex + k]);
+			}
+			data->_texCoords.push_back(mesh->_textureVerts[2 * texVertex]);
+			data->_texCoords.push_back(mesh->_textureVerts[2 * texVertex + 1]);
+		}
+
+		// Same triangles, in the same order, as TGL_POLYGON
+		for (int j = face->getNumVertices(); j >= 3; j--) {
+			data->_indices.push_back(faceElements[j - 1]);
+			data->_indices.push_back(faceElements[0]);
+			data->_indices.push_back(faceElements[j - 2]);
+		}
+	}
+	data->_faceStart.push_back(data->_indices.size());
+
+	mesh->_userData = data;
+}
+
+void GfxTinyGL::destroyMesh(const Mesh *mesh) {
+	delete (TinyGLMeshData *)mesh->_userData;
+}
+
+void GfxTinyGL::drawMesh(const Mesh *mesh) {
+	const TinyGLMeshData *data = (const TinyGLMeshData *)mesh->_userData;
+	if (!data || data->_indices.empty()) {
+		GfxBase::drawMesh(mesh);
+		return;
+	}
+
+	tglEnableClientState(TGL_VERTEX_ARRAY);
+	tglVertexPointer(3, TGL_FLOAT, 0, data->_vertices.data());
+	tglEnableClientState(TGL_NORMAL_ARRAY);
+	tglNormalPointer(TGL_FLOAT, 0, data->_normals.data());
+	tglEnableClientState(TGL_TEXTURE_COORD_ARRAY);
+	tglTexCoordPointer(2, TGL_FLOAT, 0, data->_texCoords.data());
+
+	for (int i = 0; i < mesh->_numFaces;) {
+		const MeshFace *face = &mesh->_faces[i];
+		if (!face->hasTexture()) {
+			face->draw(mesh);
+			i++;
+			continue;
+		}
+
+		// Gather the following faces which are drawn with the same state
+		int end = i + 1;
+		while (end < mesh->_numFaces && mesh->_faces[end].hasTexture() &&
+				mesh->_faces[end].getMaterial() == face->getMaterial() &&
+				(mesh->_faces[end].getLight() == 0) == (face->getLight() == 0))
+			end++;
+
+		// Same state changes as MeshFace::draw() and drawModelFace()
+		bool unlit = face->getLight() == 0 && !isShadowModeActive();
+		if (unlit)
+			disableLights();
+
+		face->getMaterial()->select();
+		tglAlphaFunc(TGL_GREATER, 0.5);
+		tglEnable(TGL_ALPHA_TEST);
+		tglDrawElements(TGL_TRIANGLES, data->_faceStart[end] - data->_faceStart[i], TGL_UNSIGNED_INT,
+		                &data->_indices[data->_faceStart[i]]);
+		tglDisable(TGL_ALPHA_TEST);
+
+		if (unlit)
+			enableLights();
+
+		// The faces without texture use the last texture coordinates set
+		const MeshFace *last = &mesh->_faces[end - 1];
+		if (last->getNumVertices() > 0)
+			tglTexCoord2fv(mesh->_textureVerts + 2 * last->getTextureVertex(last->getNumVertices() - 1));
+
+		i = end;
+	}
+
+	tglDisableClientState(TGL_VERTEX_ARRAY);
+	tglDisableClientState(TGL_NORMAL_ARRAY);
+	tglDisableClientState(TGL_TEXTURE_COORD_ARRAY);
+}
+
 void GfxTinyGL::drawSprite(const Sprite *sprite) {
 	tglMatrixMode(TGL_TEXTURE);
 	tglLoadIdentity();
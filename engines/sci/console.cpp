@@ -84,6 +84,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	// Variables
 	registerVar("sleeptime_factor",	&g_debug_sleeptime_factor);
 	registerVar("gc_interval",		&engine->_gamestate->scriptGCInterval);
+	registerVar("gc_incremental",		&engine->_gamestate->incrementalGC);
+	registerVar("gc_verify",			&engine->_gamestate->verifyGC);
 	registerVar("simulated_key",		&g_debug_simulated_key);
 	registerVar("track_mouse_clicks",	&g_debug_track_mouse_clicks);
 	// FIXME: This actually passes an enum type instead of an integer but no
@@ -115,6 +117,7 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("resource_id",		WRAP_METHOD(Console, cmdResourceId));
 	registerCmd("resource_info",		WRAP_METHOD(Console, cmdResourceInfo));
 	registerCmd("resource_types",		WRAP_METHOD(Console, cmdResourceTypes));
+	registerCmd("resource_cache",		WRAP_METHOD(Console, cmdResourceCache));
 	registerCmd("list",				WRAP_METHOD(Console, cmdList));
 	registerCmd("alloc_list",				WRAP_METHOD(Console, cmdAllocList));
 	registerCmd("hexgrep",			WRAP_METHOD(Console, cmdHexgrep));
@@ -196,6 +199,8 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	registerCmd("sg",					WRAP_METHOD(Console, cmdStepGlobal));	// alias
 	registerCmd("step_callk",			WRAP_METHOD(Console, cmdStepCallk));
 	registerCmd("snk",				WRAP_METHOD(Console, cmdStepCallk));	// alias
+	registerCmd("vm_trace",			WRAP_METHOD(Console, cmdVMTrace));
+	registerCmd("avoidpath_bench",	WRAP_METHOD(Console, cmdAvoidPathBench));
 	registerCmd("disasm",				WRAP_METHOD(Console, cmdDisassemble));
 	registerCmd("disasm_addr",		WRAP_METHOD(Console, cmdDisassembleAddress));
 	registerCmd("find_callk",			WRAP_METHOD(Console, cmdFindKernelFunctionCall));
@@ -257,6 +262,16 @@ Console::Console(SciEngine *engine) : GUI::Debugger(),
 	_debugState.breakpointWasHit = false;
 	_debugState._breakpoints.clear(); // No breakpoints defined
 	_debugState._activeBreakpointTypes = 0;
+	_debugState.useDecodedInstructions = true;
+	_debugState.recordVmTrace = false;
+	_debugState.vmTimingRuns = 0;
+	_debugState.vmTimingCache = true;
+	for (int i = 0; i < 2; i++) {
+		_debugState.vmTime[i] = 0;
+		_debugState.vmRuns[i] = 0;
+		_debugState.vmInstructions[i] = 0;
+	}
+	_debugState.recordAvoidPath = false;
 }
 
 Console::~Console() {
@@ -272,12 +287,19 @@ void Console::attach(const char *entry) {
 }
 
 void Console::preEnter() {
+	// Variables may be modified from the debugger without a write barrier
+	_engine->_gamestate->_gc->cancel();
+
 	GUI::Debugger::preEnter();
 }
 
 extern void playVideo(Video::VideoDecoder &videoDecoder);
 
 void Console::postEnter() {
+	// run_vm() keeps the VM settings in locals, which it reads again when the
+	// execution stack position changes
+	_engine->_gamestate->_executionStackPosChanged = true;
+
 	if (!_videoFile.empty()) {
 		Common::ScopedPtr<Video::VideoDecoder> videoDecoder;
 
@@ -309,6 +331,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf("---------\n");
 	debugPrintf("sleeptime_factor: Factor to multiply with wait times in kWait()\n");
 	debugPrintf("gc_interval: Number of kernel calls in between garbage collections\n");
+	debugPrintf("gc_incremental: Spread garbage collection over several kernel calls\n");
+	debugPrintf("gc_verify: Check that incremental collections only free objects a full collection frees\n");
 	debugPrintf("simulated_key: Add a key with the specified scan code to the event list\n");
 	debugPrintf("track_mouse_clicks: Toggles mouse click tracking to the console\n");
 	debugPrintf("script_abort_flag: Set to 1 to abort script execution. Set to 2 to force a replay afterwards\n");
@@ -345,6 +369,7 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" resource_id - Identifies a resource number by splitting it up in resource type and resource number\n");
 	debugPrintf(" resource_info - Shows info about a resource\n");
 	debugPrintf(" resource_types - Shows the valid resource types\n");
+	debugPrintf(" resource_cache - Shows resource cache statistics and sets the eviction policy\n");
 	debugPrintf(" list - Lists all the resources of a given type\n");
 	debugPrintf(" alloc_list - Lists all allocated resources\n");
 	debugPrintf(" hexgrep - Searches some resources for a particular sequence of bytes, represented as hexadecimal numbers\n");
@@ -414,6 +439,8 @@ bool Console::cmdHelp(int argc, const char **argv) {
 	debugPrintf(" step_event / se - Steps forward until a SCI event is received.\n");
 	debugPrintf(" step_global / sg - Steps until the global variable with the specified index is modified.\n");
 	debugPrintf(" step_callk / snk - Steps forward until it hits the next callk operation, or a specific callk (specified as a parameter)\n");
+	debugPrintf(" vm_trace - Records executed instructions and benchmarks decoding and executing them\n");
+	debugPrintf(" avoidpath_bench - Records AvoidPath calls and benchmarks replaying them\n");
 	debugPrintf(" disasm - Disassembles a method by name\n");
 	debugPrintf(" disasm_addr - Disassembles one or more commands\n");
 	debugPrintf(" send - Sends a message to an object\n");
@@ -1107,6 +1134,34 @@ bool Console::cmdResourceTypes(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::cmdResourceCache(int argc, const char **argv) {
+	ResourceManager *resMan = _engine->getResMan();
+
+	if (argc == 2) {
+		if (!scumm_stricmp(argv[1], "lru")) {
+			resMan->setEvictionPolicy(ResourceManager::kEvictionLRU);
+		} else if (!scumm_stricmp(argv[1], "cost")) {
+			resMan->setEvictionPolicy(ResourceManager::kEvictionCostWeighted);
+		} else if (!scumm_stricmp(argv[1], "reset")) {
+			resMan->resetCacheStats();
+		} else {
+			debugPrintf("Shows resource cache statistics, resets them or changes the eviction policy\n");
+			debugPrintf("Usage: %s [lru | cost | reset]\n", argv[0]);
+			return true;
+		}
+	}
+
+	const ResourceManager::CacheStats &stats = resMan->getCacheStats();
+	const uint32 lookups = stats.hits + stats.misses;
+
+	debugPrintf("Eviction policy: %s\n", resMan->getEvictionPolicy() == ResourceManager::kEvictionLRU ? "least recently used" : "cost weighted");
+	debugPrintf("Memory: %d bytes locked, %d of %d bytes under LRU control\n", resMan->getMemoryLocked(), resMan->getMemoryLRU(), resMan->getMaxMemoryLRU());
+	debugPrintf("Hits: %u, misses: %u (%u%% hit rate)\n", stats.hits, stats.misses, lookups ? (uint32)((uint64)stats.hits * 100 / lookups) : 0);
+	debugPrintf("Evictions: %u (%u bytes)\n", stats.evictions, stats.evictedBytes);
+
+	return true;
+}
+
 bool Console::cmdHexgrep(int argc, const char **argv) {
 	if (argc < 4) {
 		debugPrintf("Searches some resources for a particular sequence of bytes, represented as decimal or hexadecimal numbers.\n");
@@ -3530,6 +3585,138 @@ bool Console::cmdStepCallk(int argc, const char **argv) {
 	return cmdExit(0, 0);
 }
 
+bool Console::cmdVMTrace(int argc, const char **argv) {
+	if (argc < 2) {
+		debugPrintf("Records the addresses of executed instructions and replays them to benchmark instruction decoding.\n");
+		debugPrintf("'time' measures the execution of the next script runs, alternately with and without the decoded instruction cache.\n");
+		debugPrintf("Usage: %s start | stop | bench [<repeats>] | time [<runs>] | cache on | cache off\n", argv[0]);
+		debugPrintf("The trace contains %u instructions%s, the decoded instruction cache is %s\n",
+			_debugState.vmTrace.size(), _debugState.recordVmTrace ? " and is being recorded" : "",
+			_debugState.vmTimingRuns ? "being timed" : (_debugState.useDecodedInstructions ? "on" : "off"));
+
+		static const char *const modes[2] = { "Without cache", "With cache" };
+		for (int i = 0; i < 2; i++) {
+			if (!_debugState.vmInstructions[i])
+				continue;
+			debugPrintf("%s: %u instructions in %u runs, %u ms (%u ns per instruction)\n", modes[i],
+				_debugState.vmInstructions[i], _debugState.vmRuns[i], _debugState.vmTime[i],
+				(uint32)((uint64)_debugState.vmTime[i] * 1000000 / _debugState.vmInstructions[i]));
+		}
+		if (_debugState.vmTimingRuns)
+			debugPrintf("%u runs left to time\n", _debugState.vmTimingRuns);
+		return true;
+	}
+
+	if (!scumm_stricmp(argv[1], "start")) {
+		_debugState.vmTrace.clear();
+		_debugState.recordVmTrace = true;
+		debugPrintf("Recording up to %d instructions\n", kMaxVmTraceLength);
+	} else if (!scumm_stricmp(argv[1], "stop")) {
+		_debugState.recordVmTrace = false;
+		debugPrintf("Recorded %u instructions\n", _debugState.vmTrace.size());
+	} else if (!scumm_stricmp(argv[1], "time")) {
+		// Run the game to time the actual execution, as replaying the trace
+		// would execute the scripts again on a changed game state
+		if (!_debugState.vmTimingRuns)
+			_debugState.vmTimingCache = _debugState.useDecodedInstructions;
+		_debugState.vmTimingRuns = argc > 2 ? MAX(atoi(argv[2]), 2) : 2000;
+		for (int i = 0; i < 2; i++) {
+			_debugState.vmTime[i] = 0;
+			_debugState.vmRuns[i] = 0;
+			_debugState.vmInstructions[i] = 0;
+		}
+		debugPrintf("Timing the next %u script runs, use '%s' to see the results\n", _debugState.vmTimingRuns, argv[0]);
+	} else if (!scumm_stricmp(argv[1], "cache") && argc == 3) {
+		_debugState.useDecodedInstructions = !scumm_stricmp(argv[2], "on");
+		_debugState.vmTimingCache = _debugState.useDecodedInstructions;
+		debugPrintf("Decoded instruction cache is %s\n", _debugState.useDecodedInstructions ? "on" : "off");
+	} else if (!scumm_stricmp(argv[1], "bench")) {
+		const int repeats = argc > 2 ? MAX(atoi(argv[2]), 1) : 10;
+		SegManager *segMan = _engine->_gamestate->_segMan;
+
+		// Scripts which were unloaded since the trace was recorded are
+		// skipped, so that both passes decode the same instructions
+		Common::Array<Script *> scripts;
+		Common::Array<uint32> offsets;
+		for (uint i = 0; i < _debugState.vmTrace.size(); ++i) {
+			Script *script = segMan->getScriptIfLoaded(_debugState.vmTrace[i].getSegment());
+			const uint32 offset = _debugState.vmTrace[i].getOffset();
+			if (script && offset < script->getBufSize()) {
+				scripts.push_back(script);
+				offsets.push_back(offset);
+			}
+		}
+
+		if (scripts.empty()) {
+			debugPrintf("No recorded instructions of loaded scripts, use '%s start' first\n", argv[0]);
+			return true;
+		}
+
+		byte extOpcode;
+		int16 opparams[4];
+		uint32 decodedBytes = 0;
+		uint32 startTime = g_system->getMillis();
+		for (int r = 0; r < repeats; ++r) {
+			for (uint i = 0; i < scripts.size(); ++i)
+				decodedBytes += readPMachineInstruction(scripts[i]->getBuf(offsets[i]), extOpcode, opparams);
+		}
+		const uint32 parseTime = g_system->getMillis() - startTime;
+
+		uint32 cachedBytes = 0;
+		startTime = g_system->getMillis();
+		for (int r = 0; r < repeats; ++r) {
+			for (uint i = 0; i < scripts.size(); ++i)
+				cachedBytes += scripts[i]->getDecodedInstruction(offsets[i]).size;
+		}
+		const uint32 cacheTime = g_system->getMillis() - startTime;
+
+		debugPrintf("Decoded %u instructions %d times, without executing them\n", scripts.size(), repeats);
+		debugPrintf("readPMachineInstruction: %u ms (%u bytes)\n", parseTime, decodedBytes);
+		debugPrintf("Decoded instruction cache: %u ms (%u bytes)\n", cacheTime, cachedBytes);
+	} else {
+		debugPrintf("Unknown subcommand '%s'\n", argv[1]);
+	}
+
+	return true;
+}
+
+bool Console::cmdAvoidPathBench(int argc, const char **argv) {
+	if (argc < 2) {
+		debugPrintf("Records the input of AvoidPath calls and replays it to benchmark pathfinding.\n");
+		debugPrintf("Usage: %s start | stop | run [<repeats>]\n", argv[0]);
+		debugPrintf("%u calls are recorded%s\n", _debugState.avoidPathInputs.size(),
+			_debugState.recordAvoidPath ? ", recording is active" : "");
+		return true;
+	}
+
+	if (!scumm_stricmp(argv[1], "start")) {
+		_debugState.avoidPathInputs.clear();
+		_debugState.recordAvoidPath = true;
+		debugPrintf("Recording AvoidPath calls\n");
+	} else if (!scumm_stricmp(argv[1], "stop")) {
+		_debugState.recordAvoidPath = false;
+		debugPrintf("Recorded %u calls\n", _debugState.avoidPathInputs.size());
+	} else if (!scumm_stricmp(argv[1], "run")) {
+		if (_debugState.avoidPathInputs.empty()) {
+			debugPrintf("No AvoidPath calls recorded, use '%s start' first\n", argv[0]);
+			return true;
+		}
+
+		const int repeats = argc > 2 ? MAX(atoi(argv[2]), 1) : 10;
+		uint32 uncachedTime, cachedTime;
+		const bool identical = benchmarkAvoidPath(_engine->_gamestate, _debugState.avoidPathInputs, repeats, uncachedTime, cachedTime);
+
+		debugPrintf("Replayed %u calls %d times\n", _debugState.avoidPathInputs.size(), repeats);
+		debugPrintf("Without visibility graph cache: %u ms\n", uncachedTime);
+		debugPrintf("With visibility graph cache: %u ms\n", cachedTime);
+		debugPrintf("Paths are %s\n", identical ? "identical" : "DIFFERENT");
+	} else {
+		debugPrintf("Unknown subcommand '%s'\n", argv[1]);
+	}
+
+	return true;
+}
+
 bool Console::cmdDisassemble(int argc, const char **argv) {
 	if (argc < 3) {
 		debugPrintf("Disassembles a method by name.\n");
@@ -23,7 +23,9 @@
 #ifndef SCI_DEBUG_H
 #define SCI_DEBUG_H
 
+#include "common/array.h"
 #include "common/list.h"
+#include "common/rect.h"
 #include "sci/engine/vm_types.h"	// for StackPtr
 
 namespace Sci {
@@ -72,6 +74,16 @@ enum DebugSeeking {
 	kDebugSeekStepOver = 5      // Step forward until we reach same stack-level again
 };
 
+/** Arguments of a kAvoidPath call, recorded for benchmarking */
+struct AvoidPathInput {
+	Common::Array<int16> polygons; ///< Types and points of the polygons
+	Common::Point start;
+	Common::Point end;
+	int width;
+	int height;
+	int opt;
+};
+
 struct DebugState {
 	bool debugging;
 	bool breakpointWasHit;
@@ -84,6 +96,16 @@ struct DebugState {
 	StackPtr old_sp;
 	Common::List<Breakpoint> _breakpoints;   //< List of breakpoints
 	int _activeBreakpointTypes;  //< Bit mask specifying which types of breakpoints are active
+	bool useDecodedInstructions; //< Execute scripts from their decoded instruction cache
+	bool recordVmTrace;          //< Record the address of every executed instruction in vmTrace
+	Common::Array<reg_t> vmTrace;
+	uint32 vmTimingRuns;         //< Number of outermost run_vm() calls still to be timed
+	bool vmTimingCache;          //< Value of useDecodedInstructions to restore after timing
+	uint32 vmTime[2];            //< Milliseconds spent in run_vm(), without and with the decoded instruction cache
+	uint32 vmRuns[2];            //< Number of timed outermost run_vm() calls, likewise
+	uint32 vmInstructions[2];    //< Number of instructions executed by the timed calls, likewise
+	bool recordAvoidPath;        //< Record the input of every kAvoidPath call in avoidPathInputs
+	Common::Array<AvoidPathInput> avoidPathInputs;
 
 	void updateActiveBreakpointTypes();
 };
@@ -22,6 +22,7 @@
 
 #include "sci/engine/gc.h"
 #include "common/array.h"
+#include "common/system.h"
 #include "sci/graphics/ports.h"
 
 #ifdef ENABLE_SCI32
@@ -99,11 +100,9 @@ static void processWorkList(SegManager *segMan, WorklistManager &wm, const Commo
 	}
 }
 
-AddrSet *findAllActiveReferences(EngineState *s) {
+static void pushRootSet(EngineState *s, WorklistManager &wm) {
 	assert(!s->_executionStack.empty());
 
-	WorklistManager wm;
-
 	// Initialize registers
 	wm.push(s->r_acc);
 	wm.push(s->r_prev);
@@ -171,28 +170,34 @@ AddrSet *findAllActiveReferences(EngineState *s) {
 
 	debugC(kDebugLevelGC, "[GC] -- Finished explicitly loaded scripts, done with root set");
 
-	processWorkList(s->_segMan, wm, heap);
-
 	if (g_sci->_gfxPorts)
 		g_sci->_gfxPorts->processEngineHunkList(wm);
+}
+
+AddrSet *findAllActiveReferences(EngineState *s) {
+	WorklistManager wm;
+
+	pushRootSet(s, wm);
+	processWorkList(s->_segMan, wm, s->_segMan->getSegments());
 
 	return normalizeAddresses(s->_segMan, wm._map);
 }
 
-void run_gc(EngineState *s) {
-	SegManager *segMan = s->_segMan;
-
-	// Some debug stuff
-	debugC(kDebugLevelGC, "[GC] Running...");
+/**
+ * Frees all deallocatable objects which are not in the given set.
+ * @param liveRefs	if set, the result of a full collection which the set is
+ *					checked against
+ * @return the number of freed objects
+ */
+static uint sweep(SegManager *segMan, const AddrSet &activeRefs, const AddrSet *liveRefs) {
 #ifdef GC_DEBUG_CODE
 	const char *segnames[SEG_TYPE_MAX + 1];
 	int segcount[SEG_TYPE_MAX + 1];
 	memset(segnames, 0, sizeof(segnames));
 	memset(segcount, 0, sizeof(segcount));
 #endif
-
-	// Compute the set of all segments references currently in use.
-	AddrSet *activeRefs = findAllActiveReferences(s);
+	uint freed = 0;
+	uint floating = 0;
 
 	// Iterate over all segments, and check for each whether it
 	// contains stuff that can be collected.
@@ -211,20 +216,27 @@ void run_gc(EngineState *s) {
 			const Common::Array<reg_t> tmp = mobj->listAllDeallocatable(seg);
 			for (Common::Array<reg_t>::const_iterator it = tmp.begin(); it != tmp.end(); ++it) {
 				const reg_t addr = *it;
-				if (!activeRefs->contains(addr)) {
+				if (!activeRefs.contains(addr)) {
+					if (liveRefs && liveRefs->contains(addr))
+						error("[GC] Incremental collection would free live object %04x:%04x", PRINT_REG(addr));
+
 					// Not found -> we can free it
 					mobj->freeAtAddress(segMan, addr);
 					debugC(kDebugLevelGC, "[GC] Deallocating %04x:%04x", PRINT_REG(addr));
+					freed++;
 #ifdef GC_DEBUG_CODE
 					segcount[type]++;
 #endif
+				} else if (liveRefs && !liveRefs->contains(addr)) {
+					floating++;
 				}
 			}
 
 		}
 	}
 
-	delete activeRefs;
+	if (liveRefs)
+		debugC(kDebugLevelGC, "[GC] Verified incremental collection, %u unreachable objects kept until the next cycle", floating);
 
 #ifdef GC_DEBUG_CODE
 	// Output debug summary of garbage collection
@@ -233,6 +245,114 @@ void run_gc(EngineState *s) {
 		if (segcount[i])
 			debugC(kDebugLevelGC, "\t%d\t* %s", segcount[i], segnames[i]);
 #endif
+
+	return freed;
+}
+
+void run_gc(EngineState *s) {
+	const uint32 startTime = g_system->getMillis();
+
+	// A full collection makes any incremental cycle pointless
+	s->_gc->cancel();
+
+	// Some debug stuff
+	debugC(kDebugLevelGC, "[GC] Running...");
+
+	// Compute the set of all segments references currently in use.
+	AddrSet *activeRefs = findAllActiveReferences(s);
+	const uint freed = sweep(s->_segMan, *activeRefs, nullptr);
+	delete activeRefs;
+
+	debugC(kDebugLevelGC, "[GC] Full collection freed %u objects in %u ms", freed, g_system->getMillis() - startTime);
+}
+
+void SegManagerGCHeap::listOutgoingReferences(reg_t reg, Common::Array<reg_t> &refs) const {
+	const SegmentObj *mobj = _state->_segMan->getSegmentObj(reg.getSegment());
+
+	// Objects may have been freed since they were shaded
+	if (!mobj || mobj->getType() == SEG_TYPE_STACK || !mobj->isValidOffset(reg.getOffset()))
+		return;
+
+	refs = mobj->listAllOutgoingReferences(reg);
+}
+
+IncrementalGC::IncrementalGC(EngineState *s) :
+	_state(s),
+	_heap(s),
+	_marker(_heap),
+	_cycleStartTime(0),
+	_maxPause(0) {}
+
+void IncrementalGC::start() {
+	if (isMarking())
+		return;
+
+	const uint32 startTime = g_system->getMillis();
+	debugC(kDebugLevelGC, "[GC] Starting incremental cycle");
+
+	WorklistManager roots;
+	pushRootSet(_state, roots);
+
+	_marker.start();
+	for (uint i = 0; i < roots._worklist.size(); ++i)
+		_marker.shade(roots._worklist[i]);
+
+	// Kernel functions and guest additions set globals directly
+	if (_state->variablesSegment[VAR_GLOBAL])
+		_marker.scan(make_reg(_state->variablesSegment[VAR_GLOBAL], 0));
+
+	_cycleStartTime = startTime;
+	_maxPause = g_system->getMillis() - startTime;
+}
+
+bool IncrementalGC::step(uint budget) {
+	const uint32 startTime = g_system->getMillis();
+	const bool done = _marker.step(budget);
+	_maxPause = MAX(_maxPause, g_system->getMillis() - startTime);
+	return done;
+}
+
+void IncrementalGC::beforeKernelCall(int argc, const reg_t *argv) {
+	if (!isMarking())
+		return;
+
+	// Kernel functions write to the locals and arrays they get pointers to
+	// without barriers, so their current references are shaded first
+	SegManager *segMan = _state->_segMan;
+	for (int i = 0; i < argc; ++i) {
+		const SegmentType type = segMan->getSegmentType(argv[i].getSegment());
+		if (type == SEG_TYPE_LOCALS || type == SEG_TYPE_ARRAY)
+			_marker.scan(argv[i]);
+	}
+
+	if (step(kMarkBudget))
+		finish();
+}
+
+void IncrementalGC::finish() {
+	if (!isMarking())
+		return;
+
+	const uint32 startTime = g_system->getMillis();
+	SegManager *segMan = _state->_segMan;
+
+	_marker.step(0xFFFFFFFF);
+	AddrSet *activeRefs = normalizeAddresses(segMan, _marker.getMarked());
+	AddrSet *liveRefs = _state->verifyGC ? findAllActiveReferences(_state) : nullptr;
+	const uint freed = sweep(segMan, *activeRefs, liveRefs);
+	delete activeRefs;
+	delete liveRefs;
+
+	cancel();
+
+	const uint32 endTime = g_system->getMillis();
+	_maxPause = MAX(_maxPause, endTime - startTime);
+	debugC(kDebugLevelGC, "[GC] Incremental cycle freed %u objects over %u ms, longest pause %u ms",
+		freed, endTime - _cycleStartTime, _maxPause);
+}
+
+void IncrementalGC::cancel() {
+	_marker.stop();
 }
 
 } // End of namespace Sci
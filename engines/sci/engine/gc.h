@@ -25,6 +25,7 @@
 #define SCI_ENGINE_GC_H
 
 #include "common/hashmap.h"
+#include "sci/engine/gc_marker.h"
 #include "sci/engine/vm_types.h"
 #include "sci/engine/state.h"
 
@@ -63,6 +64,89 @@ struct WorklistManager {
 	void pushArray(const Common::Array<reg_t> &tmp);
 };
 
+/**
+ * Object graph of the segment manager, as seen by the incremental collector.
+ * The stack is scanned as part of the root set, so it has no outgoing
+ * references here.
+ */
+struct SegManagerGCHeap {
+	typedef reg_t Ref;
+	typedef reg_t_Hash RefHash;
+
+	SegManagerGCHeap(EngineState *s) : _state(s) {}
+
+	bool isReference(reg_t reg) const { return reg.getSegment() != 0; }
+	void listOutgoingReferences(reg_t reg, Common::Array<reg_t> &refs) const;
+
+	EngineState *_state;
+};
+
+/**
+ * Snapshot-at-the-beginning collector, which spreads the marking phase of
+ * run_gc() over several kernel calls.
+ *
+ * A cycle pushes the root set when it starts and then marks a limited number
+ * of references on every kernel call. References which are overwritten while
+ * marking are shaded by writeBarrier(), and objects which kernel code modifies
+ * directly are scanned first, so that everything reachable when the cycle
+ * started stays reachable. Objects allocated during the cycle are kept until
+ * the next one.
+ */
+class IncrementalGC {
+public:
+	IncrementalGC(EngineState *s);
+
+	bool isMarking() const { return _marker.isMarking(); }
+
+	/** Starts a new cycle by pushing the root set */
+	void start();
+
+	/**
+	 * Called before a kernel function is run. Scans the locals and arrays
+	 * which the kernel function may write to through its arguments, marks up
+	 * to kMarkBudget references and completes the cycle once marking is done.
+	 */
+	void beforeKernelCall(int argc, const reg_t *argv);
+
+	/** Completes marking and frees all unreachable objects */
+	void finish();
+
+	/** Drops the current cycle without freeing anything */
+	void cancel();
+
+	/** Must be called with the old value of a reference before it is overwritten */
+	inline void writeBarrier(reg_t oldValue) {
+		_marker.shade(oldValue);
+	}
+
+	/**
+	 * Must be called before kernel code modifies the references held by an
+	 * object without going through writeBarrier(), and before it frees one.
+	 */
+	inline void scanObject(reg_t object) {
+		_marker.scan(object);
+	}
+
+	/** Must be called for every deallocatable object which is allocated */
+	inline void objectAllocated(reg_t object) {
+		_marker.allocated(object);
+	}
+
+private:
+	enum {
+		/** Number of references to mark per kernel call */
+		kMarkBudget = 256
+	};
+
+	bool step(uint budget);
+
+	EngineState *_state;
+	SegManagerGCHeap _heap;
+	SnapshotMarker<SegManagerGCHeap> _marker;
+	uint32 _cycleStartTime;
+	uint32 _maxPause; ///< Longest pause of the current cycle, in ms
+};
+
 
 } // End of namespace Sci
 
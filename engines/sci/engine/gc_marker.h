@@ -0,0 +1,143 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCI_ENGINE_GC_MARKER_H
+#define SCI_ENGINE_GC_MARKER_H
+
+#include "common/array.h"
+#include "common/hashmap.h"
+
+namespace Sci {
+
+/**
+ * Marking phase of a snapshot-at-the-beginning collection, which can be
+ * interrupted at any point while the heap is being modified.
+ *
+ * An object is white while it isn't marked, grey while it is marked and its
+ * references still have to be scanned, and black once they have been shaded.
+ * Every object which is reachable when the cycle starts is marked once no
+ * grey object is left, as long as:
+ * - every root is shaded right after start(),
+ * - the old value of a reference is shaded before it is overwritten, or the
+ *   object holding it is scanned before it is modified or freed,
+ * - every object allocated while marking is reported to allocated().
+ *
+ * The Heap type provides the object graph:
+ * - Ref, the type of references, and RefHash, a hash function for them
+ * - bool isReference(Ref ref) const, false for numbers
+ * - void listOutgoingReferences(Ref ref, Common::Array<Ref> &refs) const,
+ *   which must return nothing for objects which have been freed
+ */
+template<class Heap>
+class SnapshotMarker {
+public:
+	typedef typename Heap::Ref Ref;
+	typedef Common::HashMap<Ref, bool, typename Heap::RefHash> RefSet;
+
+	SnapshotMarker(const Heap &heap) : _heap(heap), _marking(false) {}
+
+	bool isMarking() const { return _marking; }
+
+	/** The objects marked so far */
+	const RefSet &getMarked() const { return _marked; }
+
+	bool isMarked(Ref ref) const { return _marked.contains(ref); }
+
+	/** Starts a cycle. The roots have to be shaded before the heap changes. */
+	void start() {
+		stop();
+		_marking = true;
+	}
+
+	/** Drops the current cycle */
+	void stop() {
+		_worklist.clear();
+		_marked.clear();
+		_marking = false;
+	}
+
+	/** Marks an object grey, if it is still white */
+	void shade(Ref ref) {
+		if (!_marking || !_heap.isReference(ref) || _marked.contains(ref))
+			return;
+
+		_marked.setVal(ref, true);
+		_worklist.push_back(ref);
+	}
+
+	/**
+	 * Shades all the references an object holds right now. Must be called
+	 * before references held by an object are modified without a barrier, or
+	 * before the object is freed.
+	 */
+	void scan(Ref ref) {
+		if (!_marking || !_heap.isReference(ref))
+			return;
+
+		_marked.setVal(ref, true);
+		shadeOutgoingReferences(ref);
+	}
+
+	/**
+	 * Marks a new object black. It can only hold references which were
+	 * reachable when the cycle started or which were allocated since then,
+	 * so it doesn't need to be scanned.
+	 */
+	void allocated(Ref ref) {
+		if (_marking && _heap.isReference(ref))
+			_marked.setVal(ref, true);
+	}
+
+	/**
+	 * Scans up to the given number of grey objects.
+	 * @return true if no grey object is left
+	 */
+	bool step(uint budget) {
+		while (!_worklist.empty()) {
+			if (!budget--)
+				return false;
+
+			const Ref ref = _worklist.back();
+			_worklist.pop_back();
+			shadeOutgoingReferences(ref);
+		}
+		return true;
+	}
+
+private:
+	void shadeOutgoingReferences(Ref ref) {
+		_refs.clear();
+		_heap.listOutgoingReferences(ref, _refs);
+		for (uint i = 0; i < _refs.size(); ++i)
+			shade(_refs[i]);
+	}
+
+	const Heap &_heap;
+	bool _marking;
+	Common::Array<Ref> _worklist;
+	RefSet _marked;
+	Common::Array<Ref> _refs; ///< Scratch buffer for the outgoing references of an object
+};
+
+} // End of namespace Sci
+
+#endif // SCI_ENGINE_GC_MARKER_H
@@ -44,6 +44,7 @@ struct Node;	// from segment.h
 struct List;	// from segment.h
 struct SelectorCache;	// from selector.h
 struct SciWorkaroundEntry;	// from workarounds.h
+struct AvoidPathInput;	// from debug.h
 
 /**
  * @defgroup vocabulary_resources_sci Vocabulary resources in SCI
@@ -340,6 +341,13 @@ reg_t kSort(EngineState *s, int argc, reg_t *argv);
 reg_t kStrEnd(EngineState *s, int argc, reg_t *argv);
 reg_t kMemory(EngineState *s, int argc, reg_t *argv);
 reg_t kAvoidPath(EngineState *s, int argc, reg_t *argv);
+
+/**
+ * Replays recorded kAvoidPath input with and without reusing visibility
+ * graphs, and measures how long each takes.
+ * @return true if both ways computed the same paths
+ */
+bool benchmarkAvoidPath(EngineState *s, const Common::Array<AvoidPathInput> &inputs, int repeats, uint32 &uncachedTime, uint32 &cachedTime);
 reg_t kParse(EngineState *s, int argc, reg_t *argv);
 reg_t kSaid(EngineState *s, int argc, reg_t *argv);
 reg_t kStrCpy(EngineState *s, int argc, reg_t *argv);
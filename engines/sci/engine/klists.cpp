@@ -21,6 +21,7 @@
  */
 
 #include "sci/engine/features.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/kernel.h"
@@ -208,6 +209,10 @@ static void addToFront(EngineState *s, reg_t listRef, reg_t nodeRef) {
 	checkListPointer(s->_segMan, listRef);
 #endif
 
+	s->_gc->scanObject(listRef);
+	s->_gc->scanObject(nodeRef);
+	s->_gc->scanObject(list->first);
+
 	newNode->pred = NULL_REG;
 	newNode->succ = list->first;
 
@@ -234,6 +239,10 @@ static void addToEnd(EngineState *s, reg_t listRef, reg_t nodeRef) {
 	checkListPointer(s->_segMan, listRef);
 #endif
 
+	s->_gc->scanObject(listRef);
+	s->_gc->scanObject(nodeRef);
+	s->_gc->scanObject(list->last);
+
 	newNode->pred = list->last;
 	newNode->succ = NULL_REG;
 
@@ -319,6 +328,13 @@ reg_t kAddAfter(EngineState *s, int argc, reg_t *argv) {
 		return NULL_REG;
 	}
 
+	s->_gc->scanObject(argv[0]);
+	s->_gc->scanObject(argv[2]);
+	if (firstNode) {
+		s->_gc->scanObject(argv[1]);
+		s->_gc->scanObject(firstNode->succ);
+	}
+
 	if (argc == 4)
 		newNode->key = argv[3];
 
@@ -361,6 +377,13 @@ reg_t kAddBefore(EngineState *s, int argc, reg_t *argv) {
 		return NULL_REG;
 	}
 
+	s->_gc->scanObject(argv[0]);
+	s->_gc->scanObject(argv[2]);
+	if (firstNode) {
+		s->_gc->scanObject(argv[1]);
+		s->_gc->scanObject(firstNode->pred);
+	}
+
 	if (argc == 4)
 		newNode->key = argv[3];
 
@@ -423,6 +446,11 @@ reg_t kDeleteKey(EngineState *s, int argc, reg_t *argv) {
 
 	Node *n = s->_segMan->lookupNode(node_pos);
 
+	s->_gc->scanObject(argv[0]);
+	s->_gc->scanObject(node_pos);
+	s->_gc->scanObject(n->pred);
+	s->_gc->scanObject(n->succ);
+
 #ifdef ENABLE_SCI32
 	for (int i = 1; i <= list->numRecursions; ++i) {
 		if (list->nextNodes[i] == node_pos) {
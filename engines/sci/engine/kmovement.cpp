@@ -23,6 +23,7 @@
 #include "sci/sci.h"
 #include "sci/resource/resource.h"
 #include "sci/engine/features.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/state.h"
 #include "sci/engine/selector.h"
 #include "sci/engine/kernel.h"
@@ -363,6 +364,7 @@ reg_t kDoBresen(EngineState *s, int argc, reg_t *argv) {
 
 		if (collision) {
 			// We restore the backup of the client variables
+			s->_gc->scanObject(client);
 			for (uint i = 0; i < clientVarNum; ++i)
 				clientObject->getVariableRef(i) = clientBackup[i];
 
@@ -117,21 +117,22 @@ struct Vertex {
 	// Previous vertex in shortest path
 	Vertex *path_prev;
 
+	// A* open and closed set membership
+	bool open;
+	bool closed;
+	uint32 openSeq;
+
+	// Position in PathfindingState::vertex_index
+	int index;
+
 public:
 	Vertex(const Common::Point &p) : v(p) {
 		costG = HUGE_DISTANCE;
 		path_prev = NULL;
-	}
-};
-
-class VertexList: public Common::List<Vertex *> {
-public:
-	bool contains(Vertex *v) {
-		for (iterator it = begin(); it != end(); ++it) {
-			if (v == *it)
-				return true;
-		}
-		return false;
+		open = false;
+		closed = false;
+		openSeq = 0;
+		index = -1;
 	}
 };
 
@@ -263,6 +264,13 @@ struct PathfindingState {
 	// Screen size
 	int _width, _height;
 
+	// Cached visibility between the vertices of the input polygons, or NULL.
+	// Start and end points which were added as single-vertex polygons come
+	// first in vertex_index, so polygon vertex i of the graph is found at
+	// vertex_index[graphOffset + i].
+	const AvoidPathGraph *graph;
+	int graphOffset;
+
 	PathfindingState(int width, int height) : _width(width), _height(height) {
 		vertex_start = NULL;
 		vertex_end = NULL;
@@ -270,6 +278,8 @@ struct PathfindingState {
 		_prependPoint = NULL;
 		_appendPoint = NULL;
 		vertices = 0;
+		graph = NULL;
+		graphOffset = 0;
 	}
 
 	~PathfindingState() {
@@ -700,45 +710,130 @@ static int inside(const Common::Point &p, Vertex *vertex) {
 }
 
 /**
- * Returns a list of all vertices that are visible from a particular vertex.
+ * Determines whether two vertices can see each other, i.e. whether they can
+ * be connected without crossing the inside of a polygon. This relation is
+ * symmetric.
+ * @param s				the pathfinding state
+ * @param vertex_cur	the first vertex
+ * @param vertex		the second vertex
+ * @return true if the vertices are visible from each other
+ */
+static bool is_visible(PathfindingState *s, Vertex *vertex_cur, Vertex *vertex) {
+	// Make sure we don't intersect a polygon locally at the vertices
+	if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
+		return false;
+
+	// Check for intersecting edges
+	for (int j = 0; j < s->vertices; j++) {
+		Vertex *edge = s->vertex_index[j];
+		if (VERTEX_HAS_EDGES(edge)) {
+			if (between(vertex_cur->v, vertex->v, edge->v)) {
+				// If we hit a vertex, make sure we can pass through it without intersecting its polygon
+				if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
+					return false;
+
+				// This edge won't properly intersect, so we continue
+				continue;
+			}
+
+			if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
+				return false;
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Returns all vertices that are visible from a particular vertex, in
+ * descending vertex_index order.
  * @param s				the pathfinding state
  * @param vertex_cur	the vertex
- * @return list of vertices that are visible from vert
+ * @param visVerts		receives the vertices that are visible from vertex_cur
  */
-static VertexList *visible_vertices(PathfindingState *s, Vertex *vertex_cur) {
-	VertexList *visVerts = new VertexList();
+static void visible_vertices(PathfindingState *s, Vertex *vertex_cur, Common::Array<Vertex *> &visVerts) {
+	visVerts.clear();
 
-	for (int i = 0; i < s->vertices; i++) {
-		Vertex *vertex = s->vertex_index[i];
+	int first = s->vertices - 1;
 
-		// Make sure we don't intersect a polygon locally at the vertices
-		if ((vertex == vertex_cur) || (inside(vertex->v, vertex_cur)) || (inside(vertex_cur->v, vertex)))
-			continue;
+	if (s->graph && vertex_cur->index >= s->graphOffset) {
+		const Common::Array<uint16> &visible = s->graph->visible[vertex_cur->index - s->graphOffset];
+		for (uint i = 0; i < visible.size(); i++)
+			visVerts.push_back(s->vertex_index[s->graphOffset + visible[i]]);
 
-		// Check for intersecting edges
-		int j;
-		for (j = 0; j < s->vertices; j++) {
-			Vertex *edge = s->vertex_index[j];
-			if (VERTEX_HAS_EDGES(edge)) {
-				if (between(vertex_cur->v, vertex->v, edge->v)) {
-					// If we hit a vertex, make sure we can pass through it without intersecting its polygon
-					if ((inside(vertex_cur->v, edge)) || (inside(vertex->v, edge)))
-						break;
-
-					// This edge won't properly intersect, so we continue
-					continue;
-				}
+		// Only the start and end points remain to be checked
+		first = s->graphOffset - 1;
+	}
 
-				if (intersect_proper(vertex_cur->v, vertex->v, edge->v, CLIST_NEXT(edge)->v))
-					break;
+	for (int i = first; i >= 0; i--) {
+		Vertex *vertex = s->vertex_index[i];
+		if (is_visible(s, vertex_cur, vertex))
+			visVerts.push_back(vertex);
+	}
+}
+
+/**
+ * Computes the visibility between all vertices from index graphOffset on.
+ * The start and end points in front of them don't have edges, so they don't
+ * affect the result.
+ * @param s		the pathfinding state
+ * @param graph	receives the visible vertices of each vertex, relative to
+ *				graphOffset and in descending order
+ */
+static void build_visibility_graph(PathfindingState *s, AvoidPathGraph &graph) {
+	const int count = s->vertices - s->graphOffset;
+	graph.visible.clear();
+	graph.visible.resize(count);
+
+	// Visibility is symmetric, so each pair is tested once. Going downwards
+	// on both levels keeps every list sorted in descending order.
+	for (int i = count - 1; i >= 0; i--) {
+		Vertex *vertex_cur = s->vertex_index[s->graphOffset + i];
+		for (int j = i - 1; j >= 0; j--) {
+			if (is_visible(s, vertex_cur, s->vertex_index[s->graphOffset + j])) {
+				graph.visible[i].push_back(j);
+				graph.visible[j].push_back(i);
 			}
 		}
+	}
+}
 
-		if (j == s->vertices)
-			visVerts->push_front(vertex);
+/**
+ * Stores the type and points of all polygons in a flat array, which is used
+ * as the key of the visibility graph cache and for recording AvoidPath input.
+ */
+static void encode_polygons(const PolygonList &polygons, Common::Array<int16> &data) {
+	data.clear();
+
+	for (PolygonList::const_iterator it = polygons.begin(); it != polygons.end(); ++it) {
+		const Polygon *polygon = *it;
+		Vertex *vertex;
+
+		data.push_back(polygon->type);
+		data.push_back(polygon->vertices.size());
+		CLIST_FOREACH(vertex, &polygon->vertices) {
+			data.push_back(vertex->v.x);
+			data.push_back(vertex->v.y);
+		}
 	}
+}
+
+/**
+ * Recreates polygons stored by encode_polygons.
+ */
+static void decode_polygons(const Common::Array<int16> &data, PolygonList &polygons) {
+	uint pos = 0;
 
-	return visVerts;
+	while (pos + 1 < data.size()) {
+		Polygon *polygon = new Polygon(data[pos]);
+		const int size = data[pos + 1];
+		pos += 2;
+
+		for (int i = 0; i < size; i++, pos += 2)
+			polygon->vertices.insertAtEnd(new Vertex(Common::Point(data[pos], data[pos + 1])));
+
+		polygons.push_back(polygon);
+	}
 }
 
 /**
@@ -1231,50 +1326,56 @@ static void change_polygons_opt_0(PathfindingState *s) {
 	}
 }
 
+enum {
+	/** Number of visibility graphs kept for reuse by kAvoidPath */
+	kMaxAvoidPathGraphs = 4
+};
+
 /**
- * Converts the SCI input data for pathfinding
- * Parameters: (EngineState *) s: The game state
- *             (reg_t) poly_list: Polygon list
- *             (Common::Point) start: The start point
- *             (Common::Point) end: The end point
- *             (int) opt: Optimization level (0, 1 or 2)
- * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
- *                            NULL otherwise
+ * Returns the cached visibility graph of a set of polygons, building it
+ * first if necessary.
+ * @param s			The game state
+ * @param pf_s		The pathfinding state, with graphOffset set
+ * @param signature	The polygons, as stored by encode_polygons
  */
-static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt) {
-	SegManager *segMan = s->_segMan;
-	Polygon *polygon;
-	int count = 0;
-	PathfindingState *pf_s = new PathfindingState(width, height);
+static const AvoidPathGraph *find_visibility_graph(EngineState *s, PathfindingState *pf_s, const Common::Array<int16> &signature) {
+	for (Common::List<AvoidPathGraph>::const_iterator it = s->_avoidPathGraphs.begin(); it != s->_avoidPathGraphs.end(); ++it) {
+		if (it->signature == signature)
+			return &*it;
+	}
 
-	// Convert all polygons
-	if (poly_list.getSegment()) {
-		List *list = s->_segMan->lookupList(poly_list);
-		Node *node = s->_segMan->lookupNode(list->first);
+	if (s->_avoidPathGraphs.size() >= kMaxAvoidPathGraphs)
+		s->_avoidPathGraphs.pop_back();
 
-		while (node) {
-			// The node value might be null, in which case there's no polygon to parse.
-			// Happens in LB2 floppy - refer to bug #5195
-			polygon = !node->value.isNull() ? convert_polygon(s, node->value) : NULL;
+	s->_avoidPathGraphs.push_front(AvoidPathGraph());
+	AvoidPathGraph &graph = s->_avoidPathGraphs.front();
+	graph.signature = signature;
+	build_visibility_graph(pf_s, graph);
 
-			if (polygon) {
-				pf_s->polygons.push_back(polygon);
-				count += readSelectorValue(segMan, node->value, SELECTOR(size));
-			}
+	debugC(kDebugLevelAvoidPath, "[avoidpath] Built visibility graph for %d vertices", pf_s->vertices - pf_s->graphOffset);
 
-			node = s->_segMan->lookupNode(node->succ);
-		}
-	}
+	return &graph;
+}
 
-	if (opt == 0)
-		change_polygons_opt_0(pf_s);
+/**
+ * Adds the start and end points to the polygons of a pathfinding state and
+ * prepares it for AStar
+ * Parameters: (EngineState *) s: The game state
+ *             (PathfindingState *) pf_s: The pathfinding state
+ *             (Common::Point) start: The start point
+ *             (Common::Point) end: The end point
+ *             (int) opt: Optimization level (0, 1 or 2)
+ *             (bool) useGraphCache: Whether to reuse visibility graphs
+ * Returns   : (bool) true on success, false otherwise
+ */
+static bool prepare_pathfinding(EngineState *s, PathfindingState *pf_s, Common::Point start, Common::Point end, int opt, bool useGraphCache) {
+	Polygon *polygon;
 
 	Common::Point *new_start = fixup_start_point(pf_s, start);
 
 	if (!new_start) {
 		warning("AvoidPath: Couldn't fixup start position for pathfinding");
-		delete pf_s;
-		return NULL;
+		return false;
 	}
 
 	Common::Point *new_end = fixup_end_point(pf_s, end);
@@ -1282,8 +1383,7 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 	if (!new_end) {
 		warning("AvoidPath: Couldn't fixup end position for pathfinding");
 		delete new_start;
-		delete pf_s;
-		return NULL;
+		return false;
 	}
 
 	if (opt == 0) {
@@ -1305,8 +1405,7 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 				warning("AvoidPath: error finding nearest intersection");
 				delete new_start;
 				delete new_end;
-				delete pf_s;
-				return NULL;
+				return false;
 			}
 
 			if (err == PF_OK)
@@ -1322,6 +1421,15 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		}
 	}
 
+	Common::Array<int16> signature;
+	int polygonCount = 0;
+	int count = 0;
+
+	if (useGraphCache) {
+		encode_polygons(pf_s->polygons, signature);
+		polygonCount = pf_s->polygons.size();
+	}
+
 	// Merge start and end points into polygon set
 	pf_s->vertex_start = merge_point(pf_s, *new_start);
 	pf_s->vertex_end = merge_point(pf_s, *new_end);
@@ -1329,8 +1437,11 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 	delete new_start;
 	delete new_end;
 
+	for (PolygonList::iterator it = pf_s->polygons.begin(); it != pf_s->polygons.end(); ++it)
+		count += (*it)->vertices.size();
+
 	// Allocate and build vertex index
-	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * (count + 2));
+	pf_s->vertex_index = (Vertex**)malloc(sizeof(Vertex *) * count);
 
 	count = 0;
 
@@ -1339,15 +1450,160 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
 		Vertex *vertex;
 
 		CLIST_FOREACH(vertex, &polygon->vertices) {
+			vertex->index = count;
 			pf_s->vertex_index[count++] = vertex;
 		}
 	}
 
 	pf_s->vertices = count;
 
+	if (useGraphCache) {
+		// Start and end points which didn't coincide with a vertex were
+		// either added in front as single-vertex polygons, or were inserted
+		// into an edge. In the latter case the polygons differ from the
+		// cached ones, so the graph can't be used.
+		const int addedPolygons = pf_s->polygons.size() - polygonCount;
+		uint polygonVertices = 0;
+		for (uint pos = 1; pos < signature.size(); pos += 2 + signature[pos] * 2)
+			polygonVertices += signature[pos];
+
+		if ((uint)(count - addedPolygons) == polygonVertices) {
+			pf_s->graphOffset = addedPolygons;
+			pf_s->graph = find_visibility_graph(s, pf_s, signature);
+		}
+	}
+
+	return true;
+}
+
+/**
+ * Converts the SCI input data for pathfinding
+ * Parameters: (EngineState *) s: The game state
+ *             (reg_t) poly_list: Polygon list
+ *             (Common::Point) start: The start point
+ *             (Common::Point) end: The end point
+ *             (int) opt: Optimization level (0, 1 or 2)
+ * Returns   : (PathfindingState *) On success a newly allocated pathfinding state,
+ *                            NULL otherwise
+ */
+static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Common::Point start, Common::Point end, int width, int height, int opt) {
+	Polygon *polygon;
+	PathfindingState *pf_s = new PathfindingState(width, height);
+
+	// Convert all polygons
+	if (poly_list.getSegment()) {
+		List *list = s->_segMan->lookupList(poly_list);
+		Node *node = s->_segMan->lookupNode(list->first);
+
+		while (node) {
+			// The node value might be null, in which case there's no polygon to parse.
+			// Happens in LB2 floppy - refer to bug #5195
+			polygon = !node->value.isNull() ? convert_polygon(s, node->value) : NULL;
+
+			if (polygon)
+				pf_s->polygons.push_back(polygon);
+
+			node = s->_segMan->lookupNode(node->succ);
+		}
+	}
+
+	if (g_sci->_debugState.recordAvoidPath) {
+		AvoidPathInput input;
+		encode_polygons(pf_s->polygons, input.polygons);
+		input.start = start;
+		input.end = end;
+		input.width = width;
+		input.height = height;
+		input.opt = opt;
+		g_sci->_debugState.avoidPathInputs.push_back(input);
+	}
+
+	if (opt == 0)
+		change_polygons_opt_0(pf_s);
+
+	if (!prepare_pathfinding(s, pf_s, start, end, opt, true)) {
+		delete pf_s;
+		return NULL;
+	}
+
 	return pf_s;
 }
 
+struct OpenSetEntry {
+	uint32 costF;
+	uint32 seq;
+	Vertex *vertex;
+
+	/**
+	 * Returns true if this entry should be expanded after the other one. Ties
+	 * go to the vertex which was added to the open set last, which keeps the
+	 * resulting paths identical to scanning a list that new vertices are
+	 * prepended to.
+	 */
+	bool operator>(const OpenSetEntry &other) const {
+		return costF > other.costF || (costF == other.costF && seq < other.seq);
+	}
+};
+
+/**
+ * Binary min-heap of open vertices. Improving the cost of an open vertex adds
+ * another entry, outdated entries are skipped when they reach the top.
+ */
+class OpenSet {
+public:
+	bool empty() const { return _heap.empty(); }
+	const OpenSetEntry &top() const { return _heap[0]; }
+
+	void push(Vertex *vertex) {
+		OpenSetEntry entry;
+		entry.costF = vertex->costF;
+		entry.seq = vertex->openSeq;
+		entry.vertex = vertex;
+
+		uint pos = _heap.size();
+		_heap.push_back(entry);
+		while (pos > 0) {
+			const uint parent = (pos - 1) / 2;
+			if (!(_heap[parent] > entry))
+				break;
+			_heap[pos] = _heap[parent];
+			pos = parent;
+		}
+		_heap[pos] = entry;
+	}
+
+	void pop() {
+		const OpenSetEntry entry = _heap.back();
+		_heap.pop_back();
+		if (_heap.empty())
+			return;
+
+		const uint size = _heap.size();
+		uint pos = 0;
+		for (;;) {
+			uint child = pos * 2 + 1;
+			if (child >= size)
+				break;
+			if (child + 1 < size && _heap[child] > _heap[child + 1])
+				child++;
+			if (!(entry > _heap[child]))
+				break;
+			_heap[pos] = _heap[child];
+			pos = child;
+		}
+		_heap[pos] = entry;
+	}
+
+	/** Drops outdated entries from the top */
+	void prune() {
+		while (!_heap.empty() && (top().vertex->closed || top().costF != top().vertex->costF))
+			pop();
+	}
+
+private:
+	Common::Array<OpenSetEntry> _heap;
+};
+
 /**
  * Computes a shortest path from vertex_start to vertex_end. The caller can
  * construct the resulting path by following the path_prev links from
@@ -1356,52 +1612,55 @@ static PathfindingState *convert_polygon_set(EngineState *s, reg_t poly_list, Co
  * Parameters: (PathfindingState *) s: The pathfinding state
  */
 static void AStar(PathfindingState *s) {
-	// Vertices of which the shortest path is known
-	VertexList closedSet;
+	// The vertices which are reachable, but of which the shortest path isn't
+	// known yet
+	OpenSet openSet;
+	uint32 openSeq = 0;
+	bool found = false;
 
-	// The remaining vertices
-	VertexList openSet;
+	Common::Array<Vertex *> visVerts;
 
-	openSet.push_front(s->vertex_start);
 	s->vertex_start->costG = 0;
 	s->vertex_start->costF = (uint32)sqrt((float)s->vertex_start->v.sqrDist(s->vertex_end->v));
+	s->vertex_start->open = true;
+	s->vertex_start->openSeq = openSeq++;
+	openSet.push(s->vertex_start);
 
-	while (!openSet.empty()) {
+	for (;;) {
 		// Find vertex in open set with lowest F cost
-		VertexList::iterator vertex_min_it = openSet.end();
-		Vertex *vertex_min = 0;
-		uint32 min = HUGE_DISTANCE;
-
-		for (VertexList::iterator it = openSet.begin(); it != openSet.end(); ++it) {
-			Vertex *vertex = *it;
-			if (vertex->costF < min) {
-				vertex_min_it = it;
-				vertex_min = *vertex_min_it;
-				min = vertex->costF;
-			}
-		}
+		openSet.prune();
+		if (openSet.empty())
+			break;
 
-		assert(vertex_min != 0);	// the vertex cost should never be bigger than HUGE_DISTANCE
+		Vertex *vertex_min = openSet.top().vertex;
+
+		assert(vertex_min->costF < HUGE_DISTANCE);	// the vertex cost should never be bigger than HUGE_DISTANCE
 
 		// Check if we are done
-		if (vertex_min == s->vertex_end)
+		if (vertex_min == s->vertex_end) {
+			found = true;
 			break;
+		}
 
 		// Move vertex from set open to set closed
-		closedSet.push_front(vertex_min);
-		openSet.erase(vertex_min_it);
+		openSet.pop();
+		vertex_min->open = false;
+		vertex_min->closed = true;
 
-		VertexList *visVerts = visible_vertices(s, vertex_min);
+		visible_vertices(s, vertex_min, visVerts);
 
-		for (VertexList::iterator it = visVerts->begin(); it != visVerts->end(); ++it) {
+		for (uint i = 0; i < visVerts.size(); ++i) {
 			uint32 new_dist;
-			Vertex *vertex = *it;
+			Vertex *vertex = visVerts[i];
 
-			if (closedSet.contains(vertex))
+			if (vertex->closed)
 				continue;
 
-			if (!openSet.contains(vertex))
-				openSet.push_front(vertex);
+			const bool added = !vertex->open;
+			if (added) {
+				vertex->open = true;
+				vertex->openSeq = openSeq++;
+			}
 
 			new_dist = vertex_min->costG + (uint32)sqrt((float)vertex_min->v.sqrDist(vertex->v));
 
@@ -1435,17 +1694,19 @@ static void AStar(PathfindingState *s) {
 			if (s->pointOnScreenBorder(vertex->v) && !penaltyWorkaround)
 				new_dist += 10000;
 
-			if (new_dist < vertex->costG) {
+			const bool improved = new_dist < vertex->costG;
+			if (improved) {
 				vertex->costG = new_dist;
 				vertex->costF = vertex->costG + (uint32)sqrt((float)vertex->v.sqrDist(s->vertex_end->v));
 				vertex->path_prev = vertex_min;
 			}
-		}
 
-		delete visVerts;
+			if (added || improved)
+				openSet.push(vertex);
+		}
 	}
 
-	if (openSet.empty())
+	if (!found)
 		debugC(kDebugLevelAvoidPath, "AvoidPath: End point (%i, %i) is unreachable", s->vertex_end->v.x, s->vertex_end->v.y);
 }
 
@@ -1464,6 +1725,41 @@ static reg_t allocateOutputArray(SegManager *segMan, int size) {
 	return addr;
 }
 
+/**
+ * Collects the final path, including the prepended and appended points
+ * Parameters: (PathfindingState *) p: The pathfinding state
+ *             (Common::Array<Common::Point> &) path: Receives the path
+ */
+static void compute_path(PathfindingState *p, Common::Array<Common::Point> &path) {
+	path.clear();
+
+	if (p->vertex_end->path_prev == NULL) {
+		// If pathfinding failed we only return the path up to vertex_start
+
+		if (p->_prependPoint)
+			path.push_back(*p->_prependPoint);
+		else
+			path.push_back(p->vertex_start->v);
+
+		path.push_back(p->vertex_start->v);
+		return;
+	}
+
+	if (p->_prependPoint)
+		path.push_back(*p->_prependPoint);
+
+	const uint offset = path.size();
+	for (Vertex *vertex = p->vertex_end; vertex; vertex = vertex->path_prev)
+		path.push_back(vertex->v);
+
+	// The path was collected backwards from the end point
+	for (uint i = offset, j = path.size() - 1; i < j; i++, j--)
+		SWAP(path[i], path[j]);
+
+	if (p->_appendPoint)
+		path.push_back(*p->_appendPoint);
+}
+
 /**
  * Stores the final path in newly allocated dynmem
  * Parameters: (PathfindingState *) p: The pathfinding state
@@ -1471,75 +1767,73 @@ static reg_t allocateOutputArray(SegManager *segMan, int size) {
  * Returns   : (reg_t) Pointer to dynmem containing path
  */
 static reg_t output_path(PathfindingState *p, EngineState *s) {
-	int path_len = 0;
-	reg_t output;
-	Vertex *vertex = p->vertex_end;
-	int unreachable = vertex->path_prev == NULL;
-
-	if (!unreachable) {
-		while (vertex) {
-			// Compute path length
-			path_len++;
-			vertex = vertex->path_prev;
-		}
-	}
-
-	// Allocate memory for path, plus 3 extra for appended point, prepended point and sentinel
-	output = allocateOutputArray(s->_segMan, path_len + 3);
+	Common::Array<Common::Point> path;
+	compute_path(p, path);
+
+	// Allocate memory for path, plus 3 extra for appended point, prepended
+	// point and sentinel, whether or not they are used
+	const bool reachable = p->vertex_end->path_prev != NULL;
+	const int extraPoints = (p->_prependPoint ? 1 : 0) + (p->_appendPoint ? 1 : 0);
+	reg_t output = allocateOutputArray(s->_segMan, reachable ? path.size() - extraPoints + 3 : 3);
 	SegmentRef arrayRef = s->_segMan->dereference(output);
 	assert(arrayRef.isValid() && !arrayRef.skipByte);
 
-	if (unreachable) {
-		// If pathfinding failed we only return the path up to vertex_start
+	for (uint i = 0; i < path.size(); i++)
+		writePoint(arrayRef, i, path[i]);
 
-		if (p->_prependPoint)
-			writePoint(arrayRef, 0, *p->_prependPoint);
-		else
-			writePoint(arrayRef, 0, p->vertex_start->v);
+	// Sentinel
+	writePoint(arrayRef, path.size(), Common::Point(POLY_LAST_POINT, POLY_LAST_POINT));
 
-		writePoint(arrayRef, 1, p->vertex_start->v);
-		writePoint(arrayRef, 2, Common::Point(POLY_LAST_POINT, POLY_LAST_POINT));
+	if (DebugMan.isDebugChannelEnabled(kDebugLevelAvoidPath) && reachable) {
+		debug("\nReturning path:");
 
-		return output;
+		for (uint i = 0; i < path.size(); i++)
+			debugN(-1, " (%i, %i)", path[i].x, path[i].y);
+		debug(";\n");
 	}
 
-	int offset = 0;
+	return output;
+}
 
-	if (p->_prependPoint) {
-		writePoint(arrayRef, offset, *p->_prependPoint);
-		offset++;
-	}
+bool benchmarkAvoidPath(EngineState *s, const Common::Array<AvoidPathInput> &inputs, int repeats, uint32 &uncachedTime, uint32 &cachedTime) {
+	Common::Array<Common::Array<Common::Point> > paths[2];
+	uint32 times[2];
 
-	vertex = p->vertex_end;
-	for (int i = path_len - 1; i >= 0; i--) {
-		writePoint(arrayRef, offset + i, vertex->v);
-		vertex = vertex->path_prev;
-	}
-	offset += path_len;
+	for (int cached = 0; cached < 2; cached++) {
+		const uint32 startTime = g_system->getMillis();
 
-	if (p->_appendPoint)
-		writePoint(arrayRef, offset++, *p->_appendPoint);
+		paths[cached].resize(inputs.size());
+		for (int r = 0; r < repeats; r++) {
+			for (uint i = 0; i < inputs.size(); i++) {
+				const AvoidPathInput &input = inputs[i];
+				PathfindingState *p = new PathfindingState(input.width, input.height);
 
-	// Sentinel
-	writePoint(arrayRef, offset, Common::Point(POLY_LAST_POINT, POLY_LAST_POINT));
+				decode_polygons(input.polygons, p->polygons);
+				if (input.opt == 0)
+					change_polygons_opt_0(p);
 
-	if (DebugMan.isDebugChannelEnabled(kDebugLevelAvoidPath)) {
-		debug("\nReturning path:");
+				if (prepare_pathfinding(s, p, input.start, input.end, input.opt, cached)) {
+					AStar(p);
+					compute_path(p, paths[cached][i]);
+				} else {
+					paths[cached][i].clear();
+				}
 
-		SegmentRef outputList = s->_segMan->dereference(output);
-		if (!outputList.isValid() || outputList.skipByte) {
-			warning("output_path: Polygon data pointer is invalid, skipping polygon");
-			return output;
+				delete p;
+			}
 		}
 
-		for (int i = 0; i < offset; i++) {
-			Common::Point pt = readPoint(outputList, i);
-			debugN(-1, " (%i, %i)", pt.x, pt.y);
-		}
-		debug(";\n");
+		times[cached] = g_system->getMillis() - startTime;
 	}
 
-	return output;
+	uncachedTime = times[0];
+	cachedTime = times[1];
+
+	for (uint i = 0; i < inputs.size(); i++) {
+		if (paths[0][i] != paths[1][i])
+			return false;
+	}
+	return true;
 }
 
 reg_t kAvoidPath(EngineState *s, int argc, reg_t *argv) {
@@ -73,6 +73,29 @@ void Script::freeScript(const bool keepLocalsSegment) {
 	_offsetLookupObjectCount = 0;
 	_offsetLookupStringCount = 0;
 	_offsetLookupSaidCount = 0;
+
+	freeDecodedInstructions();
+}
+
+const DecodedInstruction &Script::decodeInstruction(uint32 offset) {
+	if (_decodedPages.empty())
+		_decodedPages.resize((getBufSize() + kDecodedPageSize - 1) >> kDecodedPageShift);
+
+	DecodedInstruction *&page = _decodedPages[offset >> kDecodedPageShift];
+	if (!page) {
+		page = new DecodedInstruction[kDecodedPageSize];
+		memset(page, 0, kDecodedPageSize * sizeof(DecodedInstruction));
+	}
+
+	DecodedInstruction &instruction = page[offset & (kDecodedPageSize - 1)];
+	instruction.size = readPMachineInstruction(getBuf(offset), instruction.extOpcode, instruction.opparams);
+	return instruction;
+}
+
+void Script::freeDecodedInstructions() {
+	for (uint i = 0; i < _decodedPages.size(); ++i)
+		delete[] _decodedPages[i];
+	_decodedPages.clear();
 }
 
 enum {
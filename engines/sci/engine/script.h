@@ -69,6 +69,13 @@ struct offsetLookupArrayEntry {
 
 typedef Common::Array<offsetLookupArrayEntry> offsetLookupArrayType;
 
+/** A PMachine instruction as decoded by readPMachineInstruction */
+struct DecodedInstruction {
+	int16 opparams[4];
+	uint16 size; ///< Length of the instruction in bytes, 0 if not decoded yet
+	byte extOpcode;
+};
+
 class Script : public SegmentObj {
 private:
 	int _nr; /**< Script number */
@@ -102,7 +109,36 @@ private:
 	uint16 _offsetLookupStringCount;
 	uint16 _offsetLookupSaidCount;
 
+	enum {
+		kDecodedPageShift = 8,
+		kDecodedPageSize = 1 << kDecodedPageShift
+	};
+
+	/**
+	 * Instructions decoded so far, indexed by their offset in the script
+	 * buffer. Pages of kDecodedPageSize offsets are only allocated once code
+	 * in them is executed, so that data areas cost nothing.
+	 */
+	Common::Array<DecodedInstruction *> _decodedPages;
+
+	const DecodedInstruction &decodeInstruction(uint32 offset);
+	void freeDecodedInstructions();
+
 public:
+	/**
+	 * Returns the instruction at the given offset of the script buffer,
+	 * decoding it on first use, so that the VM only parses hot code once.
+	 */
+	inline const DecodedInstruction &getDecodedInstruction(uint32 offset) {
+		const uint32 page = offset >> kDecodedPageShift;
+		if (page < _decodedPages.size() && _decodedPages[page]) {
+			const DecodedInstruction &instruction = _decodedPages[page][offset & (kDecodedPageSize - 1)];
+			if (instruction.size)
+				return instruction;
+		}
+		return decodeInstruction(offset);
+	}
+
 	int getLocalsOffset() const { return _localsOffset; }
 	uint16 getLocalsCount() const { return _localsCount; }
 
@@ -22,6 +22,7 @@
 
 #include "sci/sci.h"
 #include "sci/engine/seg_manager.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/state.h"
 #include "sci/engine/script.h"
 #ifdef ENABLE_SCI32
@@ -32,7 +33,7 @@ namespace Sci {
 
 
 SegManager::SegManager(ResourceManager *resMan, ScriptPatcher *scriptPatcher)
-	: _resMan(resMan), _scriptPatcher(scriptPatcher) {
+	: _resMan(resMan), _scriptPatcher(scriptPatcher), _gc(nullptr) {
 	_heap.push_back(0);
 
 	_clonesSegId = 0;
@@ -110,6 +111,11 @@ SegmentId SegManager::findFreeSegment() const {
 	return seg;
 }
 
+void SegManager::objectAllocated(reg_t addr) {
+	if (_gc)
+		_gc->objectAllocated(addr);
+}
+
 SegmentObj *SegManager::allocSegment(SegmentObj *mem, SegmentId *segid) {
 	// Find a free segment
 	SegmentId id = findFreeSegment();
@@ -414,6 +420,7 @@ reg_t SegManager::allocateHunkEntry(const char *hunk_type, int size) {
 	h->size = size;
 	h->type = hunk_type;
 
+	objectAllocated(addr);
 	return addr;
 }
 
@@ -440,6 +447,7 @@ Clone *SegManager::allocateClone(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_clonesSegId, offset);
+	objectAllocated(*addr);
 	return &table->at(offset);
 }
 
@@ -454,6 +462,7 @@ List *SegManager::allocateList(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_listsSegId, offset);
+	objectAllocated(*addr);
 	return &table->at(offset);
 }
 
@@ -468,6 +477,7 @@ Node *SegManager::allocateNode(reg_t *addr) {
 	offset = table->allocEntry();
 
 	*addr = make_reg(_nodesSegId, offset);
+	objectAllocated(*addr);
 	return &table->at(offset);
 }
 
@@ -866,6 +876,7 @@ byte *SegManager::allocDynmem(int size, const char *descr, reg_t *addr) {
 
 	d._description = descr;
 
+	objectAllocated(*addr);
 	return (byte *)(d._buf);
 }
 
@@ -899,6 +910,8 @@ SciArray *SegManager::allocateArray(SciArrayType type, uint16 size, reg_t *addr)
 	SciArray *array = &table->at(offset);
 	array->setType(type);
 	array->resize(size);
+
+	objectAllocated(*addr);
 	return array;
 }
 
@@ -928,6 +941,10 @@ void SegManager::freeArray(reg_t addr) {
 	if (!arrayTable.isValidEntry(addr.getOffset()))
 		error("Attempt to use non-array %04x:%04x as array", PRINT_REG(addr));
 
+	// The array may hold the last references to objects
+	if (_gc)
+		_gc->scanObject(addr);
+
 	arrayTable.freeEntry(addr.getOffset());
 }
 
@@ -955,6 +972,7 @@ SciBitmap *SegManager::allocateBitmap(reg_t *addr, const int16 width, const int1
 
 	bitmap.create(width, height, skipColor, originX, originY, xResolution, yResolution, paletteSize, remap, gc);
 
+	objectAllocated(*addr);
 	return &bitmap;
 }
 
@@ -44,6 +44,7 @@ enum ScriptLoadType {
 	SCRIPT_GET_LOCK = 3 /**< Load, if neccessary, and lock */
 };
 
+class IncrementalGC;
 class Script;
 
 class SegManager : public Common::Serializable {
@@ -61,6 +62,12 @@ public:
 
 	void resetSegMan();
 
+	/**
+	 * Sets the incremental collector, which is told about every deallocatable
+	 * object which is allocated or freed explicitly.
+	 */
+	void setGC(IncrementalGC *gc) { _gc = gc; }
+
 	void saveLoadWithSerializer(Common::Serializer &ser) override;
 
 	// 1. Scripts
@@ -466,6 +473,7 @@ private:
 
 	ResourceManager *_resMan;
 	ScriptPatcher *_scriptPatcher;
+	IncrementalGC *_gc;
 
 	SegmentId _clonesSegId; ///< ID of the (a) clones segment
 	SegmentId _listsSegId; ///< ID of the (a) list segment
@@ -486,6 +494,7 @@ public:
 
 private:
 	void deallocate(SegmentId seg);
+	void objectAllocated(reg_t addr);
 	void createClassTable();
 
 	SegmentId findFreeSegment() const;
@@ -22,6 +22,7 @@
 
 #include "sci/sci.h"
 #include "sci/engine/features.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/scriptdebug.h"
 #include "sci/engine/state.h"
@@ -285,6 +286,7 @@ void writeSelector(SegManager *segMan, reg_t object, Selector selectorId, reg_t
 			                curValue, value, segMan, BREAK_SELECTORWRITE);
 	}
 
+	g_sci->getEngineState()->_gc->writeBarrier(*address.getPointer(segMan));
 	*address.getPointer(segMan) = value;
 #ifdef ENABLE_SCI32
 	updateInfoFlagViewVisible(segMan->getObject(object), address.varindex);
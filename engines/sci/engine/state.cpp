@@ -19,11 +19,13 @@
  * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
  *
  */
+#include "common/config-manager.h"
 #include "common/system.h"
 
 #include "sci/sci.h"	// for INCLUDE_OLDGFX
 #include "sci/debug.h"	// for g_debug_sleeptime_factor
 #include "sci/engine/file.h"
+#include "sci/engine/gc.h"
 #include "sci/engine/guest_additions.h"
 #include "sci/engine/kernel.h"
 #include "sci/engine/state.h"
@@ -68,13 +70,19 @@ static const uint16 s_halfWidthSJISMap[256] = {
 
 EngineState::EngineState(SegManager *segMan)
 : _segMan(segMan),
-	_dirseeker() {
+	_dirseeker(),
+	_gc(new IncrementalGC(this)) {
 
+	_segMan->setGC(_gc);
 	reset(false);
+
+	incrementalGC = ConfMan.hasKey("sci_incremental_gc") && ConfMan.getBool("sci_incremental_gc");
+	verifyGC = false;
 }
 
 EngineState::~EngineState() {
 	delete _msgState;
+	delete _gc;
 }
 
 void EngineState::reset(bool isRestoring) {
@@ -103,6 +111,7 @@ void EngineState::reset(bool isRestoring) {
 	lastWaitTime = 0;
 
 	gcCountDown = 0;
+	_gc->cancel();
 
 #ifdef ENABLE_SCI32
 	_eventCounter = 0;
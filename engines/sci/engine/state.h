@@ -45,6 +45,7 @@ namespace Sci {
 
 class FileHandle;
 class DirSeeker;
+class IncrementalGC;
 class EventManager;
 class MessageState;
 class SoundCommandParser;
@@ -98,6 +99,12 @@ struct SciCallOrigin {
 	}
 };
 
+/** Visibility between the polygon vertices of a kAvoidPath polygon set */
+struct AvoidPathGraph {
+	Common::Array<int16> signature; ///< Types and points of the polygons
+	Common::Array<Common::Array<uint16> > visible; ///< Visible vertices of each vertex, in descending order
+};
+
 struct EngineState : public Common::Serializable {
 public:
 	EngineState(SegManager *segMan);
@@ -178,6 +185,8 @@ public:
 
 	int scriptStepCounter; // Counts the number of steps executed
 	int scriptGCInterval; // Number of steps in between gcs
+	bool incrementalGC; // Spread garbage collection over several kernel calls
+	bool verifyGC; // Check each incremental collection against a full one
 
 	uint16 currentRoomNumber() const;
 	void setRoomNumber(uint16 roomNumber);
@@ -194,6 +203,10 @@ public:
 	void shrinkStackToBase();
 
 	int gcCountDown; /**< Number of kernel calls until next gc */
+	IncrementalGC *_gc;
+
+	/** Visibility graphs of recent kAvoidPath polygon sets, most recently built first */
+	Common::List<AvoidPathGraph> _avoidPathGraphs;
 
 	MessageState *_msgState;
 
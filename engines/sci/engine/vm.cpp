@@ -23,6 +23,7 @@
 #include "common/config-manager.h"
 #include "common/debug.h"
 #include "common/debug-channels.h"
+#include "common/system.h"
 
 #include "sci/sci.h"
 #include "sci/console.h"
@@ -188,6 +189,7 @@ static void write_var(EngineState *s, int type, int index, reg_t value) {
 				ObjVarRef varp;
 				if (lookupSelector(s->_segMan, stopGroopPos, SELECTOR(client), &varp, NULL) == kSelectorVariable) {
 					reg_t *clientVar = varp.getPointer(s->_segMan);
+					s->_gc->writeBarrier(*clientVar);
 					*clientVar = value;
 				}
 			}
@@ -200,6 +202,7 @@ static void write_var(EngineState *s, int type, int index, reg_t value) {
 		if (type == VAR_TEMP && value.getSegment() == kUninitializedSegment)
 			value.setSegment(0);
 
+		s->_gc->writeBarrier(s->variables[type][index]);
 		s->variables[type][index] = value;
 
 		g_sci->_guestAdditions->writeVarHook(type, index, value);
@@ -249,6 +252,7 @@ static void _exec_varselectors(EngineState *s) {
 		} else {
 			// varselector access?
 			if (xs.argc) { // write?
+				s->_gc->writeBarrier(*var);
 				*var = xs.variables_argp[1];
 
 #ifdef ENABLE_SCI32
@@ -570,9 +574,51 @@ uint32 findOffset(const int16 relOffset, const Script *scr, const uint32 pcOffse
 	return offset;
 }
 
+/**
+ * Times the outermost run_vm() calls for the vm_trace debugger command. The
+ * calls alternate between executing with and without the decoded
+ * instruction cache, so that both see the same mix of scripts.
+ */
+class VmExecutionTimer {
+public:
+	VmExecutionTimer() : _timed(false), _startTime(0), _cache(0) {
+		DebugState &debugState = g_sci->_debugState;
+		if (_depth++ != 0 || debugState.vmTimingRuns == 0)
+			return;
+
+		_timed = true;
+		_cache = debugState.vmTimingRuns & 1;
+		debugState.useDecodedInstructions = (_cache != 0);
+		_startTime = g_system->getMillis();
+	}
+
+	~VmExecutionTimer() {
+		_depth--;
+		if (!_timed)
+			return;
+
+		DebugState &debugState = g_sci->_debugState;
+		debugState.vmTime[_cache] += g_system->getMillis() - _startTime;
+		debugState.vmRuns[_cache]++;
+		if (--debugState.vmTimingRuns == 0)
+			debugState.useDecodedInstructions = debugState.vmTimingCache;
+	}
+
+private:
+	static int _depth;
+
+	bool _timed;
+	uint32 _startTime;
+	int _cache;
+};
+
+int VmExecutionTimer::_depth = 0;
+
 void run_vm(EngineState *s) {
 	assert(s);
 
+	VmExecutionTimer timer;
+
 	int temp;
 	reg_t r_temp; // Temporary register
 	StackPtr s_temp; // Temporary stack pointer
@@ -600,6 +646,12 @@ void run_vm(EngineState *s) {
 
 	s->_executionStackPosChanged = true; // Force initialization
 
+	// Debugger settings, read again whenever the execution stack position
+	// changes. The console marks it as changed when it is left.
+	bool recordVmTrace = false;
+	bool useDecodedInstructions = true;
+	uint32 *vmInstructionCount = nullptr;
+
 #ifdef ABORT_ON_INFINITE_LOOP
 	byte prevOpcode = 0xFF;
 #endif
@@ -636,6 +688,11 @@ void run_vm(EngineState *s) {
 			}
 			s->variables[VAR_TEMP] = s->xs->fp;
 			s->variables[VAR_PARAM] = s->xs->variables_argp;
+
+			DebugState &debugState = g_sci->_debugState;
+			recordVmTrace = debugState.recordVmTrace;
+			useDecodedInstructions = debugState.useDecodedInstructions;
+			vmInstructionCount = debugState.vmTimingRuns ? &debugState.vmInstructions[useDecodedInstructions ? 1 : 0] : nullptr;
 		}
 
 		if (s->abortScriptProcessing != kAbortNone)
@@ -664,9 +721,26 @@ void run_vm(EngineState *s) {
 
 		// Get opcode
 		byte extOpcode;
-		if (!vmHooks.isActive(s))
-			s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
-		else {
+		if (!vmHooks.isActive(s)) {
+			if (recordVmTrace) {
+				if (g_sci->_debugState.vmTrace.size() < kMaxVmTraceLength)
+					g_sci->_debugState.vmTrace.push_back(s->xs->addr.pc);
+				else
+					g_sci->_debugState.recordVmTrace = recordVmTrace = false;
+			}
+
+			if (vmInstructionCount)
+				(*vmInstructionCount)++;
+
+			if (useDecodedInstructions) {
+				const DecodedInstruction &instruction = scr->getDecodedInstruction(s->xs->addr.pc.getOffset());
+				extOpcode = instruction.extOpcode;
+				memcpy(opparams, instruction.opparams, sizeof(opparams));
+				s->xs->addr.pc.incOffset(instruction.size);
+			} else {
+				s->xs->addr.pc.incOffset(readPMachineInstruction(scr->getBuf(s->xs->addr.pc.getOffset()), extOpcode, opparams));
+			}
+		} else {
 			int offset = readPMachineInstruction(vmHooks.data(), extOpcode, opparams);
 			vmHooks.advance(offset);
 		}
@@ -909,7 +983,10 @@ void run_vm(EngineState *s) {
 			// Run the garbage collector, if needed
 			if (s->gcCountDown-- <= 0) {
 				s->gcCountDown = s->scriptGCInterval;
-				run_gc(s);
+				if (s->incrementalGC)
+					s->_gc->start();
+				else
+					run_gc(s);
 			}
 
 			// Call kernel function
@@ -924,6 +1001,7 @@ void run_vm(EngineState *s) {
 			if (!oldScriptHeader)
 				argc += s->r_rest;
 
+			s->_gc->beforeKernelCall(argc, s->xs->sp + 1);
 			callKernelFunc(s, opparams[0], argc);
 
 			if (!oldScriptHeader)
@@ -990,6 +1068,7 @@ void run_vm(EngineState *s) {
 					// varselector access?
 					reg_t *var = old_xs->getVarPointer(s->_segMan);
 					if (old_xs->argc) { // write?
+						s->_gc->writeBarrier(*var);
 						*var = old_xs->variables_argp[1];
 
 #ifdef ENABLE_SCI32
@@ -1176,6 +1255,7 @@ void run_vm(EngineState *s) {
 				                    s->_segMan, BREAK_SELECTORWRITE);
 			}
 
+			s->_gc->writeBarrier(opProperty);
 			opProperty = s->r_acc;
 #ifdef ENABLE_SCI32
 			updateInfoFlagViewVisible(obj, opparams[0], true);
@@ -1206,6 +1286,7 @@ void run_vm(EngineState *s) {
 				                    opProperty, newValue,
 				                    s->_segMan, BREAK_SELECTORWRITE);
 			}
+			s->_gc->writeBarrier(opProperty);
 			opProperty = newValue;
 #ifdef ENABLE_SCI32
 			updateInfoFlagViewVisible(obj, opparams[0], true);
@@ -1229,6 +1310,7 @@ void run_vm(EngineState *s) {
 				                    s->_segMan, BREAK_SELECTORREAD);
 			}
 
+			s->_gc->writeBarrier(opProperty);
 			if (opcode & 1)
 				opProperty += 1;
 			else
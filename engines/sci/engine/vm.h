@@ -418,6 +418,11 @@ SelectorType lookupSelector(SegManager *segMan, reg_t obj, Selector selectorid,
  */
 int readPMachineInstruction(const byte *src, byte &extOpcode, int16 opparams[4]);
 
+enum {
+	/** Maximum number of instructions recorded by the vm_trace debugger command */
+	kMaxVmTraceLength = 4 * 1024 * 1024
+};
+
 /**
  * Finds the script-absolute offset of a relative object offset.
  *
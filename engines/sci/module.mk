@@ -68,6 +68,7 @@ MODULE_OBJS := \
 	resource/decompressor.o \
 	resource/resource.o \
 	resource/resource_audio.o \
+	resource/resource_index.o \
 	resource/resource_patcher.o \
 	sound/audio.o \
 	sound/midiparser_sci.o \
@@ -22,9 +22,11 @@
 
 // Resource library
 
+#include "common/config-manager.h"
 #include "common/file.h"
 #include "common/fs.h"
 #include "common/macresman.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "common/translation.h"
 #ifdef ENABLE_SCI32
@@ -34,6 +36,7 @@
 #include "sci/engine/workarounds.h"
 #include "sci/parser/vocabulary.h"
 #include "sci/resource/resource.h"
+#include "sci/resource/resource_index.h"
 #include "sci/resource/resource_intern.h"
 #include "sci/resource/resource_patcher.h"
 #include "sci/util.h"
@@ -214,6 +217,12 @@ Resource::Resource(ResourceManager *resMan, ResourceId id) : SciSpan<const byte>
 	_source = nullptr;
 	_header = nullptr;
 	_headerSize = 0;
+	_lruPrev = nullptr;
+	_lruNext = nullptr;
+	_lruRefs = 0;
+	_lruPriority = 0;
+	_lruSequence = 0;
+	_lruHeapIndex = -1;
 }
 
 Resource::~Resource() {
@@ -227,6 +236,7 @@ void Resource::unalloc() {
 	delete[] _data;
 	_data = nullptr;
 	_status = kResStatusNoMalloc;
+	_lruRefs = 0;
 }
 
 void Resource::writeToStream(Common::WriteStream *stream) const {
@@ -881,7 +891,7 @@ void ExtAudioMapResourceSource::scanSource(ResourceManager *resMan) {
 }
 
 void IntMapResourceSource::scanSource(ResourceManager *resMan) {
-	if (resMan->readAudioMapSCI11(this) != SCI_ERROR_NONE) {
+	if (resMan->readIndexedAudioMapSCI11(this) != SCI_ERROR_NONE) {
 		resMan->_hasBadResources = true;
 	}
 }
@@ -986,13 +996,28 @@ void ResourceManager::freeResourceSources() {
 }
 
 ResourceManager::ResourceManager(const bool detectionMode) :
-	_detectionMode(detectionMode) {}
+	_detectionMode(detectionMode), _resourceIndex(nullptr), _indexRecording(nullptr) {}
+
+// The resource index is stored with the saved games of the target
+static Common::String getResourceIndexFileName() {
+	return ConfMan.getActiveDomainName() + ".residx";
+}
 
 void ResourceManager::init() {
+	const uint32 startTime = g_system->getMillis();
+
 	_maxMemoryLRU = 256 * 1024; // 256KiB
 	_memoryLocked = 0;
 	_memoryLRU = 0;
-	_LRU.clear();
+	_lruHead = nullptr;
+	_lruTail = nullptr;
+	_evictionPolicy = kEvictionLRU;
+	if (ConfMan.hasKey("sci_cost_weighted_eviction") && ConfMan.getBool("sci_cost_weighted_eviction"))
+		_evictionPolicy = kEvictionCostWeighted;
+	_evictionClock = 0;
+	_lruSequence = 0;
+	_evictionHeap.clear();
+	resetCacheStats();
 	_resMap.clear();
 	_audioMapSCI1 = NULL;
 #ifdef ENABLE_SCI32
@@ -1005,6 +1030,13 @@ void ResourceManager::init() {
 		_patcher = NULL;
 	};
 
+	_indexedMaps = 0;
+	_scannedMaps = 0;
+	if (!_detectionMode && g_sci && !_resourceIndex) {
+		_resourceIndex = new ResourceIndex();
+		_resourceIndex->load(getResourceIndexFileName());
+	}
+
 	// FIXME: put this in an Init() function, so that we can error out if detection fails completely
 
 	_mapVersion = detectMapVersion();
@@ -1054,6 +1086,12 @@ void ResourceManager::init() {
 	addScriptChunkSources();
 	scanNewSources();
 
+	if (_resourceIndex)
+		_resourceIndex->flush(getResourceIndexFileName());
+
+	debugC(1, kDebugLevelResMan, "resMan: Indexed %u resources in %u ms (%u audio maps from the resource index, %u scanned into it)",
+	       _resMap.size(), g_system->getMillis() - startTime, _indexedMaps, _scannedMaps);
+
 	detectSciVersion();
 
 	debugC(1, kDebugLevelResMan, "resMan: Detected %s", getSciVersionDesc(getSciVersion()));
@@ -1100,6 +1138,12 @@ ResourceManager::~ResourceManager() {
 	}
 	freeResourceSources();
 
+	// Audio maps may have been scanned since init(), e.g. for another disc
+	if (_resourceIndex) {
+		_resourceIndex->flush(getResourceIndexFileName());
+		delete _resourceIndex;
+	}
+
 	Common::List<Common::File *>::iterator it = _volumeFiles.begin();
 	while (it != _volumeFiles.end()) {
 		delete *it;
@@ -1112,17 +1156,90 @@ void ResourceManager::removeFromLRU(Resource *res) {
 		warning("resMan: trying to remove resource that isn't enqueued");
 		return;
 	}
-	_LRU.remove(res);
+
+	if (res->_lruPrev)
+		res->_lruPrev->_lruNext = res->_lruNext;
+	else
+		_lruHead = res->_lruNext;
+
+	if (res->_lruNext)
+		res->_lruNext->_lruPrev = res->_lruPrev;
+	else
+		_lruTail = res->_lruPrev;
+
+	res->_lruPrev = res->_lruNext = nullptr;
+
+	// Fill the hole with the last entry of the heap
+	const uint index = res->_lruHeapIndex;
+	Resource *last = _evictionHeap.back();
+	_evictionHeap.pop_back();
+	res->_lruHeapIndex = -1;
+	if (last != res) {
+		_evictionHeap[index] = last;
+		last->_lruHeapIndex = index;
+		siftEvictionHeapDown(index);
+		siftEvictionHeapUp(last->_lruHeapIndex);
+	}
+
 	_memoryLRU -= res->size();
 	res->_status = kResStatusAllocated;
 }
 
+/**
+ * Relative cost of loading a resource of the given type again after it has
+ * been freed. Pictures and views are usually compressed with the slower
+ * algorithms and are drawn from repeatedly, while audio is big, read once and
+ * mostly stored uncompressed.
+ */
+static uint32 getResourceReloadCost(ResourceType type) {
+	switch (type) {
+	case kResourceTypeView:
+	case kResourceTypePic:
+		return 8;
+	case kResourceTypeScript:
+	case kResourceTypeHeap:
+	case kResourceTypeVocab:
+	case kResourceTypeFont:
+	case kResourceTypePalette:
+		return 4;
+	case kResourceTypeAudio:
+	case kResourceTypeAudio36:
+	case kResourceTypeSync:
+	case kResourceTypeSync36:
+	case kResourceTypeVMD:
+	case kResourceTypeRobot:
+	case kResourceTypeDuck:
+	case kResourceTypeWave:
+		return 1;
+	default:
+		return 2;
+	}
+}
+
 void ResourceManager::addToLRU(Resource *res) {
 	if (res->_status != kResStatusAllocated) {
 		warning("resMan: trying to enqueue resource with state %d", res->_status);
 		return;
 	}
-	_LRU.push_front(res);
+
+	res->_lruPrev = nullptr;
+	res->_lruNext = _lruHead;
+	if (_lruHead)
+		_lruHead->_lruPrev = res;
+	else
+		_lruTail = res;
+	_lruHead = res;
+
+	// GDSF priority: the clock, which is raised to the priority of every
+	// evicted resource so that old entries age out, plus frequency * cost /
+	// size in 1/65536ths of a byte
+	res->_lruPriority = _evictionClock + MIN<uint32>(res->_lruRefs, 255) * getResourceReloadCost(res->getType()) * 65536 / (res->size() + 1);
+	res->_lruSequence = _lruSequence++;
+
+	res->_lruHeapIndex = _evictionHeap.size();
+	_evictionHeap.push_back(res);
+	siftEvictionHeapUp(res->_lruHeapIndex);
+
 	_memoryLRU += res->size();
 #if SCI_VERBOSE_RESMAN
 	debug("Adding %s (%d bytes) to lru control: %d bytes total",
@@ -1135,24 +1252,78 @@ void ResourceManager::addToLRU(Resource *res) {
 void ResourceManager::printLRU() {
 	int mem = 0;
 	int entries = 0;
-	Common::List<Resource *>::iterator it = _LRU.begin();
-	Resource *res;
 
-	while (it != _LRU.end()) {
-		res = *it;
+	for (Resource *res = _lruHead; res; res = res->_lruNext) {
 		debug("\t%s: %u bytes", res->_id.toString().c_str(), res->size());
 		mem += res->size();
 		++entries;
-		++it;
 	}
 
 	debug("Total: %d entries, %d bytes (mgr says %d)", entries, mem, _memoryLRU);
 }
 
+void ResourceManager::resetCacheStats() {
+	_cacheStats.hits = 0;
+	_cacheStats.misses = 0;
+	_cacheStats.evictions = 0;
+	_cacheStats.evictedBytes = 0;
+}
+
+Resource *ResourceManager::selectEvictionVictim() const {
+	if (_evictionPolicy == kEvictionLRU)
+		return _lruTail;
+
+	return _evictionHeap.front();
+}
+
+bool ResourceManager::isEvictedBefore(const Resource *a, const Resource *b) {
+	// Recency decides between resources of the same priority
+	if (a->_lruPriority != b->_lruPriority)
+		return a->_lruPriority < b->_lruPriority;
+	return a->_lruSequence < b->_lruSequence;
+}
+
+void ResourceManager::siftEvictionHeapUp(uint index) {
+	Resource *res = _evictionHeap[index];
+	while (index > 0) {
+		const uint parent = (index - 1) / 2;
+		if (!isEvictedBefore(res, _evictionHeap[parent]))
+			break;
+		_evictionHeap[index] = _evictionHeap[parent];
+		_evictionHeap[index]->_lruHeapIndex = index;
+		index = parent;
+	}
+	_evictionHeap[index] = res;
+	res->_lruHeapIndex = index;
+}
+
+void ResourceManager::siftEvictionHeapDown(uint index) {
+	Resource *res = _evictionHeap[index];
+	const uint size = _evictionHeap.size();
+	for (;;) {
+		uint child = index * 2 + 1;
+		if (child >= size)
+			break;
+		if (child + 1 < size && isEvictedBefore(_evictionHeap[child + 1], _evictionHeap[child]))
+			child++;
+		if (!isEvictedBefore(_evictionHeap[child], res))
+			break;
+		_evictionHeap[index] = _evictionHeap[child];
+		_evictionHeap[index]->_lruHeapIndex = index;
+		index = child;
+	}
+	_evictionHeap[index] = res;
+	res->_lruHeapIndex = index;
+}
+
 void ResourceManager::freeOldResources() {
 	while (_maxMemoryLRU < _memoryLRU) {
-		assert(!_LRU.empty());
-		Resource *goner = _LRU.back();
+		assert(_lruTail);
+		Resource *goner = selectEvictionVictim();
+		if (_evictionPolicy == kEvictionCostWeighted)
+			_evictionClock = goner->_lruPriority;
+		_cacheStats.evictions++;
+		_cacheStats.evictedBytes += goner->size();
 		removeFromLRU(goner);
 		goner->unalloc();
 #ifdef SCI_VERBOSE_RESMAN
@@ -1197,9 +1368,16 @@ Resource *ResourceManager::findResource(ResourceId id, bool lock) {
 	if (!retval)
 		return NULL;
 
-	if (retval->_status == kResStatusNoMalloc)
+	if (retval->_lruRefs < 0xFFFF)
+		retval->_lruRefs++;
+
+	if (retval->_status == kResStatusNoMalloc) {
+		_cacheStats.misses++;
 		loadResource(retval);
-	else if (retval->_status == kResStatusEnqueued)
+	} else
+		_cacheStats.hits++;
+
+	if (retval->_status == kResStatusEnqueued)
 		// The resource is removed from its current position
 		// in the LRU list because it has been requested
 		// again. Below, it will either be locked, or it
@@ -2178,6 +2356,9 @@ Resource *ResourceManager::addResource(ResourceId resId, ResourceSource *src, ui
 	// format and only static sounds are heard when it's played. The second file
 	// is a typical SOL audio file. We therefore skip the first audio file and add
 	// second one for this game.
+	if (_indexRecording)
+		recordIndexedResource(resId);
+
 	if (_resMap.contains(resId) == false || (resId.getType() == kResourceTypeAudio && g_sci && g_sci->getGameId() == GID_HOYLE4)) {
 		return updateResource(resId, src, offset, size, sourceMapLocation);
 	} else {
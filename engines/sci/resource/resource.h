@@ -146,6 +146,8 @@ enum ResVersion {
 class ResourceManager;
 class ResourceSource;
 class ResourcePatcher;
+class ResourceIndex;
+struct ResourceIndexEntry;
 
 class ResourceId {
 	static inline ResourceType fixupType(ResourceType type) {
@@ -285,6 +287,7 @@ public:
 #endif
 
 	const Common::String &getResourceLocation() const;
+	int32 getFileOffset() const { return _fileOffset; }
 
 	// FIXME: This audio specific method is a hack. After all, why should a
 	// Resource have audio specific methods? But for now we keep this, as it
@@ -299,6 +302,12 @@ protected:
 	ResourceStatus _status;
 	uint16 _lockers; /**< Number of places where this resource was locked */
 	ResourceSource *_source;
+	Resource *_lruPrev; /**< Next more recently used resource in the LRU queue */
+	Resource *_lruNext; /**< Next less recently used resource in the LRU queue */
+	uint16 _lruRefs; /**< Number of lookups since the resource was loaded */
+	uint64 _lruPriority; /**< Eviction priority, for cost-weighted eviction */
+	uint64 _lruSequence; /**< When the resource was enqueued, breaks priority ties */
+	int _lruHeapIndex; /**< Position in the eviction heap, or -1 */
 	ResourceManager *_resMan;
 
 	bool loadPatch(Common::SeekableReadStream *file);
@@ -369,6 +378,33 @@ public:
 	 */
 	void unlockResource(Resource *res);
 
+	/** Strategies for choosing which unlocked resource to free first */
+	enum EvictionPolicy {
+		/** Free the least recently used resource */
+		kEvictionLRU,
+		/**
+		 * Greedy-dual-size-frequency: prefer freeing resources which are big,
+		 * rarely used and cheap to load again.
+		 */
+		kEvictionCostWeighted
+	};
+
+	/** Counters describing how well the resource cache performs */
+	struct CacheStats {
+		uint32 hits;         ///< Lookups of resources which were already in memory
+		uint32 misses;       ///< Lookups which had to load the resource
+		uint32 evictions;    ///< Resources freed to stay below the memory limit
+		uint32 evictedBytes; ///< Total size of the freed resources
+	};
+
+	void setEvictionPolicy(EvictionPolicy policy) { _evictionPolicy = policy; }
+	EvictionPolicy getEvictionPolicy() const { return _evictionPolicy; }
+	const CacheStats &getCacheStats() const { return _cacheStats; }
+	void resetCacheStats();
+	int getMemoryLRU() const { return _memoryLRU; }
+	int getMaxMemoryLRU() const { return _maxMemoryLRU; }
+	int getMemoryLocked() const { return _memoryLocked; }
+
 	/**
 	 * Tests whether a resource exists.
 	 *
@@ -489,13 +525,28 @@ protected:
 	SourcesList _sources;
 	int _memoryLocked;	///< Amount of resource bytes in locked memory
 	int _memoryLRU;		///< Amount of resource bytes under LRU control
-	Common::List<Resource *> _LRU; ///< Last Resource Used list
+	Resource *_lruHead; ///< Most recently used resource under LRU control
+	Resource *_lruTail; ///< Least recently used resource under LRU control
+	EvictionPolicy _evictionPolicy;
+	uint64 _evictionClock; ///< Priority of the last evicted resource, for kEvictionCostWeighted
+	uint64 _lruSequence; ///< Incremented for every resource put under LRU control
+	/**
+	 * Min-heap of the resources under LRU control, the next one to free for
+	 * kEvictionCostWeighted first
+	 */
+	Common::Array<Resource *> _evictionHeap;
+	CacheStats _cacheStats;
 	ResourceMap _resMap;
 	Common::List<Common::File *> _volumeFiles; ///< list of opened volume files
 	ResourceSource *_audioMapSCI1; ///< Currently loaded audio map for SCI1
 	ResVersion _volVersion; ///< resource.0xx version
 	ResVersion _mapVersion; ///< resource.map version
 	bool _isSci2Mac;
+	ResourceIndex *_resourceIndex; ///< Index of the audio map scans, or nullptr when it is not used
+	uint _indexedMaps; ///< Number of audio maps read from the index
+	uint _scannedMaps; ///< Number of audio maps scanned and stored in the index
+	Common::Array<ResourceIndexEntry> *_indexRecording; ///< Resources found by the audio map scan being recorded
+	Common::HashMap<ResourceId, bool, ResourceIdHash> _indexRecorded; ///< Resources already in _indexRecording
 
 	/**
 	 * Add a path to the resource manager's list of sources.
@@ -585,6 +636,41 @@ protected:
 	 */
 	int readAudioMapSCI11(IntMapResourceSource *map);
 
+	/**
+	 * Reads SCI1.1 audio map resources, from the resource index if it holds
+	 * an up to date scan of the map, and stores the scan in the index
+	 * otherwise.
+	 * @param map The map
+	 * @return 0 on success, an SCI_ERROR_* code otherwise
+	 */
+	int readIndexedAudioMapSCI11(IntMapResourceSource *map);
+
+	/**
+	 * Builds the resource index key of an audio map, and the signature of the
+	 * files it is read from.
+	 * @return false if the files cannot be signed, in which case the map
+	 *         should not be indexed
+	 */
+	bool getAudioMapIndexKey(IntMapResourceSource *map, ResourceSource *src, Common::String &key, Common::String &signature);
+
+	/**
+	 * Adds the resources of an indexed audio map scan.
+	 * @return false if the resources indexed so far are not the ones the scan
+	 *         was recorded with, in which case nothing is added
+	 */
+	bool addIndexedResources(ResourceSource *src, const Common::Array<ResourceIndexEntry> &entries);
+
+	/** Records a resource added by the audio map scan being recorded. */
+	void recordIndexedResource(const ResourceId &resId);
+
+	/**
+	 * Completes the recorded resources with their location once the scan is
+	 * finished.
+	 * @return false if the scan changed resources in a way the index cannot
+	 *         replay
+	 */
+	bool finishIndexRecording(ResourceSource *src, Common::Array<ResourceIndexEntry> &entries);
+
 	/**
 	 * Reads SCI1 audio map files.
 	 * @param map The map
@@ -636,6 +722,16 @@ protected:
 	void addToLRU(Resource *res);
 	void removeFromLRU(Resource *res);
 
+	/**
+	 * Returns the resource which should be freed next according to the
+	 * current eviction policy.
+	 */
+	Resource *selectEvictionVictim() const;
+
+	static bool isEvictedBefore(const Resource *a, const Resource *b);
+	void siftEvictionHeapUp(uint index);
+	void siftEvictionHeapDown(uint index);
+
 	ResourceCompression getViewCompression();
 	ViewType detectViewType();
 	bool hasSci0Voc999();
@@ -24,9 +24,12 @@
 
 #include "common/archive.h"
 #include "common/file.h"
+#include "common/fs.h"
 #include "common/textconsole.h"
 #include "common/memstream.h"
+#include "engines/detectioncache.h"
 #include "sci/resource/resource.h"
+#include "sci/resource/resource_index.h"
 #include "sci/resource/resource_intern.h"
 #include "sci/util.h"
 
@@ -640,6 +643,129 @@ int ResourceManager::readAudioMapSCI11(IntMapResourceSource *map) {
 	return 0;
 }
 
+// Signs the file of a source, as found by the same search paths the file is
+// opened with
+static bool getIndexFileSignature(const ResourceSource *source, Common::String &signature) {
+	if (source->_resourceFile)
+		return DetectionCache::getFileSignature(*source->_resourceFile, signature);
+
+	Common::ArchiveMemberPtr member = SearchMan.getMember(source->getLocationName());
+	const Common::FSNode *node = dynamic_cast<const Common::FSNode *>(member.get());
+	return node && DetectionCache::getFileSignature(*node, signature);
+}
+
+bool ResourceManager::getAudioMapIndexKey(IntMapResourceSource *map, ResourceSource *src, Common::String &key, Common::String &signature) {
+	const Resource *mapRes = _resMap.getValOrDefault(ResourceId(kResourceTypeMap, map->_mapNumber), nullptr);
+	Common::String mapSignature, volumeSignature;
+	if (!mapRes || !getIndexFileSignature(mapRes->_source, mapSignature) || !getIndexFileSignature(src, volumeSignature))
+		return false;
+
+	// The scan also depends on the detected volume version and on the
+	// fixups applied for the game and language
+	key = Common::String::format("%s|%s|%u|%d|%d|%d|%d", map->getLocationName().c_str(), src->getLocationName().c_str(),
+	                             map->_mapNumber, map->_volumeNumber, _volVersion, g_sci->getGameId(), g_sci->getLanguage());
+	signature = mapSignature + "|" + volumeSignature;
+	return true;
+}
+
+bool ResourceManager::addIndexedResources(ResourceSource *src, const Common::Array<ResourceIndexEntry> &entries) {
+	// The scan only adds the resources which are not indexed yet, so it is
+	// replayed only if the same ones are
+	for (uint i = 0; i < entries.size(); ++i) {
+		if (_resMap.contains(entries[i].id) != entries[i].existed)
+			return false;
+	}
+
+	for (uint i = 0; i < entries.size(); ++i) {
+		const ResourceIndexEntry &entry = entries[i];
+		if (!entry.updated)
+			continue;
+
+		Resource *res = _resMap.getValOrDefault(entry.id, nullptr);
+		if (res == nullptr) {
+			res = new Resource(this, entry.id);
+			_resMap.setVal(entry.id, res);
+		}
+
+		res->_status = kResStatusNoMalloc;
+		res->_source = src;
+		res->_headerSize = 0;
+		res->_fileOffset = entry.fileOffset;
+		res->_size = entry.size;
+	}
+
+	return true;
+}
+
+void ResourceManager::recordIndexedResource(const ResourceId &resId) {
+	if (_indexRecorded.contains(resId))
+		return;
+	_indexRecorded.setVal(resId, true);
+
+	// The location of existing resources is kept to tell whether the scan
+	// changed them
+	const Resource *res = _resMap.getValOrDefault(resId, nullptr);
+	ResourceIndexEntry entry;
+	entry.id = resId;
+	entry.existed = (res != nullptr);
+	entry.updated = false;
+	entry.fileOffset = res ? res->_fileOffset : 0;
+	entry.size = res ? res->_size : 0;
+	_indexRecording->push_back(entry);
+}
+
+bool ResourceManager::finishIndexRecording(ResourceSource *src, Common::Array<ResourceIndexEntry> &entries) {
+	for (uint i = 0; i < entries.size(); ++i) {
+		ResourceIndexEntry &entry = entries[i];
+		const Resource *res = _resMap.getValOrDefault(entry.id, nullptr);
+		if (res == nullptr)
+			return false;
+
+		if (res->_source == src) {
+			entry.updated = true;
+			entry.fileOffset = res->_fileOffset;
+			entry.size = res->_size;
+		} else if (!entry.existed || (uint32)res->_fileOffset != entry.fileOffset || res->_size != entry.size) {
+			// The KQ6 rave fixup adjusts the resource returned by
+			// addResource(), even when it belongs to another source
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int ResourceManager::readIndexedAudioMapSCI11(IntMapResourceSource *map) {
+	ResourceSource *src = findVolume(map, map->_volumeNumber);
+	Common::String key, signature;
+	if (!_resourceIndex || !src || !getAudioMapIndexKey(map, src, key, signature))
+		return readAudioMapSCI11(map);
+
+	const ResourceIndex::EntryList *entries = _resourceIndex->lookup(key, signature);
+	if (entries && addIndexedResources(src, *entries)) {
+		_indexedMaps++;
+		return SCI_ERROR_NONE;
+	}
+
+	Common::Array<ResourceIndexEntry> recording;
+	const bool hadBadResources = _hasBadResources;
+	_hasBadResources = false;
+	_indexRecording = &recording;
+	const int result = readAudioMapSCI11(map);
+	_indexRecording = nullptr;
+	_indexRecorded.clear();
+
+	// Scans which found invalid entries are not stored, so that their
+	// warnings are shown every time
+	if (result == SCI_ERROR_NONE && !_hasBadResources && finishIndexRecording(src, recording)) {
+		_resourceIndex->store(key, signature, recording);
+		_scannedMaps++;
+	}
+	_hasBadResources |= hadBadResources;
+
+	return result;
+}
+
 // AUDIOnnn.MAP contains 10-byte entries:
 // Early format:
 // w 5 bits resource type and 11 bits resource number
@@ -0,0 +1,175 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/debug.h"
+#include "common/savefile.h"
+#include "common/stream.h"
+#include "common/system.h"
+#include "common/textconsole.h"
+
+#include "sci/resource/resource_index.h"
+
+namespace Sci {
+
+static const uint32 kIndexFileTag = MKTAG('S', 'C', 'R', 'I');
+static const uint32 kIndexFileVersion = 1;
+
+enum {
+	kEntryExisted = 1 << 0,
+	kEntryUpdated = 1 << 1
+};
+
+static void writeIndexString(Common::WriteStream &stream, const Common::String &str) {
+	stream.writeUint16BE(str.size());
+	stream.write(str.c_str(), str.size());
+}
+
+static bool readIndexString(Common::SeekableReadStream &stream, Common::String &str) {
+	uint16 size = stream.readUint16BE();
+	if (stream.eos() || stream.err())
+		return false;
+
+	char *buf = new char[size];
+	bool success = (stream.read(buf, size) == size);
+	if (success)
+		str = Common::String(buf, size);
+	delete[] buf;
+	return success;
+}
+
+ResourceIndex::ResourceIndex() : _dirty(false) {
+}
+
+const ResourceIndex::EntryList *ResourceIndex::lookup(const Common::String &key, const Common::String &signature) const {
+	ScanMap::const_iterator it = _scans.find(key);
+	if (it == _scans.end() || it->_value.signature != signature)
+		return nullptr;
+
+	return &it->_value.entries;
+}
+
+void ResourceIndex::store(const Common::String &key, const Common::String &signature, const EntryList &entries) {
+	Scan &scan = _scans[key];
+	scan.signature = signature;
+	scan.entries = entries;
+	_dirty = true;
+}
+
+void ResourceIndex::load(const Common::String &fileName) {
+	Common::InSaveFile *stream = g_system->getSavefileManager()->openForLoading(fileName);
+	if (!stream)
+		return;
+
+	if (loadFromStream(*stream))
+		debug(1, "ResourceIndex: Loaded %u scans from '%s'", _scans.size(), fileName.c_str());
+	else
+		debug(1, "ResourceIndex: Ignoring '%s', which is truncated or has an unknown format", fileName.c_str());
+	delete stream;
+}
+
+bool ResourceIndex::loadFromStream(Common::SeekableReadStream &stream) {
+	_scans.clear();
+
+	if (stream.readUint32BE() != kIndexFileTag || stream.readUint32BE() != kIndexFileVersion)
+		return false;
+
+	uint32 count = stream.readUint32BE();
+	for (uint32 i = 0; i < count; i++) {
+		Common::String key;
+		Scan scan;
+		if (!readIndexString(stream, key) || !readIndexString(stream, scan.signature)) {
+			_scans.clear();
+			return false;
+		}
+
+		uint32 entryCount = stream.readUint32BE();
+		if (stream.eos() || entryCount > (uint32)(stream.size() - stream.pos())) {
+			_scans.clear();
+			return false;
+		}
+
+		scan.entries.resize(entryCount);
+		for (uint32 j = 0; j < entryCount; j++) {
+			ResourceIndexEntry &entry = scan.entries[j];
+			const ResourceType type = (ResourceType)stream.readByte();
+			const uint16 number = stream.readUint16BE();
+			const uint32 tuple = stream.readUint32BE();
+			entry.id = ResourceId(type, number, tuple);
+			const byte flags = stream.readByte();
+			entry.existed = (flags & kEntryExisted) != 0;
+			entry.updated = (flags & kEntryUpdated) != 0;
+			entry.fileOffset = stream.readUint32BE();
+			entry.size = stream.readUint32BE();
+		}
+		_scans[key] = scan;
+	}
+
+	if (stream.eos() || stream.err()) {
+		_scans.clear();
+		return false;
+	}
+	return true;
+}
+
+void ResourceIndex::saveToStream(Common::WriteStream &stream) const {
+	stream.writeUint32BE(kIndexFileTag);
+	stream.writeUint32BE(kIndexFileVersion);
+	stream.writeUint32BE(_scans.size());
+	for (ScanMap::const_iterator it = _scans.begin(); it != _scans.end(); ++it) {
+		writeIndexString(stream, it->_key);
+		writeIndexString(stream, it->_value.signature);
+
+		const EntryList &entries = it->_value.entries;
+		stream.writeUint32BE(entries.size());
+		for (EntryList::const_iterator entry = entries.begin(); entry != entries.end(); ++entry) {
+			stream.writeByte(entry->id.getType());
+			stream.writeUint16BE(entry->id.getNumber());
+			stream.writeUint32BE(entry->id.getTuple());
+			stream.writeByte((entry->existed ? kEntryExisted : 0) | (entry->updated ? kEntryUpdated : 0));
+			stream.writeUint32BE(entry->fileOffset);
+			stream.writeUint32BE(entry->size);
+		}
+	}
+}
+
+void ResourceIndex::flush(const Common::String &fileName) {
+	if (!_dirty)
+		return;
+
+	Common::OutSaveFile *stream = g_system->getSavefileManager()->openForSaving(fileName, false);
+	if (!stream) {
+		debug(1, "ResourceIndex: Could not create '%s'", fileName.c_str());
+		return;
+	}
+
+	saveToStream(*stream);
+	stream->finalize();
+
+	if (stream->err())
+		warning("ResourceIndex: Failed to write '%s'", fileName.c_str());
+	else
+		_dirty = false;
+
+	delete stream;
+}
+
+} // End of namespace Sci
@@ -0,0 +1,105 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCI_RESOURCE_RESOURCE_INDEX_H
+#define SCI_RESOURCE_RESOURCE_INDEX_H
+
+#include "common/array.h"
+#include "common/hashmap.h"
+#include "common/hash-str.h"
+#include "common/str.h"
+
+#include "sci/resource/resource.h"
+
+namespace Common {
+class SeekableReadStream;
+class WriteStream;
+}
+
+namespace Sci {
+
+/** A resource found by a scan of an audio map. */
+struct ResourceIndexEntry {
+	ResourceId id;
+	bool existed; ///< Whether the resource was already indexed before the scan
+	bool updated; ///< Whether the scan set the location of the resource
+	uint32 fileOffset;
+	uint32 size;
+};
+
+/**
+ * Persistent index of the resources found by scanning the audio maps of a
+ * game, so that starting the game again does not need to parse the maps and
+ * validate every audio36 and sync36 entry against its volume.
+ *
+ * Each scan is identified by a key, which tells the map and the volume it
+ * was read from, and holds a signature built from the size and the
+ * modification time of these files. A scan is only used while its signature
+ * matches the current one.
+ */
+class ResourceIndex {
+public:
+	typedef Common::Array<ResourceIndexEntry> EntryList;
+
+	ResourceIndex();
+
+	/**
+	 * Look up the resources stored for the given key.
+	 *
+	 * @return The resources, or nullptr if no scan with the same signature
+	 *         was stored.
+	 */
+	const EntryList *lookup(const Common::String &key, const Common::String &signature) const;
+
+	/** Store the resources found by a scan. */
+	void store(const Common::String &key, const Common::String &signature, const EntryList &entries);
+
+	/** Read the index from a save file, if it exists. */
+	void load(const Common::String &fileName);
+
+	/** Write the index to a save file, if it was modified. */
+	void flush(const Common::String &fileName);
+
+	/** Replace the scans with the ones read from a stream written by saveToStream(). */
+	bool loadFromStream(Common::SeekableReadStream &stream);
+
+	/** Write all the scans to a stream. */
+	void saveToStream(Common::WriteStream &stream) const;
+
+	/** Number of scans in the index. */
+	uint size() const { return _scans.size(); }
+
+private:
+	struct Scan {
+		Common::String signature;
+		EntryList entries;
+	};
+
+	typedef Common::HashMap<Common::String, Scan> ScanMap;
+
+	ScanMap _scans;
+	bool _dirty;
+};
+
+} // End of namespace Sci
+
+#endif // SCI_RESOURCE_RESOURCE_INDEX_H
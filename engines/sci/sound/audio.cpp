@@ -363,6 +363,44 @@ static byte *readSOLAudio(Common::SeekableReadStream *audioStream, uint32 &size,
 	return buffer;
 }
 
+#if (defined(USE_MAD) || defined(USE_VORBIS) || defined(USE_FLAC))
+static Audio::SeekableAudioStream *makeCompressedAudioStream(Resource *audioRes, uint32 audioCompressionType) {
+	// Compressed audio made by our tool
+	byte *compressedData = (byte *)malloc(audioRes->size());
+	assert(compressedData);
+	// We copy over the compressed data in our own buffer. We have to do
+	// this, because ResourceManager may free the original data late. All
+	// other compression types already decompress completely into an
+	// additional buffer here. MP3/OGG/FLAC decompression works on-the-fly
+	// instead.
+	audioRes->unsafeCopyDataTo(compressedData);
+	Common::SeekableReadStream *compressedStream = new Common::MemoryReadStream(compressedData, audioRes->size(), DisposeAfterUse::YES);
+
+	switch (audioCompressionType) {
+	case MKTAG('M','P','3',' '):
+#ifdef USE_MAD
+		return Audio::makeMP3Stream(compressedStream, DisposeAfterUse::YES);
+#endif
+		break;
+	case MKTAG('O','G','G',' '):
+#ifdef USE_VORBIS
+		return Audio::makeVorbisStream(compressedStream, DisposeAfterUse::YES);
+#endif
+		break;
+	case MKTAG('F','L','A','C'):
+#ifdef USE_FLAC
+		return Audio::makeFLACStream(compressedStream, DisposeAfterUse::YES);
+#endif
+		break;
+	default:
+		break;
+	}
+
+	delete compressedStream;
+	return nullptr;
+}
+#endif
+
 Audio::RewindableAudioStream *AudioPlayer::getAudioStream(uint32 number, uint32 volume, int *sampleLen) {
 	Audio::SeekableAudioStream *audioSeekStream = 0;
 	Audio::RewindableAudioStream *audioStream = 0;
@@ -393,35 +431,26 @@ Audio::RewindableAudioStream *AudioPlayer::getAudioStream(uint32 number, uint32
 
 	if (audioCompressionType) {
 #if (defined(USE_MAD) || defined(USE_VORBIS) || defined(USE_FLAC))
-		// Compressed audio made by our tool
-		byte *compressedData = (byte *)malloc(audioRes->size());
-		assert(compressedData);
-		// We copy over the compressed data in our own buffer. We have to do
-		// this, because ResourceManager may free the original data late. All
-		// other compression types already decompress completely into an
-		// additional buffer here. MP3/OGG/FLAC decompression works on-the-fly
-		// instead.
-		audioRes->unsafeCopyDataTo(compressedData);
-		Common::SeekableReadStream *compressedStream = new Common::MemoryReadStream(compressedData, audioRes->size(), DisposeAfterUse::YES);
+		// Sound effects are short and played over and over again, so keep
+		// them decoded. Speech is only streamed.
+		const bool isSoundEffect = (volume == 65535);
+		const Audio::SampleCache::Key cacheKey(audioRes->getResourceLocation(), audioRes->getFileOffset());
+		if (isSoundEffect) {
+			audioSeekStream = _sampleCache.getStream(cacheKey);
+			if (audioSeekStream) {
+				*sampleLen = (audioSeekStream->getLength().msecs() * 60) / 1000; // we translate msecs to ticks
+				return audioSeekStream;
+			}
+		}
 
-		switch (audioCompressionType) {
-		case MKTAG('M','P','3',' '):
-#ifdef USE_MAD
-			audioSeekStream = Audio::makeMP3Stream(compressedStream, DisposeAfterUse::YES);
-#endif
-			break;
-		case MKTAG('O','G','G',' '):
-#ifdef USE_VORBIS
-			audioSeekStream = Audio::makeVorbisStream(compressedStream, DisposeAfterUse::YES);
-#endif
-			break;
-		case MKTAG('F','L','A','C'):
-#ifdef USE_FLAC
-			audioSeekStream = Audio::makeFLACStream(compressedStream, DisposeAfterUse::YES);
-#endif
-			break;
-		default:
-			break;
+		audioSeekStream = makeCompressedAudioStream(audioRes, audioCompressionType);
+
+		// Stream the first play of a sound effect, so that it starts right
+		// away, and decode another copy for the cache in the background
+		if (audioSeekStream && isSoundEffect) {
+			Audio::SeekableAudioStream *decoder = makeCompressedAudioStream(audioRes, audioCompressionType);
+			if (decoder)
+				_sampleCache.prefetch(cacheKey, decoder);
 		}
 #else
 		error("Compressed audio file encountered, but no appropriate decoder is compiled in");
@@ -26,6 +26,7 @@
 
 #include "sci/engine/vm_types.h"
 #include "audio/mixer.h"
+#include "audio/samplecache.h"
 
 namespace Audio {
 class RewindableAudioStream;
@@ -89,6 +90,9 @@ private:
 	bool _wPlayFlag;
 	bool _initCD;
 	uint16 _playCounter;
+
+	/** Decoded compressed sound effects, which are played repeatedly */
+	Audio::SampleCache _sampleCache;
 };
 
 } // End of namespace Sci
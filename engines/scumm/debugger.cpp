@@ -34,6 +34,7 @@
 #include "scumm/resource.h"
 #include "scumm/scumm.h"
 #include "scumm/sound.h"
+#include "scumm/he/wiz_he.h"
 
 namespace Scumm {
 
@@ -97,6 +98,11 @@ ScummDebugger::ScummDebugger(ScummEngine *s)
 	registerCmd("imuse",     WRAP_METHOD(ScummDebugger, Cmd_IMuse));
 
 	registerCmd("resetcursors",    WRAP_METHOD(ScummDebugger, Cmd_ResetCursors));
+
+#ifdef ENABLE_HE
+	if (_vm->_game.heversion >= 71)
+		registerCmd("wizbench",  WRAP_METHOD(ScummDebugger, Cmd_WizBench));
+#endif
 }
 
 ScummDebugger::~ScummDebugger() {
@@ -845,4 +851,28 @@ bool ScummDebugger::Cmd_ResetCursors(int argc, const char **argv) {
 	return false;
 }
 
+#ifdef ENABLE_HE
+bool ScummDebugger::Cmd_WizBench(int argc, const char **argv) {
+	if (argc != 1 && argc != 4) {
+		debugPrintf("Usage: %s [<width> <height> <iterations>]\n", argv[0]);
+		debugPrintf("Times the generic and specialized Wiz image decoders on a synthetic sprite\n");
+		return true;
+	}
+
+	int w = 160, h = 120, iterations = 1000;
+	if (argc == 4) {
+		w = atoi(argv[1]);
+		h = atoi(argv[2]);
+		iterations = atoi(argv[3]);
+		if (w <= 0 || h <= 0 || iterations <= 0 || w > 1024 || h > 1024) {
+			debugPrintf("Invalid arguments\n");
+			return true;
+		}
+	}
+
+	Wiz::benchmarkDecoders(this, w, h, iterations);
+	return true;
+}
+#endif
+
 } // End of namespace Scumm
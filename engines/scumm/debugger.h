@@ -69,6 +69,10 @@ private:
 
 	bool Cmd_ResetCursors(int argc, const char **argv);
 
+#ifdef ENABLE_HE
+	bool Cmd_WizBench(int argc, const char **argv);
+#endif
+
 	void printBox(int box);
 	void drawBox(int box);
 };
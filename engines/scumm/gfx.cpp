@@ -215,6 +215,11 @@ Gdi::Gdi(ScummEngine *vm) : _vm(vm) {
 	_zbufferDisabled = false;
 	_objectMode = false;
 	_distaff = false;
+
+	_stripCache.smap = 0;
+	_stripCache.height = 0;
+	_stripCache.numZBuffer = 0;
+	memset(_stripCache.palette, 0, sizeof(_stripCache.palette));
 }
 
 Gdi::~Gdi() {
@@ -272,9 +277,12 @@ void Gdi::init() {
 		// the backbuf (thus we have to treat the right border seperately).
 		_numStrips += 1;
 	}
+
+	flushStripCache();
 }
 
 void Gdi::roomChanged(byte *roomptr) {
+	flushStripCache();
 }
 
 void GdiNES::roomChanged(byte *roomptr) {
@@ -582,24 +590,39 @@ void ScummEngine::updateDirtyScreen(VirtScreenNumber slot) {
 	if (vs->h == 0)
 		return;
 
+	// NES rooms rely on full-screen blits being recognized in
+	// drawStripToScreen, so only merge strips with identical extents there.
+	const bool mergeRuns = (_game.platform != Common::kPlatformNES);
+
 	int i;
 	int w = 8;
 	int start = 0;
+	int top = vs->h;
+	int bottom = 0;
 
 	for (i = 0; i < _gdi->_numStrips; i++) {
 		if (vs->bdirty[i]) {
-			const int top = vs->tdirty[i];
-			const int bottom = vs->bdirty[i];
+			if (mergeRuns) {
+				top = MIN<int>(top, vs->tdirty[i]);
+				bottom = MAX<int>(bottom, vs->bdirty[i]);
+			} else {
+				top = vs->tdirty[i];
+				bottom = vs->bdirty[i];
+			}
 			vs->tdirty[i] = vs->h;
 			vs->bdirty[i] = 0;
-			if (i != (_gdi->_numStrips - 1) && vs->bdirty[i + 1] == bottom && vs->tdirty[i + 1] == top) {
-				// Simple optimizations: if two or more neighboring strips
-				// form one bigger rectangle, coalesce them.
+			if (i != (_gdi->_numStrips - 1) && vs->bdirty[i + 1] &&
+					(mergeRuns || (vs->bdirty[i + 1] == bottom && vs->tdirty[i + 1] == top))) {
+				// If two or more neighboring strips are dirty, push them to
+				// the backend as one rectangle spanning all of their dirty
+				// lines instead of one call per strip.
 				w += 8;
 				continue;
 			}
 			drawStripToScreen(vs, start * 8, w, top, bottom);
 			w = 8;
+			top = vs->h;
+			bottom = 0;
 		}
 		start = i + 1;
 	}
@@ -1021,7 +1044,7 @@ void ScummEngine::redrawBGStrip(int start, int num) {
 	else
 		room = getResourceAddress(rtRoom, _roomResource);
 
-	_gdi->drawBitmap(room + _IM00_offs, &_virtscr[kMainVirtScreen], s, 0, _roomWidth, _virtscr[kMainVirtScreen].h, s, num, 0);
+	_gdi->drawBitmap(room + _IM00_offs, &_virtscr[kMainVirtScreen], s, 0, _roomWidth, _virtscr[kMainVirtScreen].h, s, num, Gdi::dbRoomBackground);
 }
 
 void ScummEngine::restoreBackground(Common::Rect rect, byte backColor) {
@@ -1829,6 +1852,8 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 	_objectMode = (flag & dbObjectMode) == dbObjectMode;
 	prepareDrawBitmap(ptr, vs, x, y, width, height, stripnr, numstrip);
 
+	const bool useCache = (flag == dbRoomBackground) && prepareStripCache(smap_ptr, vs, height, numzbuf);
+
 	sx = x - vs->xstart / 8;
 	if (sx < 0) {
 		numstrip -= -sx;
@@ -1861,7 +1886,19 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 		else
 			dstPtr = (byte *)vs->getBasePtr(x * 8, y);
 
-		transpStrip = drawStrip(dstPtr, vs, x, y, width, height, stripnr, smap_ptr);
+		const bool cached = useCache && stripnr >= 0 && stripnr < (int)_stripCache.valid.size() && _stripCache.valid[stripnr];
+		if (cached) {
+			const byte *src = &_stripCache.pixels[stripnr * 8 * height];
+			for (int h = 0; h < height; h++)
+				memcpy(dstPtr + h * vs->pitch, src + h * 8, 8);
+			transpStrip = false;
+		} else {
+			transpStrip = drawStrip(dstPtr, vs, x, y, width, height, stripnr, smap_ptr);
+		}
+
+		// Only fully opaque strips can be replayed from the cache; transparent
+		// ones depend on whatever was in the buffer before.
+		const bool storeStrip = useCache && !cached && !transpStrip && stripnr >= 0 && stripnr < (int)_stripCache.valid.size();
 
 		// COMI and HE games only uses flag value
 		if (_vm->_game.version == 8 || _vm->_game.heversion >= 60)
@@ -1875,7 +1912,33 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 				clear8Col(frontBuf, vs->pitch, height, vs->format.bytesPerPixel);
 		}
 
-		decodeMask(x, y, width, height, stripnr, numzbuf, zplane_list, transpStrip, flag);
+		if (cached) {
+			const byte *src = &_stripCache.masks[stripnr * numzbuf * height];
+			for (int i = 1; i < numzbuf; i++) {
+				if (!zplane_list[i])
+					continue;
+				byte *mask_ptr = getMaskBuffer(x, y, i);
+				for (int h = 0; h < height; h++)
+					mask_ptr[h * _numStrips] = src[i * height + h];
+			}
+		} else {
+			decodeMask(x, y, width, height, stripnr, numzbuf, zplane_list, transpStrip, flag);
+		}
+
+		if (storeStrip) {
+			byte *dst = &_stripCache.pixels[stripnr * 8 * height];
+			for (int h = 0; h < height; h++)
+				memcpy(dst + h * 8, dstPtr + h * vs->pitch, 8);
+			dst = &_stripCache.masks[stripnr * numzbuf * height];
+			for (int i = 1; i < numzbuf; i++) {
+				if (!zplane_list[i])
+					continue;
+				const byte *mask_ptr = getMaskBuffer(x, y, i);
+				for (int h = 0; h < height; h++)
+					dst[i * height + h] = mask_ptr[h * _numStrips];
+			}
+			_stripCache.valid[stripnr] = 1;
+		}
 
 #if 0
 		// HACK: blit mask(s) onto normal screen. Useful to debug masking
@@ -1903,6 +1966,42 @@ void Gdi::drawBitmap(const byte *ptr, VirtScreen *vs, int x, const int y, const
 	}
 }
 
+/**
+ * Make sure the strip cache matches the room background about to be drawn,
+ * flushing it if the image, its height, the number of z-planes or the room
+ * palette changed since it was filled. Returns false if the cache cannot be
+ * used for this draw at all.
+ */
+bool Gdi::prepareStripCache(const byte *smap_ptr, const VirtScreen *vs, int height, int numzbuf) {
+	if (!canCacheStrips() || vs->number != kMainVirtScreen || vs->format.bytesPerPixel != 1)
+		return false;
+
+	if (_stripCache.smap != smap_ptr || _stripCache.height != height || _stripCache.numZBuffer != numzbuf ||
+			memcmp(_stripCache.palette, _vm->_roomPalette, sizeof(_stripCache.palette))) {
+		const int numRoomStrips = MAX(_vm->_roomWidth, (int)vs->w) / 8;
+
+		_stripCache.smap = smap_ptr;
+		_stripCache.height = height;
+		_stripCache.numZBuffer = numzbuf;
+		memcpy(_stripCache.palette, _vm->_roomPalette, sizeof(_stripCache.palette));
+		_stripCache.valid.clear();
+		_stripCache.valid.resize(numRoomStrips);
+		_stripCache.pixels.resize(numRoomStrips * 8 * height);
+		_stripCache.masks.resize(numRoomStrips * numzbuf * height);
+	}
+
+	return true;
+}
+
+void Gdi::flushStripCache() {
+	_stripCache.smap = 0;
+	_stripCache.height = 0;
+	_stripCache.numZBuffer = 0;
+	_stripCache.valid.clear();
+	_stripCache.pixels.clear();
+	_stripCache.masks.clear();
+}
+
 bool Gdi::drawStrip(byte *dstPtr, VirtScreen *vs, int x, int y, const int width, const int height,
 					int stripnr, const byte *smap_ptr) {
 	// Do some input verification and make sure the strip/strip offset
@@ -24,6 +24,7 @@
 #define SCUMM_GFX_H
 
 #include "common/system.h"
+#include "common/array.h"
 #include "common/list.h"
 
 #include "graphics/surface.h"
@@ -220,6 +221,22 @@ protected:
 	/** Flag which is true when an object is being rendered, false otherwise. */
 	bool _objectMode;
 
+	/**
+	 * Decoded room background strips and their z-plane masks. Filled lazily
+	 * by drawBitmap() and flushed whenever a new room is entered, so that
+	 * scrolling or redrawing the background does not decompress the same
+	 * SMAP strips over and over.
+	 */
+	struct RoomStripCache {
+		const byte *smap;
+		int height;
+		int numZBuffer;
+		byte palette[256];
+		Common::Array<byte> valid;
+		Common::Array<byte> pixels;
+		Common::Array<byte> masks;
+	} _stripCache;
+
 public:
 	/** Flag which is true when loading objects or titles for distaff, in PCEngine version of Loom. */
 	bool _distaff;
@@ -267,6 +284,11 @@ protected:
 					const int x, const int y, const int width, const int height,
 	                int stripnr, int numstrip);
 
+	/** Whether room strips decoded by this renderer may be kept in the strip cache. */
+	virtual bool canCacheStrips() const { return true; }
+	bool prepareStripCache(const byte *smap_ptr, const VirtScreen *vs, int height, int numzbuf);
+	void flushStripCache();
+
 public:
 	Gdi(ScummEngine *vm);
 	virtual ~Gdi();
@@ -293,7 +315,8 @@ public:
 	enum DrawBitmapFlags {
 		dbAllowMaskOr   = 1 << 0,
 		dbDrawMaskOnAll = 1 << 1,
-		dbObjectMode    = 2 << 2
+		dbObjectMode    = 2 << 2,
+		dbRoomBackground = 1 << 4
 	};
 };
 
@@ -311,6 +334,9 @@ protected:
 	void prepareDrawBitmap(const byte *ptr, VirtScreen *vs,
 					const int x, const int y, const int width, const int height,
 	                int stripnr, int numstrip) override;
+
+	// TMSK masks are combined with the current mask buffer contents
+	bool canCacheStrips() const override { return _tmskPtr == 0; }
 public:
 	GdiHE(ScummEngine *vm);
 };
@@ -344,6 +370,8 @@ protected:
 					const int x, const int y, const int width, const int height,
 	                int stripnr, int numstrip) override;
 
+	bool canCacheStrips() const override { return false; }
+
 public:
 	GdiNES(ScummEngine *vm);
 
@@ -387,6 +415,8 @@ protected:
 					const int x, const int y, const int width, const int height,
 	                int stripnr, int numstrip) override;
 
+	bool canCacheStrips() const override { return false; }
+
 public:
 	GdiPCEngine(ScummEngine *vm);
 	~GdiPCEngine() override;
@@ -424,6 +454,8 @@ protected:
 					const int x, const int y, const int width, const int height,
 	                int stripnr, int numstrip) override;
 
+	bool canCacheStrips() const override { return false; }
+
 public:
 	GdiV1(ScummEngine *vm);
 
@@ -450,6 +482,8 @@ protected:
 					const int x, const int y, const int width, const int height,
 	                int stripnr, int numstrip) override;
 
+	bool canCacheStrips() const override { return false; }
+
 public:
 	GdiV2(ScummEngine *vm);
 	~GdiV2() override;
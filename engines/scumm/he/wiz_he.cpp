@@ -26,6 +26,7 @@
 #include "common/system.h"
 #include "graphics/cursorman.h"
 #include "graphics/primitives.h"
+#include "gui/debugger.h"
 #include "scumm/he/intern_he.h"
 #include "scumm/resource.h"
 #include "scumm/scumm.h"
@@ -35,7 +36,10 @@
 
 namespace Scumm {
 
+WizXMapRow16Proc Wiz::_xmapRow16 = xmapRow16Generic;
+
 Wiz::Wiz(ScummEngine_v71he *vm) : _vm(vm) {
+	_xmapRow16 = getXMapRow16Proc();
 	_imagesNum = 0;
 	memset(&_images, 0, sizeof(_images));
 	memset(&_polygons, 0, sizeof(_polygons));
@@ -706,6 +710,114 @@ void Wiz::write16BitColor(uint8 *dstPtr, const uint8 *dataPtr, int dstType, cons
 
 template<int type>
 void Wiz::decompress16BitWizImage(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *xmapPtr) {
+	if (canUseFastWizDecoder(srcRect, flags) && dstType >= kDstScreen && dstType <= kDstCursor) {
+		if (dstType == kDstMemory || dstType == kDstResource)
+			decompress16BitWizImageFast<type, false>(dst, dstPitch, src, srcRect, flags);
+		else
+			decompress16BitWizImageFast<type, true>(dst, dstPitch, src, srcRect, flags);
+	} else {
+		decompress16BitWizImageGeneric<type>(dst, dstPitch, dstType, src, srcRect, flags, xmapPtr);
+	}
+}
+
+template<int type, bool nativeDst>
+static inline void write16BitRun(uint8 *dstPtr, const uint8 *dataPtr, int count, bool fill, WizXMapRow16Proc xmapRow) {
+#ifdef SCUMM_LITTLE_ENDIAN
+	if (type == kWizXMap) {
+		xmapRow(dstPtr, dataPtr, fill ? 0 : 1, count);
+		return;
+	}
+#endif
+
+	if (type == kWizCopy && !fill) {
+#ifdef SCUMM_LITTLE_ENDIAN
+		memcpy(dstPtr, dataPtr, count * 2);
+		return;
+#else
+		if (!nativeDst) {
+			memcpy(dstPtr, dataPtr, count * 2);
+			return;
+		}
+#endif
+	}
+
+	const uint16 fillColor = READ_LE_UINT16(dataPtr);
+	for (int i = 0; i < count; i++, dstPtr += 2) {
+		uint16 col = fill ? fillColor : READ_LE_UINT16(dataPtr + i * 2);
+		if (type == kWizXMap) {
+			uint16 srcColor = (col >> 1) & 0x7DEF;
+			uint16 dstColor = (READ_UINT16(dstPtr) >> 1) & 0x7DEF;
+			col = srcColor + dstColor;
+		}
+		if (nativeDst)
+			WRITE_UINT16(dstPtr, col);
+		else
+			WRITE_LE_UINT16(dstPtr, col);
+	}
+}
+
+/**
+ * Decoder for the common case of an image which is neither mirrored
+ * horizontally nor clipped on its left side. Without a left clip offset
+ * each run can be written in one go, and the destination byte order is
+ * fixed at compile time instead of being checked for every pixel. On little
+ * endian hosts, kWizXMap runs are blended by the SIMD kernels of
+ * wiz_kernels.h.
+ */
+template<int type, bool nativeDst>
+void Wiz::decompress16BitWizImageFast(uint8 *dst, int dstPitch, const uint8 *src, const Common::Rect &srcRect, int flags) {
+	const uint8 *dataPtr = src;
+	const WizXMapRow16Proc xmapRow = _xmapRow16;
+
+	// Skip over the first 'srcRect->top' lines in the data
+	int h = srcRect.top;
+	while (h--) {
+		dataPtr += READ_LE_UINT16(dataPtr) + 2;
+	}
+	h = srcRect.height();
+	const int width = srcRect.width();
+	if (h <= 0 || width <= 0)
+		return;
+
+	if (flags & kWIFFlipY) {
+		dst += (h - 1) * dstPitch;
+		dstPitch = -dstPitch;
+	}
+
+	while (h--) {
+		uint16 lineSize = READ_LE_UINT16(dataPtr); dataPtr += 2;
+		const uint8 *dataPtrNext = dataPtr + lineSize;
+		uint8 *dstPtr = dst;
+		int w = width;
+		if (lineSize != 0) {
+			while (w > 0) {
+				uint8 code = *dataPtr++;
+				if (code & 1) {
+					code >>= 1;
+					dstPtr += code * 2;
+					w -= code;
+				} else if (code & 2) {
+					int count = MIN<int>((code >> 2) + 1, w);
+					write16BitRun<type, nativeDst>(dstPtr, dataPtr, count, true, xmapRow);
+					dstPtr += count * 2;
+					dataPtr += 2;
+					w -= count;
+				} else {
+					int count = (code >> 2) + 1;
+					write16BitRun<type, nativeDst>(dstPtr, dataPtr, MIN(count, w), false, xmapRow);
+					dstPtr += count * 2;
+					dataPtr += count * 2;
+					w -= count;
+				}
+			}
+		}
+		dataPtr = dataPtrNext;
+		dst += dstPitch;
+	}
+}
+
+template<int type>
+void Wiz::decompress16BitWizImageGeneric(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *xmapPtr) {
 	const uint8 *dataPtr, *dataPtrNext;
 	uint8 code;
 	uint8 *dstPtr, *dstPtrNext;
@@ -838,6 +950,96 @@ void Wiz::write8BitColor(uint8 *dstPtr, const uint8 *dataPtr, int dstType, const
 
 template<int type>
 void Wiz::decompressWizImage(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
+	if (bitDepth == 1 && canUseFastWizDecoder(srcRect, flags))
+		decompressWizImageFast<type>(dst, dstPitch, src, srcRect, flags, palPtr, xmapPtr);
+	else
+		decompressWizImageGeneric<type>(dst, dstPitch, dstType, src, srcRect, flags, palPtr, xmapPtr, bitDepth);
+}
+
+template<int type>
+static inline void write8BitRun(uint8 *dstPtr, const uint8 *dataPtr, int count, bool fill, const uint8 *palPtr, const uint8 *xmapPtr) {
+	if (type == kWizCopy) {
+		if (fill)
+			memset(dstPtr, *dataPtr, count);
+		else
+			memcpy(dstPtr, dataPtr, count);
+	} else if (type == kWizRMap) {
+		if (fill) {
+			memset(dstPtr, palPtr[*dataPtr], count);
+		} else {
+			for (int i = 0; i < count; i++)
+				dstPtr[i] = palPtr[dataPtr[i]];
+		}
+	} else {
+		for (int i = 0; i < count; i++)
+			dstPtr[i] = xmapPtr[dataPtr[fill ? 0 : i] * 256 + dstPtr[i]];
+	}
+}
+
+/**
+ * 8 bit counterpart of decompress16BitWizImageFast(). Fill and literal runs
+ * go through memset()/memcpy() for plain copies and palette remaps.
+ */
+template<int type>
+void Wiz::decompressWizImageFast(uint8 *dst, int dstPitch, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr) {
+	if (type == kWizXMap) {
+		assert(xmapPtr != 0);
+	}
+	if (type == kWizRMap) {
+		assert(palPtr != 0);
+	}
+
+	const uint8 *dataPtr = src;
+
+	// Skip over the first 'srcRect->top' lines in the data
+	int h = srcRect.top;
+	while (h--) {
+		dataPtr += READ_LE_UINT16(dataPtr) + 2;
+	}
+	h = srcRect.height();
+	const int width = srcRect.width();
+	if (h <= 0 || width <= 0)
+		return;
+
+	if (flags & kWIFFlipY) {
+		dst += (h - 1) * dstPitch;
+		dstPitch = -dstPitch;
+	}
+
+	while (h--) {
+		uint16 lineSize = READ_LE_UINT16(dataPtr); dataPtr += 2;
+		const uint8 *dataPtrNext = dataPtr + lineSize;
+		uint8 *dstPtr = dst;
+		int w = width;
+		if (lineSize != 0) {
+			while (w > 0) {
+				uint8 code = *dataPtr++;
+				if (code & 1) {
+					code >>= 1;
+					dstPtr += code;
+					w -= code;
+				} else if (code & 2) {
+					int count = MIN<int>((code >> 2) + 1, w);
+					write8BitRun<type>(dstPtr, dataPtr, count, true, palPtr, xmapPtr);
+					dstPtr += count;
+					dataPtr++;
+					w -= count;
+				} else {
+					int count = (code >> 2) + 1;
+					write8BitRun<type>(dstPtr, dataPtr, MIN(count, w), false, palPtr, xmapPtr);
+					dstPtr += count;
+					dataPtr += count;
+					w -= count;
+				}
+			}
+		}
+		dataPtr = dataPtrNext;
+		dst += dstPitch;
+	}
+}
+
+template<int type>
+void Wiz::decompressWizImageGeneric(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitDepth) {
 	const uint8 *dataPtr, *dataPtrNext;
 	uint8 code, *dstPtr, *dstPtrNext;
 	int h, w, xoff, dstInc;
@@ -2928,6 +3130,138 @@ int ScummEngine_v90he::computeWizHistogram(int resNum, int state, int x, int y,
 	return readVar(0);
 }
 
+/**
+ * Re-encode an 8 bit Wiz stream as a 16 bit one, replacing every color
+ * index by its entry in the given palette.
+ */
+static void expandWizStreamTo16Bit(Common::Array<uint8> &out, const uint8 *src, int h, const uint16 *pal) {
+	while (h--) {
+		uint16 lineSize = READ_LE_UINT16(src); src += 2;
+		const uint8 *lineEnd = src + lineSize;
+		const uint32 outLine = out.size();
+		out.push_back(0);
+		out.push_back(0);
+		while (src < lineEnd) {
+			uint8 code = *src++;
+			out.push_back(code);
+			if (code & 1)
+				continue;
+			int count = (code & 2) ? 1 : (code >> 2) + 1;
+			while (count--) {
+				uint16 col = pal[*src++];
+				out.push_back(col & 0xFF);
+				out.push_back(col >> 8);
+			}
+		}
+		WRITE_LE_UINT16(&out[outLine], out.size() - outLine - 2);
+	}
+}
+
+/**
+ * Time the generic Wiz decoders against the specialized ones on a
+ * synthetic sprite, and check that both produce the same output.
+ */
+void Wiz::benchmarkDecoders(GUI::Debugger *con, int w, int h, int iterations) {
+	const uint8 transColor = 5;
+
+	// Build a sprite resembling typical HE artwork: a transparent border
+	// around an elliptic shape made of solid bands and dithered areas.
+	Common::Array<uint8> image(w * h);
+	uint32 seed = 0x1234567;
+	for (int y = 0; y < h; y++) {
+		const int dy = 2 * y - h;
+		for (int x = 0; x < w; x++) {
+			const int dx = 2 * x - w;
+			uint8 col = transColor;
+			if ((int64)dx * dx * h * h + (int64)dy * dy * w * w < (int64)w * w * h * h) {
+				seed = seed * 1103515245 + 12345;
+				if ((x / 16 + y / 8) & 1)
+					col = 16 + (y & 0x3F);
+				else
+					col = 80 + ((seed >> 16) & 0x7F);
+			}
+			image[y * w + x] = col;
+		}
+	}
+
+	const Common::Rect rect(w, h);
+	Common::Array<uint8> data8(wizPackType1(0, image.data(), w, rect, transColor));
+	wizPackType1(data8.data(), image.data(), w, rect, transColor);
+
+	uint8 palette[256];
+	uint16 palette16[256];
+	for (int i = 0; i < 256; i++) {
+		palette[i] = 255 - i;
+		palette16[i] = (i * 0x0421) & 0x7FFF;
+	}
+	Common::Array<uint8> xmap(256 * 256);
+	for (uint i = 0; i < xmap.size(); i++)
+		xmap[i] = ((i >> 8) + (i & 0xFF)) >> 1;
+
+	Common::Array<uint8> data16;
+	expandWizStreamTo16Bit(data16, data8.data(), h, palette16);
+
+	con->debugPrintf("%dx%d sprite, %d iterations, %d bytes packed\n", w, h, iterations, data8.size());
+
+	Common::Array<uint8> bufGeneric(w * h * 2), bufFast(w * h * 2);
+	for (int test = 0; test < 5; test++) {
+		static const char *const names[] = { "8 bit copy", "8 bit remap", "8 bit xmap", "16 bit copy", "16 bit xmap" };
+		uint32 elapsed[2];
+
+		for (int pass = 0; pass < 2; pass++) {
+			Common::Array<uint8> &buf = pass ? bufFast : bufGeneric;
+			memset(buf.data(), 0x42, buf.size());
+			const uint32 start = g_system->getMillis();
+			for (int i = 0; i < iterations; i++) {
+				switch (test) {
+				case 0:
+					if (pass)
+						decompressWizImageFast<kWizCopy>(buf.data(), w, data8.data(), rect, 0, NULL, NULL);
+					else
+						decompressWizImageGeneric<kWizCopy>(buf.data(), w, kDstMemory, data8.data(), rect, 0, NULL, NULL, 1);
+					break;
+				case 1:
+					if (pass)
+						decompressWizImageFast<kWizRMap>(buf.data(), w, data8.data(), rect, 0, palette, NULL);
+					else
+						decompressWizImageGeneric<kWizRMap>(buf.data(), w, kDstMemory, data8.data(), rect, 0, palette, NULL, 1);
+					break;
+				case 2:
+					if (pass)
+						decompressWizImageFast<kWizXMap>(buf.data(), w, data8.data(), rect, 0, NULL, xmap.data());
+					else
+						decompressWizImageGeneric<kWizXMap>(buf.data(), w, kDstMemory, data8.data(), rect, 0, NULL, xmap.data(), 1);
+					break;
+#ifdef USE_RGB_COLOR
+				case 3:
+					if (pass)
+						decompress16BitWizImageFast<kWizCopy, false>(buf.data(), w * 2, data16.data(), rect, 0);
+					else
+						decompress16BitWizImageGeneric<kWizCopy>(buf.data(), w * 2, kDstMemory, data16.data(), rect, 0, NULL);
+					break;
+				case 4:
+					if (pass)
+						decompress16BitWizImageFast<kWizXMap, false>(buf.data(), w * 2, data16.data(), rect, 0);
+					else
+						decompress16BitWizImageGeneric<kWizXMap>(buf.data(), w * 2, kDstMemory, data16.data(), rect, 0, xmap.data());
+					break;
+#endif
+				default:
+					break;
+				}
+			}
+			elapsed[pass] = g_system->getMillis() - start;
+		}
+
+#ifndef USE_RGB_COLOR
+		if (test >= 3)
+			continue;
+#endif
+		con->debugPrintf("%-12s generic %5d ms, specialized %5d ms, output %s\n", names[test], elapsed[0], elapsed[1],
+			memcmp(bufGeneric.data(), bufFast.data(), bufFast.size()) ? "DIFFERS" : "identical");
+	}
+}
+
 } // End of namespace Scumm
 
 #endif // ENABLE_HE
@@ -24,6 +24,11 @@
 #define SCUMM_HE_WIZ_HE_H
 
 #include "common/rect.h"
+#include "scumm/he/wiz_kernels.h"
+
+namespace GUI {
+class Debugger;
+}
 
 namespace Scumm {
 
@@ -317,8 +322,15 @@ public:
 	static void copy16BitWizImage(uint8 *dst, const uint8 *src, int dstPitch, int dstType, int dstw, int dsth, int srcx, int srcy, int srcw, int srch, const Common::Rect *rect, int flags, const uint8 *xmapPtr);
 	static void copyRaw16BitWizImage(uint8 *dst, const uint8 *src, int dstPitch, int dstType, int dstw, int dsth, int srcx, int srcy, int srcw, int srch, const Common::Rect *rect, int flags, int transColor);
 	template<int type> static void decompress16BitWizImage(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *xmapPtr = NULL);
+	template<int type> static void decompress16BitWizImageGeneric(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *xmapPtr);
+	template<int type, bool nativeDst> static void decompress16BitWizImageFast(uint8 *dst, int dstPitch, const uint8 *src, const Common::Rect &srcRect, int flags);
 #endif
 	template<int type> static void decompressWizImage(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitdepth);
+	template<int type> static void decompressWizImageGeneric(uint8 *dst, int dstPitch, int dstType, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr, uint8 bitdepth);
+	template<int type> static void decompressWizImageFast(uint8 *dst, int dstPitch, const uint8 *src, const Common::Rect &srcRect, int flags, const uint8 *palPtr, const uint8 *xmapPtr);
+	/** The specialized decoders handle neither horizontal mirroring nor clipping on the left. */
+	static bool canUseFastWizDecoder(const Common::Rect &srcRect, int flags) { return srcRect.left == 0 && !(flags & kWIFFlipX); }
+	static void benchmarkDecoders(GUI::Debugger *con, int w, int h, int iterations);
 	template<int type> static void decompressRawWizImage(uint8 *dst, int dstPitch, int dstType, const uint8 *src, int srcPitch, int w, int h, int transColor, const uint8 *palPtr, uint8 bitdepth);
 
 #ifdef USE_RGB_COLOR
@@ -334,6 +346,9 @@ public:
 
 private:
 	ScummEngine_v71he *_vm;
+
+	/** kWizXMap kernel of the fast 16 bit decoder, picked when the Wiz is created. */
+	static WizXMapRow16Proc _xmapRow16;
 };
 
 } // End of namespace Scumm
@@ -0,0 +1,61 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifdef ENABLE_HE
+
+#include "common/endian.h"
+#include "common/system.h"
+#include "scumm/he/wiz_kernels.h"
+
+namespace Scumm {
+
+void xmapRow16Generic(uint8 *dst, const uint8 *src, int srcStep, int count) {
+	for (int i = 0; i < count; i++, dst += 2, src += srcStep * 2) {
+		const uint16 srcColor = (READ_LE_UINT16(src) >> 1) & kWizHalfColorMask;
+		const uint16 dstColor = (READ_LE_UINT16(dst) >> 1) & kWizHalfColorMask;
+		WRITE_LE_UINT16(dst, srcColor + dstColor);
+	}
+}
+
+WizXMapRow16Proc getXMapRow16Proc() {
+	WizXMapRow16Proc proc = xmapRow16Generic;
+
+	// Pick the fastest kernel the CPU supports
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+		proc = xmapRow16NEON;
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+		proc = xmapRow16SSE2;
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+		proc = xmapRow16AVX2;
+#endif
+
+	return proc;
+}
+
+} // End of namespace Scumm
+
+#endif // ENABLE_HE
@@ -0,0 +1,68 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef SCUMM_HE_WIZ_KERNELS_H
+#define SCUMM_HE_WIZ_KERNELS_H
+
+#include "common/scummsys.h"
+
+namespace Scumm {
+
+/**
+ * Blend a run of 16 bit pixels with kWizXMap: each destination pixel
+ * becomes the sum of the source and destination pixels, both halved
+ * channel by channel.
+ *
+ * The source and destination pixels are little endian.
+ *
+ * @param dst     Destination pixels.
+ * @param src     Source pixels.
+ * @param srcStep 1 for a literal run, 0 for a run of the single source pixel.
+ * @param count   Number of pixels.
+ */
+typedef void (*WizXMapRow16Proc)(uint8 *dst, const uint8 *src, int srcStep, int count);
+
+void xmapRow16Generic(uint8 *dst, const uint8 *src, int srcStep, int count);
+
+#ifdef SCUMMVM_SSE2
+void xmapRow16SSE2(uint8 *dst, const uint8 *src, int srcStep, int count);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void xmapRow16AVX2(uint8 *dst, const uint8 *src, int srcStep, int count);
+#endif
+
+#ifdef SCUMMVM_NEON
+void xmapRow16NEON(uint8 *dst, const uint8 *src, int srcStep, int count);
+#endif
+
+/** Get the fastest kWizXMap kernel the CPU supports. */
+WizXMapRow16Proc getXMapRow16Proc();
+
+/** Mask of the bits kept when a 555 pixel is halved channel by channel. */
+enum {
+	kWizHalfColorMask = 0x7DEF
+};
+
+} // End of namespace Scumm
+
+#endif
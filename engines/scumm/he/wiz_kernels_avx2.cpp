@@ -0,0 +1,51 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifdef ENABLE_HE
+
+#include "common/endian.h"
+#include "scumm/he/wiz_kernels.h"
+
+#include <immintrin.h>
+
+namespace Scumm {
+
+void xmapRow16AVX2(uint8 *dst, const uint8 *src, int srcStep, int count) {
+	const __m256i mask = _mm256_set1_epi16(kWizHalfColorMask);
+	const __m256i fill = _mm256_and_si256(_mm256_srli_epi16(_mm256_set1_epi16((int16)READ_LE_UINT16(src)), 1), mask);
+
+	int i = 0;
+	for (; i + 16 <= count; i += 16) {
+		__m256i s = fill;
+		if (srcStep)
+			s = _mm256_and_si256(_mm256_srli_epi16(_mm256_loadu_si256((const __m256i *)(src + i * 2)), 1), mask);
+		__m256i d = _mm256_loadu_si256((const __m256i *)(dst + i * 2));
+		d = _mm256_and_si256(_mm256_srli_epi16(d, 1), mask);
+		_mm256_storeu_si256((__m256i *)(dst + i * 2), _mm256_add_epi16(s, d));
+	}
+
+	xmapRow16Generic(dst + i * 2, src + i * 2 * srcStep, srcStep, count - i);
+}
+
+} // End of namespace Scumm
+
+#endif // ENABLE_HE
@@ -0,0 +1,51 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifdef ENABLE_HE
+
+#include "common/endian.h"
+#include "scumm/he/wiz_kernels.h"
+
+#include <arm_neon.h>
+
+namespace Scumm {
+
+void xmapRow16NEON(uint8 *dst, const uint8 *src, int srcStep, int count) {
+	const uint16x8_t mask = vdupq_n_u16(kWizHalfColorMask);
+	const uint16x8_t fill = vandq_u16(vdupq_n_u16(READ_LE_UINT16(src) >> 1), mask);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		uint16x8_t s = fill;
+		if (srcStep)
+			s = vandq_u16(vshrq_n_u16(vreinterpretq_u16_u8(vld1q_u8(src + i * 2)), 1), mask);
+		uint16x8_t d = vreinterpretq_u16_u8(vld1q_u8(dst + i * 2));
+		d = vandq_u16(vshrq_n_u16(d, 1), mask);
+		vst1q_u8(dst + i * 2, vreinterpretq_u8_u16(vaddq_u16(s, d)));
+	}
+
+	xmapRow16Generic(dst + i * 2, src + i * 2 * srcStep, srcStep, count - i);
+}
+
+} // End of namespace Scumm
+
+#endif // ENABLE_HE
@@ -0,0 +1,51 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifdef ENABLE_HE
+
+#include "common/endian.h"
+#include "scumm/he/wiz_kernels.h"
+
+#include <emmintrin.h>
+
+namespace Scumm {
+
+void xmapRow16SSE2(uint8 *dst, const uint8 *src, int srcStep, int count) {
+	const __m128i mask = _mm_set1_epi16(kWizHalfColorMask);
+	const __m128i fill = _mm_and_si128(_mm_srli_epi16(_mm_set1_epi16((int16)READ_LE_UINT16(src)), 1), mask);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m128i s = fill;
+		if (srcStep)
+			s = _mm_and_si128(_mm_srli_epi16(_mm_loadu_si128((const __m128i *)(src + i * 2)), 1), mask);
+		__m128i d = _mm_loadu_si128((const __m128i *)(dst + i * 2));
+		d = _mm_and_si128(_mm_srli_epi16(d, 1), mask);
+		_mm_storeu_si128((__m128i *)(dst + i * 2), _mm_add_epi16(s, d));
+	}
+
+	xmapRow16Generic(dst + i * 2, src + i * 2 * srcStep, srcStep, count - i);
+}
+
+} // End of namespace Scumm
+
+#endif // ENABLE_HE
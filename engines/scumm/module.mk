@@ -137,6 +137,7 @@ MODULE_OBJS += \
 	he/script_v100he.o \
 	he/sprite_he.o \
 	he/wiz_he.o \
+	he/wiz_kernels.o \
 	he/localizer.o \
 	he/logic/baseball2001.o \
 	he/logic/basketball.o \
@@ -161,6 +162,25 @@ ifdef USE_LIBCURL
 MODULE_OBJS += \
 	he/moonbase/net_main.o
 endif
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	he/wiz_kernels_sse2.o
+
+$(MODULE)/he/wiz_kernels_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	he/wiz_kernels_avx2.o
+
+$(MODULE)/he/wiz_kernels_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	he/wiz_kernels_neon.o
+endif
 endif
 
 # This module can be built as a plugin
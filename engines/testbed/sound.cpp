@@ -20,10 +20,13 @@
  *
  */
 
+#include "audio/mixer_intern.h"
+#include "audio/rate.h"
 #include "audio/softsynth/pcspk.h"
 
 #include "backends/audiocd/audiocd.h"
 
+#include "common/atomic.h"
 #include "common/config-manager.h"
 
 #include "testbed/sound.h"
@@ -261,6 +264,232 @@ TestExitStatus SoundSubsystem::sampleRates() {
 	return passed;
 }
 
+/**
+ * Returns the time in ms needed to resample 32 channels of sine waves with
+ * the given resampler, without mixing them.
+ */
+static uint32 benchmarkResampler(Audio::ResamplerType type, const uint *rates, uint numRates, uint outputRate, uint frames, int numCallbacks) {
+	const int numChannels = 32;
+	int16 *buffer = new int16[frames * 2];
+
+	Audio::PCSpeaker *speakers[numChannels];
+	Audio::RateConverter *converters[numChannels];
+	for (int i = 0; i < numChannels; i++) {
+		speakers[i] = new Audio::PCSpeaker(rates[i % numRates]);
+		speakers[i]->play(Audio::PCSpeaker::kWaveFormSine, 200 + i * 50, -1);
+		converters[i] = Audio::makeRateConverter(speakers[i]->getRate(), outputRate, false, false, type);
+	}
+
+	uint32 start = g_system->getMillis();
+	for (int i = 0; i < numCallbacks; i++) {
+		for (int j = 0; j < numChannels; j++)
+			converters[j]->convert(*speakers[j], buffer, frames);
+	}
+	const uint32 time = g_system->getMillis() - start;
+
+	for (int i = 0; i < numChannels; i++) {
+		delete converters[i];
+		delete speakers[i];
+	}
+	delete[] buffer;
+
+	return time;
+}
+
+TestExitStatus SoundSubsystem::mixerBenchmark() {
+	if (ConfParams.isSessionInteractive()) {
+		if (Testsuite::handleInteractiveInput("Benchmarking the software mixer with 32 channels at mixed sample rates", "Continue", "Skip", kOptionRight)) {
+			Testsuite::logPrintf("Info! Skipping test : Mixer benchmark\n");
+			return kTestSkipped;
+		}
+		Testsuite::writeOnScreen("Mixing...", Common::Point(0, 100));
+	}
+
+	const uint outputRate = 44100;
+	const uint frames = 1024;
+	const int numCallbacks = 500;
+	const int numChannels = 32;
+	// Covers the copy, simple and linear interpolation rate converters
+	const uint rates[] = { 11025, 22050, 44100, 48000, 88200 };
+
+	int16 *buffer = new int16[frames * 2];
+
+	// Mix with the block mixing engine of MixerImpl
+	Audio::MixerImpl mixer(outputRate);
+	mixer.setReady(true);
+	for (int i = 0; i < numChannels; i++) {
+		Audio::PCSpeaker *speaker = new Audio::PCSpeaker(rates[i % ARRAYSIZE(rates)]);
+		speaker->play(Audio::PCSpeaker::kWaveFormSine, 200 + i * 50, -1);
+		mixer.playStream(Audio::Mixer::kPlainSoundType, 0, speaker, -1, 128 + i * 4, (i % 3 - 1) * 64, DisposeAfterUse::YES, false, false);
+	}
+
+	uint32 start = g_system->getMillis();
+	for (int i = 0; i < numCallbacks; i++)
+		mixer.mixCallback((byte *)buffer, frames * 4);
+	const uint32 blockTime = g_system->getMillis() - start;
+	mixer.stopAll();
+
+	// Mix the same streams with one clamped add per channel and sample
+	Audio::PCSpeaker *speakers[numChannels];
+	Audio::RateConverter *converters[numChannels];
+	for (int i = 0; i < numChannels; i++) {
+		speakers[i] = new Audio::PCSpeaker(rates[i % ARRAYSIZE(rates)]);
+		speakers[i]->play(Audio::PCSpeaker::kWaveFormSine, 200 + i * 50, -1);
+		converters[i] = Audio::makeRateConverter(speakers[i]->getRate(), outputRate, false);
+	}
+
+	start = g_system->getMillis();
+	for (int i = 0; i < numCallbacks; i++) {
+		memset(buffer, 0, frames * 4);
+		for (int j = 0; j < numChannels; j++)
+			converters[j]->flow(*speakers[j], buffer, frames, 128 + j * 4, 128 + j * 4);
+	}
+	const uint32 clampedTime = g_system->getMillis() - start;
+
+	for (int i = 0; i < numChannels; i++) {
+		delete converters[i];
+		delete speakers[i];
+	}
+	delete[] buffer;
+
+	// Compare the cost of both resamplers on their own
+	const uint resampleRates[] = { 11025, 22050, 48000 };
+	const uint32 linearTime = benchmarkResampler(Audio::kResamplerLinear, resampleRates, ARRAYSIZE(resampleRates), outputRate, frames, numCallbacks);
+	const uint32 sincTime = benchmarkResampler(Audio::kResamplerSinc, resampleRates, ARRAYSIZE(resampleRates), outputRate, frames, numCallbacks);
+
+	const uint32 audioTime = numCallbacks * frames * 1000 / outputRate;
+	Testsuite::logDetailedPrintf("Mixed %u ms of audio from %d channels\n", audioTime, numChannels);
+	Testsuite::logDetailedPrintf("Block mixing: %u ms, per channel clamped adds: %u ms\n", blockTime, clampedTime);
+	Testsuite::logDetailedPrintf("Resampling: linear %u ms, sinc %u ms\n", linearTime, sincTime);
+
+	if (ConfParams.isSessionInteractive())
+		Testsuite::clearScreen();
+
+	// The mixer has to keep up with real time
+	if (blockTime >= audioTime) {
+		Testsuite::logDetailedPrintf("Error! Mixing was slower than real time\n");
+		return kTestFailed;
+	}
+
+	return kTestPassed;
+}
+
+/**
+ * Silent stream which records how regularly the mixer callback reads it.
+ */
+class MixerProbeStream : public Audio::AudioStream {
+public:
+	MixerProbeStream(int rate) : _rate(rate), _frames(0), _lastRead(0), _maxGap(0) {}
+
+	int readBuffer(int16 *buffer, const int numSamples) {
+		const uint32 now = g_system->getMillis();
+		const uint32 lastRead = _lastRead.exchange(now);
+		if (lastRead && now - lastRead > _maxGap.load())
+			_maxGap.store(now - lastRead);
+
+		memset(buffer, 0, numSamples * sizeof(int16));
+		_frames.fetchAdd(numSamples / 2);
+		return numSamples;
+	}
+
+	bool isStereo() const { return true; }
+	int getRate() const { return _rate; }
+	bool endOfData() const { return false; }
+
+	uint32 getFrames() const { return _frames.load(); }
+	uint32 getMaxGap() const { return _maxGap.load(); }
+
+private:
+	const int _rate;
+	Common::Atomic<uint32> _frames;
+	Common::Atomic<uint32> _lastRead;
+	Common::Atomic<uint32> _maxGap;
+};
+
+TestExitStatus SoundSubsystem::mixerStress() {
+	Audio::Mixer *mixer = g_system->getMixer();
+
+	if (!mixer->isReady()) {
+		Testsuite::logPrintf("Info! Skipping test : Mixer stress test, the mixer is not running\n");
+		return kTestSkipped;
+	}
+
+	if (ConfParams.isSessionInteractive()) {
+		if (Testsuite::handleInteractiveInput("Stress testing the mixer with control calls while it is mixing", "Continue", "Skip", kOptionRight)) {
+			Testsuite::logPrintf("Info! Skipping test : Mixer stress test\n");
+			return kTestSkipped;
+		}
+		Testsuite::writeOnScreen("Stressing the mixer...", Common::Point(0, 100));
+	}
+
+	const int numChannels = 8;
+	const uint32 duration = 2000;
+	const uint32 targetOpsPerSecond = 100000;
+
+	MixerProbeStream *probe = new MixerProbeStream(mixer->getOutputRate());
+	Audio::SoundHandle probeHandle;
+	mixer->playStream(Audio::Mixer::kPlainSoundType, &probeHandle, probe, -1, Audio::Mixer::kMaxChannelVolume, 0, DisposeAfterUse::NO);
+
+	// Keep the channels quiet, only the control calls matter here
+	Audio::SoundHandle handles[numChannels];
+	for (int i = 0; i < numChannels; i++) {
+		Audio::PCSpeaker *speaker = new Audio::PCSpeaker(mixer->getOutputRate());
+		speaker->play(Audio::PCSpeaker::kWaveFormSine, 200 + i * 50, -1);
+		mixer->playStream(Audio::Mixer::kPlainSoundType, &handles[i], speaker, -1, 0);
+	}
+
+	const uint32 start = g_system->getMillis();
+	const uint32 startFrames = probe->getFrames();
+	uint32 ops = 0, elapsed = 0, iteration = 0, restarts = 0;
+	while (elapsed < duration) {
+		// Go over all the channels in turn
+		for (int i = 0; i < 1000; i++, iteration++, ops += 4) {
+			Audio::SoundHandle &handle = handles[iteration % numChannels];
+			mixer->setChannelVolume(handle, (iteration >> 3) & 7);
+			mixer->setChannelBalance(handle, (int8)((iteration & 0xFF) - 128 + 1));
+			mixer->pauseHandle(handle, true);
+			mixer->pauseHandle(handle, false);
+		}
+
+		// Restart one of the channels
+		Audio::SoundHandle &handle = handles[restarts++ % numChannels];
+		mixer->stopHandle(handle);
+		Audio::PCSpeaker *speaker = new Audio::PCSpeaker(mixer->getOutputRate());
+		speaker->play(Audio::PCSpeaker::kWaveFormSine, 440, -1);
+		mixer->playStream(Audio::Mixer::kPlainSoundType, &handle, speaker, -1, 0);
+		ops += 2;
+
+		elapsed = g_system->getMillis() - start;
+	}
+	const uint32 mixedFrames = probe->getFrames() - startFrames;
+
+	for (int i = 0; i < numChannels; i++)
+		mixer->stopHandle(handles[i]);
+	mixer->stopHandle(probeHandle);
+
+	const uint32 opsPerSecond = (uint32)((uint64)ops * 1000 / elapsed);
+	const uint32 expectedFrames = (uint32)((uint64)elapsed * mixer->getOutputRate() / 1000);
+	Testsuite::logDetailedPrintf("Issued %u control calls in %u ms (%u per second)\n", ops, elapsed, opsPerSecond);
+	Testsuite::logDetailedPrintf("Mixed %u of %u frames, longest gap between callbacks: %u ms\n", mixedFrames, expectedFrames, probe->getMaxGap());
+	delete probe;
+
+	if (ConfParams.isSessionInteractive())
+		Testsuite::clearScreen();
+
+	if (opsPerSecond < targetOpsPerSecond) {
+		Testsuite::logDetailedPrintf("Error! Control calls are too slow\n");
+		return kTestFailed;
+	}
+
+	// Backends buffer some audio, so allow for a bit of slack
+	if (mixedFrames < expectedFrames * 3 / 4) {
+		Testsuite::logDetailedPrintf("Error! The mixer callback did not keep up\n");
+		return kTestFailed;
+	}
+
+	return kTestPassed;
+}
+
 SoundSubsystemTestSuite::SoundSubsystemTestSuite() {
 	addTest("SimpleBeeps", &SoundSubsystem::playBeeps, true);
 	addTest("MixSounds", &SoundSubsystem::mixSounds, true);
@@ -276,6 +505,8 @@ SoundSubsystemTestSuite::SoundSubsystemTestSuite() {
 		}
 	}
 	addTest("SampleRates", &SoundSubsystem::sampleRates, true);
+	addTest("MixerBenchmark", &SoundSubsystem::mixerBenchmark, false);
+	addTest("MixerStress", &SoundSubsystem::mixerStress, false);
 }
 
 } // End of namespace Testbed
@@ -47,6 +47,8 @@ TestExitStatus playBeeps();
 TestExitStatus mixSounds();
 TestExitStatus audiocdOutput();
 TestExitStatus sampleRates();
+TestExitStatus mixerBenchmark();
+TestExitStatus mixerStress();
 }
 
 class SoundSubsystemTestSuite : public Testsuite {
@@ -41,6 +41,9 @@
 
 #define DIRTY_RECT_LIMIT 800
 
+// Number of opaque tickets each ticket is checked against for occlusion
+#define MAX_OCCLUDING_TICKETS 16
+
 namespace Wintermute {
 
 BaseRenderer *makeOSystemRenderer(BaseGame *inGame) {
@@ -57,7 +60,6 @@ BaseRenderOSystem::BaseRenderOSystem(BaseGame *inGame) : BaseRenderer(inGame) {
 
 	_borderLeft = _borderRight = _borderTop = _borderBottom = 0;
 	_ratioX = _ratioY = 1.0f;
-	_dirtyRect = nullptr;
 	_disableDirtyRects = false;
 	if (ConfMan.hasKey("dirty_rects")) {
 		_disableDirtyRects = !ConfMan.getBool("dirty_rects");
@@ -75,8 +77,6 @@ BaseRenderOSystem::~BaseRenderOSystem() {
 		delete ticket;
 	}
 
-	delete _dirtyRect;
-
 	_renderSurface->free();
 	delete _renderSurface;
 	_blankSurface->free();
@@ -162,8 +162,7 @@ bool BaseRenderOSystem::forcedFlip() {
 bool BaseRenderOSystem::flip() {
 	if (_skipThisFrame) {
 		_skipThisFrame = false;
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRects.reset();
 		g_system->updateScreen();
 		_needsFlip = false;
 
@@ -202,9 +201,7 @@ bool BaseRenderOSystem::flip() {
 		if (_disableDirtyRects || screenChanged) {
 			g_system->copyRectToScreen((byte *)_renderSurface->getPixels(), _renderSurface->pitch, 0, 0, _renderSurface->w, _renderSurface->h);
 		}
-		//  g_system->copyRectToScreen((byte *)_renderSurface->getPixels(), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
-		delete _dirtyRect;
-		_dirtyRect = nullptr;
+		_dirtyRects.reset();
 		_needsFlip = false;
 	}
 	_lastFrameIter = _renderQueue.end();
@@ -386,12 +383,7 @@ void BaseRenderOSystem::drawFromQueuedTicket(const RenderQueueIterator &ticket)
 }
 
 void BaseRenderOSystem::addDirtyRect(const Common::Rect &rect) {
-	if (!_dirtyRect) {
-		_dirtyRect = new Common::Rect(rect);
-	} else {
-		_dirtyRect->extend(rect);
-	}
-	_dirtyRect->clip(_renderRect);
+	_dirtyRects.addDirtyRect(rect, _renderRect);
 }
 
 void BaseRenderOSystem::drawTickets() {
@@ -410,7 +402,7 @@ void BaseRenderOSystem::drawTickets() {
 			++it;
 		}
 	}
-	if (!_dirtyRect || _dirtyRect->width() == 0 || _dirtyRect->height() == 0) {
+	if (_dirtyRects.isEmpty()) {
 		it = _renderQueue.begin();
 		while (it != _renderQueue.end()) {
 			RenderTicket *ticket = *it;
@@ -420,43 +412,20 @@ void BaseRenderOSystem::drawTickets() {
 		return;
 	}
 
-	it = _renderQueue.begin();
 	_lastFrameIter = _renderQueue.end();
-	// A special case: If the screen has one giant OPAQUE rect to be drawn, then we skip filling
-	// the background color. Typical use-case: Fullscreen FMVs.
-	// Caveat: The FPS-counter will invalidate this.
-	if (it != _lastFrameIter && _renderQueue.front() == _renderQueue.back() && (*it)->_transform._alphaDisable == true) {
-		// If our single opaque rect fills the dirty rect, we can skip filling.
-		if (*_dirtyRect != (*it)->_dstRect) {
-			// Apply the clear-color to the dirty rect.
-			_renderSurface->fillRect(*_dirtyRect, _clearColor);
-		}
-		// Otherwise Do NOT fill.
-	} else {
-		// Apply the clear-color to the dirty rect.
-		_renderSurface->fillRect(*_dirtyRect, _clearColor);
+	// Each dirty rect is redrawn and copied to the screen on its own, so that
+	// changes far apart from each other don't end up redrawing what is between them.
+	const Common::Array<Common::Rect> &dirtyRects = _dirtyRects.getRects();
+	for (uint i = 0; i < dirtyRects.size(); ++i) {
+		const Common::Rect &dirtyRect = dirtyRects[i];
+		drawTicketsInRect(dirtyRect);
+		g_system->copyRectToScreen((byte *)_renderSurface->getBasePtr(dirtyRect.left, dirtyRect.top), _renderSurface->pitch, dirtyRect.left, dirtyRect.top, dirtyRect.width(), dirtyRect.height());
 	}
-	for (; it != _renderQueue.end(); ++it) {
-		RenderTicket *ticket = *it;
-		if (ticket->_dstRect.intersects(*_dirtyRect)) {
-			// dstClip is the area we want redrawn.
-			Common::Rect dstClip(ticket->_dstRect);
-			// reduce it to the dirty rect
-			dstClip.clip(*_dirtyRect);
-			// we need to keep track of the position to redraw the dirty rect
-			Common::Rect pos(dstClip);
-			int16 offsetX = ticket->_dstRect.left;
-			int16 offsetY = ticket->_dstRect.top;
-			// convert from screen-coords to surface-coords.
-			dstClip.translate(-offsetX, -offsetY);
-
-			drawFromSurface(ticket, &pos, &dstClip);
-			_needsFlip = true;
-		}
-		// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldnt become clear-color)
-		ticket->_wantsDraw = false;
+
+	// Some tickets want redraw but don't actually clip the dirty area (typically the ones that shouldnt become clear-color)
+	for (it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
+		(*it)->_wantsDraw = false;
 	}
-	g_system->copyRectToScreen((byte *)_renderSurface->getBasePtr(_dirtyRect->left, _dirtyRect->top), _renderSurface->pitch, _dirtyRect->left, _dirtyRect->top, _dirtyRect->width(), _dirtyRect->height());
 
 	it = _renderQueue.begin();
 	// Clean out the old tickets
@@ -473,6 +442,70 @@ void BaseRenderOSystem::drawTickets() {
 
 }
 
+void BaseRenderOSystem::drawTicketsInRect(const Common::Rect &dirtyRect) {
+	_rectTickets.clear();
+	for (RenderQueueIterator it = _renderQueue.begin(); it != _renderQueue.end(); ++it) {
+		if ((*it)->_dstRect.intersects(dirtyRect)) {
+			_rectTickets.push_back(*it);
+		}
+	}
+
+	if (_rectTickets.empty()) {
+		_renderSurface->fillRect(dirtyRect, _clearColor);
+		return;
+	}
+	_needsFlip = true;
+
+	// Go through the tickets front to back, and drop the ones whose visible
+	// part is hidden by an opaque ticket drawn after them. Only the first few
+	// opaque tickets are checked against, to bound the cost with many tickets.
+	Common::Rect occluders[MAX_OCCLUDING_TICKETS];
+	uint numOccluders = 0;
+	bool isCovered = false;
+	for (int i = (int)_rectTickets.size() - 1; i >= 0; --i) {
+		Common::Rect visible(_rectTickets[i]->_dstRect);
+		visible.clip(dirtyRect);
+
+		bool isHidden = false;
+		for (uint j = 0; j < numOccluders && !isHidden; ++j) {
+			isHidden = occluders[j].contains(visible);
+		}
+
+		if (isHidden) {
+			_rectTickets[i] = nullptr;
+		} else if (numOccluders < MAX_OCCLUDING_TICKETS && _rectTickets[i]->isOpaque()) {
+			occluders[numOccluders++] = visible;
+			isCovered = isCovered || visible == dirtyRect;
+		}
+	}
+
+	// Skip filling with the clear-color when an opaque ticket covers the whole
+	// rect. Typical use-case: Fullscreen FMVs.
+	if (!isCovered) {
+		_renderSurface->fillRect(dirtyRect, _clearColor);
+	}
+
+	for (uint i = 0; i < _rectTickets.size(); ++i) {
+		RenderTicket *ticket = _rectTickets[i];
+		if (!ticket) {
+			continue;
+		}
+
+		// dstClip is the area we want redrawn.
+		Common::Rect dstClip(ticket->_dstRect);
+		// reduce it to the dirty rect
+		dstClip.clip(dirtyRect);
+		// we need to keep track of the position to redraw the dirty rect
+		Common::Rect pos(dstClip);
+		int16 offsetX = ticket->_dstRect.left;
+		int16 offsetY = ticket->_dstRect.top;
+		// convert from screen-coords to surface-coords.
+		dstClip.translate(-offsetX, -offsetY);
+
+		drawFromSurface(ticket, &pos, &dstClip);
+	}
+}
+
 // Replacement for SDL2's SDL_RenderCopy
 void BaseRenderOSystem::drawFromSurface(RenderTicket *ticket) {
 	ticket->drawToSurface(_renderSurface);
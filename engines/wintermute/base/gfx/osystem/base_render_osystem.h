@@ -30,6 +30,7 @@
 #define WINTERMUTE_BASE_RENDERER_SDL_H
 
 #include "engines/wintermute/base/gfx/base_renderer.h"
+#include "engines/wintermute/base/gfx/osystem/dirty_rect_container.h"
 #include "common/rect.h"
 #include "graphics/surface.h"
 #include "common/list.h"
@@ -53,6 +54,10 @@ class RenderTicket;
  * being equal, this information is then used to check whether the draw order changed,
  * which will then create a need for redrawing, as we draw with an alpha-channel here.
  *
+ * The dirty parts of the screen are kept as a set of disjoint rects, each of
+ * which is redrawn and copied to the screen on its own. Within a dirty rect,
+ * the tickets hidden below opaque tickets are not drawn at all.
+ *
  * There is also a draw path that draws without tickets, for debugging purposes,
  * as well as to accomodate situations with large enough amounts of draw calls,
  * that there will be too much overhead involved with comparing the generated tickets.
@@ -125,12 +130,20 @@ private:
 	 * Traverse the tickets that are dirty, and draw them
 	 */
 	void drawTickets();
+	/**
+	 * Draw the tickets which intersect a dirty rect, skipping those which
+	 * are completely hidden by opaque tickets drawn after them.
+	 * @param dirtyRect the region to be redrawn
+	 */
+	void drawTicketsInRect(const Common::Rect &dirtyRect);
 	// Non-dirty-rects:
 	void drawFromSurface(RenderTicket *ticket);
 	// Dirty-rects:
 	void drawFromSurface(RenderTicket *ticket, Common::Rect *dstRect, Common::Rect *clipRect);
-	Common::Rect *_dirtyRect;
+	DirtyRectContainer _dirtyRects;
 	Common::List<RenderTicket *> _renderQueue;
+	// Tickets to be drawn in the current dirty rect, kept to avoid reallocating it
+	Common::Array<RenderTicket *> _rectTickets;
 
 	bool _needsFlip;
 	RenderQueueIterator _lastFrameIter;
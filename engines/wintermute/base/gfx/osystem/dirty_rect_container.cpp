@@ -0,0 +1,127 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "engines/wintermute/base/gfx/osystem/dirty_rect_container.h"
+
+namespace Wintermute {
+
+// Above this number of rectangles, the bookkeeping and the separate uploads
+// cost more than redrawing the bounding box
+#define DIRTY_RECT_MAX_COUNT 32
+
+// Number of pixels a merge may add, regardless of the size of the rectangles
+#define DIRTY_RECT_MERGE_SLACK (32 * 32)
+
+static int rectArea(const Common::Rect &rect) {
+	return rect.width() * rect.height();
+}
+
+void DirtyRectContainer::addDirtyRect(const Common::Rect &rect, const Common::Rect &clipRect) {
+	Common::Rect clipped(rect);
+	clipped.clip(clipRect);
+	if (clipped.isEmpty()) {
+		return;
+	}
+
+	insertRect(clipped, true);
+}
+
+bool DirtyRectContainer::shouldMerge(const Common::Rect &a, const Common::Rect &b) {
+	Common::Rect merged(a);
+	merged.extend(b);
+
+	Common::Rect overlap(a);
+	overlap.clip(b);
+	int covered = rectArea(a) + rectArea(b) - (overlap.isEmpty() ? 0 : rectArea(overlap));
+
+	// Merge when the union wastes at most a quarter of the area it covers
+	int wasted = rectArea(merged) - covered;
+	return wasted <= MAX(covered / 4, DIRTY_RECT_MERGE_SLACK);
+}
+
+void DirtyRectContainer::insertRect(const Common::Rect &rect, bool allowMerge) {
+	Common::Rect newRect(rect);
+
+	uint i = 0;
+	while (i < _rects.size()) {
+		const Common::Rect &other = _rects[i];
+		if (other.contains(newRect)) {
+			return;
+		}
+
+		if (newRect.contains(other)) {
+			_rects.remove_at(i);
+		} else if (allowMerge && shouldMerge(newRect, other)) {
+			// The grown rectangle has to be checked against all the others again
+			newRect.extend(other);
+			_rects.remove_at(i);
+			i = 0;
+		} else {
+			++i;
+		}
+	}
+
+	// Keep the set disjoint: only add the parts outside of the rectangles
+	// which overlap the new one. These parts are not merged again, as they
+	// could then grow back over the rectangle they were cut from.
+	for (i = 0; i < _rects.size(); ++i) {
+		const Common::Rect other = _rects[i];
+		if (!newRect.intersects(other)) {
+			continue;
+		}
+
+		int16 top = MAX(newRect.top, other.top);
+		int16 bottom = MIN(newRect.bottom, other.bottom);
+
+		if (other.top > newRect.top) {
+			insertRect(Common::Rect(newRect.left, newRect.top, newRect.right, other.top), false);
+		}
+		if (other.bottom < newRect.bottom) {
+			insertRect(Common::Rect(newRect.left, other.bottom, newRect.right, newRect.bottom), false);
+		}
+		if (other.left > newRect.left) {
+			insertRect(Common::Rect(newRect.left, top, other.left, bottom), false);
+		}
+		if (other.right < newRect.right) {
+			insertRect(Common::Rect(other.right, top, newRect.right, bottom), false);
+		}
+		return;
+	}
+
+	if (_rects.size() >= DIRTY_RECT_MAX_COUNT) {
+		collapse(newRect);
+	} else {
+		_rects.push_back(newRect);
+	}
+}
+
+void DirtyRectContainer::collapse(const Common::Rect &rect) {
+	Common::Rect boundingBox(rect);
+	for (uint i = 0; i < _rects.size(); ++i) {
+		boundingBox.extend(_rects[i]);
+	}
+
+	_rects.clear();
+	_rects.push_back(boundingBox);
+}
+
+} // End of namespace Wintermute
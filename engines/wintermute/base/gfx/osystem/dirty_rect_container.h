@@ -0,0 +1,69 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef WINTERMUTE_DIRTY_RECT_CONTAINER_H
+#define WINTERMUTE_DIRTY_RECT_CONTAINER_H
+
+#include "common/array.h"
+#include "common/rect.h"
+
+namespace Wintermute {
+
+/**
+ * The regions of the screen which need to be redrawn, as a set of disjoint
+ * rectangles.
+ *
+ * A rectangle which is added gets merged with the rectangles near it when
+ * their union does not cover much more than they do. Otherwise, only the
+ * parts of it which are not dirty yet are added. Should the set grow too
+ * large, it collapses into the bounding box of all the rectangles.
+ */
+class DirtyRectContainer {
+public:
+	DirtyRectContainer() {}
+
+	/**
+	 * Mark a rectangle as dirty.
+	 * @param rect the rectangle to be added
+	 * @param clipRect the part of the screen the rectangle is clipped to
+	 */
+	void addDirtyRect(const Common::Rect &rect, const Common::Rect &clipRect);
+
+	/** Forget all the dirty rectangles */
+	void reset() { _rects.clear(); }
+
+	bool isEmpty() const { return _rects.empty(); }
+
+	/** Get the dirty rectangles, which do not overlap each other */
+	const Common::Array<Common::Rect> &getRects() const { return _rects; }
+
+private:
+	void insertRect(const Common::Rect &rect, bool allowMerge);
+	void collapse(const Common::Rect &rect);
+	static bool shouldMerge(const Common::Rect &a, const Common::Rect &b);
+
+	Common::Array<Common::Rect> _rects;
+};
+
+} // End of namespace Wintermute
+
+#endif
@@ -100,6 +100,25 @@ bool RenderTicket::operator==(const RenderTicket &t) const {
 	return true;
 }
 
+bool RenderTicket::isOpaque() const {
+	// Fade-tickets are owner-less, and always blended. Repeated tickets
+	// may leave a part of their rect uncovered.
+	if (!_owner || !_surface || _transform._numTimesX * _transform._numTimesY != 1) {
+		return false;
+	}
+
+	// Only plain copies overwrite the pixels, any modulation blends them
+	if (_transform._blendMode != Graphics::BLEND_NORMAL || _transform._rgbaMod != Graphics::kDefaultRgbaMod) {
+		return false;
+	}
+
+	// The same alpha mode as used by drawToSurface()
+	if (_transform._alphaDisable) {
+		return true;
+	}
+	return !_transform._angle && _owner->getAlphaType() == Graphics::ALPHA_OPAQUE;
+}
+
 // Replacement for SDL2's SDL_RenderCopy
 void RenderTicket::drawToSurface(Graphics::Surface *_targetSurface) const {
 	Graphics::TransparentSurface src(*getSurface(), false);
@@ -59,6 +59,11 @@ public:
 	void drawToSurface(Graphics::Surface *_targetSurface) const;
 	// Dirty-rects:
 	void drawToSurface(Graphics::Surface *_targetSurface, Common::Rect *dstRect, Common::Rect *clipRect) const;
+	/**
+	 * Whether drawing the ticket replaces every pixel of its destination
+	 * rect, thus hiding whatever was drawn there before.
+	 */
+	bool isOpaque() const;
 
 	Common::Rect _dstRect;
 
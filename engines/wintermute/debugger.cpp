@@ -27,6 +27,9 @@
 #include "engines/wintermute/debugger/debugger_controller.h"
 #include "engines/wintermute/wintermute.h"
 
+#include "common/system.h"
+#include "graphics/transparent_surface.h"
+
 #define CONTROLLER _engineRef->_dbgController
 
 namespace Wintermute {
@@ -37,6 +40,7 @@ Console::Console(WintermuteEngine *vm) : GUI::Debugger(), _engineRef(vm) {
 	registerCmd("show_fps", WRAP_METHOD(Console, Cmd_ShowFps));
 	registerCmd("dump_file", WRAP_METHOD(Console, Cmd_DumpFile));
 	registerCmd("help", WRAP_METHOD(Console, Cmd_Help));
+	registerCmd("blit_bench", WRAP_METHOD(Console, Cmd_BlitBench));
 	// Actual (script) debugger commands
 	registerCmd(STEP_CMD, WRAP_METHOD(Console, Cmd_Step));
 	registerCmd(CONTINUE_CMD, WRAP_METHOD(Console, Cmd_Continue));
@@ -341,6 +345,73 @@ bool Console::Cmd_DumpFile(int argc, const char **argv) {
 	return true;
 }
 
+bool Console::Cmd_BlitBench(int argc, const char **argv) {
+	if (argc > 2) {
+		debugPrintf("Usage: %s [iterations]\n", argv[0]);
+		return true;
+	}
+
+	const int iterations = (argc == 2) ? atoi(argv[1]) : 100;
+	if (iterations <= 0) {
+		debugPrintf("%s: iterations must be positive\n", argv[0]);
+		return true;
+	}
+
+	// Sizes of a cursor or icon, a character sprite and a full screen layer
+	static const int sizes[][2] = { { 32, 32 }, { 128, 128 }, { 640, 480 } };
+	static const struct {
+		Graphics::TSpriteBlendMode mode;
+		const char *name;
+	} modes[] = {
+		{ Graphics::BLEND_NORMAL, "alpha" },
+		{ Graphics::BLEND_ADDITIVE, "additive" },
+		{ Graphics::BLEND_SUBTRACTIVE, "subtractive" },
+		{ Graphics::BLEND_MULTIPLY, "multiply" }
+	};
+	static const uint32 tints[] = { 0xffffffff, 0xc0ff8040 };
+
+	const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+	Graphics::Surface target;
+	target.create(640, 480, format);
+
+	debugPrintf("Average time per blit in microseconds over %d blits\n", iterations);
+	debugPrintf("%-9s %-12s %-9s %9s %9s\n", "size", "mode", "tint", "generic", "simd");
+
+	uint32 seed = 0x1234567;
+	for (uint s = 0; s < ARRAYSIZE(sizes); s++) {
+		Graphics::TransparentSurface sprite;
+		sprite.create(sizes[s][0], sizes[s][1], format);
+		byte *pixels = (byte *)sprite.getPixels();
+		for (int i = 0; i < sprite.pitch * sprite.h; i++) {
+			seed = seed * 1103515245 + 12345;
+			pixels[i] = (byte)(seed >> 16);
+		}
+
+		for (uint m = 0; m < ARRAYSIZE(modes); m++) {
+			for (uint t = 0; t < ARRAYSIZE(tints); t++) {
+				uint32 elapsed[2];
+				for (int simd = 0; simd < 2; simd++) {
+					Graphics::TransparentSurface::setSIMDEnabled(simd != 0);
+					const uint32 start = g_system->getMillis();
+					for (int i = 0; i < iterations; i++)
+						sprite.blit(target, 0, 0, Graphics::FLIP_NONE, nullptr, tints[t], -1, -1, modes[m].mode);
+					elapsed[simd] = g_system->getMillis() - start;
+				}
+
+				const Common::String size = Common::String::format("%dx%d", sizes[s][0], sizes[s][1]);
+				debugPrintf("%-9s %-12s %-9s %9u %9u\n", size.c_str(), modes[m].name, (tints[t] == 0xffffffff) ? "none" : "modulated",
+					elapsed[0] * 1000 / iterations, elapsed[1] * 1000 / iterations);
+			}
+		}
+
+		sprite.free();
+	}
+
+	Graphics::TransparentSurface::setSIMDEnabled(true);
+	target.free();
+	return true;
+}
+
 
 bool Console::Cmd_SourcePath(int argc, const char **argv) {
 	if (argc != 2) {
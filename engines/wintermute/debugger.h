@@ -70,6 +70,11 @@ public:
 	bool Cmd_Help(int argc, const char **argv);
 	bool Cmd_ShowFps(int argc, const char **argv);
 	bool Cmd_DumpFile(int argc, const char **argv);
+	/**
+	 * Time the blended blits of TransparentSurface with and without
+	 * the SIMD kernels.
+	 */
+	bool Cmd_BlitBench(int argc, const char **argv);
 
 #if EXTENDED_DEBUGGER_ENABLED
 	/**
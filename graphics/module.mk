@@ -39,11 +39,13 @@ MODULE_OBJS := \
 	transform_struct.o \
 	transform_tools.o \
 	transparent_surface.o \
+	transparent_surface_kernels.o \
 	thumbnail.o \
 	VectorRenderer.o \
 	VectorRendererSpec.o \
 	wincursor.o \
 	yuv_to_rgb.o \
+	yuv_to_rgb_kernels.o \
 	pixelbuffer.o \
 	opengl/context.o \
 	opengl/framebuffer.o \
@@ -74,12 +76,56 @@ MODULE_OBJS += \
 	tinygl/texture.o \
 	tinygl/texelbuffer.o \
 	tinygl/vertex.o \
+	tinygl/vertex_kernels.o \
 	tinygl/zbuffer.o \
 	tinygl/zline.o \
 	tinygl/zmath.o \
 	tinygl/ztriangle.o \
 	tinygl/zblit.o \
 	tinygl/zdirtyrect.o
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	tinygl/vertex_kernels_sse2.o
+
+$(MODULE)/tinygl/vertex_kernels_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	tinygl/vertex_kernels_avx2.o
+
+$(MODULE)/tinygl/vertex_kernels_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	tinygl/vertex_kernels_neon.o
+endif
+endif
+
+ifdef SCUMMVM_SSE2
+MODULE_OBJS += \
+	transparent_surface_kernels_sse2.o \
+	yuv_to_rgb_kernels_sse2.o
+
+$(MODULE)/transparent_surface_kernels_sse2.o: CXXFLAGS += -msse2
+$(MODULE)/yuv_to_rgb_kernels_sse2.o: CXXFLAGS += -msse2
+endif
+
+ifdef SCUMMVM_AVX2
+MODULE_OBJS += \
+	transparent_surface_kernels_avx2.o \
+	yuv_to_rgb_kernels_avx2.o
+
+$(MODULE)/transparent_surface_kernels_avx2.o: CXXFLAGS += -mavx2
+$(MODULE)/yuv_to_rgb_kernels_avx2.o: CXXFLAGS += -mavx2
+endif
+
+ifdef SCUMMVM_NEON
+MODULE_OBJS += \
+	transparent_surface_kernels_neon.o \
+	yuv_to_rgb_kernels_neon.o
 endif
 
 ifdef USE_ASPECT
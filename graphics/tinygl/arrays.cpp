@@ -35,10 +35,10 @@
 
 namespace TinyGL {
 
-void glopArrayElement(GLContext *c, GLParam *param) {
+// Set the current color, normal and texture coordinates from the arrays
+static void loadElementAttributes(GLContext *c, int idx) {
 	int i;
 	int states = c->client_states;
-	int idx = param[1].i;
 
 	if (states & COLOR_ARRAY) {
 		GLParam p[5];
@@ -65,10 +65,16 @@ void glopArrayElement(GLContext *c, GLParam *param) {
 		c->current_tex_coord.Z = size > 2 ? c->texcoord_array[i + 2] : 0.0f;
 		c->current_tex_coord.W = size > 3 ? c->texcoord_array[i + 3] : 1.0f;
 	}
-	if (states & VERTEX_ARRAY) {
+}
+
+void glopArrayElement(GLContext *c, GLParam *param) {
+	int idx = param[1].i;
+
+	loadElementAttributes(c, idx);
+	if (c->client_states & VERTEX_ARRAY) {
 		GLParam p[5];
 		int size = c->vertex_array_size;
-		i = idx * (size + c->vertex_array_stride);
+		int i = idx * (size + c->vertex_array_stride);
 		p[1].f = c->vertex_array[i];
 		p[2].f = c->vertex_array[i + 1];
 		p[3].f = size > 2 ? c->vertex_array[i + 2] : 0.0f;
@@ -77,14 +83,259 @@ void glopArrayElement(GLContext *c, GLParam *param) {
 	}
 }
 
+static void reserveVertices(GLContext *c, int n) {
+	if (c->vertex_n + n <= c->vertex_max)
+		return;
+
+	while (c->vertex_n + n > c->vertex_max)
+		c->vertex_max <<= 1;
+	GLVertex *newarray = (GLVertex *)gl_malloc(sizeof(GLVertex) * c->vertex_max);
+	if (!newarray) {
+		error("unable to allocate GLVertex array.");
+	}
+	memcpy(newarray, c->vertex, c->vertex_n * sizeof(GLVertex));
+	gl_free(c->vertex);
+	c->vertex = newarray;
+}
+
+// The vertex kernels handle all the states, except for the specular term
+// and colors changing the material for each vertex
+static bool canBatchElements(GLContext *c) {
+	if (!c->lighting_enabled)
+		return true;
+	if ((c->client_states & COLOR_ARRAY) && c->color_material_enabled)
+		return false;
+	return gl_can_shade_vertex_batch(c);
+}
+
+// Emit the vertices for up to VERTEX_BATCH_SIZE array elements, at the given
+// positions in the vertex list. This does the same as glopVertex, with the
+// transformation and lighting done by the vertex kernels for all the
+// elements at once.
+static void emitElementBatch(GLContext *c, const int *elements, const int *positions, int n) {
+	GLVertexBatch *batch = c->vertex_batch;
+	const VertexKernels &kernels = c->vertex_kernels;
+	int states = c->client_states;
+
+	int size = c->vertex_array_size;
+	for (int k = 0; k < n; k++) {
+		int i = elements[k] * (size + c->vertex_array_stride);
+		GLVertex *v = &c->vertex[positions[k]];
+		v->coord.X = batch->coord_x[k] = c->vertex_array[i];
+		v->coord.Y = batch->coord_y[k] = c->vertex_array[i + 1];
+		v->coord.Z = batch->coord_z[k] = size > 2 ? c->vertex_array[i + 2] : 0.0f;
+		v->coord.W = size > 3 ? c->vertex_array[i + 3] : 1.0f;
+	}
+
+	if (c->lighting_enabled) {
+		for (int k = 0; k < n; k++) {
+			if (states & NORMAL_ARRAY) {
+				int i = elements[k] * (3 + c->normal_array_stride);
+				batch->normal_x[k] = c->normal_array[i];
+				batch->normal_y[k] = c->normal_array[i + 1];
+				batch->normal_z[k] = c->normal_array[i + 2];
+			} else {
+				batch->normal_x[k] = c->current_normal.X;
+				batch->normal_y[k] = c->current_normal.Y;
+				batch->normal_z[k] = c->current_normal.Z;
+			}
+		}
+
+		kernels.transformPoints(*c->matrix_stack_ptr[0], batch->coord_x, batch->coord_y, batch->coord_z, NULL,
+		                        batch->ec_x, batch->ec_y, batch->ec_z, batch->ec_w, n);
+		kernels.transformPoints(*c->matrix_stack_ptr[1], batch->ec_x, batch->ec_y, batch->ec_z, batch->ec_w,
+		                        batch->pc_x, batch->pc_y, batch->pc_z, batch->pc_w, n);
+		kernels.transformNormals(c->matrix_model_view_inv, batch->normal_x, batch->normal_y, batch->normal_z,
+		                         batch->normal_x, batch->normal_y, batch->normal_z, n, c->normalize_enabled);
+		gl_shade_vertex_batch(c, batch, n);
+	} else {
+		kernels.transformPoints(c->matrix_model_projection, batch->coord_x, batch->coord_y, batch->coord_z, NULL,
+		                        batch->pc_x, batch->pc_y, batch->pc_z, batch->pc_w, n);
+		if (c->matrix_model_projection_no_w_transform) {
+			for (int k = 0; k < n; k++)
+				batch->pc_w[k] = c->matrix_model_projection._m[3][3];
+		}
+	}
+
+	for (int k = 0; k < n; k++) {
+		GLVertex *v = &c->vertex[positions[k]];
+		loadElementAttributes(c, elements[k]);
+
+		v->pc.X = batch->pc_x[k];
+		v->pc.Y = batch->pc_y[k];
+		v->pc.Z = batch->pc_z[k];
+		v->pc.W = batch->pc_w[k];
+		v->clip_code = gl_clipcode(v->pc.X, v->pc.Y, v->pc.Z, v->pc.W);
+
+		if (c->lighting_enabled) {
+			v->ec.X = batch->ec_x[k];
+			v->ec.Y = batch->ec_y[k];
+			v->ec.Z = batch->ec_z[k];
+			v->ec.W = batch->ec_w[k];
+			v->normal.X = batch->normal_x[k];
+			v->normal.Y = batch->normal_y[k];
+			v->normal.Z = batch->normal_z[k];
+			v->color.X = clampf(c->current_color.X * batch->color_r[k], 0, 1);
+			v->color.Y = clampf(c->current_color.Y * batch->color_g[k], 0, 1);
+			v->color.Z = clampf(c->current_color.Z * batch->color_b[k], 0, 1);
+			v->color.W = c->current_color.W * batch->alpha;
+		} else {
+			v->normal.X = v->normal.Y = v->normal.Z = 0;
+			v->ec.X = v->ec.Y = v->ec.Z = v->ec.W = 0;
+			v->color = c->current_color;
+		}
+
+		if (c->texture_2d_enabled) {
+			if (c->apply_texture_matrix) {
+				c->matrix_stack_ptr[2]->transform(c->current_tex_coord, v->tex_coord);
+			} else {
+				v->tex_coord = c->current_tex_coord;
+			}
+		}
+
+		if (v->clip_code == 0)
+			gl_transform_to_viewport(c, v);
+
+		v->edge_flag = c->current_edge_flag;
+	}
+}
+
 void glopDrawArrays(GLContext *c, GLParam *p) {
 	GLParam array_element[2];
 	GLParam begin[2];
+	int first = p[2].i;
+	int count = p[3].i;
+
+	begin[1].i = p[1].i;
+	glopBegin(c, begin);
+	if ((c->client_states & VERTEX_ARRAY) && count > 0 && canBatchElements(c)) {
+		int elements[VERTEX_BATCH_SIZE], positions[VERTEX_BATCH_SIZE];
+		reserveVertices(c, count);
+		for (int i = 0; i < count; i += VERTEX_BATCH_SIZE) {
+			int n = MIN(count - i, VERTEX_BATCH_SIZE);
+			for (int k = 0; k < n; k++) {
+				elements[k] = first + i + k;
+				positions[k] = c->vertex_n + i + k;
+			}
+			emitElementBatch(c, elements, positions, n);
+		}
+		c->vertex_n += count;
+		c->vertex_cnt += count;
+	} else {
+		for (int i = 0; i < count; i++) {
+			array_element[1].i = first + i;
+			glopArrayElement(c, array_element);
+		}
+	}
+	glopEnd(c, NULL);
+}
+
+template<typename T>
+static void drawElements(GLContext *c, int count, const T *indices) {
+	GLParam array_element[2];
+
+	if (!(c->client_states & VERTEX_ARRAY)) {
+		// No vertex is emitted, only the current attributes change
+		for (int i = 0; i < count; i++) {
+			array_element[1].i = indices[i];
+			glopArrayElement(c, array_element);
+		}
+		return;
+	}
+
+	int minIndex = indices[0], maxIndex = indices[0];
+	for (int i = 1; i < count; i++) {
+		minIndex = MIN<int>(minIndex, indices[i]);
+		maxIndex = MAX<int>(maxIndex, indices[i]);
+	}
+
+	int cacheSize = maxIndex - minIndex + 1;
+	if (cacheSize > c->element_cache_size) {
+		gl_free(c->element_cache);
+		c->element_cache = (int *)gl_malloc(cacheSize * sizeof(int));
+		c->element_cache_size = cacheSize;
+	}
+	int *cache = c->element_cache;
+	for (int i = 0; i < cacheSize; i++)
+		cache[i] = -1;
+
+	if (canBatchElements(c)) {
+		// Each element is transformed and lit once, in batches, at the position
+		// where it is first used. The other uses copy that vertex afterwards.
+		int elements[VERTEX_BATCH_SIZE], positions[VERTEX_BATCH_SIZE];
+		int pending = 0;
+		int first = c->vertex_n;
+
+		reserveVertices(c, count);
+		for (int i = 0; i < count; i++) {
+			int &pos = cache[indices[i] - minIndex];
+			if (pos >= 0)
+				continue;
+
+			pos = first + i;
+			elements[pending] = indices[i];
+			positions[pending] = pos;
+			if (++pending == VERTEX_BATCH_SIZE) {
+				emitElementBatch(c, elements, positions, pending);
+				pending = 0;
+			}
+		}
+		if (pending > 0)
+			emitElementBatch(c, elements, positions, pending);
+
+		for (int i = 0; i < count; i++) {
+			int pos = cache[indices[i] - minIndex];
+			if (pos != first + i)
+				c->vertex[first + i] = c->vertex[pos];
+		}
+		c->vertex_n += count;
+		c->vertex_cnt += count;
+
+		// Leave the current attributes as the last element sets them
+		loadElementAttributes(c, indices[count - 1]);
+		return;
+	}
+
+	for (int i = 0; i < count; i++) {
+		int pos = cache[indices[i] - minIndex];
+		if (pos < 0) {
+			// The vertex is transformed and lit once, and then copied
+			// each time the same element is used again
+			array_element[1].i = indices[i];
+			glopArrayElement(c, array_element);
+			cache[indices[i] - minIndex] = c->vertex_n - 1;
+			continue;
+		}
+
+		reserveVertices(c, 1);
+		c->vertex[c->vertex_n] = c->vertex[pos];
+		c->vertex_n++;
+		c->vertex_cnt++;
+	}
+}
+
+void glopDrawElements(GLContext *c, GLParam *p) {
+	GLParam begin[2];
+	int count = p[2].i;
+
+	if (count <= 0)
+		return;
+
 	begin[1].i = p[1].i;
 	glopBegin(c, begin);
-	for (int i=0; i < p[3].i; i++) {
-		array_element[1].i = p[2].i + i;
-		glopArrayElement(c, array_element);
+	switch (p[3].i) {
+	case TGL_UNSIGNED_BYTE:
+		drawElements(c, count, (const uint8 *)p[4].p);
+		break;
+	case TGL_UNSIGNED_SHORT:
+		drawElements(c, count, (const uint16 *)p[4].p);
+		break;
+	case TGL_UNSIGNED_INT:
+		drawElements(c, count, (const uint32 *)p[4].p);
+		break;
+	default:
+		assert(0);
+		break;
 	}
 	glopEnd(c, NULL);
 }
@@ -138,6 +389,16 @@ void tglDrawArrays(TGLenum mode, TGLint first, TGLsizei count) {
 	gl_add_op(p);
 }
 
+void tglDrawElements(TGLenum mode, TGLsizei count, TGLenum type, const TGLvoid *indices) {
+	TinyGL::GLParam p[5];
+	p[0].op = TinyGL::OP_DrawElements;
+	p[1].i = mode;
+	p[2].i = count;
+	p[3].i = type;
+	p[4].p = const_cast<void *>(indices);
+	gl_add_op(p);
+}
+
 void tglEnableClientState(TGLenum array) {
 	TinyGL::GLParam p[2];
 	p[0].op = TinyGL::OP_EnableClientState;
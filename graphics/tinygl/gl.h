@@ -841,6 +841,7 @@ void tglEnableClientState(TGLenum array);
 void tglDisableClientState(TGLenum array);
 void tglArrayElement(TGLint i);
 void tglDrawArrays(TGLenum mode, TGLint first, TGLsizei count);
+void tglDrawElements(TGLenum mode, TGLsizei count, TGLenum type, const TGLvoid *indices);
 void tglVertexPointer(TGLint size, TGLenum type, TGLsizei stride, const TGLvoid *pointer);
 void tglColorPointer(TGLint size, TGLenum type, TGLsizei stride, const TGLvoid *pointer);
 void tglNormalPointer(TGLenum type, TGLsizei stride, const TGLvoid *pointer);
@@ -857,6 +858,19 @@ namespace TinyGL {
 
 void tglPresentBuffer();
 
+struct VertexBenchmark {
+	int vertices;
+	int iterations;
+	unsigned int genericTime;
+	unsigned int simdTime;
+	bool identical;
+};
+
+// Transform and light a synthetic mesh of the given size several times, with
+// the generic and with the SIMD vertex kernels, timing each and comparing
+// the results. This does not need a context.
+void tglBenchmarkVertexKernels(int vertices, int iterations, VertexBenchmark &result);
+
 } // end of namespace TinyGL
 
 #endif
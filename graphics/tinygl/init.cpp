@@ -208,6 +208,10 @@ void glInit(void *zbuffer1, int textureSize) {
 
 	// opengl 1.1 arrays
 	c->client_states = 0;
+	c->element_cache = nullptr;
+	c->element_cache_size = 0;
+	c->vertex_batch = (GLVertexBatch *)gl_malloc(sizeof(GLVertexBatch));
+	getVertexKernels(c->vertex_kernels, true);
 
 	// opengl 1.1 polygon offset
 	c->offset_states = 0;
@@ -249,6 +253,8 @@ void glClose() {
 		gl_free(c->matrix_stack[i]);
 	endSharedState(c);
 	gl_free(c->vertex);
+	gl_free(c->element_cache);
+	gl_free(c->vertex_batch);
 
 	delete c;
 }
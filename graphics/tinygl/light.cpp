@@ -167,16 +167,6 @@ void glopLightModel(GLContext *c, GLParam *p) {
 	}
 }
 
-
-static inline float clampf(float a, float min, float max) {
-	if (a < min)
-		return min;
-	else if (a > max)
-		return max;
-	else
-		return a;
-}
-
 void gl_enable_disable_light(GLContext *c, int light, int v) {
 	GLLight *l = &c->lights[light];
 	if (v && !l->enabled) {
@@ -325,4 +315,73 @@ void gl_shade_vertex(GLContext *c, GLVertex *v) {
 	v->color.W = c->current_color.W * A;
 }
 
+// the vertex kernels do not handle the specular term
+bool gl_can_shade_vertex_batch(GLContext *c) {
+	const GLMaterial *m = &c->materials[0];
+
+	if (!m->has_specular)
+		return true;
+	for (const GLLight *l = c->first_light; l != NULL; l = l->next) {
+		if (l->has_specular)
+			return false;
+	}
+	return true;
+}
+
+// same lighting model as gl_shade_vertex, for a batch of vertices whose eye
+// coordinates and normals are known. The colors are left unclamped and not
+// multiplied by the current color yet.
+void gl_shade_vertex_batch(GLContext *c, GLVertexBatch *batch, int n) {
+	const GLMaterial *m = &c->materials[0];
+	LightKernelParams params;
+
+	const float R = m->emission.X + m->ambient.X * c->ambient_light_model.X;
+	const float G = m->emission.Y + m->ambient.Y * c->ambient_light_model.Y;
+	const float B = m->emission.Z + m->ambient.Z * c->ambient_light_model.Z;
+	for (int i = 0; i < n; i++) {
+		batch->color_r[i] = R;
+		batch->color_g[i] = G;
+		batch->color_b[i] = B;
+	}
+	batch->alpha = clampf(m->diffuse.W, 0, 1);
+
+	params.materialDiffuse[0] = m->diffuse.X;
+	params.materialDiffuse[1] = m->diffuse.Y;
+	params.materialDiffuse[2] = m->diffuse.Z;
+	params.twoSide = c->light_model_two_side != 0;
+
+	for (const GLLight *l = c->first_light; l != NULL; l = l->next) {
+		params.ambient[0] = l->ambient.X * m->ambient.X;
+		params.ambient[1] = l->ambient.Y * m->ambient.Y;
+		params.ambient[2] = l->ambient.Z * m->ambient.Z;
+		params.diffuse[0] = l->diffuse.X;
+		params.diffuse[1] = l->diffuse.Y;
+		params.diffuse[2] = l->diffuse.Z;
+
+		params.infinite = l->position.W == 0;
+		if (params.infinite) {
+			params.position[0] = l->norm_position.X;
+			params.position[1] = l->norm_position.Y;
+			params.position[2] = l->norm_position.Z;
+		} else {
+			params.position[0] = l->position.X;
+			params.position[1] = l->position.Y;
+			params.position[2] = l->position.Z;
+		}
+		for (int i = 0; i < 3; i++)
+			params.attenuation[i] = l->attenuation[i];
+
+		params.spot = l->spot_cutoff != 180;
+		params.spotDirection[0] = l->norm_spot_direction.X;
+		params.spotDirection[1] = l->norm_spot_direction.Y;
+		params.spotDirection[2] = l->norm_spot_direction.Z;
+		params.cosSpotCutoff = l->cos_spot_cutoff;
+		params.spotExponent = l->spot_exponent;
+
+		c->vertex_kernels.shadeLight(params, batch->ec_x, batch->ec_y, batch->ec_z,
+		                             batch->normal_x, batch->normal_y, batch->normal_z,
+		                             batch->color_r, batch->color_g, batch->color_b, n);
+	}
+}
+
 } // end of namespace TinyGL
@@ -0,0 +1,313 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "common/system.h"
+
+#include "graphics/tinygl/gl.h"
+#include "graphics/tinygl/vertex_kernels.h"
+
+namespace TinyGL {
+
+void transformPointsGeneric(const Matrix4 &m, const float *x, const float *y, const float *z, const float *w,
+                            float *outX, float *outY, float *outZ, float *outW, int count) {
+	const float (*mat)[4] = m._m;
+
+	if (!w) {
+		for (int i = 0; i < count; i++) {
+			const float vx = x[i], vy = y[i], vz = z[i];
+			outX[i] = vx * mat[0][0] + vy * mat[0][1] + vz * mat[0][2] + mat[0][3];
+			outY[i] = vx * mat[1][0] + vy * mat[1][1] + vz * mat[1][2] + mat[1][3];
+			outZ[i] = vx * mat[2][0] + vy * mat[2][1] + vz * mat[2][2] + mat[2][3];
+			outW[i] = vx * mat[3][0] + vy * mat[3][1] + vz * mat[3][2] + mat[3][3];
+		}
+		return;
+	}
+
+	for (int i = 0; i < count; i++) {
+		const float vx = x[i], vy = y[i], vz = z[i], vw = w[i];
+		outX[i] = vx * mat[0][0] + vy * mat[0][1] + vz * mat[0][2] + vw * mat[0][3];
+		outY[i] = vx * mat[1][0] + vy * mat[1][1] + vz * mat[1][2] + vw * mat[1][3];
+		outZ[i] = vx * mat[2][0] + vy * mat[2][1] + vz * mat[2][2] + vw * mat[2][3];
+		outW[i] = vx * mat[3][0] + vy * mat[3][1] + vz * mat[3][2] + vw * mat[3][3];
+	}
+}
+
+void transformNormalsGeneric(const Matrix4 &m, const float *x, const float *y, const float *z,
+                             float *outX, float *outY, float *outZ, int count, bool normalize) {
+	const float (*mat)[4] = m._m;
+
+	for (int i = 0; i < count; i++) {
+		const float vx = x[i], vy = y[i], vz = z[i];
+		float nx = vx * mat[0][0] + vy * mat[0][1] + vz * mat[0][2];
+		float ny = vx * mat[1][0] + vy * mat[1][1] + vz * mat[1][2];
+		float nz = vx * mat[2][0] + vy * mat[2][1] + vz * mat[2][2];
+
+		if (normalize) {
+			float n = sqrt(nx * nx + ny * ny + nz * nz);
+			if (n != 0) {
+				nx /= n;
+				ny /= n;
+				nz /= n;
+			}
+		}
+
+		outX[i] = nx;
+		outY[i] = ny;
+		outZ[i] = nz;
+	}
+}
+
+void shadeLightGeneric(const LightKernelParams &light, const float *ecX, const float *ecY, const float *ecZ,
+                       const float *nX, const float *nY, const float *nZ,
+                       float *r, float *g, float *b, int count) {
+	for (int i = 0; i < count; i++) {
+		float lR = light.ambient[0];
+		float lG = light.ambient[1];
+		float lB = light.ambient[2];
+		float dX, dY, dZ, dist, att;
+
+		if (light.infinite) {
+			dX = light.position[0];
+			dY = light.position[1];
+			dZ = light.position[2];
+			dist = 1;
+			att = 1;
+		} else {
+			dX = light.position[0] - ecX[i];
+			dY = light.position[1] - ecY[i];
+			dZ = light.position[2] - ecZ[i];
+			dist = sqrt(dX * dX + dY * dY + dZ * dZ);
+			att = 1.0f / (light.attenuation[0] + dist * (light.attenuation[1] +
+			              dist * light.attenuation[2]));
+		}
+
+		float dot = dX * nX[i] + dY * nY[i] + dZ * nZ[i];
+		if (light.twoSide && dot < 0)
+			dot = -dot;
+		if (dot > 0) {
+			float tmp = 1 / dist;
+			dX *= tmp;
+			dY *= tmp;
+			dZ *= tmp;
+			dot *= tmp;
+			lR += dot * light.diffuse[0] * light.materialDiffuse[0];
+			lG += dot * light.diffuse[1] * light.materialDiffuse[1];
+			lB += dot * light.diffuse[2] * light.materialDiffuse[2];
+
+			if (light.spot) {
+				float dotSpot = -(dX * light.spotDirection[0] +
+				                  dY * light.spotDirection[1] +
+				                  dZ * light.spotDirection[2]);
+				if (light.twoSide && dotSpot < 0)
+					dotSpot = -dotSpot;
+				if (dotSpot < light.cosSpotCutoff) {
+					// no contribution
+					continue;
+				}
+				if (light.spotExponent > 0)
+					att = spotAttenuation(att, dotSpot, light.spotExponent);
+			}
+		}
+
+		r[i] += att * lR;
+		g[i] += att * lG;
+		b[i] += att * lB;
+	}
+}
+
+void getVertexKernels(VertexKernels &kernels, bool simd) {
+	kernels.transformPoints = transformPointsGeneric;
+	kernels.transformNormals = transformNormalsGeneric;
+	kernels.shadeLight = shadeLightGeneric;
+
+	if (!simd)
+		return;
+
+	// Pick the fastest kernels the CPU supports
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		kernels.transformPoints = transformPointsNEON;
+		kernels.transformNormals = transformNormalsNEON;
+		kernels.shadeLight = shadeLightNEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		kernels.transformPoints = transformPointsSSE2;
+		kernels.transformNormals = transformNormalsSSE2;
+		kernels.shadeLight = shadeLightSSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		kernels.transformPoints = transformPointsAVX2;
+		kernels.transformNormals = transformNormalsAVX2;
+		kernels.shadeLight = shadeLightAVX2;
+	}
+#endif
+}
+
+/**
+ * Structure of arrays holding the vertices of the benchmark mesh and the
+ * results of each stage of the vertex processing.
+ */
+struct BenchmarkMesh {
+	enum {
+		kCoordX, kCoordY, kCoordZ,
+		kNormalX, kNormalY, kNormalZ,
+		kEyeX, kEyeY, kEyeZ, kEyeW,
+		kClipX, kClipY, kClipZ, kClipW,
+		kOutNormalX, kOutNormalY, kOutNormalZ,
+		kColorR, kColorG, kColorB,
+		kStreamCount,
+		kFirstResult = kEyeX
+	};
+
+	BenchmarkMesh(int size) : _size(size), _data(new float[kStreamCount * size]) {}
+	~BenchmarkMesh() { delete[] _data; }
+
+	float *stream(int index) { return _data + index * _size; }
+	const float *results() const { return _data + kFirstResult * _size; }
+	int resultsSize() const { return (kStreamCount - kFirstResult) * _size * sizeof(float); }
+
+	int _size;
+	float *_data;
+};
+
+// Run the vertex stage of a lit draw call, as the batched array drawing does
+static void processBenchmarkMesh(const VertexKernels &kernels, BenchmarkMesh &mesh, const Matrix4 &modelView,
+                                 const Matrix4 &projection, const Matrix4 &normalMatrix,
+                                 const LightKernelParams *lights, int lightCount) {
+	const int n = mesh._size;
+	kernels.transformPoints(modelView, mesh.stream(BenchmarkMesh::kCoordX), mesh.stream(BenchmarkMesh::kCoordY),
+	                        mesh.stream(BenchmarkMesh::kCoordZ), NULL,
+	                        mesh.stream(BenchmarkMesh::kEyeX), mesh.stream(BenchmarkMesh::kEyeY),
+	                        mesh.stream(BenchmarkMesh::kEyeZ), mesh.stream(BenchmarkMesh::kEyeW), n);
+	kernels.transformPoints(projection, mesh.stream(BenchmarkMesh::kEyeX), mesh.stream(BenchmarkMesh::kEyeY),
+	                        mesh.stream(BenchmarkMesh::kEyeZ), mesh.stream(BenchmarkMesh::kEyeW),
+	                        mesh.stream(BenchmarkMesh::kClipX), mesh.stream(BenchmarkMesh::kClipY),
+	                        mesh.stream(BenchmarkMesh::kClipZ), mesh.stream(BenchmarkMesh::kClipW), n);
+	kernels.transformNormals(normalMatrix, mesh.stream(BenchmarkMesh::kNormalX), mesh.stream(BenchmarkMesh::kNormalY),
+	                         mesh.stream(BenchmarkMesh::kNormalZ),
+	                         mesh.stream(BenchmarkMesh::kOutNormalX), mesh.stream(BenchmarkMesh::kOutNormalY),
+	                         mesh.stream(BenchmarkMesh::kOutNormalZ), n, true);
+
+	for (int i = 0; i < n; i++) {
+		mesh.stream(BenchmarkMesh::kColorR)[i] = 0.2f;
+		mesh.stream(BenchmarkMesh::kColorG)[i] = 0.2f;
+		mesh.stream(BenchmarkMesh::kColorB)[i] = 0.2f;
+	}
+	for (int l = 0; l < lightCount; l++) {
+		kernels.shadeLight(lights[l], mesh.stream(BenchmarkMesh::kEyeX), mesh.stream(BenchmarkMesh::kEyeY),
+		                   mesh.stream(BenchmarkMesh::kEyeZ),
+		                   mesh.stream(BenchmarkMesh::kOutNormalX), mesh.stream(BenchmarkMesh::kOutNormalY),
+		                   mesh.stream(BenchmarkMesh::kOutNormalZ),
+		                   mesh.stream(BenchmarkMesh::kColorR), mesh.stream(BenchmarkMesh::kColorG),
+		                   mesh.stream(BenchmarkMesh::kColorB), n);
+	}
+}
+
+static void initBenchmarkLight(LightKernelParams &light, bool infinite, bool spot) {
+	for (int i = 0; i < 3; i++) {
+		light.ambient[i] = 0.05f;
+		light.diffuse[i] = 0.8f - 0.1f * i;
+		light.materialDiffuse[i] = 0.8f;
+		light.attenuation[i] = 0.0f;
+	}
+	light.infinite = infinite;
+	if (infinite) {
+		light.position[0] = 0.0f;
+		light.position[1] = 0.6f;
+		light.position[2] = 0.8f;
+	} else {
+		light.position[0] = 1.0f;
+		light.position[1] = 2.0f;
+		light.position[2] = -1.0f;
+	}
+	light.attenuation[0] = 1.0f;
+	light.attenuation[2] = spot ? 0.0f : 1.0f;
+	light.spot = spot;
+	light.spotDirection[0] = -0.4f;
+	light.spotDirection[1] = -0.8f;
+	light.spotDirection[2] = -0.45f;
+	light.cosSpotCutoff = 0.5f;
+	light.spotExponent = spot ? 2.0f : 0.0f;
+	light.twoSide = false;
+}
+
+void tglBenchmarkVertexKernels(int vertices, int iterations, VertexBenchmark &result) {
+	BenchmarkMesh genericMesh(vertices), simdMesh(vertices);
+
+	// A closed mesh around the origin, seen from a few units away
+	uint32 seed = 0x13579bdf;
+	for (int i = 0; i < vertices; i++) {
+		float coord[3];
+		for (int j = 0; j < 3; j++) {
+			seed = seed * 1103515245 + 12345;
+			coord[j] = (float)((seed >> 8) & 0xffff) / 32768.0f - 1.0f;
+		}
+		genericMesh.stream(BenchmarkMesh::kCoordX)[i] = coord[0];
+		genericMesh.stream(BenchmarkMesh::kCoordY)[i] = coord[1];
+		genericMesh.stream(BenchmarkMesh::kCoordZ)[i] = coord[2];
+		genericMesh.stream(BenchmarkMesh::kNormalX)[i] = coord[0];
+		genericMesh.stream(BenchmarkMesh::kNormalY)[i] = coord[1];
+		genericMesh.stream(BenchmarkMesh::kNormalZ)[i] = coord[2];
+	}
+	memcpy(simdMesh._data, genericMesh._data, BenchmarkMesh::kFirstResult * vertices * sizeof(float));
+
+	Matrix4 modelView, projection, normalMatrix;
+	modelView.identity();
+	modelView._m[0][0] = modelView._m[2][2] = 0.8f;
+	modelView._m[0][2] = 0.6f;
+	modelView._m[2][0] = -0.6f;
+	modelView._m[2][3] = -4.0f;
+	projection = Matrix4::frustum(-0.1f, 0.1f, -0.075f, 0.075f, 0.1f, 100.0f);
+	normalMatrix = modelView;
+	normalMatrix.invert();
+	normalMatrix.transpose();
+
+	// Grim Fandango lights its scenes with a mix of these
+	LightKernelParams lights[3];
+	initBenchmarkLight(lights[0], true, false);
+	initBenchmarkLight(lights[1], false, false);
+	initBenchmarkLight(lights[2], false, true);
+
+	VertexKernels genericKernels, simdKernels;
+	getVertexKernels(genericKernels, false);
+	getVertexKernels(simdKernels, true);
+
+	uint32 start = g_system->getMillis();
+	for (int i = 0; i < iterations; i++)
+		processBenchmarkMesh(genericKernels, genericMesh, modelView, projection, normalMatrix, lights, ARRAYSIZE(lights));
+	result.genericTime = g_system->getMillis() - start;
+
+	start = g_system->getMillis();
+	for (int i = 0; i < iterations; i++)
+		processBenchmarkMesh(simdKernels, simdMesh, modelView, projection, normalMatrix, lights, ARRAYSIZE(lights));
+	result.simdTime = g_system->getMillis() - start;
+
+	result.vertices = vertices;
+	result.iterations = iterations;
+	result.identical = memcmp(genericMesh.results(), simdMesh.results(), genericMesh.resultsSize()) == 0;
+}
+
+} // end of namespace TinyGL
@@ -0,0 +1,146 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_TINYGL_VERTEX_KERNELS_H
+#define GRAPHICS_TINYGL_VERTEX_KERNELS_H
+
+#include "common/scummsys.h"
+
+#include "graphics/tinygl/zmath.h"
+
+namespace TinyGL {
+
+/*
+ * Vertex processing primitives working on batches of vertices stored as
+ * structure of arrays, one array per component. They perform the same
+ * operations in the same order as gl_vertex_transform and gl_shade_vertex,
+ * so that the SIMD kernels give the same results as the scalar code.
+ */
+
+/**
+ * Multiply a batch of points by a matrix, as Matrix4::transform does. When
+ * w is NULL, the points have W = 1 and the result is the one of
+ * Matrix4::transform3x4.
+ *
+ * The output arrays may be the input ones.
+ */
+typedef void (*TransformPointsProc)(const Matrix4 &m, const float *x, const float *y, const float *z, const float *w,
+                                    float *outX, float *outY, float *outZ, float *outW, int count);
+
+/**
+ * Multiply a batch of normals by the upper 3x3 part of a matrix, as
+ * Matrix4::transform3x3 does, and optionally normalize the results.
+ *
+ * The output arrays may be the input ones.
+ */
+typedef void (*TransformNormalsProc)(const Matrix4 &m, const float *x, const float *y, const float *z,
+                                     float *outX, float *outY, float *outZ, int count, bool normalize);
+
+/**
+ * The terms of the lighting model for one light and the current material.
+ * Specular lighting is not handled by the kernels.
+ */
+struct LightKernelParams {
+	/** Light ambient multiplied by the material ambient. */
+	float ambient[3];
+	float diffuse[3];
+	float materialDiffuse[3];
+	/** Normalized direction of lights at infinity, eye position of the others. */
+	float position[3];
+	bool infinite;
+	float attenuation[3];
+	bool spot;
+	float spotDirection[3];
+	float cosSpotCutoff;
+	float spotExponent;
+	bool twoSide;
+};
+
+/**
+ * Add the contribution of one light to the colors of a batch of vertices,
+ * from their eye coordinates and normals.
+ */
+typedef void (*ShadeLightProc)(const LightKernelParams &light, const float *ecX, const float *ecY, const float *ecZ,
+                               const float *nX, const float *nY, const float *nZ,
+                               float *r, float *g, float *b, int count);
+
+struct VertexKernels {
+	TransformPointsProc transformPoints;
+	TransformNormalsProc transformNormals;
+	ShadeLightProc shadeLight;
+};
+
+/**
+ * Get the fastest vertex kernels the CPU supports, or the generic ones when
+ * simd is false.
+ */
+void getVertexKernels(VertexKernels &kernels, bool simd);
+
+void transformPointsGeneric(const Matrix4 &m, const float *x, const float *y, const float *z, const float *w,
+                            float *outX, float *outY, float *outZ, float *outW, int count);
+void transformNormalsGeneric(const Matrix4 &m, const float *x, const float *y, const float *z,
+                             float *outX, float *outY, float *outZ, int count, bool normalize);
+void shadeLightGeneric(const LightKernelParams &light, const float *ecX, const float *ecY, const float *ecZ,
+                       const float *nX, const float *nY, const float *nZ,
+                       float *r, float *g, float *b, int count);
+
+#ifdef SCUMMVM_SSE2
+void transformPointsSSE2(const Matrix4 &m, const float *x, const float *y, const float *z, const float *w,
+                         float *outX, float *outY, float *outZ, float *outW, int count);
+void transformNormalsSSE2(const Matrix4 &m, const float *x, const float *y, const float *z,
+                          float *outX, float *outY, float *outZ, int count, bool normalize);
+void shadeLightSSE2(const LightKernelParams &light, const float *ecX, const float *ecY, const float *ecZ,
+                    const float *nX, const float *nY, const float *nZ,
+                    float *r, float *g, float *b, int count);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void transformPointsAVX2(const Matrix4 &m, const float *x, const float *y, const float *z, const float *w,
+                         float *outX, float *outY, float *outZ, float *outW, int count);
+void transformNormalsAVX2(const Matrix4 &m, const float *x, const float *y, const float *z,
+                          float *outX, float *outY, float *outZ, int count, bool normalize);
+void shadeLightAVX2(const LightKernelParams &light, const float *ecX, const float *ecY, const float *ecZ,
+                    const float *nX, const float *nY, const float *nZ,
+                    float *r, float *g, float *b, int count);
+#endif
+
+#ifdef SCUMMVM_NEON
+void transformPointsNEON(const Matrix4 &m, const float *x, const float *y, const float *z, const float *w,
+                         float *outX, float *outY, float *outZ, float *outW, int count);
+void transformNormalsNEON(const Matrix4 &m, const float *x, const float *y, const float *z,
+                          float *outX, float *outY, float *outZ, int count, bool normalize);
+void shadeLightNEON(const LightKernelParams &light, const float *ecX, const float *ecY, const float *ecZ,
+                    const float *nX, const float *nY, const float *nZ,
+                    float *r, float *g, float *b, int count);
+#endif
+
+/**
+ * Attenuation of a spot light, with the same expression as gl_shade_vertex.
+ * The SIMD kernels use it for each lane lit by a spot light.
+ */
+inline float spotAttenuation(float att, float dotSpot, float exponent) {
+	return att * pow(dotSpot, exponent);
+}
+
+} // end of namespace TinyGL
+
+#endif
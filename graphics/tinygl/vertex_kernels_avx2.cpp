@@ -0,0 +1,180 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "graphics/tinygl/vertex_kernels.h"
+
+#include <immintrin.h>
+
+namespace TinyGL {
+
+static inline __m256 selectAVX2(__m256 mask, __m256 a, __m256 b) {
+	return _mm256_blendv_ps(b, a, mask);
+}
+
+// One row of a matrix product, summed in the same order as Matrix4::transform
+static inline __m256 dotRowAVX2(__m256 x, __m256 y, __m256 z, const float *row) {
+	return _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(x, _mm256_set1_ps(row[0])), _mm256_mul_ps(y, _mm256_set1_ps(row[1]))),
+	                  _mm256_mul_ps(z, _mm256_set1_ps(row[2])));
+}
+
+void transformPointsAVX2(const Matrix4 &m, const float *x, const float *y, const float *z, const float *w,
+                         float *outX, float *outY, float *outZ, float *outW, int count) {
+	const __m256 one = _mm256_set1_ps(1.0f);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256 vx = _mm256_loadu_ps(x + i);
+		const __m256 vy = _mm256_loadu_ps(y + i);
+		const __m256 vz = _mm256_loadu_ps(z + i);
+		// Multiplying by W = 1 keeps the result of transform3x4
+		const __m256 vw = w ? _mm256_loadu_ps(w + i) : one;
+
+		const __m256 rx = _mm256_add_ps(dotRowAVX2(vx, vy, vz, m._m[0]), _mm256_mul_ps(vw, _mm256_set1_ps(m._m[0][3])));
+		const __m256 ry = _mm256_add_ps(dotRowAVX2(vx, vy, vz, m._m[1]), _mm256_mul_ps(vw, _mm256_set1_ps(m._m[1][3])));
+		const __m256 rz = _mm256_add_ps(dotRowAVX2(vx, vy, vz, m._m[2]), _mm256_mul_ps(vw, _mm256_set1_ps(m._m[2][3])));
+		const __m256 rw = _mm256_add_ps(dotRowAVX2(vx, vy, vz, m._m[3]), _mm256_mul_ps(vw, _mm256_set1_ps(m._m[3][3])));
+		_mm256_storeu_ps(outX + i, rx);
+		_mm256_storeu_ps(outY + i, ry);
+		_mm256_storeu_ps(outZ + i, rz);
+		_mm256_storeu_ps(outW + i, rw);
+	}
+
+	if (i < count)
+		transformPointsGeneric(m, x + i, y + i, z + i, w ? w + i : NULL, outX + i, outY + i, outZ + i, outW + i, count - i);
+}
+
+void transformNormalsAVX2(const Matrix4 &m, const float *x, const float *y, const float *z,
+                          float *outX, float *outY, float *outZ, int count, bool normalize) {
+	const __m256 zero = _mm256_setzero_ps();
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		const __m256 vx = _mm256_loadu_ps(x + i);
+		const __m256 vy = _mm256_loadu_ps(y + i);
+		const __m256 vz = _mm256_loadu_ps(z + i);
+		__m256 nx = dotRowAVX2(vx, vy, vz, m._m[0]);
+		__m256 ny = dotRowAVX2(vx, vy, vz, m._m[1]);
+		__m256 nz = dotRowAVX2(vx, vy, vz, m._m[2]);
+
+		if (normalize) {
+			const __m256 n = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(nx, nx), _mm256_mul_ps(ny, ny)), _mm256_mul_ps(nz, nz)));
+			const __m256 nonZero = _mm256_cmp_ps(n, zero, _CMP_NEQ_UQ);
+			nx = selectAVX2(nonZero, _mm256_div_ps(nx, n), nx);
+			ny = selectAVX2(nonZero, _mm256_div_ps(ny, n), ny);
+			nz = selectAVX2(nonZero, _mm256_div_ps(nz, n), nz);
+		}
+
+		_mm256_storeu_ps(outX + i, nx);
+		_mm256_storeu_ps(outY + i, ny);
+		_mm256_storeu_ps(outZ + i, nz);
+	}
+
+	if (i < count)
+		transformNormalsGeneric(m, x + i, y + i, z + i, outX + i, outY + i, outZ + i, count - i, normalize);
+}
+
+void shadeLightAVX2(const LightKernelParams &light, const float *ecX, const float *ecY, const float *ecZ,
+                    const float *nX, const float *nY, const float *nZ,
+                    float *r, float *g, float *b, int count) {
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 signBit = _mm256_set1_ps(-0.0f);
+	const __m256 allSet = _mm256_cmp_ps(zero, zero, _CMP_EQ_OQ);
+	const __m256 posX = _mm256_set1_ps(light.position[0]);
+	const __m256 posY = _mm256_set1_ps(light.position[1]);
+	const __m256 posZ = _mm256_set1_ps(light.position[2]);
+
+	int i = 0;
+	for (; i + 8 <= count; i += 8) {
+		__m256 dX, dY, dZ, dist, att;
+		if (light.infinite) {
+			dX = posX;
+			dY = posY;
+			dZ = posZ;
+			dist = one;
+			att = one;
+		} else {
+			dX = _mm256_sub_ps(posX, _mm256_loadu_ps(ecX + i));
+			dY = _mm256_sub_ps(posY, _mm256_loadu_ps(ecY + i));
+			dZ = _mm256_sub_ps(posZ, _mm256_loadu_ps(ecZ + i));
+			dist = _mm256_sqrt_ps(_mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dX, dX), _mm256_mul_ps(dY, dY)), _mm256_mul_ps(dZ, dZ)));
+			const __m256 inner = _mm256_add_ps(_mm256_set1_ps(light.attenuation[1]), _mm256_mul_ps(dist, _mm256_set1_ps(light.attenuation[2])));
+			att = _mm256_div_ps(one, _mm256_add_ps(_mm256_set1_ps(light.attenuation[0]), _mm256_mul_ps(dist, inner)));
+		}
+
+		__m256 dot = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dX, _mm256_loadu_ps(nX + i)), _mm256_mul_ps(dY, _mm256_loadu_ps(nY + i))),
+		                        _mm256_mul_ps(dZ, _mm256_loadu_ps(nZ + i)));
+		if (light.twoSide)
+			dot = _mm256_andnot_ps(signBit, dot);
+		const __m256 lit = _mm256_cmp_ps(dot, zero, _CMP_GT_OQ);
+
+		const __m256 tmp = _mm256_div_ps(one, dist);
+		dot = _mm256_mul_ps(dot, tmp);
+
+		__m256 lR = _mm256_set1_ps(light.ambient[0]);
+		__m256 lG = _mm256_set1_ps(light.ambient[1]);
+		__m256 lB = _mm256_set1_ps(light.ambient[2]);
+		lR = selectAVX2(lit, _mm256_add_ps(lR, _mm256_mul_ps(_mm256_mul_ps(dot, _mm256_set1_ps(light.diffuse[0])), _mm256_set1_ps(light.materialDiffuse[0]))), lR);
+		lG = selectAVX2(lit, _mm256_add_ps(lG, _mm256_mul_ps(_mm256_mul_ps(dot, _mm256_set1_ps(light.diffuse[1])), _mm256_set1_ps(light.materialDiffuse[1]))), lG);
+		lB = selectAVX2(lit, _mm256_add_ps(lB, _mm256_mul_ps(_mm256_mul_ps(dot, _mm256_set1_ps(light.diffuse[2])), _mm256_set1_ps(light.materialDiffuse[2]))), lB);
+
+		__m256 contributes = allSet;
+		if (light.spot) {
+			dX = _mm256_mul_ps(dX, tmp);
+			dY = _mm256_mul_ps(dY, tmp);
+			dZ = _mm256_mul_ps(dZ, tmp);
+			__m256 dotSpot = _mm256_xor_ps(signBit, _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(dX, _mm256_set1_ps(light.spotDirection[0])),
+			                                                           _mm256_mul_ps(dY, _mm256_set1_ps(light.spotDirection[1]))),
+			                                                _mm256_mul_ps(dZ, _mm256_set1_ps(light.spotDirection[2]))));
+			if (light.twoSide)
+				dotSpot = _mm256_andnot_ps(signBit, dotSpot);
+
+			const __m256 cut = _mm256_and_ps(lit, _mm256_cmp_ps(dotSpot, _mm256_set1_ps(light.cosSpotCutoff), _CMP_LT_OQ));
+			contributes = _mm256_andnot_ps(cut, allSet);
+
+			const int attenuated = _mm256_movemask_ps(_mm256_andnot_ps(cut, lit));
+			if (light.spotExponent > 0 && attenuated) {
+				float attLanes[8], dotLanes[8];
+				_mm256_storeu_ps(attLanes, att);
+				_mm256_storeu_ps(dotLanes, dotSpot);
+				for (int lane = 0; lane < 8; lane++) {
+					if (attenuated & (1 << lane))
+						attLanes[lane] = spotAttenuation(attLanes[lane], dotLanes[lane], light.spotExponent);
+				}
+				att = _mm256_loadu_ps(attLanes);
+			}
+		}
+
+		const __m256 vr = _mm256_loadu_ps(r + i);
+		const __m256 vg = _mm256_loadu_ps(g + i);
+		const __m256 vb = _mm256_loadu_ps(b + i);
+		_mm256_storeu_ps(r + i, selectAVX2(contributes, _mm256_add_ps(vr, _mm256_mul_ps(att, lR)), vr));
+		_mm256_storeu_ps(g + i, selectAVX2(contributes, _mm256_add_ps(vg, _mm256_mul_ps(att, lG)), vg));
+		_mm256_storeu_ps(b + i, selectAVX2(contributes, _mm256_add_ps(vb, _mm256_mul_ps(att, lB)), vb));
+	}
+
+	if (i < count)
+		shadeLightGeneric(light, ecX + i, ecY + i, ecZ + i, nX + i, nY + i, nZ + i, r + i, g + i, b + i, count - i);
+}
+
+} // end of namespace TinyGL
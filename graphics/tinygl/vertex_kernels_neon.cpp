@@ -0,0 +1,203 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "graphics/tinygl/vertex_kernels.h"
+
+#include <arm_neon.h>
+
+namespace TinyGL {
+
+// Division and square root are only vector instructions on AArch64. They
+// must be correctly rounded to match the scalar code, which rules out the
+// estimate instructions.
+static inline float32x4_t divNEON(float32x4_t a, float32x4_t b) {
+#ifdef __aarch64__
+	return vdivq_f32(a, b);
+#else
+	float va[4], vb[4];
+	vst1q_f32(va, a);
+	vst1q_f32(vb, b);
+	for (int lane = 0; lane < 4; lane++)
+		va[lane] /= vb[lane];
+	return vld1q_f32(va);
+#endif
+}
+
+static inline float32x4_t sqrtNEON(float32x4_t a) {
+#ifdef __aarch64__
+	return vsqrtq_f32(a);
+#else
+	float va[4];
+	vst1q_f32(va, a);
+	for (int lane = 0; lane < 4; lane++)
+		va[lane] = sqrt(va[lane]);
+	return vld1q_f32(va);
+#endif
+}
+
+// One row of a matrix product, summed in the same order as Matrix4::transform
+static inline float32x4_t dotRowNEON(float32x4_t x, float32x4_t y, float32x4_t z, const float *row) {
+	return vaddq_f32(vaddq_f32(vmulq_n_f32(x, row[0]), vmulq_n_f32(y, row[1])), vmulq_n_f32(z, row[2]));
+}
+
+void transformPointsNEON(const Matrix4 &m, const float *x, const float *y, const float *z, const float *w,
+                         float *outX, float *outY, float *outZ, float *outW, int count) {
+	const float32x4_t one = vdupq_n_f32(1.0f);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const float32x4_t vx = vld1q_f32(x + i);
+		const float32x4_t vy = vld1q_f32(y + i);
+		const float32x4_t vz = vld1q_f32(z + i);
+		// Multiplying by W = 1 keeps the result of transform3x4
+		const float32x4_t vw = w ? vld1q_f32(w + i) : one;
+
+		const float32x4_t rx = vaddq_f32(dotRowNEON(vx, vy, vz, m._m[0]), vmulq_n_f32(vw, m._m[0][3]));
+		const float32x4_t ry = vaddq_f32(dotRowNEON(vx, vy, vz, m._m[1]), vmulq_n_f32(vw, m._m[1][3]));
+		const float32x4_t rz = vaddq_f32(dotRowNEON(vx, vy, vz, m._m[2]), vmulq_n_f32(vw, m._m[2][3]));
+		const float32x4_t rw = vaddq_f32(dotRowNEON(vx, vy, vz, m._m[3]), vmulq_n_f32(vw, m._m[3][3]));
+		vst1q_f32(outX + i, rx);
+		vst1q_f32(outY + i, ry);
+		vst1q_f32(outZ + i, rz);
+		vst1q_f32(outW + i, rw);
+	}
+
+	if (i < count)
+		transformPointsGeneric(m, x + i, y + i, z + i, w ? w + i : NULL, outX + i, outY + i, outZ + i, outW + i, count - i);
+}
+
+void transformNormalsNEON(const Matrix4 &m, const float *x, const float *y, const float *z,
+                          float *outX, float *outY, float *outZ, int count, bool normalize) {
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const float32x4_t vx = vld1q_f32(x + i);
+		const float32x4_t vy = vld1q_f32(y + i);
+		const float32x4_t vz = vld1q_f32(z + i);
+		float32x4_t nx = dotRowNEON(vx, vy, vz, m._m[0]);
+		float32x4_t ny = dotRowNEON(vx, vy, vz, m._m[1]);
+		float32x4_t nz = dotRowNEON(vx, vy, vz, m._m[2]);
+
+		if (normalize) {
+			const float32x4_t n = sqrtNEON(vaddq_f32(vaddq_f32(vmulq_f32(nx, nx), vmulq_f32(ny, ny)), vmulq_f32(nz, nz)));
+			const uint32x4_t nonZero = vmvnq_u32(vceqq_f32(n, zero));
+			nx = vbslq_f32(nonZero, divNEON(nx, n), nx);
+			ny = vbslq_f32(nonZero, divNEON(ny, n), ny);
+			nz = vbslq_f32(nonZero, divNEON(nz, n), nz);
+		}
+
+		vst1q_f32(outX + i, nx);
+		vst1q_f32(outY + i, ny);
+		vst1q_f32(outZ + i, nz);
+	}
+
+	if (i < count)
+		transformNormalsGeneric(m, x + i, y + i, z + i, outX + i, outY + i, outZ + i, count - i, normalize);
+}
+
+void shadeLightNEON(const LightKernelParams &light, const float *ecX, const float *ecY, const float *ecZ,
+                    const float *nX, const float *nY, const float *nZ,
+                    float *r, float *g, float *b, int count) {
+	const float32x4_t zero = vdupq_n_f32(0.0f);
+	const float32x4_t one = vdupq_n_f32(1.0f);
+	const uint32x4_t allSet = vdupq_n_u32(0xffffffff);
+	const float32x4_t posX = vdupq_n_f32(light.position[0]);
+	const float32x4_t posY = vdupq_n_f32(light.position[1]);
+	const float32x4_t posZ = vdupq_n_f32(light.position[2]);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		float32x4_t dX, dY, dZ, dist, att;
+		if (light.infinite) {
+			dX = posX;
+			dY = posY;
+			dZ = posZ;
+			dist = one;
+			att = one;
+		} else {
+			dX = vsubq_f32(posX, vld1q_f32(ecX + i));
+			dY = vsubq_f32(posY, vld1q_f32(ecY + i));
+			dZ = vsubq_f32(posZ, vld1q_f32(ecZ + i));
+			dist = sqrtNEON(vaddq_f32(vaddq_f32(vmulq_f32(dX, dX), vmulq_f32(dY, dY)), vmulq_f32(dZ, dZ)));
+			const float32x4_t inner = vaddq_f32(vdupq_n_f32(light.attenuation[1]), vmulq_n_f32(dist, light.attenuation[2]));
+			att = divNEON(one, vaddq_f32(vdupq_n_f32(light.attenuation[0]), vmulq_f32(dist, inner)));
+		}
+
+		float32x4_t dot = vaddq_f32(vaddq_f32(vmulq_f32(dX, vld1q_f32(nX + i)), vmulq_f32(dY, vld1q_f32(nY + i))),
+		                            vmulq_f32(dZ, vld1q_f32(nZ + i)));
+		if (light.twoSide)
+			dot = vabsq_f32(dot);
+		const uint32x4_t lit = vcgtq_f32(dot, zero);
+
+		const float32x4_t tmp = divNEON(one, dist);
+		dot = vmulq_f32(dot, tmp);
+
+		float32x4_t lR = vdupq_n_f32(light.ambient[0]);
+		float32x4_t lG = vdupq_n_f32(light.ambient[1]);
+		float32x4_t lB = vdupq_n_f32(light.ambient[2]);
+		lR = vbslq_f32(lit, vaddq_f32(lR, vmulq_n_f32(vmulq_n_f32(dot, light.diffuse[0]), light.materialDiffuse[0])), lR);
+		lG = vbslq_f32(lit, vaddq_f32(lG, vmulq_n_f32(vmulq_n_f32(dot, light.diffuse[1]), light.materialDiffuse[1])), lG);
+		lB = vbslq_f32(lit, vaddq_f32(lB, vmulq_n_f32(vmulq_n_f32(dot, light.diffuse[2]), light.materialDiffuse[2])), lB);
+
+		uint32x4_t contributes = allSet;
+		if (light.spot) {
+			dX = vmulq_f32(dX, tmp);
+			dY = vmulq_f32(dY, tmp);
+			dZ = vmulq_f32(dZ, tmp);
+			float32x4_t dotSpot = vnegq_f32(vaddq_f32(vaddq_f32(vmulq_n_f32(dX, light.spotDirection[0]),
+			                                                    vmulq_n_f32(dY, light.spotDirection[1])),
+			                                          vmulq_n_f32(dZ, light.spotDirection[2])));
+			if (light.twoSide)
+				dotSpot = vabsq_f32(dotSpot);
+
+			const uint32x4_t cut = vandq_u32(lit, vcltq_f32(dotSpot, vdupq_n_f32(light.cosSpotCutoff)));
+			contributes = vmvnq_u32(cut);
+
+			if (light.spotExponent > 0) {
+				uint32 attenuated[4];
+				float attLanes[4], dotLanes[4];
+				vst1q_u32(attenuated, vbicq_u32(lit, cut));
+				vst1q_f32(attLanes, att);
+				vst1q_f32(dotLanes, dotSpot);
+				for (int lane = 0; lane < 4; lane++) {
+					if (attenuated[lane])
+						attLanes[lane] = spotAttenuation(attLanes[lane], dotLanes[lane], light.spotExponent);
+				}
+				att = vld1q_f32(attLanes);
+			}
+		}
+
+		const float32x4_t vr = vld1q_f32(r + i);
+		const float32x4_t vg = vld1q_f32(g + i);
+		const float32x4_t vb = vld1q_f32(b + i);
+		vst1q_f32(r + i, vbslq_f32(contributes, vaddq_f32(vr, vmulq_f32(att, lR)), vr));
+		vst1q_f32(g + i, vbslq_f32(contributes, vaddq_f32(vg, vmulq_f32(att, lG)), vg));
+		vst1q_f32(b + i, vbslq_f32(contributes, vaddq_f32(vb, vmulq_f32(att, lB)), vb));
+	}
+
+	if (i < count)
+		shadeLightGeneric(light, ecX + i, ecY + i, ecZ + i, nX + i, nY + i, nZ + i, r + i, g + i, b + i, count - i);
+}
+
+} // end of namespace TinyGL
@@ -0,0 +1,180 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+
+#include "graphics/tinygl/vertex_kernels.h"
+
+#include <emmintrin.h>
+
+namespace TinyGL {
+
+static inline __m128 selectSSE2(__m128 mask, __m128 a, __m128 b) {
+	return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+}
+
+// One row of a matrix product, summed in the same order as Matrix4::transform
+static inline __m128 dotRowSSE2(__m128 x, __m128 y, __m128 z, const float *row) {
+	return _mm_add_ps(_mm_add_ps(_mm_mul_ps(x, _mm_set1_ps(row[0])), _mm_mul_ps(y, _mm_set1_ps(row[1]))),
+	                  _mm_mul_ps(z, _mm_set1_ps(row[2])));
+}
+
+void transformPointsSSE2(const Matrix4 &m, const float *x, const float *y, const float *z, const float *w,
+                         float *outX, float *outY, float *outZ, float *outW, int count) {
+	const __m128 one = _mm_set1_ps(1.0f);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128 vx = _mm_loadu_ps(x + i);
+		const __m128 vy = _mm_loadu_ps(y + i);
+		const __m128 vz = _mm_loadu_ps(z + i);
+		// Multiplying by W = 1 keeps the result of transform3x4
+		const __m128 vw = w ? _mm_loadu_ps(w + i) : one;
+
+		const __m128 rx = _mm_add_ps(dotRowSSE2(vx, vy, vz, m._m[0]), _mm_mul_ps(vw, _mm_set1_ps(m._m[0][3])));
+		const __m128 ry = _mm_add_ps(dotRowSSE2(vx, vy, vz, m._m[1]), _mm_mul_ps(vw, _mm_set1_ps(m._m[1][3])));
+		const __m128 rz = _mm_add_ps(dotRowSSE2(vx, vy, vz, m._m[2]), _mm_mul_ps(vw, _mm_set1_ps(m._m[2][3])));
+		const __m128 rw = _mm_add_ps(dotRowSSE2(vx, vy, vz, m._m[3]), _mm_mul_ps(vw, _mm_set1_ps(m._m[3][3])));
+		_mm_storeu_ps(outX + i, rx);
+		_mm_storeu_ps(outY + i, ry);
+		_mm_storeu_ps(outZ + i, rz);
+		_mm_storeu_ps(outW + i, rw);
+	}
+
+	if (i < count)
+		transformPointsGeneric(m, x + i, y + i, z + i, w ? w + i : NULL, outX + i, outY + i, outZ + i, outW + i, count - i);
+}
+
+void transformNormalsSSE2(const Matrix4 &m, const float *x, const float *y, const float *z,
+                          float *outX, float *outY, float *outZ, int count, bool normalize) {
+	const __m128 zero = _mm_setzero_ps();
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		const __m128 vx = _mm_loadu_ps(x + i);
+		const __m128 vy = _mm_loadu_ps(y + i);
+		const __m128 vz = _mm_loadu_ps(z + i);
+		__m128 nx = dotRowSSE2(vx, vy, vz, m._m[0]);
+		__m128 ny = dotRowSSE2(vx, vy, vz, m._m[1]);
+		__m128 nz = dotRowSSE2(vx, vy, vz, m._m[2]);
+
+		if (normalize) {
+			const __m128 n = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny)), _mm_mul_ps(nz, nz)));
+			const __m128 nonZero = _mm_cmpneq_ps(n, zero);
+			nx = selectSSE2(nonZero, _mm_div_ps(nx, n), nx);
+			ny = selectSSE2(nonZero, _mm_div_ps(ny, n), ny);
+			nz = selectSSE2(nonZero, _mm_div_ps(nz, n), nz);
+		}
+
+		_mm_storeu_ps(outX + i, nx);
+		_mm_storeu_ps(outY + i, ny);
+		_mm_storeu_ps(outZ + i, nz);
+	}
+
+	if (i < count)
+		transformNormalsGeneric(m, x + i, y + i, z + i, outX + i, outY + i, outZ + i, count - i, normalize);
+}
+
+void shadeLightSSE2(const LightKernelParams &light, const float *ecX, const float *ecY, const float *ecZ,
+                    const float *nX, const float *nY, const float *nZ,
+                    float *r, float *g, float *b, int count) {
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+	const __m128 allSet = _mm_cmpeq_ps(zero, zero);
+	const __m128 posX = _mm_set1_ps(light.position[0]);
+	const __m128 posY = _mm_set1_ps(light.position[1]);
+	const __m128 posZ = _mm_set1_ps(light.position[2]);
+
+	int i = 0;
+	for (; i + 4 <= count; i += 4) {
+		__m128 dX, dY, dZ, dist, att;
+		if (light.infinite) {
+			dX = posX;
+			dY = posY;
+			dZ = posZ;
+			dist = one;
+			att = one;
+		} else {
+			dX = _mm_sub_ps(posX, _mm_loadu_ps(ecX + i));
+			dY = _mm_sub_ps(posY, _mm_loadu_ps(ecY + i));
+			dZ = _mm_sub_ps(posZ, _mm_loadu_ps(ecZ + i));
+			dist = _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(dX, dX), _mm_mul_ps(dY, dY)), _mm_mul_ps(dZ, dZ)));
+			const __m128 inner = _mm_add_ps(_mm_set1_ps(light.attenuation[1]), _mm_mul_ps(dist, _mm_set1_ps(light.attenuation[2])));
+			att = _mm_div_ps(one, _mm_add_ps(_mm_set1_ps(light.attenuation[0]), _mm_mul_ps(dist, inner)));
+		}
+
+		__m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dX, _mm_loadu_ps(nX + i)), _mm_mul_ps(dY, _mm_loadu_ps(nY + i))),
+		                        _mm_mul_ps(dZ, _mm_loadu_ps(nZ + i)));
+		if (light.twoSide)
+			dot = _mm_andnot_ps(signBit, dot);
+		const __m128 lit = _mm_cmpgt_ps(dot, zero);
+
+		const __m128 tmp = _mm_div_ps(one, dist);
+		dot = _mm_mul_ps(dot, tmp);
+
+		__m128 lR = _mm_set1_ps(light.ambient[0]);
+		__m128 lG = _mm_set1_ps(light.ambient[1]);
+		__m128 lB = _mm_set1_ps(light.ambient[2]);
+		lR = selectSSE2(lit, _mm_add_ps(lR, _mm_mul_ps(_mm_mul_ps(dot, _mm_set1_ps(light.diffuse[0])), _mm_set1_ps(light.materialDiffuse[0]))), lR);
+		lG = selectSSE2(lit, _mm_add_ps(lG, _mm_mul_ps(_mm_mul_ps(dot, _mm_set1_ps(light.diffuse[1])), _mm_set1_ps(light.materialDiffuse[1]))), lG);
+		lB = selectSSE2(lit, _mm_add_ps(lB, _mm_mul_ps(_mm_mul_ps(dot, _mm_set1_ps(light.diffuse[2])), _mm_set1_ps(light.materialDiffuse[2]))), lB);
+
+		__m128 contributes = allSet;
+		if (light.spot) {
+			dX = _mm_mul_ps(dX, tmp);
+			dY = _mm_mul_ps(dY, tmp);
+			dZ = _mm_mul_ps(dZ, tmp);
+			__m128 dotSpot = _mm_xor_ps(signBit, _mm_add_ps(_mm_add_ps(_mm_mul_ps(dX, _mm_set1_ps(light.spotDirection[0])),
+			                                                           _mm_mul_ps(dY, _mm_set1_ps(light.spotDirection[1]))),
+			                                                _mm_mul_ps(dZ, _mm_set1_ps(light.spotDirection[2]))));
+			if (light.twoSide)
+				dotSpot = _mm_andnot_ps(signBit, dotSpot);
+
+			const __m128 cut = _mm_and_ps(lit, _mm_cmplt_ps(dotSpot, _mm_set1_ps(light.cosSpotCutoff)));
+			contributes = _mm_andnot_ps(cut, allSet);
+
+			const int attenuated = _mm_movemask_ps(_mm_andnot_ps(cut, lit));
+			if (light.spotExponent > 0 && attenuated) {
+				float attLanes[4], dotLanes[4];
+				_mm_storeu_ps(attLanes, att);
+				_mm_storeu_ps(dotLanes, dotSpot);
+				for (int lane = 0; lane < 4; lane++) {
+					if (attenuated & (1 << lane))
+						attLanes[lane] = spotAttenuation(attLanes[lane], dotLanes[lane], light.spotExponent);
+				}
+				att = _mm_loadu_ps(attLanes);
+			}
+		}
+
+		const __m128 vr = _mm_loadu_ps(r + i);
+		const __m128 vg = _mm_loadu_ps(g + i);
+		const __m128 vb = _mm_loadu_ps(b + i);
+		_mm_storeu_ps(r + i, selectSSE2(contributes, _mm_add_ps(vr, _mm_mul_ps(att, lR)), vr));
+		_mm_storeu_ps(g + i, selectSSE2(contributes, _mm_add_ps(vg, _mm_mul_ps(att, lG)), vg));
+		_mm_storeu_ps(b + i, selectSSE2(contributes, _mm_add_ps(vb, _mm_mul_ps(att, lB)), vb));
+	}
+
+	if (i < count)
+		shadeLightGeneric(light, ecX + i, ecY + i, ecZ + i, nX + i, nY + i, nZ + i, r + i, g + i, b + i, count - i);
+}
+
+} // end of namespace TinyGL
@@ -30,6 +30,7 @@
 #include "graphics/tinygl/zgl.h"
 #include "graphics/tinygl/gl.h"
 #include "common/debug.h"
+#include "common/hashmap.h"
 #include "common/math.h"
 
 namespace TinyGL {
@@ -113,94 +114,190 @@ void tglDisposeDrawCallLists(TinyGL::GLContext *c) {
 	c->_drawCallsQueue.clear();
 }
 
-static inline void _appendDirtyRectangle(const Graphics::DrawCall &call, Common::List<DirtyRectangle> &rectangles, int r, int g, int b) {
+static inline void _appendDirtyRectangle(const Graphics::DrawCall &call, Common::Array<DirtyRectangle> &rectangles, int r, int g, int b) {
 	Common::Rect dirty_region = call.getDirtyRegion();
 	if (rectangles.empty() || dirty_region != rectangles.back().rectangle)
 		rectangles.push_back(DirtyRectangle(dirty_region, r, g, b));
 }
 
+static inline bool _sameDrawCall(const Graphics::DrawCall *a, uint32 hashA, const Graphics::DrawCall *b, uint32 hashB) {
+	return hashA == hashB && *a == *b;
+}
+
+// Pairs up the draw calls of the previous and the current frame which are
+// identical, keeping the submission order on both sides. A pixel only has to
+// be redrawn when a call without a counterpart touches it: every other pixel
+// is the result of the very same calls in the very same order.
+static void _matchDrawCalls(const Common::Array<Graphics::DrawCall *> &prev, const Common::Array<Graphics::DrawCall *> &cur,
+		Common::Array<bool> &prevMatched, Common::Array<bool> &curMatched) {
+	typedef Common::HashMap<uint32, Common::Array<uint> > PositionMap;
+
+	Common::Array<uint32> prevHash(prev.size()), curHash(cur.size());
+	for (uint i = 0; i < prev.size(); i++)
+		prevHash[i] = prev[i]->getHash();
+	for (uint i = 0; i < cur.size(); i++)
+		curHash[i] = cur[i]->getHash();
+
+	prevMatched.resize(prev.size());
+	curMatched.resize(cur.size());
+	for (uint i = 0; i < prev.size(); i++)
+		prevMatched[i] = false;
+	for (uint i = 0; i < cur.size(); i++)
+		curMatched[i] = false;
+
+	// Most frames differ from the previous one in a few calls only, so strip
+	// the common head and tail first.
+	uint prevStart = 0, curStart = 0;
+	uint prevEnd = prev.size(), curEnd = cur.size();
+	while (prevStart < prevEnd && curStart < curEnd &&
+			_sameDrawCall(prev[prevStart], prevHash[prevStart], cur[curStart], curHash[curStart])) {
+		prevMatched[prevStart++] = true;
+		curMatched[curStart++] = true;
+	}
+	while (prevStart < prevEnd && curStart < curEnd &&
+			_sameDrawCall(prev[prevEnd - 1], prevHash[prevEnd - 1], cur[curEnd - 1], curHash[curEnd - 1])) {
+		prevMatched[--prevEnd] = true;
+		curMatched[--curEnd] = true;
+	}
+
+	if (prevStart == prevEnd || curStart == curEnd)
+		return;
+
+	// Match the remaining calls greedily through their content hash, so that
+	// an inserted or removed call does not invalidate all the ones after it.
+	PositionMap positions;
+	for (uint i = prevStart; i < prevEnd; i++)
+		positions[prevHash[i]].push_back(i);
+
+	uint nextPrev = prevStart;
+	for (uint i = curStart; i < curEnd; i++) {
+		PositionMap::iterator found = positions.find(curHash[i]);
+		if (found == positions.end())
+			continue;
+		const Common::Array<uint> &candidates = found->_value;
+		for (uint j = 0; j < candidates.size(); j++) {
+			const uint p = candidates[j];
+			if (p >= nextPrev && *prev[p] == *cur[i]) {
+				prevMatched[p] = true;
+				curMatched[i] = true;
+				nextPrev = p + 1;
+				break;
+			}
+		}
+	}
+}
+
+// Size of the grid cells used to look up overlapping dirty rectangles.
+static const int kMergeCellSize = 64;
+
+// Merges the dirty rectangles until none of them overlap. Every rectangle is
+// registered in the grid cells it covers, so finding the ones a rectangle
+// overlaps only involves its neighbourhood rather than the whole list.
+static void _mergeDirtyRectangles(Common::Array<DirtyRectangle> &rectangles, const Common::Rect &bounds) {
+	const int columns = MAX<int>(1, (bounds.width() + kMergeCellSize - 1) / kMergeCellSize);
+	const int rows = MAX<int>(1, (bounds.height() + kMergeCellSize - 1) / kMergeCellSize);
+	Common::Array<Common::Array<uint> > cells(columns * rows);
+	Common::Array<DirtyRectangle> merged;
+	Common::Array<bool> alive;
+
+	for (uint i = 0; i < rectangles.size(); i++) {
+		DirtyRectangle rect = rectangles[i];
+		if (rect.rectangle.isEmpty())
+			continue;
+
+		int left, top, right, bottom;
+		bool grown;
+		do {
+			grown = false;
+			// Rectangles reaching outside of the bounds go to the border cells.
+			left = CLIP<int>((rect.rectangle.left - bounds.left) / kMergeCellSize, 0, columns - 1);
+			top = CLIP<int>((rect.rectangle.top - bounds.top) / kMergeCellSize, 0, rows - 1);
+			right = CLIP<int>((rect.rectangle.right - 1 - bounds.left) / kMergeCellSize, 0, columns - 1);
+			bottom = CLIP<int>((rect.rectangle.bottom - 1 - bounds.top) / kMergeCellSize, 0, rows - 1);
+			for (int y = top; y <= bottom; y++) {
+				for (int x = left; x <= right; x++) {
+					const Common::Array<uint> &cell = cells[y * columns + x];
+					for (uint j = 0; j < cell.size(); j++) {
+						const uint other = cell[j];
+						if (alive[other] && merged[other].rectangle.intersects(rect.rectangle)) {
+							rect.rectangle.extend(merged[other].rectangle);
+							rect.r = 0;
+							rect.g = 0;
+							rect.b = 255;
+							alive[other] = false;
+							grown = true;
+						}
+					}
+				}
+			}
+			// A grown rectangle may now overlap rectangles in new cells.
+		} while (grown);
+
+		const uint index = merged.size();
+		merged.push_back(rect);
+		alive.push_back(true);
+		for (int y = top; y <= bottom; y++) {
+			for (int x = left; x <= right; x++) {
+				cells[y * columns + x].push_back(index);
+			}
+		}
+	}
+
+	rectangles.clear();
+	for (uint i = 0; i < merged.size(); i++) {
+		if (alive[i])
+			rectangles.push_back(merged[i]);
+	}
+}
+
 static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 	typedef Common::List<Graphics::DrawCall *>::const_iterator DrawCallIterator;
-	typedef Common::List<TinyGL::DirtyRectangle>::iterator RectangleIterator;
 
-	Common::List<DirtyRectangle> rectangles;
+	Common::Array<DirtyRectangle> rectangles;
 
-	DrawCallIterator itFrame = c->_drawCallsQueue.begin();
-	DrawCallIterator endFrame = c->_drawCallsQueue.end();
-	DrawCallIterator itPrevFrame = c->_previousFrameDrawCallsQueue.begin();
-	DrawCallIterator endPrevFrame = c->_previousFrameDrawCallsQueue.end();
+	Common::Array<Graphics::DrawCall *> prevFrame, frame;
+	for (DrawCallIterator it = c->_previousFrameDrawCallsQueue.begin(); it != c->_previousFrameDrawCallsQueue.end(); ++it) {
+		prevFrame.push_back(*it);
+	}
+	for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
+		frame.push_back(*it);
+	}
 
 	// Compare draw calls.
-	for ( ; itPrevFrame != endPrevFrame && itFrame != endFrame;
-		++itPrevFrame, ++itFrame) {
-			const Graphics::DrawCall &currentCall = **itFrame;
-			const Graphics::DrawCall &previousCall = **itPrevFrame;
-
-			if (previousCall != currentCall) {
-				_appendDirtyRectangle(previousCall, rectangles, 255, 255, 255);
-				_appendDirtyRectangle(currentCall, rectangles, 255, 0, 0);
-			}
-	}
+	Common::Array<bool> prevMatched, matched;
+	_matchDrawCalls(prevFrame, frame, prevMatched, matched);
 
-	for ( ; itPrevFrame != endPrevFrame; ++itPrevFrame) {
-		_appendDirtyRectangle(**itPrevFrame, rectangles, 255, 255, 255);
+	for (uint i = 0; i < prevFrame.size(); i++) {
+		if (!prevMatched[i])
+			_appendDirtyRectangle(*prevFrame[i], rectangles, 255, 255, 255);
 	}
 
-	for ( ; itFrame != endFrame; ++itFrame) {
-		_appendDirtyRectangle(**itFrame, rectangles, 255, 0, 0);
+	for (uint i = 0; i < frame.size(); i++) {
+		if (!matched[i])
+			_appendDirtyRectangle(*frame[i], rectangles, 255, 0, 0);
 	}
 
 	// This loop increases outer rectangle coordinates to favor merging of adjacent rectangles.
-	for (RectangleIterator it = rectangles.begin(); it != rectangles.end(); ++it) {
-		(*it).rectangle.right++;
-		(*it).rectangle.bottom++;
+	for (uint i = 0; i < rectangles.size(); i++) {
+		rectangles[i].rectangle.right++;
+		rectangles[i].rectangle.bottom++;
 	}
 
 	// Merge coalesce dirty rects.
-	bool restartMerge;
-	do {
-		restartMerge = false;
-		for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-			for (RectangleIterator it2 = rectangles.begin(); it2 != rectangles.end();) {
-				if (it1 != it2) {
-					if ((*it1).rectangle.intersects((*it2).rectangle)) {
-						(*it1).rectangle.extend((*it2).rectangle);
-						it2 = rectangles.erase(it2);
-						restartMerge = true;
-					} else {
-						++it2;
-					}
-				} else {
-					++it2;
-				}
-			}
-		}
-	} while(restartMerge);
-
-	for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-		RectangleIterator it2 = it1;
-		it2++;
-		while (it2 != rectangles.end()) {
-			if ((*it1).rectangle.contains((*it2).rectangle)) {
-				it2 = rectangles.erase(it2);
-			} else {
-				++it2;
-			}
-		}
-	}
+	_mergeDirtyRectangles(rectangles, c->renderRect);
 
-	for (RectangleIterator it1 = rectangles.begin(); it1 != rectangles.end(); ++it1) {
-		(*it1).rectangle.clip(c->renderRect);
+	for (uint i = 0; i < rectangles.size(); i++) {
+		rectangles[i].rectangle.clip(c->renderRect);
 	}
 
 	if (!rectangles.empty()) {
 		// Execute draw calls.
-		for (DrawCallIterator it = c->_drawCallsQueue.begin(); it != c->_drawCallsQueue.end(); ++it) {
-			Common::Rect drawCallRegion = (*it)->getDirtyRegion();
-			for (RectangleIterator itRect = rectangles.begin(); itRect != rectangles.end(); ++itRect) {
-				Common::Rect dirtyRegion = (*itRect).rectangle;
+		for (uint i = 0; i < frame.size(); i++) {
+			Common::Rect drawCallRegion = frame[i]->getDirtyRegion();
+			for (uint j = 0; j < rectangles.size(); j++) {
+				const Common::Rect &dirtyRegion = rectangles[j].rectangle;
 				if (dirtyRegion.intersects(drawCallRegion)) {
-					(*it)->execute(dirtyRegion, true);
+					frame[i]->execute(dirtyRegion, true);
 				}
 			}
 		}
@@ -215,8 +312,8 @@ static void tglPresentBufferDirtyRects(TinyGL::GLContext *c) {
 		c->fb->enableBlending(false);
 		c->fb->enableAlphaTest(false);
 
-		for (RectangleIterator it = rectangles.begin(); it != rectangles.end(); ++it) {
-			tglDrawRectangle((*it).rectangle, (*it).r, (*it).g, (*it).b);
+		for (uint i = 0; i < rectangles.size(); i++) {
+			tglDrawRectangle(rectangles[i].rectangle, rectangles[i].r, rectangles[i].g, rectangles[i].b);
 		}
 
 		c->fb->enableBlending(blendingEnabled);
@@ -267,6 +364,30 @@ void tglPresentBuffer() {
 
 namespace Graphics {
 
+// FNV-1a style mixing of the values making up a draw call hash.
+static inline uint32 hashCombine(uint32 hash, uint32 value) {
+	return (hash ^ value) * 16777619;
+}
+
+static inline uint32 hashCombine(uint32 hash, float value) {
+	uint32 bits;
+	memcpy(&bits, &value, sizeof(bits));
+	return hashCombine(hash, bits);
+}
+
+static inline uint32 hashCombine(uint32 hash, const void *value) {
+	return hashCombine(hash, (uint32)(size_t)value);
+}
+
+static inline uint32 hashCombine(uint32 hash, const Common::Rect &rect) {
+	hash = hashCombine(hash, (uint32)rect.left);
+	hash = hashCombine(hash, (uint32)rect.top);
+	hash = hashCombine(hash, (uint32)rect.right);
+	return hashCombine(hash, (uint32)rect.bottom);
+}
+
+static const uint32 kHashSeed = 2166136261u;
+
 bool DrawCall::operator==(const DrawCall &other) const {
 	if (_type == other._type) {
 		switch (_type) {
@@ -521,6 +642,22 @@ bool RasterizationDrawCall::operator==(const RasterizationDrawCall &other) const
 	return false;
 }
 
+uint32 RasterizationDrawCall::getHash() const {
+	// Only the state which tells draw calls apart the most is hashed,
+	// operator== takes care of the rest.
+	uint32 hash = hashCombine(kHashSeed, (uint32)_vertexCount);
+	hash = hashCombine(hash, (uint32)_state.beginType);
+	hash = hashCombine(hash, _state.texture);
+	for (int i = 0; i < _vertexCount; i++) {
+		const TinyGL::ZBufferPoint &zp = _vertex[i].zp;
+		hash = hashCombine(hash, (uint32)zp.x);
+		hash = hashCombine(hash, (uint32)zp.y);
+		hash = hashCombine(hash, (uint32)zp.z);
+		hash = hashCombine(hash, (uint32)(zp.r ^ zp.g ^ zp.b ^ zp.a));
+	}
+	return hash;
+}
+
 BlittingDrawCall::BlittingDrawCall(Graphics::BlitImage *image, const BlitTransform &transform, BlittingMode blittingMode) : DrawCall(DrawCall_Blitting), _transform(transform), _mode(blittingMode), _image(image) {
 	tglIncBlitImageRef(image);
 	_blitState = captureState();
@@ -627,6 +764,15 @@ bool BlittingDrawCall::operator==(const BlittingDrawCall &other) const {
 			_imageVersion == tglGetBlitImageVersion(other._image);
 }
 
+uint32 BlittingDrawCall::getHash() const {
+	uint32 hash = hashCombine(kHashSeed, (uint32)_mode);
+	hash = hashCombine(hash, _image);
+	hash = hashCombine(hash, _transform._sourceRectangle);
+	hash = hashCombine(hash, _transform._destinationRectangle);
+	hash = hashCombine(hash, (uint32)_transform._rotation);
+	return hashCombine(hash, _transform._aTint);
+}
+
 ClearBufferDrawCall::ClearBufferDrawCall(bool clearZBuffer, int zValue, bool clearColorBuffer, int rValue, int gValue, int bValue) 
 	: _clearZBuffer(clearZBuffer), _clearColorBuffer(clearColorBuffer), _zValue(zValue), _rValue(rValue), _gValue(gValue), _bValue(bValue), DrawCall(DrawCall_Clear) {
 	TinyGL::GLContext *c = TinyGL::gl_get_context();
@@ -655,6 +801,14 @@ bool ClearBufferDrawCall::operator==(const ClearBufferDrawCall &other) const {
 			_zValue == other._zValue;
 }
 
+uint32 ClearBufferDrawCall::getHash() const {
+	uint32 hash = hashCombine(kHashSeed, (uint32)_clearZBuffer);
+	hash = hashCombine(hash, (uint32)_clearColorBuffer);
+	hash = hashCombine(hash, (uint32)_zValue);
+	hash = hashCombine(hash, (uint32)_rValue);
+	hash = hashCombine(hash, (uint32)_gValue);
+	return hashCombine(hash, (uint32)_bValue);
+}
 
 bool RasterizationDrawCall::RasterizationState::operator==(const RasterizationState &other) const {
 	return	beginType == other.beginType && 
@@ -41,6 +41,7 @@
 #include "graphics/tinygl/zblit.h"
 #include "graphics/tinygl/zdirtyrect.h"
 #include "graphics/tinygl/texelbuffer.h"
+#include "graphics/tinygl/vertex_kernels.h"
 
 namespace TinyGL {
 
@@ -249,6 +250,19 @@ private:
 	size_t _memoryPosition;
 };
 
+#define VERTEX_BATCH_SIZE 256
+
+// array elements transformed and lit together by the vertex kernels, stored
+// as one array per component
+struct GLVertexBatch {
+	float coord_x[VERTEX_BATCH_SIZE], coord_y[VERTEX_BATCH_SIZE], coord_z[VERTEX_BATCH_SIZE];
+	float normal_x[VERTEX_BATCH_SIZE], normal_y[VERTEX_BATCH_SIZE], normal_z[VERTEX_BATCH_SIZE];
+	float ec_x[VERTEX_BATCH_SIZE], ec_y[VERTEX_BATCH_SIZE], ec_z[VERTEX_BATCH_SIZE], ec_w[VERTEX_BATCH_SIZE];
+	float pc_x[VERTEX_BATCH_SIZE], pc_y[VERTEX_BATCH_SIZE], pc_z[VERTEX_BATCH_SIZE], pc_w[VERTEX_BATCH_SIZE];
+	float color_r[VERTEX_BATCH_SIZE], color_g[VERTEX_BATCH_SIZE], color_b[VERTEX_BATCH_SIZE];
+	float alpha;
+};
+
 struct GLContext;
 
 typedef void (*gl_draw_triangle_func)(GLContext *c, GLVertex *p0, GLVertex *p1, GLVertex *p2);
@@ -362,6 +376,15 @@ struct GLContext {
 	int texcoord_array_stride;
 	int client_states;
 
+	// position in the vertex list of the vertex emitted for each array
+	// element, so that glDrawElements transforms each element only once
+	int *element_cache;
+	int element_cache_size;
+
+	// the array elements are transformed and lit in batches
+	GLVertexBatch *vertex_batch;
+	VertexKernels vertex_kernels;
+
 	// opengl 1.1 polygon offset
 	float offset_factor;
 	float offset_units;
@@ -420,6 +443,8 @@ void gl_print_matrix(const float *m);
 void gl_add_select(GLContext *c, unsigned int zmin, unsigned int zmax);
 void gl_enable_disable_light(GLContext *c, int light, int v);
 void gl_shade_vertex(GLContext *c, GLVertex *v);
+bool gl_can_shade_vertex_batch(GLContext *c);
+void gl_shade_vertex_batch(GLContext *c, GLVertexBatch *batch, int n);
 
 void glInitTextures(GLContext *c);
 void glEndTextures(GLContext *c);
@@ -471,6 +496,15 @@ static inline int gl_clipcode(float x, float y, float z, float w1) {
 	return (x < -w) | ((x > w) << 1) | ((y < -w) << 2) | ((y > w) << 3) | ((z < -w) << 4) | ((z > w) << 5);
 }
 
+static inline float clampf(float a, float min, float max) {
+	if (a < min)
+		return min;
+	else if (a > max)
+		return max;
+	else
+		return a;
+}
+
 } // end of namespace TinyGL
 
 #endif
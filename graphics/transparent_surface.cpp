@@ -32,17 +32,16 @@
 #include "common/util.h"
 #include "common/rect.h"
 #include "common/math.h"
+#include "common/system.h"
 #include "common/textconsole.h"
 #include "graphics/conversion.h"
 #include "graphics/primitives.h"
 #include "graphics/transparent_surface.h"
+#include "graphics/transparent_surface_kernels.h"
 #include "graphics/transform_tools.h"
 
 namespace Graphics {
 
-static const int kBModShift = 0;//img->format.bShift;
-static const int kGModShift = 8;//img->format.gShift;
-static const int kRModShift = 16;//img->format.rShift;
 static const int kAModShift = 24;//img->format.aShift;
 
 #ifdef SCUMM_LITTLE_ENDIAN
@@ -130,6 +129,70 @@ void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
 	}
 }
 
+/**
+ * Row kernels used by the blended blits, the fastest ones the CPU supports.
+ */
+struct BlendBlitRowProcs {
+	BlendBlitRowProc alpha;
+	BlendBlitRowProc additive;
+	BlendBlitRowProc subtractive;
+	BlendBlitRowProc multiply;
+};
+
+static BlendBlitRowProcs s_blendRowProcs;
+static bool s_blendRowProcsInitialized = false;
+
+void TransparentSurface::setSIMDEnabled(bool enabled) {
+	s_blendRowProcs.alpha = blendBlitRowAlphaGeneric;
+	s_blendRowProcs.additive = blendBlitRowAdditiveGeneric;
+	s_blendRowProcs.subtractive = blendBlitRowSubtractiveGeneric;
+	s_blendRowProcs.multiply = blendBlitRowMultiplyGeneric;
+	s_blendRowProcsInitialized = true;
+
+	if (!enabled)
+		return;
+
+	// Pick the fastest row kernels the CPU supports
+#if defined(SCUMMVM_NEON) && defined(SCUMM_LITTLE_ENDIAN)
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		s_blendRowProcs.alpha = blendBlitRowAlphaNEON;
+		s_blendRowProcs.additive = blendBlitRowAdditiveNEON;
+		s_blendRowProcs.subtractive = blendBlitRowSubtractiveNEON;
+		s_blendRowProcs.multiply = blendBlitRowMultiplyNEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		s_blendRowProcs.alpha = blendBlitRowAlphaSSE2;
+		s_blendRowProcs.additive = blendBlitRowAdditiveSSE2;
+		s_blendRowProcs.subtractive = blendBlitRowSubtractiveSSE2;
+		s_blendRowProcs.multiply = blendBlitRowMultiplySSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		s_blendRowProcs.alpha = blendBlitRowAlphaAVX2;
+		s_blendRowProcs.additive = blendBlitRowAdditiveAVX2;
+		s_blendRowProcs.subtractive = blendBlitRowSubtractiveAVX2;
+		s_blendRowProcs.multiply = blendBlitRowMultiplyAVX2;
+	}
+#endif
+}
+
+static const BlendBlitRowProcs &getBlendRowProcs() {
+	if (!s_blendRowProcsInitialized)
+		TransparentSurface::setSIMDEnabled(true);
+	return s_blendRowProcs;
+}
+
+static void doBlitBlended(BlendBlitRowProc rowProc, byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
+	for (uint32 i = 0; i < height; i++) {
+		rowProc(outo, ino, width, inStep, color);
+		outo += pitch;
+		ino += inoStep;
+	}
+}
+
 /**
  * Optimized version of doBlit to be used with alpha blended blitting
  * @param ino a pointer to the input surface
@@ -142,259 +205,28 @@ void doBlitBinaryFast(byte *ino, byte *outo, uint32 width, uint32 height, uint32
  * @color colormod in 0xAARRGGBB format - 0xFFFFFFFF for no colormod
  */
 void doBlitAlphaBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
-	byte *in;
-	byte *out;
-
-	if (color == 0xffffffff) {
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				if (in[kAIndex] != 0) {
-					out[kAIndex] = 255;
-					out[kRIndex] = ((in[kRIndex] * in[kAIndex]) + out[kRIndex] * (255 - in[kAIndex])) >> 8;
-					out[kGIndex] = ((in[kGIndex] * in[kAIndex]) + out[kGIndex] * (255 - in[kAIndex])) >> 8;
-					out[kBIndex] = ((in[kBIndex] * in[kAIndex]) + out[kBIndex] * (255 - in[kAIndex])) >> 8;
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	} else {
-
-		byte ca = (color >> kAModShift) & 0xFF;
-		byte cr = (color >> kRModShift) & 0xFF;
-		byte cg = (color >> kGModShift) & 0xFF;
-		byte cb = (color >> kBModShift) & 0xFF;
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				uint32 ina = in[kAIndex] * ca >> 8;
-
-				if (ina != 0) {
-					out[kAIndex] = 255;
-					out[kBIndex] = (out[kBIndex] * (255 - ina) >> 8);
-					out[kGIndex] = (out[kGIndex] * (255 - ina) >> 8);
-					out[kRIndex] = (out[kRIndex] * (255 - ina) >> 8);
-
-					out[kBIndex] = out[kBIndex] + (in[kBIndex] * ina * cb >> 16);
-					out[kGIndex] = out[kGIndex] + (in[kGIndex] * ina * cg >> 16);
-					out[kRIndex] = out[kRIndex] + (in[kRIndex] * ina * cr >> 16);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	}
+	doBlitBlended(getBlendRowProcs().alpha, ino, outo, width, height, pitch, inStep, inoStep, color);
 }
 
 /**
  * Optimized version of doBlit to be used with additive blended blitting
  */
 void doBlitAdditiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
-	byte *in;
-	byte *out;
-
-	if (color == 0xffffffff) {
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				if (in[kAIndex] != 0) {
-					out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) + out[kRIndex], 255);
-					out[kGIndex] = MIN((in[kGIndex] * in[kAIndex] >> 8) + out[kGIndex], 255);
-					out[kBIndex] = MIN((in[kBIndex] * in[kAIndex] >> 8) + out[kBIndex], 255);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	} else {
-
-		byte ca = (color >> kAModShift) & 0xFF;
-		byte cr = (color >> kRModShift) & 0xFF;
-		byte cg = (color >> kGModShift) & 0xFF;
-		byte cb = (color >> kBModShift) & 0xFF;
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				uint32 ina = in[kAIndex] * ca >> 8;
-
-				if (cb != 255) {
-					out[kBIndex] = MIN<uint>(out[kBIndex] + ((in[kBIndex] * cb * ina) >> 16), 255u);
-				} else {
-					out[kBIndex] = MIN<uint>(out[kBIndex] + (in[kBIndex] * ina >> 8), 255u);
-				}
-
-				if (cg != 255) {
-					out[kGIndex] = MIN<uint>(out[kGIndex] + ((in[kGIndex] * cg * ina) >> 16), 255u);
-				} else {
-					out[kGIndex] = MIN<uint>(out[kGIndex] + (in[kGIndex] * ina >> 8), 255u);
-				}
-
-				if (cr != 255) {
-					out[kRIndex] = MIN<uint>(out[kRIndex] + ((in[kRIndex] * cr * ina) >> 16), 255u);
-				} else {
-					out[kRIndex] = MIN<uint>(out[kRIndex] + (in[kRIndex] * ina >> 8), 255u);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	}
+	doBlitBlended(getBlendRowProcs().additive, ino, outo, width, height, pitch, inStep, inoStep, color);
 }
 
 /**
  * Optimized version of doBlit to be used with subtractive blended blitting
  */
 void doBlitSubtractiveBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
-	byte *in;
-	byte *out;
-
-	if (color == 0xffffffff) {
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				if (in[kAIndex] != 0) {
-					out[kRIndex] = MAX(out[kRIndex] - ((in[kRIndex] * out[kRIndex]) * in[kAIndex] >> 16), 0);
-					out[kGIndex] = MAX(out[kGIndex] - ((in[kGIndex] * out[kGIndex]) * in[kAIndex] >> 16), 0);
-					out[kBIndex] = MAX(out[kBIndex] - ((in[kBIndex] * out[kBIndex]) * in[kAIndex] >> 16), 0);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	} else {
-
-		byte cr = (color >> kRModShift) & 0xFF;
-		byte cg = (color >> kGModShift) & 0xFF;
-		byte cb = (color >> kBModShift) & 0xFF;
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				out[kAIndex] = 255;
-				if (cb != 255) {
-					out[kBIndex] = MAX(out[kBIndex] - ((in[kBIndex] * cb  * (out[kBIndex]) * in[kAIndex]) >> 24), 0);
-				} else {
-					out[kBIndex] = MAX(out[kBIndex] - (in[kBIndex] * (out[kBIndex]) * in[kAIndex] >> 16), 0);
-				}
-
-				if (cg != 255) {
-					out[kGIndex] = MAX(out[kGIndex] - ((in[kGIndex] * cg  * (out[kGIndex]) * in[kAIndex]) >> 24), 0);
-				} else {
-					out[kGIndex] = MAX(out[kGIndex] - (in[kGIndex] * (out[kGIndex]) * in[kAIndex] >> 16), 0);
-				}
-
-				if (cr != 255) {
-					out[kRIndex] = MAX(out[kRIndex] - ((in[kRIndex] * cr * (out[kRIndex]) * in[kAIndex]) >> 24), 0);
-				} else {
-					out[kRIndex] = MAX(out[kRIndex] - (in[kRIndex] * (out[kRIndex]) * in[kAIndex] >> 16), 0);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	}
+	doBlitBlended(getBlendRowProcs().subtractive, ino, outo, width, height, pitch, inStep, inoStep, color);
 }
 
 /**
  * Optimized version of doBlit to be used with multiply blended blitting
  */
 void doBlitMultiplyBlend(byte *ino, byte *outo, uint32 width, uint32 height, uint32 pitch, int32 inStep, int32 inoStep, uint32 color) {
-	byte *in;
-	byte *out;
-
-	if (color == 0xffffffff) {
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				if (in[kAIndex] != 0) {
-					out[kRIndex] = MIN((in[kRIndex] * in[kAIndex] >> 8) * out[kRIndex] >> 8, 255);
-					out[kGIndex] = MIN((in[kGIndex] * in[kAIndex] >> 8) * out[kGIndex] >> 8, 255);
-					out[kBIndex] = MIN((in[kBIndex] * in[kAIndex] >> 8) * out[kBIndex] >> 8, 255);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	} else {
-		byte ca = (color >> kAModShift) & 0xFF;
-		byte cr = (color >> kRModShift) & 0xFF;
-		byte cg = (color >> kGModShift) & 0xFF;
-		byte cb = (color >> kBModShift) & 0xFF;
-
-		for (uint32 i = 0; i < height; i++) {
-			out = outo;
-			in = ino;
-			for (uint32 j = 0; j < width; j++) {
-
-				uint32 ina = in[kAIndex] * ca >> 8;
-
-				if (cb != 255) {
-					out[kBIndex] = MIN<uint>(out[kBIndex] * ((in[kBIndex] * cb * ina) >> 16) >> 8, 255u);
-				} else {
-					out[kBIndex] = MIN<uint>(out[kBIndex] * (in[kBIndex] * ina >> 8) >> 8, 255u);
-				}
-
-				if (cg != 255) {
-					out[kGIndex] = MIN<uint>(out[kGIndex] * ((in[kGIndex] * cg * ina) >> 16) >> 8, 255u);
-				} else {
-					out[kGIndex] = MIN<uint>(out[kGIndex] * (in[kGIndex] * ina >> 8) >> 8, 255u);
-				}
-
-				if (cr != 255) {
-					out[kRIndex] = MIN<uint>(out[kRIndex] * ((in[kRIndex] * cr * ina) >> 16) >> 8, 255u);
-				} else {
-					out[kRIndex] = MIN<uint>(out[kRIndex] * (in[kRIndex] * ina >> 8) >> 8, 255u);
-				}
-
-				in += inStep;
-				out += 4;
-			}
-			outo += pitch;
-			ino += inoStep;
-		}
-	}
-
+	doBlitBlended(getBlendRowProcs().multiply, ino, outo, width, height, pitch, inStep, inoStep, color);
 }
 
 Common::Rect TransparentSurface::blit(Graphics::Surface &target, int posX, int posY, int flipping, Common::Rect *pPartRect, uint color, int width, int height, TSpriteBlendMode blendMode) {
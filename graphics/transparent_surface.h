@@ -179,6 +179,15 @@ struct TransparentSurface : public Graphics::Surface {
 
 	AlphaType getAlphaMode() const;
 	void setAlphaMode(AlphaType);
+
+	/**
+	 * Enable or disable the SIMD kernels used for blended blits.
+	 *
+	 * They are enabled by default on CPUs which support them, and produce
+	 * the same pixels as the generic kernels. Disabling them is meant for
+	 * testing and benchmarking.
+	 */
+	static void setSIMDEnabled(bool enabled);
 private:
 	AlphaType _alphaMode;
 };
@@ -0,0 +1,96 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_TRANSPARENT_SURFACE_KERNELS_H
+#define GRAPHICS_TRANSPARENT_SURFACE_KERNELS_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+/**
+ * @defgroup graphics_transparent_surface_kernels Transparent surface kernels
+ * @ingroup graphics
+ *
+ * @brief Row blending primitives used by TransparentSurface.
+ *
+ * Both rows are in the pixel format of TransparentSurface. The SIMD kernels
+ * blend several pixels at once and are bit-exact with the generic ones.
+ * They only handle unflipped source rows, and hand flipped rows and the
+ * pixels left over at the end of a row to the generic kernels.
+ * @{
+ */
+
+/**
+ * Blend one row of source pixels onto the destination pixels.
+ *
+ * @param out    Destination pixels.
+ * @param in     First source pixel.
+ * @param width  Number of pixels.
+ * @param inStep Distance in bytes between source pixels, negative when
+ *               the source is flipped horizontally.
+ * @param color  Color modulation in 0xAARRGGBB format, 0xFFFFFFFF for none.
+ */
+typedef void (*BlendBlitRowProc)(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color);
+
+void blendBlitRowAlphaGeneric(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color);
+void blendBlitRowAdditiveGeneric(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color);
+void blendBlitRowSubtractiveGeneric(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color);
+void blendBlitRowMultiplyGeneric(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color);
+
+#ifdef SCUMMVM_SSE2
+void blendBlitRowAlphaSSE2(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color);
+void blendBlitRowAdditiveSSE2(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color);
+void blendBlitRowSubtractiveSSE2(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color);
+void blendBlitRowMultiplySSE2(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void blendBlitRowAlphaAVX2(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color);
+void blendBlitRowAdditiveAVX2(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color);
+void blendBlitRowSubtractiveAVX2(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color);
+void blendBlitRowMultiplyAVX2(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color);
+#endif
+
+#ifdef SCUMMVM_NEON
+void blendBlitRowAlphaNEON(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color);
+void blendBlitRowAdditiveNEON(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color);
+void blendBlitRowSubtractiveNEON(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color);
+void blendBlitRowMultiplyNEON(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color);
+#endif
+
+/**
+ * Per channel multiplier used by the SIMD kernels for the color modulation.
+ *
+ * The generic additive, subtractive and multiply kernels modulate a channel
+ * by (x * c) >> 16, except for channels which are not modulated (c = 255),
+ * which they scale by x >> 8 instead. Multiplying by 256 and keeping the
+ * high half gives the latter.
+ */
+inline uint16 blendBlitModulation(byte c) {
+	return (c == 255) ? 256 : c;
+}
+
+/** @} */
+} // End of namespace Graphics
+
+#endif
@@ -0,0 +1,201 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/transparent_surface_kernels.h"
+
+#include <immintrin.h>
+
+namespace Graphics {
+
+// Pixels are unpacked to four 16-bit lanes each, in memory order: alpha,
+// blue, green and red. Eight pixels are blended per iteration. Unpacking
+// and packing both work within 128-bit halves, so the pixel order is kept.
+
+static inline __m256i broadcastAlphaAVX2(__m256i pixels) {
+	return _mm256_shufflehi_epi16(_mm256_shufflelo_epi16(pixels, 0), 0);
+}
+
+static inline __m256i modulationAVX2(uint16 r, uint16 g, uint16 b) {
+	return _mm256_broadcastsi128_si256(_mm_set_epi16(r, g, b, 0, r, g, b, 0));
+}
+
+template<bool modulated>
+static void blendAlphaAVX2(byte *out, const byte *in, uint32 width, uint32 color) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i max = _mm256_set1_epi16(255);
+	const __m256i opaque = _mm256_set1_epi32(0xff);
+	const __m256i ca = _mm256_set1_epi16((color >> 24) & 0xff);
+	const __m256i mod = modulationAVX2((color >> 16) & 0xff, (color >> 8) & 0xff, color & 0xff);
+
+	for (uint32 i = 0; i < width; i += 8) {
+		const __m256i src = _mm256_loadu_si256((const __m256i *)(in + i * 4));
+		const __m256i dst = _mm256_loadu_si256((const __m256i *)(out + i * 4));
+		const __m256i sLo = _mm256_unpacklo_epi8(src, zero), sHi = _mm256_unpackhi_epi8(src, zero);
+		const __m256i dLo = _mm256_unpacklo_epi8(dst, zero), dHi = _mm256_unpackhi_epi8(dst, zero);
+		__m256i aLo = broadcastAlphaAVX2(sLo), aHi = broadcastAlphaAVX2(sHi);
+
+		__m256i rLo, rHi;
+		if (modulated) {
+			aLo = _mm256_srli_epi16(_mm256_mullo_epi16(aLo, ca), 8);
+			aHi = _mm256_srli_epi16(_mm256_mullo_epi16(aHi, ca), 8);
+			rLo = _mm256_add_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(dLo, _mm256_sub_epi16(max, aLo)), 8),
+			                    _mm256_mulhi_epu16(_mm256_mullo_epi16(sLo, aLo), mod));
+			rHi = _mm256_add_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(dHi, _mm256_sub_epi16(max, aHi)), 8),
+			                    _mm256_mulhi_epu16(_mm256_mullo_epi16(sHi, aHi), mod));
+		} else {
+			rLo = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(sLo, aLo), _mm256_mullo_epi16(dLo, _mm256_sub_epi16(max, aLo))), 8);
+			rHi = _mm256_srli_epi16(_mm256_add_epi16(_mm256_mullo_epi16(sHi, aHi), _mm256_mullo_epi16(dHi, _mm256_sub_epi16(max, aHi))), 8);
+		}
+
+		// Fully transparent pixels leave the destination untouched.
+		const __m256i transparent = _mm256_packs_epi16(_mm256_cmpeq_epi16(aLo, zero), _mm256_cmpeq_epi16(aHi, zero));
+		const __m256i blended = _mm256_or_si256(_mm256_packus_epi16(rLo, rHi), opaque);
+		_mm256_storeu_si256((__m256i *)(out + i * 4), _mm256_or_si256(_mm256_and_si256(transparent, dst), _mm256_andnot_si256(transparent, blended)));
+	}
+}
+
+template<bool modulated>
+static void blendAdditiveAVX2(byte *out, const byte *in, uint32 width, uint32 color) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i ca = _mm256_set1_epi16((color >> 24) & 0xff);
+	const __m256i mod = modulated ?
+		modulationAVX2(blendBlitModulation((color >> 16) & 0xff), blendBlitModulation((color >> 8) & 0xff), blendBlitModulation(color & 0xff)) :
+		modulationAVX2(256, 256, 256);
+
+	for (uint32 i = 0; i < width; i += 8) {
+		const __m256i src = _mm256_loadu_si256((const __m256i *)(in + i * 4));
+		const __m256i dst = _mm256_loadu_si256((const __m256i *)(out + i * 4));
+		const __m256i sLo = _mm256_unpacklo_epi8(src, zero), sHi = _mm256_unpackhi_epi8(src, zero);
+		__m256i aLo = broadcastAlphaAVX2(sLo), aHi = broadcastAlphaAVX2(sHi);
+		if (modulated) {
+			aLo = _mm256_srli_epi16(_mm256_mullo_epi16(aLo, ca), 8);
+			aHi = _mm256_srli_epi16(_mm256_mullo_epi16(aHi, ca), 8);
+		}
+
+		const __m256i addLo = _mm256_mulhi_epu16(_mm256_mullo_epi16(sLo, aLo), mod);
+		const __m256i addHi = _mm256_mulhi_epu16(_mm256_mullo_epi16(sHi, aHi), mod);
+		_mm256_storeu_si256((__m256i *)(out + i * 4), _mm256_adds_epu8(dst, _mm256_packus_epi16(addLo, addHi)));
+	}
+}
+
+template<bool modulated>
+static void blendSubtractiveAVX2(byte *out, const byte *in, uint32 width, uint32 color) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i opaque = _mm256_set1_epi32(modulated ? 0xff : 0);
+	const __m256i mod = modulated ?
+		modulationAVX2(blendBlitModulation((color >> 16) & 0xff), blendBlitModulation((color >> 8) & 0xff), blendBlitModulation(color & 0xff)) :
+		modulationAVX2(256, 256, 256);
+
+	for (uint32 i = 0; i < width; i += 8) {
+		const __m256i src = _mm256_loadu_si256((const __m256i *)(in + i * 4));
+		const __m256i dst = _mm256_loadu_si256((const __m256i *)(out + i * 4));
+		const __m256i sLo = _mm256_unpacklo_epi8(src, zero), sHi = _mm256_unpackhi_epi8(src, zero);
+		const __m256i dLo = _mm256_unpacklo_epi8(dst, zero), dHi = _mm256_unpackhi_epi8(dst, zero);
+		const __m256i fLo = _mm256_mullo_epi16(broadcastAlphaAVX2(sLo), mod);
+		const __m256i fHi = _mm256_mullo_epi16(broadcastAlphaAVX2(sHi), mod);
+
+		const __m256i subLo = _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(sLo, dLo), fLo), 8);
+		const __m256i subHi = _mm256_srli_epi16(_mm256_mulhi_epu16(_mm256_mullo_epi16(sHi, dHi), fHi), 8);
+		const __m256i result = _mm256_packus_epi16(_mm256_sub_epi16(dLo, subLo), _mm256_sub_epi16(dHi, subHi));
+		_mm256_storeu_si256((__m256i *)(out + i * 4), _mm256_or_si256(result, opaque));
+	}
+}
+
+template<bool modulated>
+static void blendMultiplyAVX2(byte *out, const byte *in, uint32 width, uint32 color) {
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i alphaMask = _mm256_set1_epi32(0xff);
+	const __m256i ca = _mm256_set1_epi16((color >> 24) & 0xff);
+	const __m256i mod = modulated ?
+		modulationAVX2(blendBlitModulation((color >> 16) & 0xff), blendBlitModulation((color >> 8) & 0xff), blendBlitModulation(color & 0xff)) :
+		modulationAVX2(256, 256, 256);
+
+	for (uint32 i = 0; i < width; i += 8) {
+		const __m256i src = _mm256_loadu_si256((const __m256i *)(in + i * 4));
+		const __m256i dst = _mm256_loadu_si256((const __m256i *)(out + i * 4));
+		const __m256i sLo = _mm256_unpacklo_epi8(src, zero), sHi = _mm256_unpackhi_epi8(src, zero);
+		const __m256i dLo = _mm256_unpacklo_epi8(dst, zero), dHi = _mm256_unpackhi_epi8(dst, zero);
+		__m256i aLo = broadcastAlphaAVX2(sLo), aHi = broadcastAlphaAVX2(sHi);
+		if (modulated) {
+			aLo = _mm256_srli_epi16(_mm256_mullo_epi16(aLo, ca), 8);
+			aHi = _mm256_srli_epi16(_mm256_mullo_epi16(aHi, ca), 8);
+		}
+
+		const __m256i tLo = _mm256_mulhi_epu16(_mm256_mullo_epi16(sLo, aLo), mod);
+		const __m256i tHi = _mm256_mulhi_epu16(_mm256_mullo_epi16(sHi, aHi), mod);
+		__m256i result = _mm256_packus_epi16(_mm256_srli_epi16(_mm256_mullo_epi16(dLo, tLo), 8), _mm256_srli_epi16(_mm256_mullo_epi16(dHi, tHi), 8));
+
+		// The destination alpha is kept, and so are the pixels under fully
+		// transparent ones unless the source is modulated.
+		__m256i keep = alphaMask;
+		if (!modulated)
+			keep = _mm256_or_si256(keep, _mm256_packs_epi16(_mm256_cmpeq_epi16(aLo, zero), _mm256_cmpeq_epi16(aHi, zero)));
+		result = _mm256_or_si256(_mm256_and_si256(keep, dst), _mm256_andnot_si256(keep, result));
+		_mm256_storeu_si256((__m256i *)(out + i * 4), result);
+	}
+}
+
+void blendBlitRowAlphaAVX2(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color) {
+	uint32 blocks = (inStep == 4) ? width & ~7 : 0;
+	if (color == 0xffffffff)
+		blendAlphaAVX2<false>(out, in, blocks, color);
+	else
+		blendAlphaAVX2<true>(out, in, blocks, color);
+
+	if (blocks < width)
+		blendBlitRowAlphaGeneric(out + blocks * 4, in + blocks * inStep, width - blocks, inStep, color);
+}
+
+void blendBlitRowAdditiveAVX2(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color) {
+	uint32 blocks = (inStep == 4) ? width & ~7 : 0;
+	if (color == 0xffffffff)
+		blendAdditiveAVX2<false>(out, in, blocks, color);
+	else
+		blendAdditiveAVX2<true>(out, in, blocks, color);
+
+	if (blocks < width)
+		blendBlitRowAdditiveGeneric(out + blocks * 4, in + blocks * inStep, width - blocks, inStep, color);
+}
+
+void blendBlitRowSubtractiveAVX2(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color) {
+	uint32 blocks = (inStep == 4) ? width & ~7 : 0;
+	if (color == 0xffffffff)
+		blendSubtractiveAVX2<false>(out, in, blocks, color);
+	else
+		blendSubtractiveAVX2<true>(out, in, blocks, color);
+
+	if (blocks < width)
+		blendBlitRowSubtractiveGeneric(out + blocks * 4, in + blocks * inStep, width - blocks, inStep, color);
+}
+
+void blendBlitRowMultiplyAVX2(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color) {
+	uint32 blocks = (inStep == 4) ? width & ~7 : 0;
+	if (color == 0xffffffff)
+		blendMultiplyAVX2<false>(out, in, blocks, color);
+	else
+		blendMultiplyAVX2<true>(out, in, blocks, color);
+
+	if (blocks < width)
+		blendBlitRowMultiplyGeneric(out + blocks * 4, in + blocks * inStep, width - blocks, inStep, color);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,214 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/transparent_surface_kernels.h"
+
+#include <arm_neon.h>
+
+namespace Graphics {
+
+// Pixels are unpacked to four 16-bit lanes each, in memory order: alpha,
+// blue, green and red. Four pixels are blended per iteration.
+
+static inline uint16x8_t mulhiNEON(uint16x8_t a, uint16x8_t b) {
+	return vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(a), vget_low_u16(b)), 16),
+	                    vshrn_n_u32(vmull_u16(vget_high_u16(a), vget_high_u16(b)), 16));
+}
+
+static inline uint8x16_t packNEON(uint16x8_t lo, uint16x8_t hi) {
+	return vcombine_u8(vqmovn_u16(lo), vqmovn_u16(hi));
+}
+
+static inline uint8x16_t isZeroNEON(uint16x8_t lo, uint16x8_t hi) {
+	const uint16x8_t zero = vdupq_n_u16(0);
+	return vcombine_u8(vmovn_u16(vceqq_u16(lo, zero)), vmovn_u16(vceqq_u16(hi, zero)));
+}
+
+/**
+ * Set every byte of the pixels to their alpha value.
+ */
+static inline uint8x16_t broadcastAlphaNEON(uint8x16_t pixels) {
+	return vreinterpretq_u8_u32(vmulq_n_u32(vandq_u32(vreinterpretq_u32_u8(pixels), vdupq_n_u32(0xff)), 0x01010101));
+}
+
+static inline uint16x8_t modulationNEON(uint16 r, uint16 g, uint16 b) {
+	const uint16 mod[8] = { 0, b, g, r, 0, b, g, r };
+	return vld1q_u16(mod);
+}
+
+template<bool modulated>
+static void blendAlphaNEON(byte *out, const byte *in, uint32 width, uint32 color) {
+	const uint16x8_t max = vdupq_n_u16(255);
+	const uint8x16_t opaque = vreinterpretq_u8_u32(vdupq_n_u32(0xff));
+	const uint16x8_t ca = vdupq_n_u16((color >> 24) & 0xff);
+	const uint16x8_t mod = modulationNEON((color >> 16) & 0xff, (color >> 8) & 0xff, color & 0xff);
+
+	for (uint32 i = 0; i < width; i += 4) {
+		const uint8x16_t src = vld1q_u8(in + i * 4);
+		const uint8x16_t dst = vld1q_u8(out + i * 4);
+		const uint8x16_t alpha = broadcastAlphaNEON(src);
+		const uint16x8_t sLo = vmovl_u8(vget_low_u8(src)), sHi = vmovl_u8(vget_high_u8(src));
+		const uint16x8_t dLo = vmovl_u8(vget_low_u8(dst)), dHi = vmovl_u8(vget_high_u8(dst));
+		uint16x8_t aLo = vmovl_u8(vget_low_u8(alpha)), aHi = vmovl_u8(vget_high_u8(alpha));
+
+		uint16x8_t rLo, rHi;
+		if (modulated) {
+			aLo = vshrq_n_u16(vmulq_u16(aLo, ca), 8);
+			aHi = vshrq_n_u16(vmulq_u16(aHi, ca), 8);
+			rLo = vaddq_u16(vshrq_n_u16(vmulq_u16(dLo, vsubq_u16(max, aLo)), 8), mulhiNEON(vmulq_u16(sLo, aLo), mod));
+			rHi = vaddq_u16(vshrq_n_u16(vmulq_u16(dHi, vsubq_u16(max, aHi)), 8), mulhiNEON(vmulq_u16(sHi, aHi), mod));
+		} else {
+			rLo = vshrq_n_u16(vaddq_u16(vmulq_u16(sLo, aLo), vmulq_u16(dLo, vsubq_u16(max, aLo))), 8);
+			rHi = vshrq_n_u16(vaddq_u16(vmulq_u16(sHi, aHi), vmulq_u16(dHi, vsubq_u16(max, aHi))), 8);
+		}
+
+		// Fully transparent pixels leave the destination untouched.
+		const uint8x16_t blended = vorrq_u8(packNEON(rLo, rHi), opaque);
+		vst1q_u8(out + i * 4, vbslq_u8(isZeroNEON(aLo, aHi), dst, blended));
+	}
+}
+
+template<bool modulated>
+static void blendAdditiveNEON(byte *out, const byte *in, uint32 width, uint32 color) {
+	const uint16x8_t ca = vdupq_n_u16((color >> 24) & 0xff);
+	const uint16x8_t mod = modulated ?
+		modulationNEON(blendBlitModulation((color >> 16) & 0xff), blendBlitModulation((color >> 8) & 0xff), blendBlitModulation(color & 0xff)) :
+		modulationNEON(256, 256, 256);
+
+	for (uint32 i = 0; i < width; i += 4) {
+		const uint8x16_t src = vld1q_u8(in + i * 4);
+		const uint8x16_t dst = vld1q_u8(out + i * 4);
+		const uint8x16_t alpha = broadcastAlphaNEON(src);
+		const uint16x8_t sLo = vmovl_u8(vget_low_u8(src)), sHi = vmovl_u8(vget_high_u8(src));
+		uint16x8_t aLo = vmovl_u8(vget_low_u8(alpha)), aHi = vmovl_u8(vget_high_u8(alpha));
+		if (modulated) {
+			aLo = vshrq_n_u16(vmulq_u16(aLo, ca), 8);
+			aHi = vshrq_n_u16(vmulq_u16(aHi, ca), 8);
+		}
+
+		const uint16x8_t addLo = mulhiNEON(vmulq_u16(sLo, aLo), mod);
+		const uint16x8_t addHi = mulhiNEON(vmulq_u16(sHi, aHi), mod);
+		vst1q_u8(out + i * 4, vqaddq_u8(dst, packNEON(addLo, addHi)));
+	}
+}
+
+template<bool modulated>
+static void blendSubtractiveNEON(byte *out, const byte *in, uint32 width, uint32 color) {
+	const uint8x16_t opaque = vreinterpretq_u8_u32(vdupq_n_u32(modulated ? 0xff : 0));
+	const uint16x8_t mod = modulated ?
+		modulationNEON(blendBlitModulation((color >> 16) & 0xff), blendBlitModulation((color >> 8) & 0xff), blendBlitModulation(color & 0xff)) :
+		modulationNEON(256, 256, 256);
+
+	for (uint32 i = 0; i < width; i += 4) {
+		const uint8x16_t src = vld1q_u8(in + i * 4);
+		const uint8x16_t dst = vld1q_u8(out + i * 4);
+		const uint8x16_t alpha = broadcastAlphaNEON(src);
+		const uint16x8_t sLo = vmovl_u8(vget_low_u8(src)), sHi = vmovl_u8(vget_high_u8(src));
+		const uint16x8_t dLo = vmovl_u8(vget_low_u8(dst)), dHi = vmovl_u8(vget_high_u8(dst));
+		const uint16x8_t fLo = vmulq_u16(vmovl_u8(vget_low_u8(alpha)), mod);
+		const uint16x8_t fHi = vmulq_u16(vmovl_u8(vget_high_u8(alpha)), mod);
+
+		const uint16x8_t subLo = vshrq_n_u16(mulhiNEON(vmulq_u16(sLo, dLo), fLo), 8);
+		const uint16x8_t subHi = vshrq_n_u16(mulhiNEON(vmulq_u16(sHi, dHi), fHi), 8);
+		const uint8x16_t result = packNEON(vsubq_u16(dLo, subLo), vsubq_u16(dHi, subHi));
+		vst1q_u8(out + i * 4, vorrq_u8(result, opaque));
+	}
+}
+
+template<bool modulated>
+static void blendMultiplyNEON(byte *out, const byte *in, uint32 width, uint32 color) {
+	const uint8x16_t alphaMask = vreinterpretq_u8_u32(vdupq_n_u32(0xff));
+	const uint16x8_t ca = vdupq_n_u16((color >> 24) & 0xff);
+	const uint16x8_t mod = modulated ?
+		modulationNEON(blendBlitModulation((color >> 16) & 0xff), blendBlitModulation((color >> 8) & 0xff), blendBlitModulation(color & 0xff)) :
+		modulationNEON(256, 256, 256);
+
+	for (uint32 i = 0; i < width; i += 4) {
+		const uint8x16_t src = vld1q_u8(in + i * 4);
+		const uint8x16_t dst = vld1q_u8(out + i * 4);
+		const uint8x16_t alpha = broadcastAlphaNEON(src);
+		const uint16x8_t sLo = vmovl_u8(vget_low_u8(src)), sHi = vmovl_u8(vget_high_u8(src));
+		const uint16x8_t dLo = vmovl_u8(vget_low_u8(dst)), dHi = vmovl_u8(vget_high_u8(dst));
+		uint16x8_t aLo = vmovl_u8(vget_low_u8(alpha)), aHi = vmovl_u8(vget_high_u8(alpha));
+		if (modulated) {
+			aLo = vshrq_n_u16(vmulq_u16(aLo, ca), 8);
+			aHi = vshrq_n_u16(vmulq_u16(aHi, ca), 8);
+		}
+
+		const uint16x8_t tLo = mulhiNEON(vmulq_u16(sLo, aLo), mod);
+		const uint16x8_t tHi = mulhiNEON(vmulq_u16(sHi, aHi), mod);
+		const uint8x16_t result = packNEON(vshrq_n_u16(vmulq_u16(dLo, tLo), 8), vshrq_n_u16(vmulq_u16(dHi, tHi), 8));
+
+		// The destination alpha is kept, and so are the pixels under fully
+		// transparent ones unless the source is modulated.
+		uint8x16_t keep = alphaMask;
+		if (!modulated)
+			keep = vorrq_u8(keep, isZeroNEON(aLo, aHi));
+		vst1q_u8(out + i * 4, vbslq_u8(keep, dst, result));
+	}
+}
+
+void blendBlitRowAlphaNEON(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color) {
+	uint32 blocks = (inStep == 4) ? width & ~3 : 0;
+	if (color == 0xffffffff)
+		blendAlphaNEON<false>(out, in, blocks, color);
+	else
+		blendAlphaNEON<true>(out, in, blocks, color);
+
+	if (blocks < width)
+		blendBlitRowAlphaGeneric(out + blocks * 4, in + blocks * inStep, width - blocks, inStep, color);
+}
+
+void blendBlitRowAdditiveNEON(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color) {
+	uint32 blocks = (inStep == 4) ? width & ~3 : 0;
+	if (color == 0xffffffff)
+		blendAdditiveNEON<false>(out, in, blocks, color);
+	else
+		blendAdditiveNEON<true>(out, in, blocks, color);
+
+	if (blocks < width)
+		blendBlitRowAdditiveGeneric(out + blocks * 4, in + blocks * inStep, width - blocks, inStep, color);
+}
+
+void blendBlitRowSubtractiveNEON(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color) {
+	uint32 blocks = (inStep == 4) ? width & ~3 : 0;
+	if (color == 0xffffffff)
+		blendSubtractiveNEON<false>(out, in, blocks, color);
+	else
+		blendSubtractiveNEON<true>(out, in, blocks, color);
+
+	if (blocks < width)
+		blendBlitRowSubtractiveGeneric(out + blocks * 4, in + blocks * inStep, width - blocks, inStep, color);
+}
+
+void blendBlitRowMultiplyNEON(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color) {
+	uint32 blocks = (inStep == 4) ? width & ~3 : 0;
+	if (color == 0xffffffff)
+		blendMultiplyNEON<false>(out, in, blocks, color);
+	else
+		blendMultiplyNEON<true>(out, in, blocks, color);
+
+	if (blocks < width)
+		blendBlitRowMultiplyGeneric(out + blocks * 4, in + blocks * inStep, width - blocks, inStep, color);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,200 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/transparent_surface_kernels.h"
+
+#include <emmintrin.h>
+
+namespace Graphics {
+
+// Pixels are unpacked to four 16-bit lanes each, in memory order: alpha,
+// blue, green and red. Four pixels are blended per iteration.
+
+static inline __m128i broadcastAlphaSSE2(__m128i pixels) {
+	return _mm_shufflehi_epi16(_mm_shufflelo_epi16(pixels, 0), 0);
+}
+
+static inline __m128i modulationSSE2(uint16 r, uint16 g, uint16 b) {
+	return _mm_set_epi16(r, g, b, 0, r, g, b, 0);
+}
+
+template<bool modulated>
+static void blendAlphaSSE2(byte *out, const byte *in, uint32 width, uint32 color) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i max = _mm_set1_epi16(255);
+	const __m128i opaque = _mm_set1_epi32(0xff);
+	const __m128i ca = _mm_set1_epi16((color >> 24) & 0xff);
+	const __m128i mod = modulationSSE2((color >> 16) & 0xff, (color >> 8) & 0xff, color & 0xff);
+
+	for (uint32 i = 0; i < width; i += 4) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)(in + i * 4));
+		const __m128i dst = _mm_loadu_si128((const __m128i *)(out + i * 4));
+		const __m128i sLo = _mm_unpacklo_epi8(src, zero), sHi = _mm_unpackhi_epi8(src, zero);
+		const __m128i dLo = _mm_unpacklo_epi8(dst, zero), dHi = _mm_unpackhi_epi8(dst, zero);
+		__m128i aLo = broadcastAlphaSSE2(sLo), aHi = broadcastAlphaSSE2(sHi);
+
+		__m128i rLo, rHi;
+		if (modulated) {
+			aLo = _mm_srli_epi16(_mm_mullo_epi16(aLo, ca), 8);
+			aHi = _mm_srli_epi16(_mm_mullo_epi16(aHi, ca), 8);
+			rLo = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(dLo, _mm_sub_epi16(max, aLo)), 8),
+			                    _mm_mulhi_epu16(_mm_mullo_epi16(sLo, aLo), mod));
+			rHi = _mm_add_epi16(_mm_srli_epi16(_mm_mullo_epi16(dHi, _mm_sub_epi16(max, aHi)), 8),
+			                    _mm_mulhi_epu16(_mm_mullo_epi16(sHi, aHi), mod));
+		} else {
+			rLo = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(sLo, aLo), _mm_mullo_epi16(dLo, _mm_sub_epi16(max, aLo))), 8);
+			rHi = _mm_srli_epi16(_mm_add_epi16(_mm_mullo_epi16(sHi, aHi), _mm_mullo_epi16(dHi, _mm_sub_epi16(max, aHi))), 8);
+		}
+
+		// Fully transparent pixels leave the destination untouched.
+		const __m128i transparent = _mm_packs_epi16(_mm_cmpeq_epi16(aLo, zero), _mm_cmpeq_epi16(aHi, zero));
+		const __m128i blended = _mm_or_si128(_mm_packus_epi16(rLo, rHi), opaque);
+		_mm_storeu_si128((__m128i *)(out + i * 4), _mm_or_si128(_mm_and_si128(transparent, dst), _mm_andnot_si128(transparent, blended)));
+	}
+}
+
+template<bool modulated>
+static void blendAdditiveSSE2(byte *out, const byte *in, uint32 width, uint32 color) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i ca = _mm_set1_epi16((color >> 24) & 0xff);
+	const __m128i mod = modulated ?
+		modulationSSE2(blendBlitModulation((color >> 16) & 0xff), blendBlitModulation((color >> 8) & 0xff), blendBlitModulation(color & 0xff)) :
+		modulationSSE2(256, 256, 256);
+
+	for (uint32 i = 0; i < width; i += 4) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)(in + i * 4));
+		const __m128i dst = _mm_loadu_si128((const __m128i *)(out + i * 4));
+		const __m128i sLo = _mm_unpacklo_epi8(src, zero), sHi = _mm_unpackhi_epi8(src, zero);
+		__m128i aLo = broadcastAlphaSSE2(sLo), aHi = broadcastAlphaSSE2(sHi);
+		if (modulated) {
+			aLo = _mm_srli_epi16(_mm_mullo_epi16(aLo, ca), 8);
+			aHi = _mm_srli_epi16(_mm_mullo_epi16(aHi, ca), 8);
+		}
+
+		const __m128i addLo = _mm_mulhi_epu16(_mm_mullo_epi16(sLo, aLo), mod);
+		const __m128i addHi = _mm_mulhi_epu16(_mm_mullo_epi16(sHi, aHi), mod);
+		_mm_storeu_si128((__m128i *)(out + i * 4), _mm_adds_epu8(dst, _mm_packus_epi16(addLo, addHi)));
+	}
+}
+
+template<bool modulated>
+static void blendSubtractiveSSE2(byte *out, const byte *in, uint32 width, uint32 color) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i opaque = _mm_set1_epi32(modulated ? 0xff : 0);
+	const __m128i mod = modulated ?
+		modulationSSE2(blendBlitModulation((color >> 16) & 0xff), blendBlitModulation((color >> 8) & 0xff), blendBlitModulation(color & 0xff)) :
+		modulationSSE2(256, 256, 256);
+
+	for (uint32 i = 0; i < width; i += 4) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)(in + i * 4));
+		const __m128i dst = _mm_loadu_si128((const __m128i *)(out + i * 4));
+		const __m128i sLo = _mm_unpacklo_epi8(src, zero), sHi = _mm_unpackhi_epi8(src, zero);
+		const __m128i dLo = _mm_unpacklo_epi8(dst, zero), dHi = _mm_unpackhi_epi8(dst, zero);
+		const __m128i fLo = _mm_mullo_epi16(broadcastAlphaSSE2(sLo), mod);
+		const __m128i fHi = _mm_mullo_epi16(broadcastAlphaSSE2(sHi), mod);
+
+		const __m128i subLo = _mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(sLo, dLo), fLo), 8);
+		const __m128i subHi = _mm_srli_epi16(_mm_mulhi_epu16(_mm_mullo_epi16(sHi, dHi), fHi), 8);
+		const __m128i result = _mm_packus_epi16(_mm_sub_epi16(dLo, subLo), _mm_sub_epi16(dHi, subHi));
+		_mm_storeu_si128((__m128i *)(out + i * 4), _mm_or_si128(result, opaque));
+	}
+}
+
+template<bool modulated>
+static void blendMultiplySSE2(byte *out, const byte *in, uint32 width, uint32 color) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaMask = _mm_set1_epi32(0xff);
+	const __m128i ca = _mm_set1_epi16((color >> 24) & 0xff);
+	const __m128i mod = modulated ?
+		modulationSSE2(blendBlitModulation((color >> 16) & 0xff), blendBlitModulation((color >> 8) & 0xff), blendBlitModulation(color & 0xff)) :
+		modulationSSE2(256, 256, 256);
+
+	for (uint32 i = 0; i < width; i += 4) {
+		const __m128i src = _mm_loadu_si128((const __m128i *)(in + i * 4));
+		const __m128i dst = _mm_loadu_si128((const __m128i *)(out + i * 4));
+		const __m128i sLo = _mm_unpacklo_epi8(src, zero), sHi = _mm_unpackhi_epi8(src, zero);
+		const __m128i dLo = _mm_unpacklo_epi8(dst, zero), dHi = _mm_unpackhi_epi8(dst, zero);
+		__m128i aLo = broadcastAlphaSSE2(sLo), aHi = broadcastAlphaSSE2(sHi);
+		if (modulated) {
+			aLo = _mm_srli_epi16(_mm_mullo_epi16(aLo, ca), 8);
+			aHi = _mm_srli_epi16(_mm_mullo_epi16(aHi, ca), 8);
+		}
+
+		const __m128i tLo = _mm_mulhi_epu16(_mm_mullo_epi16(sLo, aLo), mod);
+		const __m128i tHi = _mm_mulhi_epu16(_mm_mullo_epi16(sHi, aHi), mod);
+		__m128i result = _mm_packus_epi16(_mm_srli_epi16(_mm_mullo_epi16(dLo, tLo), 8), _mm_srli_epi16(_mm_mullo_epi16(dHi, tHi), 8));
+
+		// The destination alpha is kept, and so are the pixels under fully
+		// transparent ones unless the source is modulated.
+		__m128i keep = alphaMask;
+		if (!modulated)
+			keep = _mm_or_si128(keep, _mm_packs_epi16(_mm_cmpeq_epi16(aLo, zero), _mm_cmpeq_epi16(aHi, zero)));
+		result = _mm_or_si128(_mm_and_si128(keep, dst), _mm_andnot_si128(keep, result));
+		_mm_storeu_si128((__m128i *)(out + i * 4), result);
+	}
+}
+
+void blendBlitRowAlphaSSE2(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color) {
+	uint32 blocks = (inStep == 4) ? width & ~3 : 0;
+	if (color == 0xffffffff)
+		blendAlphaSSE2<false>(out, in, blocks, color);
+	else
+		blendAlphaSSE2<true>(out, in, blocks, color);
+
+	if (blocks < width)
+		blendBlitRowAlphaGeneric(out + blocks * 4, in + blocks * inStep, width - blocks, inStep, color);
+}
+
+void blendBlitRowAdditiveSSE2(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color) {
+	uint32 blocks = (inStep == 4) ? width & ~3 : 0;
+	if (color == 0xffffffff)
+		blendAdditiveSSE2<false>(out, in, blocks, color);
+	else
+		blendAdditiveSSE2<true>(out, in, blocks, color);
+
+	if (blocks < width)
+		blendBlitRowAdditiveGeneric(out + blocks * 4, in + blocks * inStep, width - blocks, inStep, color);
+}
+
+void blendBlitRowSubtractiveSSE2(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color) {
+	uint32 blocks = (inStep == 4) ? width & ~3 : 0;
+	if (color == 0xffffffff)
+		blendSubtractiveSSE2<false>(out, in, blocks, color);
+	else
+		blendSubtractiveSSE2<true>(out, in, blocks, color);
+
+	if (blocks < width)
+		blendBlitRowSubtractiveGeneric(out + blocks * 4, in + blocks * inStep, width - blocks, inStep, color);
+}
+
+void blendBlitRowMultiplySSE2(byte *out, const byte *in, uint32 width, int32 inStep, uint32 color) {
+	uint32 blocks = (inStep == 4) ? width & ~3 : 0;
+	if (color == 0xffffffff)
+		blendMultiplySSE2<false>(out, in, blocks, color);
+	else
+		blendMultiplySSE2<true>(out, in, blocks, color);
+
+	if (blocks < width)
+		blendBlitRowMultiplyGeneric(out + blocks * 4, in + blocks * inStep, width - blocks, inStep, color);
+}
+
+} // End of namespace Graphics
@@ -83,6 +83,8 @@
 // BASIS, AND BROWN UNIVERSITY HAS NO OBLIGATION TO PROVIDE MAINTENANCE,
 // SUPPORT, UPDATES, ENHANCEMENTS, OR MODIFICATIONS.
 
+#include "common/array.h"
+#include "common/system.h"
 #include "graphics/surface.h"
 #include "graphics/yuv_to_rgb.h"
 
@@ -187,6 +189,8 @@ YUVToRGBManager::YUVToRGBManager() {
 		Cb_g_tab[i] = (int16) (-(0.114 / 0.331) * CB);
 		Cb_b_tab[i] = (int16) ( (0.587 / 0.331) * CB) + 2 * 768 + 256;
 	}
+
+	setSIMDEnabled(true);
 }
 
 YUVToRGBManager::~YUVToRGBManager() {
@@ -203,6 +207,109 @@ const YUVToRGBLookup *YUVToRGBManager::getLookup(Graphics::PixelFormat format, Y
 	return _lookup;
 }
 
+void YUVToRGBManager::setSIMDEnabled(bool enabled) {
+	_rowProc16 = 0;
+	_rowProc32 = 0;
+
+	if (!enabled)
+		return;
+
+	// Pick the fastest row kernels the CPU supports
+#ifdef SCUMMVM_NEON
+	if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+		_rowProc16 = yuvToRGBRow16NEON;
+		_rowProc32 = yuvToRGBRow32NEON;
+	}
+#endif
+#ifdef SCUMMVM_SSE2
+	if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+		_rowProc16 = yuvToRGBRow16SSE2;
+		_rowProc32 = yuvToRGBRow32SSE2;
+	}
+#endif
+#ifdef SCUMMVM_AVX2
+	if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+		_rowProc16 = yuvToRGBRow16AVX2;
+		_rowProc32 = yuvToRGBRow32AVX2;
+	}
+#endif
+}
+
+void YUVToRGBManager::convertRows(Graphics::Surface *dst, YUVToRGBManager::LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch, bool subsampled) {
+	const Graphics::PixelFormat &pixelFormat = dst->format;
+	const YUVToRGBRowProc rowProc = (pixelFormat.bytesPerPixel == 2) ? _rowProc16 : _rowProc32;
+
+	YUVToRGBFormat format;
+	format.rLoss = pixelFormat.rLoss;
+	format.gLoss = pixelFormat.gLoss;
+	format.bLoss = pixelFormat.bLoss;
+	format.rShift = pixelFormat.rShift;
+	format.gShift = pixelFormat.gShift;
+	format.bShift = pixelFormat.bShift;
+	format.alpha = pixelFormat.ARGBToColor(255, 0, 0, 0);
+	format.itu = (scale == kScaleITU);
+
+	const int16 *Cr_r_tab = &_colorTab[0 * 256];
+	const int16 *Cr_g_tab = &_colorTab[1 * 256];
+	const int16 *Cb_g_tab = &_colorTab[2 * 256];
+	const int16 *Cb_b_tab = &_colorTab[3 * 256];
+
+	// The tables are biased to index the lookup tables; remove the bias so
+	// that the offsets apply to the color channels directly. The buffer is
+	// kept for the next frames, which usually have the same width.
+	if (_rowOffsets.size() != (uint)yWidth * 3)
+		_rowOffsets.resize(yWidth * 3);
+	int16 *rOffsets = &_rowOffsets[0];
+	int16 *gOffsets = rOffsets + yWidth;
+	int16 *bOffsets = gOffsets + yWidth;
+
+	const int chromaHeight = subsampled ? yHeight >> 1 : yHeight;
+	const int lumaRows = subsampled ? 2 : 1;
+	byte *dstPtr = (byte *)dst->getPixels();
+
+	// Each chroma sample covers two luma columns when subsampled, the last
+	// one only covering one for odd widths
+	const int chromaWidth = subsampled ? yWidth >> 1 : yWidth;
+	const int chromaStep = subsampled ? 2 : 1;
+
+	for (int h = 0; h < chromaHeight; h++) {
+		// The offsets only depend on the chroma, so compute them once per
+		// chroma sample and repeat them for the luma columns sharing it
+		int w = 0;
+		for (int c = 0; c < chromaWidth; c++, w += chromaStep) {
+			const byte u = uSrc[c];
+			const byte v = vSrc[c];
+			const int16 rOffset = Cr_r_tab[v] - (0 * 768 + 256);
+			const int16 gOffset = Cr_g_tab[v] + Cb_g_tab[u] - (1 * 768 + 256);
+			const int16 bOffset = Cb_b_tab[u] - (2 * 768 + 256);
+			rOffsets[w] = rOffset;
+			gOffsets[w] = gOffset;
+			bOffsets[w] = bOffset;
+			if (subsampled) {
+				rOffsets[w + 1] = rOffset;
+				gOffsets[w + 1] = gOffset;
+				bOffsets[w + 1] = bOffset;
+			}
+		}
+		if (w < yWidth) {
+			const byte u = uSrc[chromaWidth];
+			const byte v = vSrc[chromaWidth];
+			rOffsets[w] = Cr_r_tab[v] - (0 * 768 + 256);
+			gOffsets[w] = Cr_g_tab[v] + Cb_g_tab[u] - (1 * 768 + 256);
+			bOffsets[w] = Cb_b_tab[u] - (2 * 768 + 256);
+		}
+
+		for (int i = 0; i < lumaRows; i++) {
+			rowProc(dstPtr, ySrc, rOffsets, gOffsets, bOffsets, yWidth, format);
+			dstPtr += dst->pitch;
+			ySrc += yPitch;
+		}
+
+		uSrc += uvPitch;
+		vSrc += uvPitch;
+	}
+}
+
 #define PUT_PIXEL(s, d) \
 	L = &rgbToPix[(s)]; \
 	*((PixelInt *)(d)) = (L[cr_r] | L[crb_g] | L[cb_b])
@@ -244,6 +351,11 @@ void YUVToRGBManager::convert444(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert(dst->format.bytesPerPixel == 2 || dst->format.bytesPerPixel == 4);
 	assert(ySrc && uSrc && vSrc);
 
+	if ((dst->format.bytesPerPixel == 2 ? _rowProc16 : _rowProc32) != 0) {
+		convertRows(dst, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch, false);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
@@ -300,6 +412,11 @@ void YUVToRGBManager::convert420(Graphics::Surface *dst, YUVToRGBManager::Lumina
 	assert((yWidth & 1) == 0);
 	assert((yHeight & 1) == 0);
 
+	if ((dst->format.bytesPerPixel == 2 ? _rowProc16 : _rowProc32) != 0) {
+		convertRows(dst, scale, ySrc, uSrc, vSrc, yWidth, yHeight, yPitch, uvPitch, true);
+		return;
+	}
+
 	const YUVToRGBLookup *lookup = getLookup(dst->format, scale);
 
 	// Use a templated function to avoid an if check on every pixel
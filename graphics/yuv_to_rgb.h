@@ -39,8 +39,10 @@
 #define GRAPHICS_YUV_TO_RGB_H
 
 #include "common/scummsys.h"
+#include "common/array.h"
 #include "common/singleton.h"
 #include "graphics/surface.h"
+#include "graphics/yuv_to_rgb_kernels.h"
 
 namespace Graphics {
 
@@ -121,16 +123,30 @@ public:
 	 */
 	void convert410(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch);
 
+	/**
+	 * Enable or disable the SIMD row kernels used by convert444() and
+	 * convert420(). They are enabled by default when the CPU supports them;
+	 * disabling them falls back to the lookup tables. Mostly useful for
+	 * tests and benchmarks.
+	 */
+	void setSIMDEnabled(bool enabled);
+
 private:
 	friend class Common::Singleton<SingletonBaseType>;
 	YUVToRGBManager();
 	~YUVToRGBManager();
 
 	const YUVToRGBLookup *getLookup(Graphics::PixelFormat format, LuminanceScale scale, bool alphaMode = false);
+	void convertRows(Graphics::Surface *dst, LuminanceScale scale, const byte *ySrc, const byte *uSrc, const byte *vSrc, int yWidth, int yHeight, int yPitch, int uvPitch, bool subsampled);
 
 	YUVToRGBLookup *_lookup;
 	int16 _colorTab[4 * 256]; // 2048 bytes
 	bool _alphaMode;
+
+	YUVToRGBRowProc _rowProc16;
+	YUVToRGBRowProc _rowProc32;
+	/** Per pixel color offsets of the current rows, for yWidth pixels */
+	Common::Array<int16> _rowOffsets;
 };
  /** @} */
 } // End of namespace Graphics
@@ -0,0 +1,62 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/yuv_to_rgb_kernels.h"
+#include "common/util.h"
+
+namespace Graphics {
+
+static inline uint32 convertPixel(byte y, int16 rOffset, int16 gOffset, int16 bOffset, const YUVToRGBFormat &format) {
+	int r, g, b;
+
+	if (format.itu) {
+		r = CLIP<int>(y + rOffset, 16, 235) - 16;
+		g = CLIP<int>(y + gOffset, 16, 235) - 16;
+		b = CLIP<int>(y + bOffset, 16, 235) - 16;
+		r = r * 255 / 219;
+		g = g * 255 / 219;
+		b = b * 255 / 219;
+	} else {
+		r = CLIP<int>(y + rOffset, 0, 255);
+		g = CLIP<int>(y + gOffset, 0, 255);
+		b = CLIP<int>(y + bOffset, 0, 255);
+	}
+
+	return ((r >> format.rLoss) << format.rShift) |
+	       ((g >> format.gLoss) << format.gShift) |
+	       ((b >> format.bLoss) << format.bShift) |
+	       format.alpha;
+}
+
+void yuvToRGBRow16Generic(byte *dst, const byte *ySrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBFormat &format) {
+	uint16 *out = (uint16 *)dst;
+	for (int i = 0; i < width; i++)
+		out[i] = convertPixel(ySrc[i], rOffsets[i], gOffsets[i], bOffsets[i], format);
+}
+
+void yuvToRGBRow32Generic(byte *dst, const byte *ySrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBFormat &format) {
+	uint32 *out = (uint32 *)dst;
+	for (int i = 0; i < width; i++)
+		out[i] = convertPixel(ySrc[i], rOffsets[i], gOffsets[i], bOffsets[i], format);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,100 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#ifndef GRAPHICS_YUV_TO_RGB_KERNELS_H
+#define GRAPHICS_YUV_TO_RGB_KERNELS_H
+
+#include "common/scummsys.h"
+
+namespace Graphics {
+
+/**
+ * @defgroup graphics_yuvtorgb_kernels YUV to RGB kernels
+ * @ingroup graphics_yuvtorgb
+ *
+ * @brief Row conversion primitives used by YUVToRGBManager.
+ *
+ * Instead of looking up every pixel in the tables of YUVToRGBManager, these
+ * kernels compute the color channels of several pixels at once. The chroma
+ * contributions still come from the tables, and are passed in expanded to
+ * one value per pixel. The results are bit-exact with the table lookups.
+ * @{
+ */
+
+/**
+ * Bit layout of the target pixel format.
+ */
+struct YUVToRGBFormat {
+	uint8 rLoss, gLoss, bLoss;
+	uint8 rShift, gShift, bShift;
+	/** Alpha bits set in every pixel. */
+	uint32 alpha;
+	/** Whether luminance is in the [16, 235] range of ITU-R BT.601. */
+	bool itu;
+};
+
+/**
+ * Convert one row of pixels.
+ *
+ * The color channels are Y plus the respective offset, clamped to the
+ * valid range and, for ITU-R BT.601 luminance, stretched to [0, 255].
+ *
+ * @param dst      Destination pixels, 2 or 4 bytes each depending on the kernel.
+ * @param ySrc     Luminance values.
+ * @param rOffsets Red chroma offset per pixel.
+ * @param gOffsets Green chroma offset per pixel.
+ * @param bOffsets Blue chroma offset per pixel.
+ * @param width    Number of pixels.
+ * @param format   Target pixel format.
+ */
+typedef void (*YUVToRGBRowProc)(byte *dst, const byte *ySrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBFormat &format);
+
+void yuvToRGBRow16Generic(byte *dst, const byte *ySrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBFormat &format);
+void yuvToRGBRow32Generic(byte *dst, const byte *ySrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBFormat &format);
+
+#ifdef SCUMMVM_SSE2
+void yuvToRGBRow16SSE2(byte *dst, const byte *ySrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBFormat &format);
+void yuvToRGBRow32SSE2(byte *dst, const byte *ySrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBFormat &format);
+#endif
+
+#ifdef SCUMMVM_AVX2
+void yuvToRGBRow16AVX2(byte *dst, const byte *ySrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBFormat &format);
+void yuvToRGBRow32AVX2(byte *dst, const byte *ySrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBFormat &format);
+#endif
+
+#ifdef SCUMMVM_NEON
+void yuvToRGBRow16NEON(byte *dst, const byte *ySrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBFormat &format);
+void yuvToRGBRow32NEON(byte *dst, const byte *ySrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBFormat &format);
+#endif
+
+/**
+ * Multiplier for stretching [0, 219] to [0, 255]: x * 255 / 219 equals
+ * x + ((x * kITUStretch) >> 16) for all x in that range.
+ */
+enum {
+	kITUStretch = 10775
+};
+
+/** @} */
+} // End of namespace Graphics
+
+#endif
@@ -0,0 +1,100 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/yuv_to_rgb_kernels.h"
+
+#include <immintrin.h>
+
+namespace Graphics {
+
+/**
+ * Compute one color channel of sixteen pixels as 16-bit values in [0, 255].
+ */
+static inline __m256i channelAVX2(__m256i y, const int16 *offsets, __m256i lo, __m256i hi, bool itu) {
+	__m256i c = _mm256_add_epi16(y, _mm256_loadu_si256((const __m256i *)offsets));
+	c = _mm256_min_epi16(_mm256_max_epi16(c, lo), hi);
+
+	if (itu) {
+		c = _mm256_sub_epi16(c, lo);
+		c = _mm256_add_epi16(c, _mm256_mulhi_epu16(c, _mm256_set1_epi16(kITUStretch)));
+	}
+
+	return c;
+}
+
+void yuvToRGBRow16AVX2(byte *dst, const byte *ySrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBFormat &format) {
+	const __m256i lo = _mm256_set1_epi16(format.itu ? 16 : 0);
+	const __m256i hi = _mm256_set1_epi16(format.itu ? 235 : 255);
+	const __m256i alpha = _mm256_set1_epi16((int16)format.alpha);
+	const __m128i rLoss = _mm_cvtsi32_si128(format.rLoss), rShift = _mm_cvtsi32_si128(format.rShift);
+	const __m128i gLoss = _mm_cvtsi32_si128(format.gLoss), gShift = _mm_cvtsi32_si128(format.gShift);
+	const __m128i bLoss = _mm_cvtsi32_si128(format.bLoss), bShift = _mm_cvtsi32_si128(format.bShift);
+
+	int i = 0;
+	for (; i + 16 <= width; i += 16) {
+		const __m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ySrc + i)));
+		const __m256i r = channelAVX2(y, rOffsets + i, lo, hi, format.itu);
+		const __m256i g = channelAVX2(y, gOffsets + i, lo, hi, format.itu);
+		const __m256i b = channelAVX2(y, bOffsets + i, lo, hi, format.itu);
+
+		__m256i pixels = _mm256_sll_epi16(_mm256_srl_epi16(r, rLoss), rShift);
+		pixels = _mm256_or_si256(pixels, _mm256_sll_epi16(_mm256_srl_epi16(g, gLoss), gShift));
+		pixels = _mm256_or_si256(pixels, _mm256_sll_epi16(_mm256_srl_epi16(b, bLoss), bShift));
+		pixels = _mm256_or_si256(pixels, alpha);
+		_mm256_storeu_si256((__m256i *)(dst + i * 2), pixels);
+	}
+
+	if (i < width)
+		yuvToRGBRow16Generic(dst + i * 2, ySrc + i, rOffsets + i, gOffsets + i, bOffsets + i, width - i, format);
+}
+
+void yuvToRGBRow32AVX2(byte *dst, const byte *ySrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBFormat &format) {
+	const __m256i lo = _mm256_set1_epi16(format.itu ? 16 : 0);
+	const __m256i hi = _mm256_set1_epi16(format.itu ? 235 : 255);
+	const __m256i alpha = _mm256_set1_epi32((int32)format.alpha);
+	const __m128i rLoss = _mm_cvtsi32_si128(format.rLoss), rShift = _mm_cvtsi32_si128(format.rShift);
+	const __m128i gLoss = _mm_cvtsi32_si128(format.gLoss), gShift = _mm_cvtsi32_si128(format.gShift);
+	const __m128i bLoss = _mm_cvtsi32_si128(format.bLoss), bShift = _mm_cvtsi32_si128(format.bShift);
+
+	int i = 0;
+	for (; i + 16 <= width; i += 16) {
+		const __m256i y = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(ySrc + i)));
+		const __m256i r = _mm256_srl_epi16(channelAVX2(y, rOffsets + i, lo, hi, format.itu), rLoss);
+		const __m256i g = _mm256_srl_epi16(channelAVX2(y, gOffsets + i, lo, hi, format.itu), gLoss);
+		const __m256i b = _mm256_srl_epi16(channelAVX2(y, bOffsets + i, lo, hi, format.itu), bLoss);
+
+		// Widen each 128-bit half separately to keep the pixels in order
+		__m256i pixels0 = _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(r)), rShift);
+		__m256i pixels1 = _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(r, 1)), rShift);
+		pixels0 = _mm256_or_si256(pixels0, _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(g)), gShift));
+		pixels1 = _mm256_or_si256(pixels1, _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(g, 1)), gShift));
+		pixels0 = _mm256_or_si256(pixels0, _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_castsi256_si128(b)), bShift));
+		pixels1 = _mm256_or_si256(pixels1, _mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm256_extracti128_si256(b, 1)), bShift));
+		_mm256_storeu_si256((__m256i *)(dst + i * 4), _mm256_or_si256(pixels0, alpha));
+		_mm256_storeu_si256((__m256i *)(dst + i * 4 + 32), _mm256_or_si256(pixels1, alpha));
+	}
+
+	if (i < width)
+		yuvToRGBRow32Generic(dst + i * 4, ySrc + i, rOffsets + i, gOffsets + i, bOffsets + i, width - i, format);
+}
+
+} // End of namespace Graphics
@@ -0,0 +1,102 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/yuv_to_rgb_kernels.h"
+
+#include <arm_neon.h>
+
+namespace Graphics {
+
+/**
+ * Compute one color channel of eight pixels as 16-bit values in [0, 255].
+ */
+static inline uint16x8_t channelNEON(int16x8_t y, const int16 *offsets, int16x8_t lo, int16x8_t hi, bool itu) {
+	int16x8_t c = vaddq_s16(y, vld1q_s16(offsets));
+	c = vminq_s16(vmaxq_s16(c, lo), hi);
+
+	uint16x8_t u = vreinterpretq_u16_s16(c);
+	if (itu) {
+		u = vsubq_u16(u, vreinterpretq_u16_s16(lo));
+		const uint16x4_t stretch = vdup_n_u16(kITUStretch);
+		const uint16x8_t scaled = vcombine_u16(vshrn_n_u32(vmull_u16(vget_low_u16(u), stretch), 16),
+		                                       vshrn_n_u32(vmull_u16(vget_high_u16(u), stretch), 16));
+		u = vaddq_u16(u, scaled);
+	}
+
+	return u;
+}
+
+void yuvToRGBRow16NEON(byte *dst, const byte *ySrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBFormat &format) {
+	const int16x8_t lo = vdupq_n_s16(format.itu ? 16 : 0);
+	const int16x8_t hi = vdupq_n_s16(format.itu ? 235 : 255);
+	const uint16x8_t alpha = vdupq_n_u16((uint16)format.alpha);
+	// Negative shift counts shift to the right
+	const int16x8_t rLoss = vdupq_n_s16(-format.rLoss), rShift = vdupq_n_s16(format.rShift);
+	const int16x8_t gLoss = vdupq_n_s16(-format.gLoss), gShift = vdupq_n_s16(format.gShift);
+	const int16x8_t bLoss = vdupq_n_s16(-format.bLoss), bShift = vdupq_n_s16(format.bShift);
+
+	int i = 0;
+	for (; i + 8 <= width; i += 8) {
+		const int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ySrc + i)));
+		const uint16x8_t r = channelNEON(y, rOffsets + i, lo, hi, format.itu);
+		const uint16x8_t g = channelNEON(y, gOffsets + i, lo, hi, format.itu);
+		const uint16x8_t b = channelNEON(y, bOffsets + i, lo, hi, format.itu);
+
+		uint16x8_t pixels = vshlq_u16(vshlq_u16(r, rLoss), rShift);
+		pixels = vorrq_u16(pixels, vshlq_u16(vshlq_u16(g, gLoss), gShift));
+		pixels = vorrq_u16(pixels, vshlq_u16(vshlq_u16(b, bLoss), bShift));
+		vst1q_u16((uint16 *)(dst + i * 2), vorrq_u16(pixels, alpha));
+	}
+
+	if (i < width)
+		yuvToRGBRow16Generic(dst + i * 2, ySrc + i, rOffsets + i, gOffsets + i, bOffsets + i, width - i, format);
+}
+
+void yuvToRGBRow32NEON(byte *dst, const byte *ySrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBFormat &format) {
+	const int16x8_t lo = vdupq_n_s16(format.itu ? 16 : 0);
+	const int16x8_t hi = vdupq_n_s16(format.itu ? 235 : 255);
+	const uint32x4_t alpha = vdupq_n_u32(format.alpha);
+	const int16x8_t rLoss = vdupq_n_s16(-format.rLoss), gLoss = vdupq_n_s16(-format.gLoss), bLoss = vdupq_n_s16(-format.bLoss);
+	const int32x4_t rShift = vdupq_n_s32(format.rShift), gShift = vdupq_n_s32(format.gShift), bShift = vdupq_n_s32(format.bShift);
+
+	int i = 0;
+	for (; i + 8 <= width; i += 8) {
+		const int16x8_t y = vreinterpretq_s16_u16(vmovl_u8(vld1_u8(ySrc + i)));
+		const uint16x8_t r = vshlq_u16(channelNEON(y, rOffsets + i, lo, hi, format.itu), rLoss);
+		const uint16x8_t g = vshlq_u16(channelNEON(y, gOffsets + i, lo, hi, format.itu), gLoss);
+		const uint16x8_t b = vshlq_u16(channelNEON(y, bOffsets + i, lo, hi, format.itu), bLoss);
+
+		uint32x4_t pixels0 = vshlq_u32(vmovl_u16(vget_low_u16(r)), rShift);
+		uint32x4_t pixels1 = vshlq_u32(vmovl_u16(vget_high_u16(r)), rShift);
+		pixels0 = vorrq_u32(pixels0, vshlq_u32(vmovl_u16(vget_low_u16(g)), gShift));
+		pixels1 = vorrq_u32(pixels1, vshlq_u32(vmovl_u16(vget_high_u16(g)), gShift));
+		pixels0 = vorrq_u32(pixels0, vshlq_u32(vmovl_u16(vget_low_u16(b)), bShift));
+		pixels1 = vorrq_u32(pixels1, vshlq_u32(vmovl_u16(vget_high_u16(b)), bShift));
+		vst1q_u32((uint32 *)(dst + i * 4), vorrq_u32(pixels0, alpha));
+		vst1q_u32((uint32 *)(dst + i * 4 + 16), vorrq_u32(pixels1, alpha));
+	}
+
+	if (i < width)
+		yuvToRGBRow32Generic(dst + i * 4, ySrc + i, rOffsets + i, gOffsets + i, bOffsets + i, width - i, format);
+}
+
+} // End of namespace Graphics
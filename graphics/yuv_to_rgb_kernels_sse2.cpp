@@ -0,0 +1,101 @@
+/* ScummVM - Graphic Adventure Engine
+ *
+ * ScummVM is the legal property of its developers, whose names
+ * are too numerous to list here. Please refer to the COPYRIGHT
+ * file distributed with this source distribution.
+ *
+ * This program is free software; you can redistribute it and/or
+ * modify it under the terms of the GNU General Public License
+ * as published by the Free Software Foundation; either version 2
+ * of the License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ *
+ */
+
+#include "graphics/yuv_to_rgb_kernels.h"
+
+#include <emmintrin.h>
+
+namespace Graphics {
+
+/**
+ * Compute one color channel of eight pixels as 16-bit values in [0, 255].
+ */
+static inline __m128i channelSSE2(__m128i y, const int16 *offsets, __m128i lo, __m128i hi, bool itu) {
+	__m128i c = _mm_add_epi16(y, _mm_loadu_si128((const __m128i *)offsets));
+	c = _mm_min_epi16(_mm_max_epi16(c, lo), hi);
+
+	if (itu) {
+		c = _mm_sub_epi16(c, lo);
+		c = _mm_add_epi16(c, _mm_mulhi_epu16(c, _mm_set1_epi16(kITUStretch)));
+	}
+
+	return c;
+}
+
+void yuvToRGBRow16SSE2(byte *dst, const byte *ySrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBFormat &format) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i lo = _mm_set1_epi16(format.itu ? 16 : 0);
+	const __m128i hi = _mm_set1_epi16(format.itu ? 235 : 255);
+	const __m128i alpha = _mm_set1_epi16((int16)format.alpha);
+	const __m128i rLoss = _mm_cvtsi32_si128(format.rLoss), rShift = _mm_cvtsi32_si128(format.rShift);
+	const __m128i gLoss = _mm_cvtsi32_si128(format.gLoss), gShift = _mm_cvtsi32_si128(format.gShift);
+	const __m128i bLoss = _mm_cvtsi32_si128(format.bLoss), bShift = _mm_cvtsi32_si128(format.bShift);
+
+	int i = 0;
+	for (; i + 8 <= width; i += 8) {
+		const __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(ySrc + i)), zero);
+		const __m128i r = channelSSE2(y, rOffsets + i, lo, hi, format.itu);
+		const __m128i g = channelSSE2(y, gOffsets + i, lo, hi, format.itu);
+		const __m128i b = channelSSE2(y, bOffsets + i, lo, hi, format.itu);
+
+		__m128i pixels = _mm_sll_epi16(_mm_srl_epi16(r, rLoss), rShift);
+		pixels = _mm_or_si128(pixels, _mm_sll_epi16(_mm_srl_epi16(g, gLoss), gShift));
+		pixels = _mm_or_si128(pixels, _mm_sll_epi16(_mm_srl_epi16(b, bLoss), bShift));
+		pixels = _mm_or_si128(pixels, alpha);
+		_mm_storeu_si128((__m128i *)(dst + i * 2), pixels);
+	}
+
+	if (i < width)
+		yuvToRGBRow16Generic(dst + i * 2, ySrc + i, rOffsets + i, gOffsets + i, bOffsets + i, width - i, format);
+}
+
+void yuvToRGBRow32SSE2(byte *dst, const byte *ySrc, const int16 *rOffsets, const int16 *gOffsets, const int16 *bOffsets, int width, const YUVToRGBFormat &format) {
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i lo = _mm_set1_epi16(format.itu ? 16 : 0);
+	const __m128i hi = _mm_set1_epi16(format.itu ? 235 : 255);
+	const __m128i alpha = _mm_set1_epi32((int32)format.alpha);
+	const __m128i rLoss = _mm_cvtsi32_si128(format.rLoss), rShift = _mm_cvtsi32_si128(format.rShift);
+	const __m128i gLoss = _mm_cvtsi32_si128(format.gLoss), gShift = _mm_cvtsi32_si128(format.gShift);
+	const __m128i bLoss = _mm_cvtsi32_si128(format.bLoss), bShift = _mm_cvtsi32_si128(format.bShift);
+
+	int i = 0;
+	for (; i + 8 <= width; i += 8) {
+		const __m128i y = _mm_unpacklo_epi8(_mm_loadl_epi64((const __m128i *)(ySrc + i)), zero);
+		const __m128i r = _mm_srl_epi16(channelSSE2(y, rOffsets + i, lo, hi, format.itu), rLoss);
+		const __m128i g = _mm_srl_epi16(channelSSE2(y, gOffsets + i, lo, hi, format.itu), gLoss);
+		const __m128i b = _mm_srl_epi16(channelSSE2(y, bOffsets + i, lo, hi, format.itu), bLoss);
+
+		__m128i pixels0 = _mm_sll_epi32(_mm_unpacklo_epi16(r, zero), rShift);
+		__m128i pixels1 = _mm_sll_epi32(_mm_unpackhi_epi16(r, zero), rShift);
+		pixels0 = _mm_or_si128(pixels0, _mm_sll_epi32(_mm_unpacklo_epi16(g, zero), gShift));
+		pixels1 = _mm_or_si128(pixels1, _mm_sll_epi32(_mm_unpackhi_epi16(g, zero), gShift));
+		pixels0 = _mm_or_si128(pixels0, _mm_sll_epi32(_mm_unpacklo_epi16(b, zero), bShift));
+		pixels1 = _mm_or_si128(pixels1, _mm_sll_epi32(_mm_unpackhi_epi16(b, zero), bShift));
+		_mm_storeu_si128((__m128i *)(dst + i * 4), _mm_or_si128(pixels0, alpha));
+		_mm_storeu_si128((__m128i *)(dst + i * 4 + 16), _mm_or_si128(pixels1, alpha));
+	}
+
+	if (i < width)
+		yuvToRGBRow32Generic(dst + i * 4, ySrc + i, rOffsets + i, gOffsets + i, bOffsets + i, width - i, format);
+}
+
+} // End of namespace Graphics
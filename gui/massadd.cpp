@@ -20,6 +20,7 @@
  *
  */
 
+#include "engines/detectioncache.h"
 #include "engines/metaengine.h"
 #include "common/algorithm.h"
 #include "common/config-manager.h"
@@ -68,6 +69,8 @@ MassAddDialog::MassAddDialog(const Common::FSNode &startDir)
 
 	// The dir we start our scan at
 	_scanStack.push(startDir);
+	_startPath = startDir.getPath();
+	DetectionCacheMan.startScan();
 
 	// Removed for now... Why would you put a title on mass add dialog called "Mass Add Dialog"?
 	// new StaticTextWidget(this, "massadddialog_caption", "Mass Add Dialog");
@@ -254,6 +257,10 @@ void MassAddDialog::handleTickle() {
 		// Enable the OK button
 		_okButton->setEnabled(true);
 
+		DetectionCacheMan.finishScan(_startPath);
+		DetectionCacheMan.flush();
+		debug(1, "MassAddDialog: Detection cache: %u hits, %u misses", DetectionCacheMan.getHits(), DetectionCacheMan.getMisses());
+
 		buf = _("Scan complete!");
 		_dirProgressText->setLabel(buf);
 
@@ -52,6 +52,7 @@ public:
 
 private:
 	Common::Stack<Common::FSNode>  _scanStack;
+	Common::String _startPath;
 	DetectedGames _games;
 
 	/**
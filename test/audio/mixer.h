@@ -0,0 +1,289 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/mixer_intern.h"
+#include "audio/mixer_kernels.h"
+#include "audio/rate.h"
+#include "audio/decoders/raw.h"
+
+#include "common/system.h"
+
+#include "helper.h"
+#include "../null_osystem.h"
+
+class MixerTestSuite : public CxxTest::TestSuite
+{
+private:
+	static Audio::SeekableAudioStream *createConstantStream(const int16 value, const int sampleRate, const int samples) {
+		byte *data = (byte *)malloc(samples * 2);
+		for (int i = 0; i < samples; ++i)
+			WRITE_BE_UINT16(data + i * 2, value);
+
+		Common::SeekableReadStream *stream = new Common::MemoryReadStream(data, samples * 2, DisposeAfterUse::YES);
+		return Audio::makeRawStream(stream, sampleRate, Audio::FLAG_16BITS);
+	}
+
+	void kernelTestTemplate(Audio::MixAccumulateProc accumulate, Audio::MixClampProc clamp) {
+		// Use an odd number of frames to exercise the tail handling
+		const uint frames = 1021;
+		int16 *src = new int16[frames * 2];
+		int32 *expectedAcc = new int32[frames * 2];
+		int32 *acc = new int32[frames * 2];
+		int16 *expected = new int16[frames * 2];
+		int16 *out = new int16[frames * 2];
+
+		uint32 seed = 0x12345678;
+		for (uint i = 0; i < frames * 2; ++i) {
+			seed = seed * 1103515245 + 12345;
+			src[i] = (int16)(seed >> 16);
+			expectedAcc[i] = acc[i] = (int32)(seed % 200000) - 100000;
+		}
+
+		const uint16 volumes[][2] = { { 256, 256 }, { 255, 1 }, { 0, 129 }, { 77, 200 } };
+		for (uint v = 0; v < ARRAYSIZE(volumes); ++v) {
+			Audio::mixAccumulateGeneric(expectedAcc, src, frames, volumes[v][0], volumes[v][1]);
+			accumulate(acc, src, frames, volumes[v][0], volumes[v][1]);
+		}
+		TS_ASSERT_EQUALS(memcmp(expectedAcc, acc, frames * 2 * sizeof(int32)), 0);
+
+		Audio::mixClampGeneric(expected, expectedAcc, frames * 2);
+		clamp(out, acc, frames * 2);
+		TS_ASSERT_EQUALS(memcmp(expected, out, frames * 2 * sizeof(int16)), 0);
+
+		delete[] src;
+		delete[] expectedAcc;
+		delete[] acc;
+		delete[] expected;
+		delete[] out;
+	}
+
+	void dotProductTestTemplate(Audio::DotProductProc dotProduct) {
+		const uint count = 64;
+		int16 a[count], b[count];
+
+		uint32 seed = 0x87654321;
+		for (uint i = 0; i < count; ++i) {
+			seed = seed * 1103515245 + 12345;
+			a[i] = (int16)(seed >> 16);
+			b[i] = (int16)(seed % 32768) - 16384;
+		}
+
+		for (uint n = 16; n <= count; n += 16)
+			TS_ASSERT_EQUALS(dotProduct(a, b, n), Audio::dotProductGeneric(a, b, n));
+	}
+
+	void convertTestTemplate(const int inputRate, const int outputRate, const bool isStereo, const bool reverseStereo, const Audio::ResamplerType type = Audio::kResamplerLinear) {
+		const uint frames = 4000;
+		const Audio::st_volume_t volL = 200, volR = 73;
+
+		// Mix a stream the way RateConverter::flow() does
+		Audio::SeekableAudioStream *s = createSineStream<int16>(inputRate, 1, 0, false, isStereo);
+		Audio::RateConverter *converter = Audio::makeRateConverter(inputRate, outputRate, isStereo, reverseStereo, type);
+		int16 *expected = new int16[frames * 2];
+		memset(expected, 0, frames * 2 * sizeof(int16));
+		const int expectedFrames = converter->flow(*s, expected, frames, volL, volR);
+		delete converter;
+		delete s;
+
+		// ...and the way MixerImpl does
+		s = createSineStream<int16>(inputRate, 1, 0, false, isStereo);
+		converter = Audio::makeRateConverter(inputRate, outputRate, isStereo, reverseStereo, type);
+		int16 *converted = new int16[frames * 2];
+		int32 *acc = new int32[frames * 2];
+		int16 *mixed = new int16[frames * 2];
+		memset(acc, 0, frames * 2 * sizeof(int32));
+		const int convertedFrames = converter->convert(*s, converted, frames);
+		if (isStereo && reverseStereo)
+			Audio::mixAccumulateGeneric(acc, converted, convertedFrames, volR, volL);
+		else
+			Audio::mixAccumulateGeneric(acc, converted, convertedFrames, volL, volR);
+		Audio::mixClampGeneric(mixed, acc, frames * 2);
+		delete converter;
+		delete s;
+
+		TS_ASSERT_EQUALS(convertedFrames, expectedFrames);
+		TS_ASSERT_EQUALS(memcmp(expected, mixed, expectedFrames * 2 * sizeof(int16)), 0);
+
+		delete[] expected;
+		delete[] converted;
+		delete[] acc;
+		delete[] mixed;
+	}
+
+public:
+	void test_kernels() {
+		Common::install_null_g_system();
+
+		kernelTestTemplate(Audio::mixAccumulateGeneric, Audio::mixClampGeneric);
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+			kernelTestTemplate(Audio::mixAccumulateSSE2, Audio::mixClampSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+			kernelTestTemplate(Audio::mixAccumulateAVX2, Audio::mixClampAVX2);
+#endif
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+			kernelTestTemplate(Audio::mixAccumulateNEON, Audio::mixClampNEON);
+#endif
+	}
+
+	void test_convert_matches_flow() {
+		const int outputRate = 22050;
+		// Covers the simple, linear interpolation and copy rate converters
+		const int inputRates[] = { 44100, 11025, 22050 };
+
+		for (uint r = 0; r < ARRAYSIZE(inputRates); ++r) {
+			convertTestTemplate(inputRates[r], outputRate, false, false);
+			convertTestTemplate(inputRates[r], outputRate, true, false);
+			convertTestTemplate(inputRates[r], outputRate, true, true);
+		}
+	}
+
+	void test_dot_product() {
+		Common::install_null_g_system();
+
+		dotProductTestTemplate(Audio::dotProductGeneric);
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+			dotProductTestTemplate(Audio::dotProductSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+			dotProductTestTemplate(Audio::dotProductAVX2);
+#endif
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+			dotProductTestTemplate(Audio::dotProductNEON);
+#endif
+	}
+
+	void test_sinc_convert_matches_flow() {
+		Common::install_null_g_system();
+
+		const int outputRate = 44100;
+		const int inputRates[] = { 22050, 48000, 11025 };
+
+		for (uint r = 0; r < ARRAYSIZE(inputRates); ++r) {
+			convertTestTemplate(inputRates[r], outputRate, false, false, Audio::kResamplerSinc);
+			convertTestTemplate(inputRates[r], outputRate, true, false, Audio::kResamplerSinc);
+			convertTestTemplate(inputRates[r], outputRate, true, true, Audio::kResamplerSinc);
+		}
+	}
+
+	void test_sinc_sine() {
+		Common::install_null_g_system();
+
+		const int inputRates[] = { 22050, 48000 };
+		const int outputRate = 44100;
+
+		for (uint r = 0; r < ARRAYSIZE(inputRates); ++r) {
+			const int inputRate = inputRates[r];
+			Audio::SeekableAudioStream *s = createSineStream<int16>(inputRate, 1, 0, false, false);
+			Audio::RateConverter *converter = Audio::makeRateConverter(inputRate, outputRate, false, false, Audio::kResamplerSinc);
+
+			const uint frames = outputRate + 1024;
+			int16 *out = new int16[frames * 2];
+			const int converted = converter->convert(*s, out, frames);
+
+			// One second of input yields one second of output, including
+			// the filter tail flushed at the end of the stream, give or take
+			// the rounding of the last filter window
+			TS_ASSERT_LESS_THAN_EQUALS(outputRate, converted);
+			TS_ASSERT_LESS_THAN_EQUALS(converted, outputRate + 2);
+
+			// The 1Hz sine keeps its shape and amplitude
+			int16 peak = 0;
+			int maxError = 0;
+			for (int i = 0; i < outputRate - 64; ++i) {
+				const int expected = (int)(sin((double)i / outputRate * 2 * M_PI) * 32767);
+				maxError = MAX(maxError, ABS(out[i * 2] - expected));
+				peak = MAX(peak, out[i * 2]);
+				TS_ASSERT_EQUALS(out[i * 2], out[i * 2 + 1]);
+			}
+			TS_ASSERT_LESS_THAN(32700, peak);
+			TS_ASSERT_LESS_THAN(maxError, 64);
+
+			delete[] out;
+			delete converter;
+			delete s;
+		}
+	}
+
+	void test_channel_table() {
+		Common::install_null_g_system();
+
+		const uint frames = 256;
+		int16 *out = new int16[frames * 2];
+
+		Audio::MixerImpl mixer(22050);
+		Audio::Mixer &base = mixer;
+		mixer.setReady(true);
+
+		Audio::SoundHandle handle, shortHandle;
+		base.playStream(Audio::Mixer::kPlainSoundType, &handle, createConstantStream(1000, 22050, 22050));
+		base.playStream(Audio::Mixer::kPlainSoundType, &shortHandle, createConstantStream(1000, 22050, frames / 2));
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+		TS_ASSERT(mixer.isSoundHandleActive(shortHandle));
+
+		mixer.mixCallback((byte *)out, frames * 4);
+		TS_ASSERT_EQUALS(out[0], 2000);
+		TS_ASSERT_EQUALS(out[frames * 2 - 1], 1000);
+
+		// The callback hands finished channels back to the control functions
+		mixer.mixCallback((byte *)out, frames * 4);
+		TS_ASSERT(!mixer.isSoundHandleActive(shortHandle));
+		TS_ASSERT(mixer.isSoundHandleActive(handle));
+
+		// Volume changes apply to the next callback
+		mixer.setChannelVolume(handle, 0);
+		mixer.mixCallback((byte *)out, frames * 4);
+		TS_ASSERT_EQUALS(out[0], 0);
+		mixer.setChannelVolume(handle, Audio::Mixer::kMaxChannelVolume);
+
+		// Paused channels are not mixed, and do not advance
+		mixer.pauseHandle(handle, true);
+		const int elapsed = mixer.getElapsedTime(handle).totalNumberOfFrames();
+		mixer.mixCallback((byte *)out, frames * 4);
+		TS_ASSERT_EQUALS(out[0], 0);
+		TS_ASSERT_EQUALS(mixer.getElapsedTime(handle).totalNumberOfFrames(), elapsed);
+		mixer.pauseHandle(handle, false);
+		mixer.mixCallback((byte *)out, frames * 4);
+		TS_ASSERT_EQUALS(out[0], 1000);
+
+		mixer.stopHandle(handle);
+		TS_ASSERT(!mixer.isSoundHandleActive(handle));
+		mixer.mixCallback((byte *)out, frames * 4);
+		TS_ASSERT_EQUALS(out[0], 0);
+
+		delete[] out;
+	}
+
+	void test_clamp_after_sum() {
+		const uint frames = 64;
+		int16 *loud = new int16[frames * 2];
+		int16 *inverted = new int16[frames * 2];
+		int32 *acc = new int32[frames * 2];
+		int16 *out = new int16[frames * 2];
+
+		for (uint i = 0; i < frames * 2; ++i) {
+			loud[i] = 30000;
+			inverted[i] = -30000;
+		}
+
+		memset(acc, 0, frames * 2 * sizeof(int32));
+		Audio::mixAccumulateGeneric(acc, loud, frames, 256, 256);
+		Audio::mixAccumulateGeneric(acc, loud, frames, 256, 256);
+		Audio::mixAccumulateGeneric(acc, inverted, frames, 256, 256);
+		Audio::mixClampGeneric(out, acc, frames * 2);
+
+		// Clamping after every channel would leave only 32767 - 30000
+		for (uint i = 0; i < frames * 2; ++i)
+			TS_ASSERT_EQUALS(out[i], 30000);
+
+		delete[] loud;
+		delete[] inverted;
+		delete[] acc;
+		delete[] out;
+	}
+};
@@ -0,0 +1,160 @@
+#include <cxxtest/TestSuite.h>
+
+#include "audio/samplecache.h"
+#include "audio/audiostream.h"
+#include "audio/rate.h"
+
+#include "helper.h"
+#include "../null_osystem.h"
+
+class SampleCacheTestSuite : public CxxTest::TestSuite
+{
+private:
+	/** Compare a stream with the samples it should produce. */
+	static bool readsSamples(Audio::AudioStream *stream, const int16 *expected, int numSamples) {
+		int16 *buffer = new int16[numSamples + 16];
+		const int read = stream->readBuffer(buffer, numSamples + 16);
+		const bool equal = (read == numSamples) && !memcmp(buffer, expected, numSamples * sizeof(int16)) && stream->endOfData();
+		delete[] buffer;
+		return equal;
+	}
+
+public:
+	void test_add_and_get() {
+		Common::install_null_g_system();
+
+		const int rate = 11025;
+		int16 *sine;
+		Audio::SampleCache cache;
+		const Audio::SampleCache::Key key("resource.sfx", 1234);
+
+		TS_ASSERT(!cache.getStream(key));
+
+		Audio::SeekableAudioStream *stream = cache.addStream(key, createSineStream<int16>(rate, 1, &sine, false, true));
+		TS_ASSERT(stream);
+		TS_ASSERT(stream->isStereo());
+		TS_ASSERT_EQUALS(stream->getRate(), rate);
+		TS_ASSERT_EQUALS(stream->getLength().totalNumberOfFrames(), rate);
+		TS_ASSERT(readsSamples(stream, sine, rate * 2));
+		TS_ASSERT_EQUALS(cache.getSize(), (uint32)rate * 2 * sizeof(int16));
+
+		// Replays do not need the decoder anymore
+		Audio::SeekableAudioStream *replay = cache.getStream(key);
+		TS_ASSERT(replay);
+		TS_ASSERT(readsSamples(replay, sine, rate * 2));
+
+		// Seeking and rewinding
+		TS_ASSERT(replay->seek(Audio::Timestamp(0, 5000, rate)));
+		TS_ASSERT(readsSamples(replay, sine + 10000, rate * 2 - 10000));
+		TS_ASSERT(stream->rewind());
+		TS_ASSERT(readsSamples(stream, sine, rate * 2));
+
+		TS_ASSERT(!cache.getStream(Audio::SampleCache::Key("resource.sfx", 1235)));
+		TS_ASSERT(!cache.getStream(Audio::SampleCache::Key("resource.aud", 1234)));
+
+		delete stream;
+		delete replay;
+		delete[] sine;
+	}
+
+	void test_lru_eviction() {
+		Common::install_null_g_system();
+
+		const int rate = 1000;
+		const uint32 soundSize = rate * sizeof(int16);
+		Audio::SampleCache cache(soundSize * 2);
+		const Audio::SampleCache::Key key1("a", 0), key2("b", 0), key3("c", 0);
+
+		delete cache.addStream(key1, createSineStream<int16>(rate, 1, 0, false, false));
+		delete cache.addStream(key2, createSineStream<int16>(rate, 1, 0, false, false));
+
+		// Use the first sound, so the second one is the least recently used
+		Audio::SeekableAudioStream *playing = cache.getStream(key1);
+		delete cache.getStream(key2);
+		delete playing;
+		playing = cache.getStream(key1);
+
+		delete cache.addStream(key3, createSineStream<int16>(rate, 1, 0, false, false));
+		TS_ASSERT(cache.isCached(key1));
+		TS_ASSERT(!cache.isCached(key2));
+		TS_ASSERT(cache.isCached(key3));
+		TS_ASSERT_EQUALS(cache.getSize(), soundSize * 2);
+
+		// Evicted sounds keep playing
+		cache.setBudget(0);
+		TS_ASSERT(!cache.isCached(key1));
+		TS_ASSERT_EQUALS(cache.getSize(), 0u);
+
+		int16 *sine = createSine<int16>(rate, 1);
+		TS_ASSERT(readsSamples(playing, sine, rate));
+		free(sine);
+		delete playing;
+
+		// Sounds larger than the budget are only streamed
+		Audio::SeekableAudioStream *stream = cache.addStream(key1, createSineStream<int16>(rate, 1, 0, false, false));
+		TS_ASSERT(stream);
+		TS_ASSERT(!cache.isCached(key1));
+		delete stream;
+	}
+
+	void test_prefetch() {
+		Common::install_null_g_system();
+
+		const int rate = 22050;
+		int16 *sine;
+		Audio::SampleCache cache;
+		const Audio::SampleCache::Key key("sfx.ogg", 0);
+
+		cache.prefetch(key, createSineStream<int16>(rate, 2, &sine, false, false));
+		// Without a timer manager, nothing is decoded in the background
+		TS_ASSERT(!cache.isCached(key));
+
+		// Queueing the same sound again is ignored
+		cache.prefetch(key, createSineStream<int16>(rate, 1, 0, false, false));
+
+		Audio::SeekableAudioStream *stream = cache.getStream(key);
+		TS_ASSERT(stream);
+		TS_ASSERT(cache.isCached(key));
+		TS_ASSERT(readsSamples(stream, sine, rate * 2));
+
+		delete stream;
+		delete[] sine;
+	}
+
+	void test_read_past_end() {
+		Common::install_null_g_system();
+
+		const int rate = 11025;
+		int16 *sine;
+		Audio::SampleCache cache;
+		const Audio::SampleCache::Key key("resource.sfx", 0);
+
+		Audio::SeekableAudioStream *stream = cache.addStream(key, createSineStream<int16>(rate, 1, &sine, false, false));
+		TS_ASSERT(readsSamples(stream, sine, rate));
+
+		int16 buffer[16];
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, 16), 0);
+		TS_ASSERT(stream->seek(Audio::Timestamp(0, rate, rate)));
+		TS_ASSERT_EQUALS(stream->readBuffer(buffer, 16), 0);
+		delete stream;
+
+		// Rate converters read again after the end of the stream
+		for (int type = Audio::kResamplerLinear; type <= Audio::kResamplerSinc; type++) {
+			stream = cache.getStream(key);
+			TS_ASSERT(stream);
+			Audio::RateConverter *converter = Audio::makeRateConverter(rate, 22050, false, false, (Audio::ResamplerType)type);
+
+			Audio::st_sample_t output[1024];
+			for (int i = 0; i < 64; i++) {
+				memset(output, 0, sizeof(output));
+				converter->flow(*stream, output, 512, Audio::Mixer::kMaxMixerVolume, Audio::Mixer::kMaxMixerVolume);
+			}
+			TS_ASSERT(stream->endOfData());
+
+			delete converter;
+			delete stream;
+		}
+
+		delete[] sine;
+	}
+};
@@ -0,0 +1,104 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+#include "engines/ags/lib/allegro/surface_kernels.h"
+
+#include "../../null_osystem.h"
+
+/**
+ * Test suite for the SIMD alpha blending row kernels of the AGS BITMAP
+ * drawing code in engines/ags/lib/allegro/surface_kernels.h. The kernels must
+ * give exactly the same pixels as rgbBlendPixel, which is what BITMAP::rgbBlend
+ * computes.
+ */
+class AGSSurfaceKernelsTestSuite : public CxxTest::TestSuite {
+	static const int kMaxWidth = 67;
+
+	uint32 _seed;
+
+	uint32 nextRandom() {
+		_seed = _seed * 1103515245 + 12345;
+		const uint32 low = _seed >> 16;
+		_seed = _seed * 1103515245 + 12345;
+		return low | ((_seed >> 16) << 16);
+	}
+
+	static void blendRowGeneric(uint32 *dest, const uint32 *src, int width, int srcStep, const AGS3::RgbBlendRowArgs &args) {
+		for (int x = 0; x < width; ++x, src += srcStep) {
+			if (args.skipTrans && (*src & args.transMask) == args.transColor)
+				continue;
+			dest[x] = AGS3::rgbBlendPixel(*src, dest[x], args);
+		}
+	}
+
+	void kernelTestTemplate(AGS3::RgbBlendRowProc proc) {
+		uint32 src[kMaxWidth], expected[kMaxWidth], result[kMaxWidth];
+
+		// ARGB and ABGR formats with alpha in the top byte, RGBA with alpha
+		// in the bottom byte
+		static const uint32 shifts[3][4] = {
+			{ 16, 8, 0, 24 },
+			{ 0, 8, 16, 24 },
+			{ 24, 16, 8, 0 }
+		};
+
+		for (int format = 0; format < 3; ++format) {
+			for (int blender = 0; blender < 4; ++blender) {
+				for (int width = 0; width <= kMaxWidth; width += (width < 20) ? 1 : 7) {
+					AGS3::RgbBlendRowArgs args;
+					args.rShift = shifts[format][0];
+					args.gShift = shifts[format][1];
+					args.bShift = shifts[format][2];
+					args.aShift = shifts[format][3];
+					// The blenders set up by BITMAP::drawInner: source alpha,
+					// source alpha scaled by the blender alpha, blender alpha
+					// only, and the latter preserving the destination alpha
+					const uint32 blenderAlpha = nextRandom() & 0xff;
+					args.alphaOr = (blender >= 2) ? 0xff : 0;
+					args.alphaMul = (blender == 0) ? 256 : blenderAlpha + 1;
+					args.destKeepMask = (blender == 3) ? 0xffu << args.aShift : 0;
+					args.skipTrans = (width & 1);
+					args.transMask = 0xffffffu << (args.aShift ? 0 : 8);
+					args.transColor = 0xff00ffu << (args.aShift ? 0 : 8);
+
+					for (int i = 0; i < kMaxWidth; ++i) {
+						src[i] = nextRandom();
+						// Fully transparent and fully opaque pixels take other
+						// paths in some kernels
+						if ((nextRandom() & 7) == 0)
+							src[i] &= ~(0xffu << args.aShift);
+						else if ((nextRandom() & 7) == 0)
+							src[i] |= 0xffu << args.aShift;
+						if (args.skipTrans && (nextRandom() & 3) == 0)
+							src[i] = (src[i] & ~args.transMask) | args.transColor;
+						expected[i] = result[i] = nextRandom();
+					}
+
+					for (int srcStep = 1; srcStep >= -1; srcStep -= 2) {
+						const uint32 *first = (srcStep > 0) ? src : src + width - 1;
+						blendRowGeneric(expected, first, width, srcStep, args);
+						proc(result, first, width, srcStep, args);
+						TS_ASSERT_EQUALS(memcmp(expected, result, sizeof(expected)), 0);
+					}
+				}
+			}
+		}
+	}
+
+public:
+	AGSSurfaceKernelsTestSuite() : _seed(0x13579bdf) {
+	}
+
+	void test_kernels() {
+		Common::install_null_g_system();
+
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+			kernelTestTemplate(AGS3::rgbBlendRowSSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+			kernelTestTemplate(AGS3::rgbBlendRowAVX2);
+#endif
+	}
+};
@@ -0,0 +1,114 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "engines/detectioncache.h"
+
+/**
+ * Test suite for the detection cache in engines/detectioncache.h
+ */
+class DetectionCacheTestSuite : public CxxTest::TestSuite {
+	static FileProperties makeProperties(const char *md5, int32 size) {
+		FileProperties fileProps;
+		fileProps.md5 = md5;
+		fileProps.size = size;
+		return fileProps;
+	}
+
+	static void storeFile(const Common::String &path, const char *md5) {
+		DetectionCacheMan.store("5000:" + path, path, "100:1234", makeProperties(md5, 100));
+	}
+
+	static bool hasFile(const Common::String &path) {
+		FileProperties fileProps;
+		return DetectionCacheMan.lookup("5000:" + path, "100:1234", fileProps);
+	}
+
+	public:
+	void test_round_trip() {
+		DetectionCacheMan.clear();
+		DetectionCacheMan.store("5000:/games/monkey/000.lfl", "/games/monkey/000.lfl", "8357:1600000000", makeProperties("2d1e891fe52df707c30185e52c50cd92", 8357));
+		DetectionCacheMan.store("rsrc:0:/games/loom/Loom", "/games/loom/Loom", "Loom.rsrc=12:34;", makeProperties("r:a0e5e6f1e0c4d8a4d3c4e6a4d5c6b7a8", 1234567));
+		DetectionCacheMan.store("5000:/games/empty", "/games/empty", "0:0", makeProperties("", 0));
+
+		Common::MemoryWriteStreamDynamic writeStream(DisposeAfterUse::YES);
+		DetectionCacheMan.saveToStream(writeStream);
+
+		DetectionCacheMan.clear();
+		TS_ASSERT_EQUALS(DetectionCacheMan.size(), 0u);
+
+		Common::MemoryReadStream readStream(writeStream.getData(), writeStream.size());
+		TS_ASSERT(DetectionCacheMan.loadFromStream(readStream));
+		TS_ASSERT_EQUALS(DetectionCacheMan.size(), 3u);
+
+		FileProperties fileProps;
+		TS_ASSERT(DetectionCacheMan.lookup("5000:/games/monkey/000.lfl", "8357:1600000000", fileProps));
+		TS_ASSERT_EQUALS(fileProps.md5, "2d1e891fe52df707c30185e52c50cd92");
+		TS_ASSERT_EQUALS(fileProps.size, 8357);
+
+		TS_ASSERT(DetectionCacheMan.lookup("rsrc:0:/games/loom/Loom", "Loom.rsrc=12:34;", fileProps));
+		TS_ASSERT_EQUALS(fileProps.md5, "r:a0e5e6f1e0c4d8a4d3c4e6a4d5c6b7a8");
+		TS_ASSERT_EQUALS(fileProps.size, 1234567);
+
+		TS_ASSERT(DetectionCacheMan.lookup("5000:/games/empty", "0:0", fileProps));
+		TS_ASSERT_EQUALS(fileProps.md5, "");
+		TS_ASSERT_EQUALS(fileProps.size, 0);
+
+		// A file which changed since its properties were stored
+		TS_ASSERT(!DetectionCacheMan.lookup("5000:/games/monkey/000.lfl", "8357:1600000001", fileProps));
+		TS_ASSERT(!DetectionCacheMan.lookup("5000:/games/monkey/001.lfl", "8357:1600000000", fileProps));
+	}
+
+	void test_truncated() {
+		DetectionCacheMan.clear();
+		storeFile("/games/monkey/000.lfl", "2d1e891fe52df707c30185e52c50cd92");
+		storeFile("/games/monkey/901.lfl", "3a03dab514e4038df192d8a8de469788");
+
+		Common::MemoryWriteStreamDynamic writeStream(DisposeAfterUse::YES);
+		DetectionCacheMan.saveToStream(writeStream);
+
+		for (int32 size = 0; size < writeStream.size(); size++) {
+			Common::MemoryReadStream readStream(writeStream.getData(), size);
+			TS_ASSERT(!DetectionCacheMan.loadFromStream(readStream));
+			TS_ASSERT_EQUALS(DetectionCacheMan.size(), 0u);
+		}
+
+		// Another format version
+		Common::MemoryWriteStreamDynamic otherStream(DisposeAfterUse::YES);
+		otherStream.write(writeStream.getData(), writeStream.size());
+		otherStream.getData()[7]++;
+		Common::MemoryReadStream readStream(otherStream.getData(), otherStream.size());
+		TS_ASSERT(!DetectionCacheMan.loadFromStream(readStream));
+	}
+
+	void test_prune() {
+		DetectionCacheMan.clear();
+		storeFile("/games/monkey/000.lfl", "2d1e891fe52df707c30185e52c50cd92");
+		storeFile("/games/monkey/901.lfl", "3a03dab514e4038df192d8a8de469788");
+		storeFile("/games/monkey/data/disk1.lec", "8eb84cee9b429314c7f0bdcf560723eb");
+		storeFile("/games/monkey2/000.lfl", "3686cf8f89e102ececf4366e1d2c8126");
+		storeFile("/other/sky.dsk", "c3e0ea7ef1c7f6ab8f38f9d2f1d5d8c2");
+
+		// Without a scan, nothing is dropped
+		DetectionCacheMan.finishScan("/games/monkey");
+		TS_ASSERT_EQUALS(DetectionCacheMan.size(), 5u);
+
+		// 901.lfl and disk1.lec are gone, the other directories were not scanned
+		DetectionCacheMan.startScan();
+		TS_ASSERT(hasFile("/games/monkey/000.lfl"));
+		DetectionCacheMan.finishScan("/games/monkey/");
+		TS_ASSERT_EQUALS(DetectionCacheMan.size(), 3u);
+		TS_ASSERT(hasFile("/games/monkey/000.lfl"));
+		TS_ASSERT(!hasFile("/games/monkey/901.lfl"));
+		TS_ASSERT(!hasFile("/games/monkey/data/disk1.lec"));
+		TS_ASSERT(hasFile("/games/monkey2/000.lfl"));
+		TS_ASSERT(hasFile("/other/sky.dsk"));
+
+		// Entries stored during the scan are kept
+		DetectionCacheMan.startScan();
+		storeFile("/games/monkey2/001.lfl", "4d34e4a3e3d5a3f1c7e0f2b6a8c9d0e1");
+		DetectionCacheMan.finishScan("/games");
+		TS_ASSERT_EQUALS(DetectionCacheMan.size(), 2u);
+		TS_ASSERT(hasFile("/games/monkey2/001.lfl"));
+		TS_ASSERT(hasFile("/other/sky.dsk"));
+	}
+};
@@ -0,0 +1,259 @@
+#include <cxxtest/TestSuite.h>
+#include "engines/sci/engine/gc_marker.h"
+
+/**
+ * Test suite for the snapshot-at-the-beginning marker of the SCI incremental
+ * garbage collector in engines/sci/engine/gc_marker.h
+ */
+
+struct GCMarkerTestHeap {
+	typedef uint Ref;
+	struct RefHash {
+		uint operator()(uint x) const { return x; }
+	};
+
+	// Object 0 stands for numbers
+	Common::Array<Common::Array<uint> > _objects;
+	Common::Array<bool> _freed;
+
+	GCMarkerTestHeap() {
+		_objects.resize(1);
+		_freed.push_back(false);
+	}
+
+	bool isReference(uint ref) const { return ref != 0; }
+
+	void listOutgoingReferences(uint ref, Common::Array<uint> &refs) const {
+		if (!_freed[ref])
+			refs = _objects[ref];
+	}
+
+	uint allocate(uint fields) {
+		_objects.push_back(Common::Array<uint>());
+		_objects.back().resize(fields);
+		for (uint i = 0; i < fields; ++i)
+			_objects.back()[i] = 0;
+		_freed.push_back(false);
+		return _objects.size() - 1;
+	}
+
+	Common::Array<bool> reachableFrom(const Common::Array<uint> &roots) const {
+		Common::Array<bool> reachable;
+		reachable.resize(_objects.size());
+		for (uint i = 0; i < reachable.size(); ++i)
+			reachable[i] = false;
+
+		Common::Array<uint> worklist = roots;
+		while (!worklist.empty()) {
+			const uint ref = worklist.back();
+			worklist.pop_back();
+			if (!ref || reachable[ref] || _freed[ref])
+				continue;
+			reachable[ref] = true;
+			for (uint i = 0; i < _objects[ref].size(); ++i)
+				worklist.push_back(_objects[ref][i]);
+		}
+		return reachable;
+	}
+};
+
+typedef Sci::SnapshotMarker<GCMarkerTestHeap> GCTestMarker;
+
+class SciGCMarkerTestSuite : public CxxTest::TestSuite {
+	uint32 _seed;
+
+	uint nextRandom(uint max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) % max;
+	}
+
+	uint randomReachable(const Common::Array<bool> &reachable) {
+		for (;;) {
+			const uint ref = nextRandom(reachable.size());
+			if (reachable[ref])
+				return ref;
+		}
+	}
+
+	void buildHeap(GCMarkerTestHeap &heap, uint count, uint fields) {
+		for (uint i = 0; i < count; ++i)
+			heap.allocate(fields);
+		for (uint i = 1; i <= count; ++i)
+			for (uint j = 0; j < fields; ++j)
+				heap._objects[i][j] = nextRandom(3) ? nextRandom(count + 1) : 0;
+	}
+
+	void startCycle(GCTestMarker &marker, const Common::Array<uint> &roots) {
+		marker.start();
+		for (uint i = 0; i < roots.size(); ++i)
+			marker.shade(roots[i]);
+	}
+
+	public:
+	SciGCMarkerTestSuite() : _seed(1) {
+	}
+
+	void test_mark_without_mutation() {
+		GCMarkerTestHeap heap;
+		buildHeap(heap, 100, 3);
+		Common::Array<uint> roots;
+		roots.push_back(1);
+		roots.push_back(2);
+
+		GCTestMarker marker(heap);
+		startCycle(marker, roots);
+		while (!marker.step(5))
+			;
+
+		const Common::Array<bool> reachable = heap.reachableFrom(roots);
+		for (uint i = 1; i < reachable.size(); ++i)
+			TS_ASSERT_EQUALS(marker.isMarked(i), reachable[i]);
+	}
+
+	void test_snapshot_invariant() {
+		for (uint run = 0; run < 20; ++run) {
+			GCMarkerTestHeap heap;
+			buildHeap(heap, 200, 4);
+
+			// The registers are scanned when the cycle starts, like the stack,
+			// and are written to without barriers. The first one always keeps
+			// object 1, which is never freed.
+			Common::Array<uint> registers;
+			registers.push_back(1);
+			for (uint i = 0; i < 3; ++i)
+				registers.push_back(nextRandom(10) + 1);
+
+			GCTestMarker marker(heap);
+			startCycle(marker, registers);
+			const Common::Array<bool> snapshot = heap.reachableFrom(registers);
+			Common::Array<uint> allocated;
+
+			while (!marker.step(nextRandom(4))) {
+				const Common::Array<bool> reachable = heap.reachableFrom(registers);
+				const uint object = randomReachable(reachable);
+				Common::Array<uint> &fields = heap._objects[object];
+
+				switch (nextRandom(5)) {
+				case 0: {
+					// Store a reachable reference, with a barrier
+					const uint field = nextRandom(fields.size());
+					marker.shade(fields[field]);
+					fields[field] = randomReachable(reachable);
+					break;
+				}
+				case 1:
+					// Load a reference into a register
+					if (fields[0])
+						registers[1 + nextRandom(registers.size() - 1)] = fields[0];
+					break;
+				case 2: {
+					// Modify an object without barriers, after scanning it
+					marker.scan(object);
+					for (uint i = 0; i < fields.size(); ++i)
+						fields[i] = nextRandom(2) ? randomReachable(reachable) : 0;
+					break;
+				}
+				case 3: {
+					// Allocate an object and link it
+					const uint created = heap.allocate(2);
+					marker.allocated(created);
+					allocated.push_back(created);
+					heap._objects[created][0] = randomReachable(reachable);
+					const uint field = nextRandom(heap._objects[object].size());
+					marker.shade(heap._objects[object][field]);
+					heap._objects[object][field] = created;
+					break;
+				}
+				default: {
+					// Unlink an object and free it explicitly
+					const uint victim = fields[0];
+					if (!victim || victim <= 10)
+						break;
+					for (uint i = 1; i < heap._objects.size(); ++i) {
+						for (uint j = 0; j < heap._objects[i].size(); ++j) {
+							if (heap._objects[i][j] == victim) {
+								marker.shade(heap._objects[i][j]);
+								heap._objects[i][j] = 0;
+							}
+						}
+					}
+					for (uint i = 0; i < registers.size(); ++i) {
+						if (registers[i] == victim)
+							registers[i] = 0;
+					}
+					marker.scan(victim);
+					heap._freed[victim] = true;
+					break;
+				}
+				}
+			}
+
+			// Everything reachable when the cycle started, everything allocated
+			// since then and everything reachable now must be kept
+			const Common::Array<bool> reachable = heap.reachableFrom(registers);
+			for (uint i = 1; i < heap._objects.size(); ++i) {
+				if (i < snapshot.size() && snapshot[i])
+					TS_ASSERT(marker.isMarked(i));
+				if (reachable[i])
+					TS_ASSERT(marker.isMarked(i));
+			}
+			for (uint i = 0; i < allocated.size(); ++i)
+				TS_ASSERT(marker.isMarked(allocated[i]));
+		}
+	}
+
+	void test_missing_barrier_loses_object() {
+		// 1 -> 2 -> 3, with 4 as a second root
+		GCMarkerTestHeap heap;
+		for (uint i = 0; i < 4; ++i)
+			heap.allocate(1);
+		heap._objects[1][0] = 2;
+		heap._objects[2][0] = 3;
+
+		Common::Array<uint> roots;
+		roots.push_back(1);
+		roots.push_back(4);
+
+		GCTestMarker marker(heap);
+		startCycle(marker, roots);
+		// Blacken 4, then move 3 from the white object 2 into it
+		marker.step(1);
+		heap._objects[4][0] = 3;
+		heap._objects[2][0] = 0;
+		while (!marker.step(1))
+			;
+		TS_ASSERT(!marker.isMarked(3));
+
+		// The same mutation with a barrier keeps 3
+		heap._objects[2][0] = 3;
+		heap._objects[4][0] = 0;
+		startCycle(marker, roots);
+		marker.step(1);
+		heap._objects[4][0] = 3;
+		marker.shade(heap._objects[2][0]);
+		heap._objects[2][0] = 0;
+		while (!marker.step(1))
+			;
+		TS_ASSERT(marker.isMarked(3));
+	}
+
+	void test_stop() {
+		GCMarkerTestHeap heap;
+		buildHeap(heap, 10, 2);
+		Common::Array<uint> roots;
+		roots.push_back(1);
+
+		GCTestMarker marker(heap);
+		startCycle(marker, roots);
+		TS_ASSERT(marker.isMarking());
+		marker.stop();
+		TS_ASSERT(!marker.isMarking());
+		TS_ASSERT(!marker.isMarked(1));
+
+		// Nothing is marked outside of a cycle
+		marker.shade(1);
+		marker.allocated(2);
+		marker.scan(3);
+		TS_ASSERT(marker.getMarked().empty());
+	}
+};
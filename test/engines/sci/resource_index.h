@@ -0,0 +1,106 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/memstream.h"
+#include "engines/sci/resource/resource_index.h"
+
+/**
+ * Test suite for the persistent index of the SCI audio map scans in
+ * engines/sci/resource/resource_index.h
+ */
+class SciResourceIndexTestSuite : public CxxTest::TestSuite {
+	static Sci::ResourceIndexEntry makeEntry(const Sci::ResourceId &id, bool existed, bool updated, uint32 fileOffset, uint32 size) {
+		Sci::ResourceIndexEntry entry;
+		entry.id = id;
+		entry.existed = existed;
+		entry.updated = updated;
+		entry.fileOffset = fileOffset;
+		entry.size = size;
+		return entry;
+	}
+
+	static Sci::ResourceIndex::EntryList makeScan() {
+		Sci::ResourceIndex::EntryList entries;
+		entries.push_back(makeEntry(Sci::ResourceId(Sci::kResourceTypeSync36, 140, 0x01020304), false, true, 1000, 86));
+		entries.push_back(makeEntry(Sci::ResourceId(Sci::kResourceTypeAudio36, 140, 0x01020304), false, true, 1086, 0));
+		entries.push_back(makeEntry(Sci::ResourceId(Sci::kResourceTypeAudio36, 140, 0xfffefd00), true, false, 0, 0));
+		entries.push_back(makeEntry(Sci::ResourceId(Sci::kResourceTypeAudio, 3), true, true, 0xfffffff0, 0x12345678));
+		return entries;
+	}
+
+	static void checkScan(const Sci::ResourceIndex::EntryList *entries) {
+		const Sci::ResourceIndex::EntryList expected = makeScan();
+		TS_ASSERT(entries);
+		if (!entries)
+			return;
+
+		TS_ASSERT_EQUALS(entries->size(), expected.size());
+		for (uint i = 0; i < entries->size() && i < expected.size(); i++) {
+			TS_ASSERT((*entries)[i].id == expected[i].id);
+			TS_ASSERT_EQUALS((*entries)[i].existed, expected[i].existed);
+			TS_ASSERT_EQUALS((*entries)[i].updated, expected[i].updated);
+			TS_ASSERT_EQUALS((*entries)[i].fileOffset, expected[i].fileOffset);
+			TS_ASSERT_EQUALS((*entries)[i].size, expected[i].size);
+		}
+	}
+
+	public:
+	void test_round_trip() {
+		Sci::ResourceIndex index;
+		index.store("RESSCI.000|RESOURCE.AUD|140|0", "2048:1600000000|81920:1600000000", makeScan());
+		index.store("RESSCI.000|RESOURCE.AUD|141|0", "2048:1600000000|81920:1600000000", Sci::ResourceIndex::EntryList());
+
+		Common::MemoryWriteStreamDynamic writeStream(DisposeAfterUse::YES);
+		index.saveToStream(writeStream);
+
+		Sci::ResourceIndex loaded;
+		Common::MemoryReadStream readStream(writeStream.getData(), writeStream.size());
+		TS_ASSERT(loaded.loadFromStream(readStream));
+		TS_ASSERT_EQUALS(loaded.size(), 2u);
+
+		checkScan(loaded.lookup("RESSCI.000|RESOURCE.AUD|140|0", "2048:1600000000|81920:1600000000"));
+
+		const Sci::ResourceIndex::EntryList *entries = loaded.lookup("RESSCI.000|RESOURCE.AUD|141|0", "2048:1600000000|81920:1600000000");
+		TS_ASSERT(entries);
+		TS_ASSERT(entries && entries->empty());
+	}
+
+	void test_changed_files() {
+		Sci::ResourceIndex index;
+		index.store("RESSCI.000|RESOURCE.AUD|140|0", "2048:1600000000|81920:1600000000", makeScan());
+
+		// The map or the volume were modified, or have another size
+		TS_ASSERT(!index.lookup("RESSCI.000|RESOURCE.AUD|140|0", "2048:1600000001|81920:1600000000"));
+		TS_ASSERT(!index.lookup("RESSCI.000|RESOURCE.AUD|140|0", "2048:1600000000|81920:1600000002"));
+		TS_ASSERT(!index.lookup("RESSCI.000|RESOURCE.AUD|140|0", "2049:1600000000|81920:1600000000"));
+		TS_ASSERT(!index.lookup("RESSCI.000|RESOURCE.AUD|141|0", "2048:1600000000|81920:1600000000"));
+
+		// Scanning the files again replaces the stored scan
+		index.store("RESSCI.000|RESOURCE.AUD|140|0", "2048:1600000001|81920:1600000000", makeScan());
+		TS_ASSERT_EQUALS(index.size(), 1u);
+		TS_ASSERT(!index.lookup("RESSCI.000|RESOURCE.AUD|140|0", "2048:1600000000|81920:1600000000"));
+		checkScan(index.lookup("RESSCI.000|RESOURCE.AUD|140|0", "2048:1600000001|81920:1600000000"));
+	}
+
+	void test_truncated() {
+		Sci::ResourceIndex index;
+		index.store("RESSCI.000|RESOURCE.AUD|140|0", "2048:1600000000|81920:1600000000", makeScan());
+		index.store("RESSCI.000|RESOURCE.AUD|141|0", "2048:1600000000|81920:1600000000", makeScan());
+
+		Common::MemoryWriteStreamDynamic writeStream(DisposeAfterUse::YES);
+		index.saveToStream(writeStream);
+
+		for (int32 size = 0; size < writeStream.size(); size++) {
+			Common::MemoryReadStream readStream(writeStream.getData(), size);
+			TS_ASSERT(!index.loadFromStream(readStream));
+			TS_ASSERT_EQUALS(index.size(), 0u);
+		}
+
+		// Another format version
+		Common::MemoryWriteStreamDynamic otherStream(DisposeAfterUse::YES);
+		otherStream.write(writeStream.getData(), writeStream.size());
+		otherStream.getData()[7]++;
+		Common::MemoryReadStream readStream(otherStream.getData(), otherStream.size());
+		TS_ASSERT(!index.loadFromStream(readStream));
+		TS_ASSERT_EQUALS(index.size(), 0u);
+	}
+};
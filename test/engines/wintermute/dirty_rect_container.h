@@ -0,0 +1,170 @@
+#include <cxxtest/TestSuite.h>
+#include "engines/wintermute/base/gfx/osystem/dirty_rect_container.h"
+
+/**
+ * Test suite for the dirty rectangles of the software renderer in
+ * engines/wintermute/base/gfx/osystem/dirty_rect_container.h
+ *
+ * The rectangles are checked against a mask of the pixels which were
+ * marked as dirty.
+ */
+
+class DirtyRectContainerTestSuite : public CxxTest::TestSuite {
+	enum {
+		kScreenWidth = 320,
+		kScreenHeight = 200
+	};
+
+	uint32 _seed;
+	bool _dirty[kScreenHeight][kScreenWidth];
+	byte _coverage[kScreenHeight][kScreenWidth];
+
+	uint nextRandom(uint max) {
+		_seed = _seed * 1103515245 + 12345;
+		return (_seed >> 16) % max;
+	}
+
+	Common::Rect randomRect(uint maxSize) {
+		// Some rectangles stick out of the screen, to exercise the clipping
+		const int16 left = (int16)nextRandom(kScreenWidth + 20) - 10;
+		const int16 top = (int16)nextRandom(kScreenHeight + 20) - 10;
+		const int16 width = (int16)nextRandom(maxSize) + 1;
+		const int16 height = (int16)nextRandom(maxSize) + 1;
+		return Common::Rect(left, top, left + width, top + height);
+	}
+
+	void clearMask() {
+		for (int y = 0; y < kScreenHeight; ++y)
+			for (int x = 0; x < kScreenWidth; ++x)
+				_dirty[y][x] = false;
+	}
+
+	void markMask(const Common::Rect &rect, const Common::Rect &clipRect) {
+		Common::Rect clipped(rect);
+		clipped.clip(clipRect);
+		if (clipped.isEmpty())
+			return;
+		for (int y = clipped.top; y < clipped.bottom; ++y)
+			for (int x = clipped.left; x < clipped.right; ++x)
+				_dirty[y][x] = true;
+	}
+
+	/**
+	 * The rectangles must be disjoint, stay inside the clipping rectangle and
+	 * the bounding box of the dirty pixels, and cover every dirty pixel.
+	 */
+	void checkRects(const Wintermute::DirtyRectContainer &container, const Common::Rect &clipRect) {
+		const Common::Array<Common::Rect> &rects = container.getRects();
+		TS_ASSERT(rects.size() <= 32);
+
+		Common::Rect boundingBox;
+		bool anyDirty = false;
+		for (int y = 0; y < kScreenHeight; ++y) {
+			for (int x = 0; x < kScreenWidth; ++x) {
+				if (!_dirty[y][x])
+					continue;
+				const Common::Rect pixel(x, y, x + 1, y + 1);
+				if (anyDirty)
+					boundingBox.extend(pixel);
+				else
+					boundingBox = pixel;
+				anyDirty = true;
+			}
+		}
+		TS_ASSERT_EQUALS(container.isEmpty(), !anyDirty);
+
+		for (int y = 0; y < kScreenHeight; ++y)
+			for (int x = 0; x < kScreenWidth; ++x)
+				_coverage[y][x] = 0;
+
+		for (uint i = 0; i < rects.size(); ++i) {
+			const Common::Rect &rect = rects[i];
+			TS_ASSERT(!rect.isEmpty());
+			TS_ASSERT(clipRect.contains(rect));
+			TS_ASSERT(boundingBox.contains(rect));
+			if (!clipRect.contains(rect))
+				continue;
+			for (int y = rect.top; y < rect.bottom; ++y)
+				for (int x = rect.left; x < rect.right; ++x)
+					++_coverage[y][x];
+		}
+
+		uint uncovered = 0, overlapping = 0;
+		for (int y = 0; y < kScreenHeight; ++y) {
+			for (int x = 0; x < kScreenWidth; ++x) {
+				if (_dirty[y][x] && !_coverage[y][x])
+					++uncovered;
+				if (_coverage[y][x] > 1)
+					++overlapping;
+			}
+		}
+		TS_ASSERT_EQUALS(uncovered, 0u);
+		TS_ASSERT_EQUALS(overlapping, 0u);
+	}
+
+	public:
+	DirtyRectContainerTestSuite() : _seed(1) {
+	}
+
+	void test_single_rect() {
+		const Common::Rect clipRect(kScreenWidth, kScreenHeight);
+		Wintermute::DirtyRectContainer container;
+		TS_ASSERT(container.isEmpty());
+
+		container.addDirtyRect(Common::Rect(-5, -5, 10, 10), clipRect);
+		TS_ASSERT_EQUALS(container.getRects().size(), 1u);
+		TS_ASSERT_EQUALS(container.getRects()[0], Common::Rect(0, 0, 10, 10));
+
+		// Rectangles outside of the clipping rectangle are dropped
+		container.addDirtyRect(Common::Rect(kScreenWidth, 0, kScreenWidth + 10, 10), clipRect);
+		TS_ASSERT_EQUALS(container.getRects().size(), 1u);
+
+		container.reset();
+		TS_ASSERT(container.isEmpty());
+	}
+
+	void test_disjoint_cover() {
+		for (uint run = 0; run < 200; ++run) {
+			// Half of the runs clip to a part of the screen only
+			Common::Rect clipRect(kScreenWidth, kScreenHeight);
+			if (run & 1)
+				clipRect = Common::Rect(17, 5, kScreenWidth - 23, kScreenHeight - 9);
+
+			Wintermute::DirtyRectContainer container;
+			clearMask();
+
+			// Large rectangles get merged, small ones mostly get split
+			const uint maxSize = (run % 4 < 2) ? 160 : 24;
+			const uint count = nextRandom(40) + 1;
+			for (uint i = 0; i < count; ++i) {
+				const Common::Rect rect = randomRect(maxSize);
+				container.addDirtyRect(rect, clipRect);
+				markMask(rect, clipRect);
+				checkRects(container, clipRect);
+			}
+		}
+	}
+
+	void test_collapse() {
+		// Lines which are too far apart to be merged
+		const Common::Rect clipRect(kScreenWidth, kScreenHeight);
+		Wintermute::DirtyRectContainer container;
+		clearMask();
+
+		for (int i = 0; i < 32; ++i) {
+			const Common::Rect rect(0, i * 6, kScreenWidth, i * 6 + 1);
+			container.addDirtyRect(rect, clipRect);
+			markMask(rect, clipRect);
+		}
+		checkRects(container, clipRect);
+		TS_ASSERT_EQUALS(container.getRects().size(), 32u);
+
+		// One more collapses them into their bounding box
+		const Common::Rect last(kScreenWidth - 1, kScreenHeight - 1, kScreenWidth, kScreenHeight);
+		container.addDirtyRect(last, clipRect);
+		markMask(last, clipRect);
+		checkRects(container, clipRect);
+		TS_ASSERT_EQUALS(container.getRects().size(), 1u);
+		TS_ASSERT_EQUALS(container.getRects()[0], Common::Rect(0, 0, kScreenWidth, kScreenHeight));
+	}
+};
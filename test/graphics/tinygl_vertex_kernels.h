@@ -0,0 +1,142 @@
+#include <cxxtest/TestSuite.h>
+
+#include "common/system.h"
+
+#ifdef USE_TINYGL
+#include "graphics/tinygl/vertex_kernels.h"
+#endif
+
+#include "../null_osystem.h"
+
+class TinyGLVertexKernelsTestSuite : public CxxTest::TestSuite
+{
+#ifdef USE_TINYGL
+private:
+	// Use an odd number of vertices per SIMD block to exercise the tail handling
+	static const int kCount = 8 * 13 + 5;
+
+	static void fillRandom(float *data, int size, float scale, uint32 &seed) {
+		for (int i = 0; i < size; ++i) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = ((float)((seed >> 8) & 0xffff) / 32768.0f - 1.0f) * scale;
+		}
+	}
+
+	static void fillMatrix(TinyGL::Matrix4 &m, uint32 &seed) {
+		fillRandom(&m._m[0][0], 16, 2.0f, seed);
+	}
+
+	static void initLight(TinyGL::LightKernelParams &light, bool infinite, bool spot, float spotExponent, bool twoSide) {
+		for (int i = 0; i < 3; ++i) {
+			light.ambient[i] = 0.05f * (i + 1);
+			light.diffuse[i] = 0.9f - 0.2f * i;
+			light.materialDiffuse[i] = 0.7f + 0.1f * i;
+		}
+		light.infinite = infinite;
+		light.position[0] = infinite ? 0.48f : 1.5f;
+		light.position[1] = infinite ? 0.6f : -0.5f;
+		light.position[2] = infinite ? 0.64f : 2.0f;
+		light.attenuation[0] = 1.0f;
+		light.attenuation[1] = 0.25f;
+		light.attenuation[2] = 0.5f;
+		light.spot = spot;
+		light.spotDirection[0] = -0.6f;
+		light.spotDirection[1] = 0.0f;
+		light.spotDirection[2] = -0.8f;
+		light.cosSpotCutoff = 0.3f;
+		light.spotExponent = spotExponent;
+		light.twoSide = twoSide;
+	}
+
+	void kernelTestTemplate(const TinyGL::VertexKernels &kernels) {
+		float in[4][kCount], expected[4][kCount], result[4][kCount];
+		uint32 seed = 0x2468ace1;
+		TinyGL::Matrix4 m;
+
+		for (int pass = 0; pass < 4; ++pass) {
+			fillMatrix(m, seed);
+			fillRandom(&in[0][0], 4 * kCount, 3.0f, seed);
+			// Some of the normals are null, which normalizing must leave alone
+			in[0][3] = in[1][3] = in[2][3] = 0.0f;
+
+			TinyGL::transformPointsGeneric(m, in[0], in[1], in[2], NULL, expected[0], expected[1], expected[2], expected[3], kCount);
+			kernels.transformPoints(m, in[0], in[1], in[2], NULL, result[0], result[1], result[2], result[3], kCount);
+			TS_ASSERT_EQUALS(memcmp(expected, result, sizeof(expected)), 0);
+
+			TinyGL::transformPointsGeneric(m, in[0], in[1], in[2], in[3], expected[0], expected[1], expected[2], expected[3], kCount);
+			kernels.transformPoints(m, in[0], in[1], in[2], in[3], result[0], result[1], result[2], result[3], kCount);
+			TS_ASSERT_EQUALS(memcmp(expected, result, sizeof(expected)), 0);
+
+			for (int normalize = 0; normalize < 2; ++normalize) {
+				TinyGL::transformNormalsGeneric(m, in[0], in[1], in[2], expected[0], expected[1], expected[2], kCount, normalize);
+				kernels.transformNormals(m, in[0], in[1], in[2], result[0], result[1], result[2], kCount, normalize);
+				TS_ASSERT_EQUALS(memcmp(expected, result, 3 * sizeof(expected[0])), 0);
+			}
+		}
+
+		// Eye coordinates around the lights, and unit normals
+		float ec[3][kCount], normals[3][kCount];
+		fillRandom(&ec[0][0], 3 * kCount, 4.0f, seed);
+		fillRandom(&normals[0][0], 3 * kCount, 1.0f, seed);
+		m.identity();
+		TinyGL::transformNormalsGeneric(m, normals[0], normals[1], normals[2], normals[0], normals[1], normals[2], kCount, true);
+
+		for (int type = 0; type < 8; ++type) {
+			TinyGL::LightKernelParams light;
+			initLight(light, type == 0 || type == 1, type >= 4, (type & 2) ? 2.0f : 0.0f, type & 1);
+
+			for (int c = 0; c < 3; ++c) {
+				for (int i = 0; i < kCount; ++i)
+					expected[c][i] = result[c][i] = 0.1f * c;
+			}
+			TinyGL::shadeLightGeneric(light, ec[0], ec[1], ec[2], normals[0], normals[1], normals[2], expected[0], expected[1], expected[2], kCount);
+			kernels.shadeLight(light, ec[0], ec[1], ec[2], normals[0], normals[1], normals[2], result[0], result[1], result[2], kCount);
+			TS_ASSERT_EQUALS(memcmp(expected, result, 3 * sizeof(expected[0])), 0);
+		}
+	}
+#endif
+
+public:
+	void test_kernels() {
+#ifdef USE_TINYGL
+		Common::install_null_g_system();
+
+		TinyGL::VertexKernels kernels;
+		TinyGL::getVertexKernels(kernels, false);
+		kernelTestTemplate(kernels);
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2)) {
+			kernels.transformPoints = TinyGL::transformPointsSSE2;
+			kernels.transformNormals = TinyGL::transformNormalsSSE2;
+			kernels.shadeLight = TinyGL::shadeLightSSE2;
+			kernelTestTemplate(kernels);
+		}
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2)) {
+			kernels.transformPoints = TinyGL::transformPointsAVX2;
+			kernels.transformNormals = TinyGL::transformNormalsAVX2;
+			kernels.shadeLight = TinyGL::shadeLightAVX2;
+			kernelTestTemplate(kernels);
+		}
+#endif
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON)) {
+			kernels.transformPoints = TinyGL::transformPointsNEON;
+			kernels.transformNormals = TinyGL::transformNormalsNEON;
+			kernels.shadeLight = TinyGL::shadeLightNEON;
+			kernelTestTemplate(kernels);
+		}
+#endif
+#endif
+	}
+};
+
+#ifdef USE_TINYGL
+// The other test suites are built along with this one, and zmath.h defines
+// short macros for the vector components
+#undef X
+#undef Y
+#undef Z
+#undef W
+#endif
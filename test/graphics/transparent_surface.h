@@ -0,0 +1,120 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/transparent_surface.h"
+#include "graphics/transparent_surface_kernels.h"
+
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class TransparentSurfaceTestSuite : public CxxTest::TestSuite
+{
+private:
+	static void fillRandom(byte *data, int size, uint32 &seed) {
+		for (int i = 0; i < size; ++i) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = (byte)(seed >> 16);
+		}
+	}
+
+	void kernelTestTemplate(Graphics::BlendBlitRowProc generic, Graphics::BlendBlitRowProc kernel) {
+		// Use an odd number of pixels per SIMD block to exercise the tail handling
+		const int width = 8 * 13 + 5;
+		byte src[width * 4], expected[width * 4], blended[width * 4];
+
+		const uint32 colors[] = {
+			0xffffffff, 0xff808080, 0x80ffffff, 0xffff00ff,
+			0x7f10ff80, 0x00ffffff, 0xfe01fffe, 0x01000000
+		};
+
+		uint32 seed = 0x13579bdf;
+		for (int round = 0; round < 16; ++round) {
+			fillRandom(src, sizeof(src), seed);
+			fillRandom(expected, sizeof(expected), seed);
+			// Make sure fully transparent and opaque pixels are covered
+			for (int i = 0; i < width; i += 3)
+				src[i * 4] = (i & 1) ? 0xff : 0;
+
+			for (uint c = 0; c < ARRAYSIZE(colors); ++c) {
+				for (int flipped = 0; flipped < 2; ++flipped) {
+					const int32 inStep = flipped ? -4 : 4;
+					const byte *in = flipped ? src + (width - 1) * 4 : src;
+
+					memcpy(blended, expected, sizeof(blended));
+					byte reference[width * 4];
+					memcpy(reference, expected, sizeof(reference));
+					generic(reference, in, width, inStep, colors[c]);
+					kernel(blended, in, width, inStep, colors[c]);
+					TS_ASSERT_EQUALS(memcmp(reference, blended, sizeof(blended)), 0);
+				}
+			}
+		}
+	}
+
+	void kernelSetTestTemplate(Graphics::BlendBlitRowProc alpha, Graphics::BlendBlitRowProc additive,
+			Graphics::BlendBlitRowProc subtractive, Graphics::BlendBlitRowProc multiply) {
+		kernelTestTemplate(Graphics::blendBlitRowAlphaGeneric, alpha);
+		kernelTestTemplate(Graphics::blendBlitRowAdditiveGeneric, additive);
+		kernelTestTemplate(Graphics::blendBlitRowSubtractiveGeneric, subtractive);
+		kernelTestTemplate(Graphics::blendBlitRowMultiplyGeneric, multiply);
+	}
+
+public:
+	void test_kernels() {
+		Common::install_null_g_system();
+
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+			kernelSetTestTemplate(Graphics::blendBlitRowAlphaSSE2, Graphics::blendBlitRowAdditiveSSE2,
+				Graphics::blendBlitRowSubtractiveSSE2, Graphics::blendBlitRowMultiplySSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+			kernelSetTestTemplate(Graphics::blendBlitRowAlphaAVX2, Graphics::blendBlitRowAdditiveAVX2,
+				Graphics::blendBlitRowSubtractiveAVX2, Graphics::blendBlitRowMultiplyAVX2);
+#endif
+#if defined(SCUMMVM_NEON) && defined(SCUMM_LITTLE_ENDIAN)
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+			kernelSetTestTemplate(Graphics::blendBlitRowAlphaNEON, Graphics::blendBlitRowAdditiveNEON,
+				Graphics::blendBlitRowSubtractiveNEON, Graphics::blendBlitRowMultiplyNEON);
+#endif
+	}
+
+	void test_blit_matches_generic() {
+		Common::install_null_g_system();
+
+		const Graphics::PixelFormat format = Graphics::TransparentSurface::getSupportedPixelFormat();
+		Graphics::TransparentSurface sprite;
+		sprite.create(37, 23, format);
+		Graphics::Surface expected, blended;
+		expected.create(64, 48, format);
+		blended.create(64, 48, format);
+
+		uint32 seed = 0x2468ace1;
+		fillRandom((byte *)sprite.getPixels(), sprite.pitch * sprite.h, seed);
+
+		const Graphics::TSpriteBlendMode modes[] = {
+			Graphics::BLEND_NORMAL, Graphics::BLEND_ADDITIVE, Graphics::BLEND_SUBTRACTIVE, Graphics::BLEND_MULTIPLY
+		};
+		const int flips[] = { Graphics::FLIP_NONE, Graphics::FLIP_H, Graphics::FLIP_V };
+
+		for (uint m = 0; m < ARRAYSIZE(modes); ++m) {
+			for (uint f = 0; f < ARRAYSIZE(flips); ++f) {
+				fillRandom((byte *)expected.getPixels(), expected.pitch * expected.h, seed);
+				blended.copyFrom(expected);
+
+				Graphics::TransparentSurface::setSIMDEnabled(false);
+				sprite.blit(expected, 5, -3, flips[f], nullptr, 0xc8ff8040, -1, -1, modes[m]);
+				Graphics::TransparentSurface::setSIMDEnabled(true);
+				sprite.blit(blended, 5, -3, flips[f], nullptr, 0xc8ff8040, -1, -1, modes[m]);
+
+				for (int row = 0; row < expected.h; ++row)
+					TS_ASSERT_EQUALS(memcmp(expected.getBasePtr(0, row), blended.getBasePtr(0, row), expected.w * 4), 0);
+			}
+		}
+
+		sprite.free();
+		expected.free();
+		blended.free();
+	}
+};
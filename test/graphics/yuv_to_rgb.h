@@ -0,0 +1,131 @@
+#include <cxxtest/TestSuite.h>
+
+#include "graphics/yuv_to_rgb.h"
+
+#include "common/system.h"
+
+#include "../null_osystem.h"
+
+class YUVToRGBTestSuite : public CxxTest::TestSuite
+{
+private:
+	static void fillRandom(byte *data, int size, uint32 &seed) {
+		for (int i = 0; i < size; ++i) {
+			seed = seed * 1103515245 + 12345;
+			data[i] = (byte)(seed >> 16);
+		}
+	}
+
+	void convertTestTemplate(const Graphics::PixelFormat &format, Graphics::YUVToRGBManager::LuminanceScale scale, bool subsampled) {
+		// Use an odd number of pixels per SIMD block to exercise the tail handling
+		const int width = 2 * 37;
+		const int height = 6;
+		const int yPitch = width + 3;
+		const int uvWidth = subsampled ? width / 2 : width;
+		const int uvHeight = subsampled ? height / 2 : height;
+		const int uvPitch = uvWidth + 5;
+
+		byte *y = new byte[yPitch * height];
+		byte *u = new byte[uvPitch * uvHeight];
+		byte *v = new byte[uvPitch * uvHeight];
+
+		uint32 seed = 0x2468ace1;
+		fillRandom(y, yPitch * height, seed);
+		fillRandom(u, uvPitch * uvHeight, seed);
+		fillRandom(v, uvPitch * uvHeight, seed);
+
+		Graphics::Surface expected, converted;
+		expected.create(width, height, format);
+		converted.create(width, height, format);
+
+		YUVToRGBMan.setSIMDEnabled(false);
+		if (subsampled)
+			YUVToRGBMan.convert420(&expected, scale, y, u, v, width, height, yPitch, uvPitch);
+		else
+			YUVToRGBMan.convert444(&expected, scale, y, u, v, width, height, yPitch, uvPitch);
+
+		YUVToRGBMan.setSIMDEnabled(true);
+		if (subsampled)
+			YUVToRGBMan.convert420(&converted, scale, y, u, v, width, height, yPitch, uvPitch);
+		else
+			YUVToRGBMan.convert444(&converted, scale, y, u, v, width, height, yPitch, uvPitch);
+
+		for (int row = 0; row < height; ++row)
+			TS_ASSERT_EQUALS(memcmp(expected.getBasePtr(0, row), converted.getBasePtr(0, row), width * format.bytesPerPixel), 0);
+
+		expected.free();
+		converted.free();
+		delete[] y;
+		delete[] u;
+		delete[] v;
+	}
+
+	void kernelTestTemplate(Graphics::YUVToRGBRowProc row16, Graphics::YUVToRGBRowProc row32) {
+		// Cover every luminance value with offsets beyond both ends of the range
+		const int width = 256 + 13;
+		byte y[width];
+		int16 rOffsets[width], gOffsets[width], bOffsets[width];
+		for (int i = 0; i < width; ++i) {
+			y[i] = (byte)i;
+			rOffsets[i] = (int16)((i * 7) % 600 - 300);
+			gOffsets[i] = (int16)((i * 13) % 600 - 300);
+			bOffsets[i] = (int16)((i * 31) % 600 - 300);
+		}
+
+		Graphics::YUVToRGBFormat formats[] = {
+			{ 3, 2, 3, 11, 5, 0, 0, false },
+			{ 3, 3, 3, 10, 5, 0, 0x8000, true },
+			{ 0, 0, 0, 24, 16, 8, 0xff, false },
+			{ 0, 0, 0, 16, 8, 0, 0xff000000, true }
+		};
+
+		uint32 expected[width], converted[width];
+		for (uint f = 0; f < ARRAYSIZE(formats); ++f) {
+			Graphics::yuvToRGBRow16Generic((byte *)expected, y, rOffsets, gOffsets, bOffsets, width, formats[f]);
+			row16((byte *)converted, y, rOffsets, gOffsets, bOffsets, width, formats[f]);
+			TS_ASSERT_EQUALS(memcmp(expected, converted, width * 2), 0);
+
+			Graphics::yuvToRGBRow32Generic((byte *)expected, y, rOffsets, gOffsets, bOffsets, width, formats[f]);
+			row32((byte *)converted, y, rOffsets, gOffsets, bOffsets, width, formats[f]);
+			TS_ASSERT_EQUALS(memcmp(expected, converted, width * 4), 0);
+		}
+	}
+
+public:
+	void test_kernels() {
+		Common::install_null_g_system();
+
+		kernelTestTemplate(Graphics::yuvToRGBRow16Generic, Graphics::yuvToRGBRow32Generic);
+#ifdef SCUMMVM_SSE2
+		if (g_system->hasFeature(OSystem::kFeatureCpuSSE2))
+			kernelTestTemplate(Graphics::yuvToRGBRow16SSE2, Graphics::yuvToRGBRow32SSE2);
+#endif
+#ifdef SCUMMVM_AVX2
+		if (g_system->hasFeature(OSystem::kFeatureCpuAVX2))
+			kernelTestTemplate(Graphics::yuvToRGBRow16AVX2, Graphics::yuvToRGBRow32AVX2);
+#endif
+#ifdef SCUMMVM_NEON
+		if (g_system->hasFeature(OSystem::kFeatureCpuNEON))
+			kernelTestTemplate(Graphics::yuvToRGBRow16NEON, Graphics::yuvToRGBRow32NEON);
+#endif
+	}
+
+	void test_convert_matches_lookup() {
+		Common::install_null_g_system();
+
+		const Graphics::PixelFormat formats[] = {
+			Graphics::PixelFormat(2, 5, 6, 5, 0, 11, 5, 0, 0),
+			Graphics::PixelFormat(2, 5, 5, 5, 1, 10, 5, 0, 15),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 24, 16, 8, 0),
+			Graphics::PixelFormat(4, 8, 8, 8, 8, 16, 8, 0, 24),
+			Graphics::PixelFormat(4, 8, 8, 8, 0, 0, 8, 16, 0)
+		};
+
+		for (uint f = 0; f < ARRAYSIZE(formats); ++f) {
+			convertTestTemplate(formats[f], Graphics::YUVToRGBManager::kScaleFull, false);
+			convertTestTemplate(formats[f], Graphics::YUVToRGBManager::kScaleITU, false);
+			convertTestTemplate(formats[f], Graphics::YUVToRGBManager::kScaleFull, true);
+			convertTestTemplate(formats[f], Graphics::YUVToRGBManager::kScaleITU, true);
+		}
+	}
+};
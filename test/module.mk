@@ -5,7 +5,7 @@
 #
 ######################################################################
 
-TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/math/*.h
+TESTS        := $(srcdir)/test/common/*.h $(srcdir)/test/audio/*.h $(srcdir)/test/graphics/*.h $(srcdir)/test/math/*.h $(srcdir)/test/engines/*.h
 TEST_LIBS    :=
 
 ifdef POSIX
@@ -27,13 +27,23 @@ TEST_LIBS += test/null_osystem.o \
 	backends/modular-backend.o
 endif
 
-TEST_LIBS +=	audio/libaudio.a math/libmath.a common/libcommon.a
+TEST_LIBS +=	engines/libengines.a audio/libaudio.a graphics/libgraphics.a math/libmath.a common/libcommon.a
 
 ifeq ($(ENABLE_WINTERMUTE), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/wintermute/*.h
 	TEST_LIBS += engines/wintermute/libwintermute.a
 endif
 
+ifeq ($(ENABLE_SCI), STATIC_PLUGIN)
+	TESTS += $(srcdir)/test/engines/sci/*.h
+	TEST_LIBS += engines/sci/libsci.a
+endif
+
+ifeq ($(ENABLE_AGS), STATIC_PLUGIN)
+	TESTS += $(srcdir)/test/engines/ags/*.h
+	TEST_LIBS += engines/ags/libags.a
+endif
+
 ifeq ($(ENABLE_ULTIMA), STATIC_PLUGIN)
 	TESTS += $(srcdir)/test/engines/ultima/*/*/*.h
 	TEST_LIBS += engines/ultima/libultima.a